@@ -0,0 +1 @@
+module.exports = '/root/repo/dist/release/lib/x64/libmetawear.so.0.20.9';
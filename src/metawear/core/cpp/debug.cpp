@@ -85,12 +85,14 @@ void free_debug_module(void *state) {
 void mbl_mw_debug_reset(const MblMwMetaWearBoard *board) {
     uint8_t command[2]= {MBL_MW_MODULE_DEBUG, ORDINAL(DebugRegister::RESET)};
     SEND_COMMAND;
+    clear_config_shadow(board);
 }
 
 // Jump to bootloader
 void mbl_mw_debug_jump_to_bootloader(const MblMwMetaWearBoard *board) {
     uint8_t command[2]= {MBL_MW_MODULE_DEBUG, ORDINAL(DebugRegister::BOOTLOADER)};
     SEND_COMMAND;
+    clear_config_shadow(board);
 }
 
 // Disconnect
@@ -103,6 +105,7 @@ void mbl_mw_debug_disconnect(const MblMwMetaWearBoard *board) {
 void mbl_mw_debug_reset_after_gc(const MblMwMetaWearBoard *board) {
     uint8_t command[2]= {MBL_MW_MODULE_DEBUG, ORDINAL(DebugRegister::RESET_GC)};
     SEND_COMMAND;
+    clear_config_shadow(board);
 }
 
 // Power save
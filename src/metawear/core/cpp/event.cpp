@@ -1,25 +1,46 @@
 #include "metawear/core/event.h"
 #include "metawear/core/module.h"
 #include "metawear/core/status.h"
-#include "metawear/platform/cpp/threadpool.h"
 
+#include "constant.h"
 #include "event_register.h"
 #include "event_private.h"
 #include "metawearboard_def.h"
 #include "register.h"
 
 #include <memory>
+#include <queue>
 #include <vector>
 
 using std::forward_as_tuple;
 using std::make_shared;
 using std::piecewise_construct;
+using std::queue;
 using std::shared_ptr;
 using std::static_pointer_cast;
 using std::vector;
 
 #define GET_EVENT_STATE(board) static_pointer_cast<EventState>(board->event_state)
 
+const uint8_t MAX_PAIRS_IN_FLIGHT= 4, ENTRY_LENGTH= 8, DATA_TOKEN_LENGTH= 2;
+
+struct EventBatch {
+    EventBatch(const MblMwEventBinding* bindings, uint32_t n_bindings, void *context, MblMwFnEventBindingResults programmed);
+
+    // ENTRY and CMD_PARAMETERS commands, each prefixed by its length
+    vector<uint8_t> buffer;
+    // start of each ENTRY command in the buffer, and the binding it belongs to
+    vector<size_t> pair_offsets;
+    vector<uint32_t> pair_bindings;
+    vector<uint8_t> entry_ids;
+    vector<MblMwEventBindingResult> results;
+    shared_ptr<Task> timeout;
+    void *context;
+    MblMwFnEventBindingResults programmed;
+    uint32_t current_binding;
+    size_t n_sent, n_acked;
+};
+
 struct EventState {
     shared_ptr<Task> record_cmd_task;
     void *event_recorded_context;
@@ -27,10 +48,23 @@ struct EventState {
     MblMwEvent* event_owner;
     const EventDataParameter* data_token;
     vector<uint8_t> event_config;
+    // batch being programmed, batches the caller records meanwhile wait in order, and the batch commands are recorded into
+    shared_ptr<EventBatch> batch, recording_batch;
+    queue<shared_ptr<EventBatch>> queued_batches;
 
     EventState();
 };
 
+EventBatch::EventBatch(const MblMwEventBinding* bindings, uint32_t n_bindings, void *context, MblMwFnEventBindingResults programmed) : 
+        context(context), programmed(programmed), current_binding(0), n_sent(0), n_acked(0) {
+    // sized for one full length command per binding, more commands grow the buffer
+    buffer.reserve(n_bindings * (ENTRY_LENGTH + DATA_TOKEN_LENGTH + BLE_PACKET_SIZE + 2));
+    results.reserve(n_bindings);
+    for(uint32_t i= 0; i < n_bindings; i++) {
+        results.push_back({bindings[i].event, nullptr, 0});
+    }
+}
+
 EventState::EventState() : event_recorded_context(nullptr), event_recorded_callback(nullptr), event_owner(nullptr), data_token(nullptr) {
 }
 
@@ -64,14 +98,82 @@ void MblMwEvent::serialize(vector<uint8_t>& state) const {
     state.insert(state.end(), event_command_ids.begin(), event_command_ids.end());
 }
 
+static void send_batch_pairs(MblMwMetaWearBoard* board, shared_ptr<EventBatch> batch);
+
+// Helper function - reports the batch results and starts the next queued batch
+static void complete_batch(MblMwMetaWearBoard* board, shared_ptr<EventBatch> batch, int32_t status) {
+    auto state = GET_EVENT_STATE(board);
+    if (state->batch != batch) {
+        return;
+    }
+
+    // the next batch is claimed before the callback so batches programmed from it queue behind
+    shared_ptr<EventBatch> next;
+    if (!state->queued_batches.empty()) {
+        next = state->queued_batches.front();
+        state->queued_batches.pop();
+    }
+    state->batch = next;
+    if (batch->timeout != nullptr) {
+        batch->timeout->cancel();
+    }
+    batch->programmed(batch->context, board, batch->results.data(), (uint32_t) batch->results.size(), status);
+
+    if (next != nullptr) {
+        if (next->pair_offsets.empty()) {
+            complete_batch(board, next, MBL_MW_STATUS_OK);
+        } else {
+            send_batch_pairs(board, next);
+        }
+    }
+}
+
+// Helper function - sends ENTRY/CMD_PARAMETERS pairs until the in flight limit is reached
+static void send_batch_pairs(MblMwMetaWearBoard* board, shared_ptr<EventBatch> batch) {
+    bool sent = false;
+    while(batch->n_sent < batch->pair_offsets.size() && batch->n_sent - batch->n_acked < MAX_PAIRS_IN_FLIGHT) {
+        const uint8_t* entry = batch->buffer.data() + batch->pair_offsets[batch->n_sent];
+        const uint8_t* parameters = entry + entry[0] + 1;
+
+        batch->n_sent++;
+        sent = true;
+        send_command(board, entry + 1, entry[0]);
+        send_command(board, parameters + 1, parameters[0]);
+    }
+
+    if (batch->timeout != nullptr) {
+        batch->timeout->cancel();
+    }
+    batch->timeout = schedule_response_timeout(board, [board, batch](void) -> void {
+        complete_batch(board, batch, MBL_MW_STATUS_ERROR_TIMEOUT);
+    }, batch->n_sent - batch->n_acked, sent);
+}
+
 // Helper function - event command recorded
 static int32_t event_command_recorded(MblMwMetaWearBoard *board, const uint8_t *response, uint8_t len) {
     auto state = GET_EVENT_STATE(board);
-    if (state->event_owner != nullptr) {
+    auto batch = state->batch;
+    if (batch != nullptr && batch->n_acked < batch->n_sent) {
+        response_received(batch->timeout);
+
+        uint32_t binding = batch->pair_bindings[batch->n_acked];
+        auto& result = batch->results[binding];
+
+        batch->entry_ids[batch->n_acked] = response[2];
+        result.n_entry_ids++;
+        result.event->event_command_ids.push_back(response[2]);
+        batch->n_acked++;
+
+        if (batch->n_acked == batch->pair_offsets.size()) {
+            complete_batch(board, batch, MBL_MW_STATUS_OK);
+        } else {
+            send_batch_pairs(board, batch);
+        }
+    } else if (state->event_owner != nullptr) {
         state->event_owner->event_command_ids.push_back(response[2]);
 
         if ((uint8_t)state->event_owner->event_command_ids.size() == state->event_owner->num_expected_cmds) {
-            state->record_cmd_task->cancel();
+            response_received(state->record_cmd_task);
 
             auto caller = state->event_owner;
             state->event_owner = nullptr;
@@ -113,25 +215,96 @@ void mbl_mw_event_end_record(MblMwEvent *event, void *context, MblMwFnEventPtrIn
     state->event_recorded_context= context;
     state->event_recorded_callback= commands_recorded;
     state->event_config.clear();
-    state->record_cmd_task= ThreadPool::schedule([state, event](void) -> void {
+    state->record_cmd_task= schedule_response_timeout(event->owner, [state, event](void) -> void {
         state->event_owner = nullptr;
         state->event_recorded_callback(state->event_recorded_context, event, MBL_MW_STATUS_ERROR_TIMEOUT);
-    }, event->commands.size() * event->owner->time_per_response);
+    }, event->commands.size());
 
     for(auto it: event->commands) {
         send_command(event->owner, it.data(), (uint8_t) it.size());
     }
 }
 
+// Program a batch of bindings
+void mbl_mw_event_program(MblMwMetaWearBoard* board, const MblMwEventBinding* bindings, uint32_t n_bindings, 
+        void *context, MblMwFnEventBindingResults programmed) {
+    auto state = GET_EVENT_STATE(board);
+    auto batch = make_shared<EventBatch>(bindings, n_bindings, context, programmed);
+
+    state->recording_batch = batch;
+    for(uint32_t i = 0; i < n_bindings; i++) {
+        const MblMwEventBinding& binding = bindings[i];
+
+        batch->current_binding = i;
+        state->event_config.assign({binding.event->header.module_id, binding.event->header.register_id, binding.event->header.data_id});
+        binding.record(binding.context, binding.event);
+    }
+    state->event_config.clear();
+    state->recording_batch = nullptr;
+
+    // every binding's ids are contiguous since bindings are recorded in order
+    batch->entry_ids.resize(batch->pair_offsets.size());
+    size_t offset = 0;
+    for(uint32_t i = 0; i < n_bindings; i++) {
+        batch->results[i].entry_ids = batch->entry_ids.data() + offset;
+        while(offset < batch->pair_bindings.size() && batch->pair_bindings[offset] == i) {
+            offset++;
+        }
+    }
+
+    if (state->batch != nullptr) {
+        state->queued_batches.push(batch);
+        return;
+    }
+
+    state->batch = batch;
+    if (batch->pair_offsets.empty()) {
+        complete_batch(board, batch, MBL_MW_STATUS_OK);
+    } else {
+        send_batch_pairs(board, batch);
+    }
+}
+
 // Get owner
 MblMwMetaWearBoard* mbl_mw_event_get_owner(const MblMwEvent *event) {
     return event->owner;
 }
 
 // Helper function - record command
+bool is_recording_commands(const MblMwMetaWearBoard* board) {
+    auto state = GET_EVENT_STATE(board);
+    return state != nullptr && !state->event_config.empty();
+}
+
+// Helper function - appends an ENTRY/CMD_PARAMETERS pair to the batch buffer
+static void encode_batch_pair(EventState* state, const uint8_t* command, uint8_t len) {
+    auto batch = state->recording_batch;
+    auto& buffer = batch->buffer;
+
+    batch->pair_offsets.push_back(buffer.size());
+    batch->pair_bindings.push_back(batch->current_binding);
+
+    buffer.push_back(ENTRY_LENGTH + (state->data_token != nullptr ? DATA_TOKEN_LENGTH : 0));
+    buffer.insert(buffer.end(), { MBL_MW_MODULE_EVENT, ORDINAL(EventRegister::ENTRY),
+        state->event_config[0], state->event_config[1], state->event_config[2], command[0], command[1], (uint8_t)(len - 2) });
+    if (state->data_token != nullptr) {
+        buffer.push_back((uint8_t)(0x01 | (state->data_token->data_length << 1) | (state->data_token->data_offset << 4)));
+        buffer.push_back(state->data_token->dest_offset);
+    }
+
+    buffer.push_back(len);
+    buffer.push_back(MBL_MW_MODULE_EVENT);
+    buffer.push_back(ORDINAL(EventRegister::CMD_PARAMETERS));
+    buffer.insert(buffer.end(), command + 2, command + len);
+}
+
 bool record_command(const MblMwMetaWearBoard* board, const uint8_t* command, uint8_t len) {
     auto state = GET_EVENT_STATE(board);
 
+    if (state != nullptr && !state->event_config.empty() && state->recording_batch != nullptr) {
+        encode_batch_pair(state.get(), command, len);
+        return true;
+    }
     if (state != nullptr && !state->event_config.empty()) {
         state->event_owner->num_expected_cmds++;
         vector<uint8_t> event_entry = { MBL_MW_MODULE_EVENT, ORDINAL(EventRegister::ENTRY),
@@ -31,5 +31,6 @@ struct MblMwEvent {
 void init_event_module(MblMwMetaWearBoard* board);
 void free_event_module(void *state);
 bool record_command(const MblMwMetaWearBoard* board, const uint8_t* command, uint8_t len);
+bool is_recording_commands(const MblMwMetaWearBoard* board);
 void set_data_token(MblMwMetaWearBoard* board, const EventDataParameter* token);
 void clear_data_token(MblMwMetaWearBoard* board);
@@ -4,7 +4,6 @@
 #include "metawear/core/status.h"
 #include "metawear/core/cpp/metawearboard_macro.h"
 #include "metawear/platform/cpp/async_creator.h"
-#include "metawear/platform/cpp/threadpool.h"
 #include "metawear/processor/cpp/dataprocessor_config.h"
 #include "metawear/processor/cpp/dataprocessor_private.h"
 #include "metawear/processor/cpp/dataprocessor_register.h"
@@ -22,6 +21,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <sstream>
 #include <unordered_map>
@@ -35,8 +35,12 @@ using namespace std::chrono;
 #define GET_LOGGER_STATE(board) static_pointer_cast<LoggerState>(board->logger_state)
 
 const uint8_t REVISION_EXTENDED_LOGGING= 2, MMS_REVISION= 3, ENTRY_ID_MASK= 0x1f, RESET_UID_MASK= 0x7, 
-        LOG_ENTRY_SIZE= (uint8_t) sizeof(uint32_t), ROOT_SIGNAL_INDEX= 0xff;
+        LOG_ENTRY_SIZE= (uint8_t) sizeof(uint32_t), ROOT_SIGNAL_INDEX= 0xff, N_ENTRY_IDS= ENTRY_ID_MASK + 1, N_RESET_UIDS= RESET_UID_MASK + 1;
 const double TICK_TIME_STEP= (48.0 / 32768.0) * 1000.0;         ///< milliseconds
+// TICK_TIME_STEP is exactly 375/256 ms, so ticks convert to ms without floating point: (tick * 375 + 128) >> 8
+const uint64_t TICK_TIME_NUMERATOR= 375, TICK_TIME_SHIFT= 8;
+// Max number of logger / processor reads in flight when querying the active loggers
+const uint8_t MAX_PENDING_QUERIES= 4;
 
 const ResponseHeader 
     LOGGING_TIME_RESPONSE_HEADER(MBL_MW_MODULE_LOGGING, READ_REGISTER(ORDINAL(LoggingRegister::TIME))),
@@ -50,20 +54,40 @@ struct TimeReference {
     int64_t epoch;
     uint8_t reset_uid;
 
+    TimeReference();
     TimeReference(uint8_t** state_stream, uint8_t format);
     TimeReference(int64_t epoch, uint8_t reset_uid);
     void serialize(vector<uint8_t>& state) const;
 };
 
+static inline int64_t ticks_to_ms(uint32_t tick) {
+    return static_cast<int64_t>((tick * TICK_TIME_NUMERATOR + (1 << (TICK_TIME_SHIFT - 1))) >> TICK_TIME_SHIFT);
+}
+
+struct LoggerConfig {
+    uint8_t module_id, register_id, data_id, offset_length;
+    bool active;
+};
+
 struct MblMwDataLogger;
+/**
+ * Log entries carry a 5-bit entry id and a 3-bit reset uid so the readout tables are indexed directly 
+ * rather than hashed.  The *_valid bitmasks track which slots hold a value.
+ */
 struct LoggerState : public AsyncCreator {
-    unordered_map<uint8_t, TimeReference> log_time_references;
-    unordered_map<uint8_t, uint32_t> latest_tick, rollback_timestamps;
-    unordered_map<uint8_t, MblMwDataLogger*> data_loggers;
+    TimeReference log_time_references[N_RESET_UIDS];
+    uint32_t latest_tick[N_RESET_UIDS], rollback_timestamps[N_RESET_UIDS];
+    MblMwDataLogger* data_loggers[N_ENTRY_IDS];
+    uint8_t time_references_valid, latest_tick_valid, rollback_valid;
     unordered_map<const MblMwDataLogger*, string> identifiers;
     unordered_map<ResponseHeader, uint8_t> placeholder;
     unordered_map<ResponseHeader, int8_t> nRemainingLoggers;
     vector<MblMwAnonymousDataSignal*> anonymous_signals;
+    LoggerConfig logger_configs[N_ENTRY_IDS];
+    unordered_map<uint8_t, ProcessorEntry> synced_processors;
+    unordered_set<uint8_t> requested_processors;
+    unordered_map<ResponseHeader, vector<MblMwDataSignal*>> candidate_sources;
+    queue<uint8_t> pending_log_reads, queued_processor_reads;
     stack<uint8_t> fuser_ids;
     stack<tuple<MblMwDataSignal*, ProcessorEntry>> fuser_configs;
     MblMwDataLogger* next_logger;
@@ -71,12 +95,26 @@ struct LoggerState : public AsyncCreator {
     MblMwRawLogDownloadHandler raw_log_download_handler;
     float log_download_notify_progress;
     uint32_t n_log_entries;
-    uint8_t latest_reset_uid, queryLogId;
-    bool state_signal;
+    uint8_t latest_reset_uid, queryLogId, next_log_query, n_log_queries, n_pending_processor_reads;
+    bool state_signal, querying;
+    // guards the active logger query, its responses can arrive on several threads
+    recursive_mutex query_lock;
 
     LoggerState();
 
     void clear_data_loggers();
+    inline bool has_time_reference(uint8_t reset_uid) const {
+        return (time_references_valid & (1 << reset_uid)) != 0;
+    }
+    inline void set_time_reference(uint8_t reset_uid, int64_t epoch) {
+        log_time_references[reset_uid].epoch = epoch;
+        log_time_references[reset_uid].reset_uid = reset_uid;
+        time_references_valid |= (1 << reset_uid);
+    }
+    inline void clear_ticks() {
+        latest_tick_valid = 0;
+        rollback_valid = 0;
+    }
 };
 
 struct MblMwDataLogger : public MblMwAnonymousDataSignal {
@@ -153,12 +191,18 @@ static int32_t logging_response_entry_id_received(MblMwMetaWearBoard *board, con
 static MblMwDataSignal* guessLogSource(MblMwMetaWearBoard* board, ResponseHeader& key, uint8_t offset, uint8_t length) {
     key.disable_silent();
 
-    vector<MblMwDataSignal*> possible;
-    auto source = dynamic_cast<MblMwDataSignal*>(board->module_events.at(key));
+    auto state = GET_LOGGER_STATE(board);
+    auto candidates = state->candidate_sources.find(key);
+    if (candidates == state->candidate_sources.end()) {
+        vector<MblMwDataSignal*> possible;
+        auto source = dynamic_cast<MblMwDataSignal*>(board->module_events.at(key));
+
+        possible.push_back(source);
+        possible.insert(possible.end(), source->components.begin(), source->components.end());
+        candidates = state->candidate_sources.emplace(key, move(possible)).first;
+    }
+    const auto& possible = candidates->second;
 
-    possible.push_back(source);
-    possible.insert(possible.end(), source->components.begin(), source->components.end());
-    
     MblMwDataSignal* original = nullptr;
     bool multiple = false;
     for(auto it: possible) {
@@ -169,7 +213,6 @@ static MblMwDataSignal* guessLogSource(MblMwMetaWearBoard* board, ResponseHeader
     }
 
     if (multiple) {
-        auto state = GET_LOGGER_STATE(board);
         if (offset == 0 && length > LOG_ENTRY_SIZE) {
             return original;
         }
@@ -194,43 +237,6 @@ static MblMwDataSignal* guessLogSource(MblMwMetaWearBoard* board, ResponseHeader
     return nullptr;
 }
 
-// Helper function - queue
-static void queue_next_logger(MblMwMetaWearBoard* board) {
-    auto state = GET_LOGGER_STATE(board);
-    state->timeout->cancel();
-
-    state->queryLogId++;
-    if (state->queryLogId < board->module_info.at(MBL_MW_MODULE_LOGGING).extra[0]) {
-        state->pending_fns.push([=](void) -> void {
-            state->timeout= ThreadPool::schedule([state, board](void) -> void {
-                board->anon_signals_created(board->anon_signals_context, board, nullptr, MBL_MW_STATUS_ERROR_TIMEOUT);
-                state->create_next(true);
-            }, board->time_per_response);
-    
-            uint8_t command[3]= {MBL_MW_MODULE_LOGGING, READ_REGISTER(ORDINAL(LoggingRegister::TRIGGER)), state->queryLogId};
-            SEND_COMMAND;
-        });
-    } else {
-        vector<uint8_t> sorted;
-        for (auto it: state->data_loggers) {
-            sorted.push_back(it.first);
-        }
-        sort(sorted.begin(), sorted.end());
-
-        state->anonymous_signals.clear();
-        for(auto it: sorted) {
-            auto val = state->data_loggers[it];
-            auto pos = find(begin(state->anonymous_signals), end(state->anonymous_signals), val);
-            if (pos == end(state->anonymous_signals)) {
-                state->anonymous_signals.push_back(val);
-            }
-        }
-
-        board->anon_signals_created(board->anon_signals_context, board, state->anonymous_signals.data(), (uint32_t) state->anonymous_signals.size());
-    }
-    state->create_next(true);
-}
-
 // Helper function - got source
 static void log_source_discovered(shared_ptr<LoggerState> state, MblMwDataSignal* source, uint8_t offset) {
     if (state->state_signal) {
@@ -252,10 +258,13 @@ static void log_source_discovered(shared_ptr<LoggerState> state, MblMwDataSignal
 
     MblMwDataLogger* logger = nullptr;
     for(auto it: state->data_loggers) {
-        auto other = it.second->source;
+        if (it == nullptr) {
+            continue;
+        }
+        auto other = it->source;
         if (other->header == source->header && other->offset == source->offset && 
                 other->is_signed == source->is_signed && other->n_channels == source->n_channels && other->channel_size == source->channel_size) {
-            logger = it.second;
+            logger = it;
             break;
         }
     }
@@ -264,7 +273,7 @@ static void log_source_discovered(shared_ptr<LoggerState> state, MblMwDataSignal
         logger = new MblMwDataLogger(source, nullptr, nullptr);
     }
     logger->add_entry_id(state->queryLogId, true);
-    state->data_loggers[state->queryLogId] = logger;
+    state->data_loggers[state->queryLogId & ENTRY_ID_MASK] = logger;
 
     if (state->nRemainingLoggers.count(source->header)) {
         state->nRemainingLoggers[source->header]--;
@@ -272,8 +281,23 @@ static void log_source_discovered(shared_ptr<LoggerState> state, MblMwDataSignal
             state->nRemainingLoggers.erase(source->header);
         }
     }
+}
+
+// Helper function - build chain from the synced processors, root most processor on top
+static bool build_processor_chain(shared_ptr<LoggerState> state, uint8_t id, stack<ProcessorEntry>& chain) {
+    while(true) {
+        auto it = state->synced_processors.find(id);
+        if (it == state->synced_processors.end()) {
+            return false;
+        }
 
-    queue_next_logger(source->owner);
+        chain.push(it->second);
+        if (it->second.source.module_id == MBL_MW_MODULE_DATA_PROCESSOR && it->second.source.register_id == ORDINAL(DataProcessorRegister::NOTIFY)) {
+            id = it->second.source.data_id;
+        } else {
+            return true;
+        }
+    }
 }
 
 // Helper function - proc synced
@@ -331,27 +355,196 @@ static void processor_synced(MblMwMetaWearBoard* board, stack<ProcessorEntry>& e
         auto id = state->fuser_ids.top();
         state->fuser_ids.pop();
 
-        sync_processor_chain(board, id, processor_synced);
+        stack<ProcessorEntry> chain;
+        if (build_processor_chain(state, id, chain)) {
+            processor_synced(board, chain);
+        } else {
+            while(!state->fuser_ids.empty()) {
+                state->fuser_ids.pop();
+            }
+            while(!state->fuser_configs.empty()) {
+                state->fuser_configs.pop();
+            }
+        }
     }
 }
 
-// Helper function - response read entry id
-static int32_t logging_response_read_entry_id(MblMwMetaWearBoard *board, const uint8_t *response, uint8_t len) {
+// Helper function - restore loggers, the caller reports them once the query lock is released
+static void restore_active_loggers(MblMwMetaWearBoard* board) {
     auto state = GET_LOGGER_STATE(board);
+    if (state->timeout) {
+        state->timeout->cancel();
+    }
+    state->querying = false;
+    set_processor_config_handler(board, nullptr);
+
+    for(uint8_t i = 0; i < N_ENTRY_IDS; i++) {
+        const auto& config = state->logger_configs[i];
+        if (!config.active) {
+            continue;
+        }
 
-    if (len > 2) { 
-        uint8_t offset = (uint8_t) (response[5] & 0x1f), length = (uint8_t) (((response[5] >> 5) & 0x3) + 1);
-        ResponseHeader key(response[2], response[3], response[4]);
+        uint8_t offset = (uint8_t) (config.offset_length & 0x1f), length = (uint8_t) (((config.offset_length >> 5) & 0x3) + 1);
+        ResponseHeader key(config.module_id, config.register_id, config.data_id);
 
+        state->queryLogId = i;
         state->state_signal = key.module_id == MBL_MW_MODULE_DATA_PROCESSOR && CLEAR_READ(key.register_id) == ORDINAL(DataProcessorRegister::STATE);
         if (key.module_id == MBL_MW_MODULE_DATA_PROCESSOR && (key.register_id == ORDINAL(DataProcessorRegister::NOTIFY) || state->state_signal)) {
-            sync_processor_chain(board, key.data_id, processor_synced);
+            stack<ProcessorEntry> chain;
+            if (build_processor_chain(state, key.data_id, chain)) {
+                processor_synced(board, chain);
+            }
         } else {
-            log_source_discovered(state, guessLogSource(board, key, offset, length), offset);
+            auto source = guessLogSource(board, key, offset, length);
+            if (source != nullptr) {
+                log_source_discovered(state, source, offset);
+            }
+        }
+    }
+    state->candidate_sources.clear();
+    state->synced_processors.clear();
+
+    state->anonymous_signals.clear();
+    for(auto it: state->data_loggers) {
+        if (it != nullptr && find(begin(state->anonymous_signals), end(state->anonymous_signals), it) == end(state->anonymous_signals)) {
+            state->anonymous_signals.push_back(it);
+        }
+    }
+}
+
+// Helper function - report restored loggers
+static void active_loggers_restored(MblMwMetaWearBoard* board) {
+    auto state = GET_LOGGER_STATE(board);
+    board->anon_signals_created(board->anon_signals_context, board, state->anonymous_signals.data(), (uint32_t) state->anonymous_signals.size());
+    state->create_next(true);
+}
+
+// Helper function - number of query reads waiting on a response
+static size_t n_queries_in_flight(const shared_ptr<LoggerState>& state) {
+    return state->pending_log_reads.size() + state->n_pending_processor_reads;
+}
+
+// Helper function - query timeout, waits on every read in flight; fresh if the reads were all sent after the last response
+static void schedule_query_timeout(MblMwMetaWearBoard* board, bool fresh) {
+    auto state = GET_LOGGER_STATE(board);
+    if (state->timeout) {
+        state->timeout->cancel();
+    }
+    state->timeout= schedule_response_timeout(board, [state, board](void) -> void {
+        {
+            lock_guard<recursive_mutex> lock(state->query_lock);
+            // the last response can race the timeout, only one of them ends the query
+            if (!state->querying) {
+                return;
+            }
+            state->querying = false;
+            set_processor_config_handler(board, nullptr);
+        }
+
+        board->anon_signals_created(board->anon_signals_context, board, nullptr, MBL_MW_STATUS_ERROR_TIMEOUT);
+        state->create_next(true);
+    }, n_queries_in_flight(state), fresh);
+}
+
+// Helper function - request proc config
+static void queue_processor_read(shared_ptr<LoggerState> state, uint8_t id) {
+    if (state->requested_processors.insert(id).second) {
+        state->queued_processor_reads.push(id);
+    }
+}
+
+// Helper function - fill read window, true if every read was answered and the loggers were restored
+static bool send_pending_queries(MblMwMetaWearBoard* board) {
+    auto state = GET_LOGGER_STATE(board);
+
+    while(state->querying && state->pending_log_reads.size() + state->n_pending_processor_reads < MAX_PENDING_QUERIES) {
+        if (!state->queued_processor_reads.empty()) {
+            uint8_t id = state->queued_processor_reads.front();
+            state->queued_processor_reads.pop();
+            state->n_pending_processor_reads++;
+
+            read_processor_config(board, id);
+        } else if (state->next_log_query < state->n_log_queries) {
+            uint8_t id = state->next_log_query++;
+            state->pending_log_reads.push(id);
+
+            uint8_t command[3]= {MBL_MW_MODULE_LOGGING, READ_REGISTER(ORDINAL(LoggingRegister::TRIGGER)), id};
+            SEND_COMMAND;
+        } else {
+            break;
+        }
+    }
+
+    if (state->querying && state->pending_log_reads.empty() && state->n_pending_processor_reads == 0 && 
+            state->queued_processor_reads.empty() && state->next_log_query >= state->n_log_queries) {
+        restore_active_loggers(board);
+        return true;
+    }
+    return false;
+}
+
+// Helper function - proc config received
+static void logging_processor_config_received(MblMwMetaWearBoard* board, uint8_t id, const ProcessorEntry* entry) {
+    auto state = GET_LOGGER_STATE(board);
+    {
+        lock_guard<recursive_mutex> lock(state->query_lock);
+        if (!state->querying || state->n_pending_processor_reads == 0) {
+            return;
+        }
+        state->n_pending_processor_reads--;
+
+        if (entry != nullptr) {
+            state->synced_processors.emplace(id, *entry);
+
+            if (entry->source.module_id == MBL_MW_MODULE_DATA_PROCESSOR && entry->source.register_id == ORDINAL(DataProcessorRegister::NOTIFY)) {
+                queue_processor_read(state, entry->source.data_id);
+            }
+            if (entry->config.size() > 1 && entry->config[0] == 0x1b) {
+                for(size_t i = 0; i < (entry->config[1] & 0x1f) && i + 2 < entry->config.size(); i++) {
+                    queue_processor_read(state, entry->config[i + 2]);
+                }
+            }
+        }
+
+        response_received(state->timeout);
+        size_t n_in_flight = n_queries_in_flight(state);
+        if (!send_pending_queries(board)) {
+            schedule_query_timeout(board, n_in_flight == 0);
+            return;
         }
-    } else {
-        queue_next_logger(board);
     }
+    active_loggers_restored(board);
+}
+
+// Helper function - response read entry id
+static int32_t logging_response_read_entry_id(MblMwMetaWearBoard *board, const uint8_t *response, uint8_t len) {
+    auto state = GET_LOGGER_STATE(board);
+    {
+        lock_guard<recursive_mutex> lock(state->query_lock);
+        if (!state->querying || state->pending_log_reads.empty()) {
+            return 0;
+        }
+
+        // reads are answered in the order they were sent
+        uint8_t id = state->pending_log_reads.front();
+        state->pending_log_reads.pop();
+
+        if (len > 5) {
+            state->logger_configs[id & ENTRY_ID_MASK] = { response[2], response[3], response[4], response[5], true };
+            if (response[2] == MBL_MW_MODULE_DATA_PROCESSOR && (response[3] == ORDINAL(DataProcessorRegister::NOTIFY) || 
+                    CLEAR_READ(response[3]) == ORDINAL(DataProcessorRegister::STATE))) {
+                queue_processor_read(state, response[4]);
+            }
+        }
+
+        response_received(state->timeout);
+        size_t n_in_flight = n_queries_in_flight(state);
+        if (!send_pending_queries(board)) {
+            schedule_query_timeout(board, n_in_flight == 0);
+            return 0;
+        }
+    }
+    active_loggers_restored(board);
 
     return 0;
 }
@@ -364,8 +557,7 @@ static int32_t logging_response_length_received(MblMwMetaWearBoard *board, uint3
     // If there are no entires we won't get any responses, so end the download now
     // by forcing a callback on the readout progress with 0 remaining entries
     if (state->n_log_entries == 0) {
-        state->latest_tick.clear();
-        state->rollback_timestamps.clear();
+        state->clear_ticks();
         uint8_t readoutResponse[6] = {0};
         return logging_response_readout_progress(board, readoutResponse, sizeof(readoutResponse));
     }
@@ -380,47 +572,47 @@ static int32_t logging_response_length_received(MblMwMetaWearBoard *board, uint3
 }
 
 // Lookup reset 
-static TimeReference& mbl_mw_logger_lookup_reset_uid(const MblMwMetaWearBoard* board, uint8_t reset_uid) {
-    auto logger_state = GET_LOGGER_STATE(board);
-    if (logger_state->log_time_references.count(reset_uid)) {
-        return logger_state->log_time_references.at(reset_uid);
+static TimeReference& mbl_mw_logger_lookup_reset_uid(LoggerState* logger_state, uint8_t reset_uid) {
+    if (logger_state->has_time_reference(reset_uid)) {
+        return logger_state->log_time_references[reset_uid];
     }
     // No valid reset uid time base found.  This means we had multiple unexpected resets,
     // so come up with a best guess by working backwards to find a previous reset uid base.
     for (uint8_t prev_uid = (reset_uid - 1) & RESET_UID_MASK; prev_uid != reset_uid; prev_uid = (prev_uid - 1) & RESET_UID_MASK) {
-        if (logger_state->log_time_references.count(prev_uid)) {
+        if (logger_state->has_time_reference(prev_uid)) {
             // Copy the previous one
-            TimeReference prev_reference = logger_state->log_time_references.at(prev_uid);
-            prev_reference.reset_uid = reset_uid;
-            logger_state->log_time_references.emplace(reset_uid, prev_reference);
-            return logger_state->log_time_references.at(reset_uid);
+            logger_state->set_time_reference(reset_uid, logger_state->log_time_references[prev_uid].epoch);
+            return logger_state->log_time_references[reset_uid];
         }
     }
     // Nothing to go on just create a new one
-    logger_state->log_time_references.emplace(piecewise_construct, forward_as_tuple(reset_uid), 
-        forward_as_tuple(0, reset_uid));
-    return logger_state->log_time_references.at(reset_uid);
+    logger_state->set_time_reference(reset_uid, 0);
+    return logger_state->log_time_references[reset_uid];
 }
 
 // Helper function - calculate epoch
-static int64_t calculate_epoch_inner(shared_ptr<LoggerState> state, uint32_t tick, TimeReference& reference) {
+static int64_t calculate_epoch_inner(LoggerState* state, uint32_t tick, const TimeReference& reference) {
     state->latest_tick[reference.reset_uid]= tick;
-    return reference.epoch + static_cast<int64_t>(round((double)tick * TICK_TIME_STEP));
+    state->latest_tick_valid |= (1 << reference.reset_uid);
+    return reference.epoch + ticks_to_ms(tick);
 }
 
 // Helper function - response readout notify
 static int32_t logging_response_readout_notify(MblMwMetaWearBoard *board, const uint8_t *response, uint8_t len) {
-    auto parse_response= [&board, &response](uint8_t offset) -> void {
-        auto state= GET_LOGGER_STATE(board);
-        uint8_t entry_id= response[offset] & ENTRY_ID_MASK, reset_uid= (response[offset] & ~ENTRY_ID_MASK) >> 5;
-        auto entry_tick = (uint32_t*) (response + offset + 1), data = entry_tick + 1;
-
-        if (!state->rollback_timestamps.count(reset_uid) || state->rollback_timestamps.at(reset_uid) < *entry_tick) {
-            auto realtime = calculate_epoch_inner(state, *entry_tick, mbl_mw_logger_lookup_reset_uid(board, reset_uid));
-            if (state->data_loggers.count(entry_id)) {
-                state->data_loggers.at(entry_id)->process_log_data(entry_id, realtime, *data);
+    auto state= static_cast<LoggerState*>(board->logger_state.get());
+    auto parse_response= [state, &response](uint8_t offset) -> void {
+        uint8_t entry_id= response[offset] & ENTRY_ID_MASK, reset_uid= (response[offset] >> 5) & RESET_UID_MASK;
+        uint32_t entry_tick, data;
+        memcpy(&entry_tick, response + offset + 1, sizeof(entry_tick));
+        memcpy(&data, response + offset + 5, sizeof(data));
+
+        if (!(state->rollback_valid & (1 << reset_uid)) || state->rollback_timestamps[reset_uid] < entry_tick) {
+            auto realtime = calculate_epoch_inner(state, entry_tick, mbl_mw_logger_lookup_reset_uid(state, reset_uid));
+            auto logger = state->data_loggers[entry_id];
+            if (logger != nullptr) {
+                logger->process_log_data(entry_id, realtime, data);
             } else if (state->log_download_handler.received_unknown_entry != nullptr) {
-                state->log_download_handler.received_unknown_entry(state->log_download_handler.context, entry_id, realtime, (const uint8_t*) data, sizeof(*data));
+                state->log_download_handler.received_unknown_entry(state->log_download_handler.context, entry_id, realtime, (const uint8_t*) &data, sizeof(data));
             }
         }
     };
@@ -463,8 +655,7 @@ static int32_t logging_response_readout_progress(MblMwMetaWearBoard *board, cons
     memcpy(&entries_left, response + 2, min(len - 2, 4));
 
     if (entries_left == 0) {
-        state->latest_tick.clear();
-        state->rollback_timestamps.clear();
+        state->clear_ticks();
     }
     if (state->log_download_handler.received_progress_update != nullptr) {
         state->log_download_handler.received_progress_update(state->log_download_handler.context, entries_left, state->n_log_entries);
@@ -494,6 +685,9 @@ static int32_t raw_logging_response_page_completed(MblMwMetaWearBoard *board, co
     return 0;
 }
 
+TimeReference::TimeReference() : epoch(0), reset_uid(0) {
+}
+
 TimeReference::TimeReference(uint8_t** state_stream, uint8_t format) {
     if (format <= ORDINAL(SerializationFormat::SIGNAL_COMPONENT)) {
         milliseconds epoch(*((int64_t*) *state_stream));
@@ -508,7 +702,7 @@ TimeReference::TimeReference(uint8_t** state_stream, uint8_t format) {
 
         (*state_stream)++;
 
-        this->epoch = duration_cast<milliseconds>(timestamp.time_since_epoch()).count() - static_cast<int64_t>(round((double)tick * TICK_TIME_STEP));
+        this->epoch = duration_cast<milliseconds>(timestamp.time_since_epoch()).count() - ticks_to_ms(tick);
     } else {
         memcpy(&epoch, *state_stream, sizeof(int64_t));
         *state_stream += sizeof(int64_t);
@@ -571,10 +765,10 @@ void MblMwDataLogger::add_entry_id(uint8_t id, bool anonymous) {
     if (!anonymous && (uint8_t) entry_ids.size() == n_req_entries) {
         auto state= GET_LOGGER_STATE(source->owner);
 
-        state->timeout->cancel();
+        response_received(state->timeout);
 
         for(auto it: entry_ids) {
-            state->data_loggers[it]= this;
+            state->data_loggers[it & ENTRY_ID_MASK]= this;
         }
         state->next_logger = nullptr;
 
@@ -588,18 +782,20 @@ void MblMwDataLogger::process_log_data(uint8_t id, int64_t epoch, uint32_t data)
     entries.at(id).push(data);
     
     bool ready= true;
-    for(auto it: entries) {
+    for(const auto& it: entries) {
         ready&= !it.second.empty();
     }
     if (ready) {
-        vector<uint8_t> merged;
+        uint8_t merged[N_ENTRY_IDS * LOG_ENTRY_SIZE];
+        uint8_t merged_size= 0;
         for(auto it: entry_ids) {
-            uint8_t *data= (uint8_t*) &entries.at(it).front();
-            merged.insert(merged.end(), data, data + 4);
-            entries.at(it).pop();
+            auto& pending= entries.at(it);
+            memcpy(merged + merged_size, &pending.front(), LOG_ENTRY_SIZE);
+            merged_size+= LOG_ENTRY_SIZE;
+            pending.pop();
         }
 
-        MblMwData* data = data_response_converters.at(source->interpreter)(true, source, merged.data(), (uint8_t) merged.size());
+        MblMwData* data = data_response_converters.at(source->interpreter)(true, source, merged, merged_size);
         data->epoch= epoch;
 
         MblMwFnData unhandled_callback;
@@ -635,19 +831,26 @@ void MblMwDataLogger::serialize(vector<uint8_t>& state) const {
     state.insert(state.end(), entry_ids.begin(), entry_ids.end());
 }
 
-LoggerState::LoggerState() : next_logger(nullptr) { }
+LoggerState::LoggerState() : time_references_valid(0), latest_tick_valid(0), rollback_valid(0), next_logger(nullptr), 
+        n_pending_processor_reads(0), querying(false) {
+    memset(latest_tick, 0, sizeof(latest_tick));
+    memset(rollback_timestamps, 0, sizeof(rollback_timestamps));
+    fill(begin(data_loggers), end(data_loggers), nullptr);
+}
 
 void LoggerState::clear_data_loggers() {
     unordered_set<MblMwDataLogger*> unique_loggables;
     for (auto it : data_loggers) {
-        unique_loggables.insert(it.second);
+        if (it != nullptr) {
+            unique_loggables.insert(it);
+        }
     }
 
     for(auto it: unique_loggables) {
         delete it;
     }
 
-    data_loggers.clear();
+    fill(begin(data_loggers), end(data_loggers), nullptr);
     identifiers.clear();
 }
 
@@ -689,15 +892,33 @@ void tear_down_logging(void *state, bool preserve_memory) {
     }
 }
 
+// Helper function - number of on-board logger entries
+uint32_t count_logger_entries(const void *state) {
+    auto logging_state= (const LoggerState*) state;
+    uint32_t n_entries = 0;
+
+    if (logging_state != nullptr) {
+        for(auto it: logging_state->data_loggers) {
+            if (it != nullptr) {
+                n_entries++;
+            }
+        }
+    }
+    return n_entries;
+}
+
 // Helper function - disconnect
 void disconnect_logging(MblMwMetaWearBoard* board) {
     auto state = GET_LOGGER_STATE(board);
 
     if (state != nullptr) {
         state->pending_fns.clear();
-        for(auto it: state->latest_tick) {
-            state->rollback_timestamps[it.first] = it.second;
+        for(uint8_t i = 0; i < N_RESET_UIDS; i++) {
+            if (state->latest_tick_valid & (1 << i)) {
+                state->rollback_timestamps[i] = state->latest_tick[i];
+            }
         }
+        state->rollback_valid |= state->latest_tick_valid;
     }
 }
 
@@ -818,7 +1039,7 @@ MblMwDataSignal* mbl_mw_logger_get_signal(const MblMwDataLogger* logger) {
 // Lookup logger ID
 MblMwDataLogger* mbl_mw_logger_lookup_id(const MblMwMetaWearBoard* board, uint8_t id) {
     auto logger_state = GET_LOGGER_STATE(board);
-    return logger_state->data_loggers.count(id) ? logger_state->data_loggers.at(id) : nullptr;
+    return id < N_ENTRY_IDS ? logger_state->data_loggers[id] : nullptr;
 }
 
 // Remove logger
@@ -827,7 +1048,7 @@ void mbl_mw_logger_remove(MblMwDataLogger* loggable) {
 
     sort(loggable->entry_ids.begin(), loggable->entry_ids.end());
     for (auto it : loggable->entry_ids) {
-        state->data_loggers.erase(it);
+        state->data_loggers[it & ENTRY_ID_MASK] = nullptr;
         uint8_t command[3] = { MBL_MW_MODULE_LOGGING, ORDINAL(LoggingRegister::REMOVE), it };
         SEND_COMMAND_BOARD(loggable->source->owner);
     }
@@ -852,13 +1073,13 @@ void mbl_mw_datasignal_log(MblMwDataSignal *signal, void *context, MblMwFnDataLo
 
     state->pending_fns.push([=](void) -> void {
         state->next_logger= new MblMwDataLogger(signal, context, logger_ready);
-        state->timeout= ThreadPool::schedule([context, state, logger_ready](void) -> void {
+        state->timeout= schedule_response_timeout(signal->owner, [context, state, logger_ready](void) -> void {
             delete state->next_logger;
             state->next_logger = nullptr;
 
             logger_ready(context, nullptr);
             state->create_next(true);
-        }, state->next_logger->n_req_entries * signal->owner->time_per_response);
+        }, state->next_logger->n_req_entries);
 
         auto entries= state->next_logger->n_req_entries;
         uint8_t remainder= signal->length();
@@ -877,32 +1098,31 @@ void serialize_logging(const MblMwMetaWearBoard* board, std::vector<uint8_t>& st
     auto logger_state= GET_LOGGER_STATE(board);
 
     {
-        vector<uint8_t> sorted_keys;
-        for (auto it : logger_state->log_time_references) {
-            sorted_keys.push_back(it.first);
+        uint8_t n_refs = 0;
+        for (uint8_t i = 0; i < N_RESET_UIDS; i++) {
+            n_refs += logger_state->has_time_reference(i) ? 1 : 0;
         }
-        sort(sorted_keys.begin(), sorted_keys.end());
 
-        state.push_back((uint8_t)logger_state->log_time_references.size());
-        for (auto it : sorted_keys) {
-            logger_state->log_time_references.at(it).serialize(state);
+        state.push_back(n_refs);
+        for (uint8_t i = 0; i < N_RESET_UIDS; i++) {
+            if (logger_state->has_time_reference(i)) {
+                logger_state->log_time_references[i].serialize(state);
+            }
         }
     }
 
     {
-        vector<uint8_t> sorted_keys;
         unordered_set<MblMwDataLogger*> unique_loggers;
         for (auto it : logger_state->data_loggers) {
-            sorted_keys.push_back(it.first);
-            unique_loggers.insert(it.second);
+            if (it != nullptr) {
+                unique_loggers.insert(it);
+            }
         }
-        sort(sorted_keys.begin(), sorted_keys.end());
 
         state.push_back((uint8_t) unique_loggers.size());
         unique_loggers.clear();
-        for (auto it : sorted_keys) {
-            auto current = logger_state->data_loggers.at(it);
-            if (!unique_loggers.count(current)) {
+        for (auto current : logger_state->data_loggers) {
+            if (current != nullptr && !unique_loggers.count(current)) {
                 unique_loggers.insert(current);
                 current->serialize(state);
             }
@@ -924,7 +1144,9 @@ void deserialize_logging(MblMwMetaWearBoard* board, uint8_t format, uint8_t** st
     (*state_stream)++;
     for (uint8_t i = 0; i < n_refs; i++) {
         TimeReference reference(state_stream, format);
-        saved_log_state->log_time_references.emplace(reference.reset_uid, reference);
+        if (reference.reset_uid < N_RESET_UIDS) {
+            saved_log_state->set_time_reference(reference.reset_uid, reference.epoch);
+        }
     }
 
     uint8_t n_loggers = **state_stream;
@@ -933,14 +1155,15 @@ void deserialize_logging(MblMwMetaWearBoard* board, uint8_t format, uint8_t** st
         MblMwDataLogger* saved_loggable = new MblMwDataLogger(state_stream, format, board);
 
         for (auto it : saved_loggable->entry_ids) {
-            saved_log_state->data_loggers[it] = saved_loggable;
+            saved_log_state->data_loggers[it & ENTRY_ID_MASK] = saved_loggable;
         }
     }
 }
 
 // Helper function - calc epoch
 int64_t calculate_epoch(const MblMwMetaWearBoard* board, uint32_t tick) {
-    return calculate_epoch_inner(GET_LOGGER_STATE(board), tick, mbl_mw_logger_lookup_reset_uid(board, GET_LOGGER_STATE(board)->latest_reset_uid));
+    auto state = static_cast<LoggerState*>(board->logger_state.get());
+    return calculate_epoch_inner(state, tick, mbl_mw_logger_lookup_reset_uid(state, state->latest_reset_uid & RESET_UID_MASK));
 }
 
 // Helper function - query loggers
@@ -948,16 +1171,30 @@ void query_active_loggers(MblMwMetaWearBoard* board) {
     auto state= GET_LOGGER_STATE(board);
     state->clear_data_loggers();
     state->anonymous_signals.clear();
-    state->queryLogId = 0;
 
     state->pending_fns.push([=](void) -> void {
-        state->timeout= ThreadPool::schedule([state, board](void) -> void {            
-            board->anon_signals_created(board->anon_signals_context, board, nullptr, MBL_MW_STATUS_ERROR_TIMEOUT);
-            state->create_next(true);
-        }, board->time_per_response);
-
-        uint8_t command[3]= {MBL_MW_MODULE_LOGGING, READ_REGISTER(ORDINAL(LoggingRegister::TRIGGER)), state->queryLogId};
-        SEND_COMMAND;
+        {
+            lock_guard<recursive_mutex> lock(state->query_lock);
+            for(auto& it: state->logger_configs) {
+                it.active = false;
+            }
+            state->synced_processors.clear();
+            state->requested_processors.clear();
+            state->candidate_sources.clear();
+            state->pending_log_reads = queue<uint8_t>();
+            state->queued_processor_reads = queue<uint8_t>();
+            state->n_pending_processor_reads = 0;
+            state->next_log_query = 0;
+            state->n_log_queries = max<uint8_t>(1, min<uint8_t>(N_ENTRY_IDS, board->module_info.at(MBL_MW_MODULE_LOGGING).extra[0]));
+            state->querying = true;
+
+            set_processor_config_handler(board, logging_processor_config_received);
+            if (!send_pending_queries(board)) {
+                schedule_query_timeout(board, true);
+                return;
+            }
+        }
+        active_loggers_restored(board);
     });
     state->create_next(false);
 }
@@ -985,19 +1222,15 @@ void mbl_mw_logging_set_latest_reset_uid(const MblMwMetaWearBoard* board, uint8_
 // Get ref time
 int64_t mbl_mw_logging_get_reference_time(const MblMwMetaWearBoard *board, uint8_t reset_uid) {
     auto logger_state = GET_LOGGER_STATE(board);
-    if (logger_state->log_time_references.count(reset_uid)) {
-        return logger_state->log_time_references.at(reset_uid).epoch;
+    if (reset_uid < N_RESET_UIDS && logger_state->has_time_reference(reset_uid)) {
+        return logger_state->log_time_references[reset_uid].epoch;
     }
     return -1;
 }
 
 // Set ref time
 void mbl_mw_logging_set_reference_time(const MblMwMetaWearBoard *board, uint8_t reset_uid, int64_t reference_epoch) {
-    auto logger_state = GET_LOGGER_STATE(board);
-    if (logger_state->log_time_references.count(reset_uid)) {
-        logger_state->log_time_references.at(reset_uid).epoch = reference_epoch;
-    } else {
-        logger_state->log_time_references.emplace(piecewise_construct, forward_as_tuple(reset_uid), 
-        forward_as_tuple(reference_epoch, reset_uid));
+    if (reset_uid < N_RESET_UIDS) {
+        GET_LOGGER_STATE(board)->set_time_reference(reset_uid, reference_epoch);
     }
 }
@@ -9,6 +9,7 @@ extern const double TICK_TIME_STEP;
 
 void init_logging(MblMwMetaWearBoard *board);
 void tear_down_logging(void *state, bool preserve_memory);
+uint32_t count_logger_entries(const void *state);
 void serialize_logging(const MblMwMetaWearBoard* board, std::vector<uint8_t>& state);
 void deserialize_logging(MblMwMetaWearBoard* board, uint8_t format, uint8_t** state_stream);
 void disconnect_logging(MblMwMetaWearBoard* board);
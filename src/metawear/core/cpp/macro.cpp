@@ -7,21 +7,48 @@
 #include "metawear/core/macro.h"
 #include "metawear/core/module.h"
 #include "metawear/core/status.h"
-#include "metawear/platform/cpp/threadpool.h"
 
+#include <chrono>
 #include <stdint.h>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+using namespace std::chrono;
 using std::forward_as_tuple;
 using std::make_shared;
+using std::next;
 using std::piecewise_construct;
+using std::shared_ptr;
 using std::static_pointer_cast;
+using std::unordered_map;
+using std::unordered_set;
 using std::vector;
 
 #define GET_MACRO_STATE(board) static_pointer_cast<MacroState>(board->macro_state)
 
-const size_t PARTIAL_LENGTH = 2;
-const ResponseHeader MACRO_BEGIN(MBL_MW_MODULE_MACRO, ORDINAL(MacroRegister::BEGIN));
+const size_t PARTIAL_LENGTH = 2, MACRO_ADD_HEADER_LENGTH = 2;
+const ResponseHeader MACRO_BEGIN(MBL_MW_MODULE_MACRO, ORDINAL(MacroRegister::BEGIN)),
+        MACRO_INFO(MBL_MW_MODULE_MACRO, READ_REGISTER(0x0));
+
+struct MacroCommand {
+    vector<uint8_t> bytes;
+    bool config;
+};
+
+struct MblMwMacroBuilder {
+    MblMwMacroBuilder(MblMwMetaWearBoard *board, uint8_t exec_on_boot);
+
+    MblMwMetaWearBoard *board;
+    vector<MacroCommand> commands;
+    vector<vector<uint8_t>> packets;
+    MblMwMacroUploadResult result;
+    shared_ptr<Task> timeout;
+    steady_clock::time_point upload_start;
+    void *uploaded_context;
+    MblMwFnMacroUploaded uploaded;
+    uint8_t exec_on_boot;
+};
 
 struct MacroState {
     MacroState();
@@ -29,22 +56,121 @@ struct MacroState {
     MblMwFnBoardPtrInt commands_recorded;
     void *commands_recorded_context;
     vector<vector<uint8_t>> commands;
+    MblMwMacroBuilder *builder, *uploading;
     bool is_recording;
     uint8_t exec_on_boot;
 };
 
-MacroState::MacroState() : is_recording(false) { }
+MacroState::MacroState() : builder(nullptr), uploading(nullptr), is_recording(false) { }
+
+MblMwMacroBuilder::MblMwMacroBuilder(MblMwMetaWearBoard *board, uint8_t exec_on_boot) : board(board), result(), uploaded_context(nullptr), 
+        uploaded(nullptr), exec_on_boot(exec_on_boot == 0 ? 0 : 1) { }
+
+// Helper function - wraps a command in the macro packets that store it
+static void encode_macro_command(vector<vector<uint8_t>>& packets, const uint8_t* command, uint8_t len) {
+    if (len >= MW_CMD_MAX_LENGTH) {
+        vector<uint8_t> macro_cmd = { MBL_MW_MODULE_MACRO, ORDINAL(MacroRegister::ADD_PARTIAL) };
+        macro_cmd.insert(macro_cmd.end(), command, command + PARTIAL_LENGTH);
+        packets.push_back(macro_cmd);
+
+        macro_cmd = { MBL_MW_MODULE_MACRO, ORDINAL(MacroRegister::ADD_COMMAND) };
+        macro_cmd.insert(macro_cmd.end(), command + PARTIAL_LENGTH, command + (len - PARTIAL_LENGTH));
+        packets.push_back(macro_cmd);
+    } else {
+        vector<uint8_t> macro_cmd = { MBL_MW_MODULE_MACRO, ORDINAL(MacroRegister::ADD_COMMAND) };
+        macro_cmd.insert(macro_cmd.end(), command, command + len);
+        packets.push_back(macro_cmd);
+    }
+}
+
+// Helper function - drop config writes that are overwritten before anything reads them, or that rewrite the current value
+static vector<const MacroCommand*> compile_macro(const MblMwMacroBuilder* builder) {
+    vector<bool> keep(builder->commands.size(), true);
+
+    // a config write is dead if the same register is written again before any other command of that module runs
+    unordered_set<uint16_t> overwritten;
+    for(size_t i = builder->commands.size(); i > 0; i--) {
+        const auto& it = builder->commands[i - 1];
+        uint16_t key = (it.bytes[0] << 8) | it.bytes[1];
+
+        if (!it.config) {
+            for(auto key_it = overwritten.begin(); key_it != overwritten.end();) {
+                key_it = (*key_it >> 8) == it.bytes[0] ? overwritten.erase(key_it) : next(key_it);
+            }
+        } else if (!overwritten.insert(key).second) {
+            keep[i - 1] = false;
+        }
+    }
+
+    vector<const MacroCommand*> compiled;
+    unordered_map<uint16_t, vector<uint8_t>> written;
+    for(size_t i = 0; i < builder->commands.size(); i++) {
+        const auto& it = builder->commands[i];
+        if (!keep[i]) {
+            continue;
+        }
+
+        if (it.config) {
+            auto& value = written[(it.bytes[0] << 8) | it.bytes[1]];
+            if (value == it.bytes) {
+                continue;
+            }
+            value = it.bytes;
+        } else if (it.bytes[0] == MBL_MW_MODULE_DEBUG) {
+            // resets put every register back to its default
+            written.clear();
+        }
+        compiled.push_back(&it);
+    }
+    return compiled;
+}
+
+// Helper function - bytes the add registers store for the encoded packets
+static uint32_t estimate_macro_size(const vector<vector<uint8_t>>& packets) {
+    uint32_t size = 0;
+    for(const auto& it: packets) {
+        size += (uint32_t) (it.size() - MACRO_ADD_HEADER_LENGTH);
+    }
+    return size;
+}
+
+// Helper function - predicted flash use of the compiled commands
+static uint32_t estimate_macro_size(const vector<const MacroCommand*>& compiled) {
+    vector<vector<uint8_t>> packets;
+    for(auto it: compiled) {
+        encode_macro_command(packets, it->bytes.data(), (uint8_t) it->bytes.size());
+    }
+    return estimate_macro_size(packets);
+}
+
+// Helper function - fill in the packets and summary for the upload
+static void prepare_upload(MblMwMacroBuilder* builder) {
+    auto compiled = compile_macro(builder);
+
+    builder->packets.clear();
+    for(auto it: compiled) {
+        encode_macro_command(builder->packets, it->bytes.data(), (uint8_t) it->bytes.size());
+    }
+
+    builder->result = MblMwMacroUploadResult();
+    builder->result.n_commands = (uint32_t) compiled.size();
+    builder->result.n_dropped = (uint32_t) (builder->commands.size() - compiled.size());
+    builder->result.size = estimate_macro_size(builder->packets);
+}
 
 // Helper function - macro add
 static int32_t macro_add_cmd_response(MblMwMetaWearBoard *board, const uint8_t *response, uint8_t len) {
     auto state = GET_MACRO_STATE(board);
 
-    for(auto it: state->commands) {
-        send_command(board, it.data(), it.size());
-    }
+    {
+        WriteBatch batch(board);
+        for(auto it: state->commands) {
+            send_command(board, it.data(), it.size());
+        }
 
-    uint8_t end_cmd[2] = {MBL_MW_MODULE_MACRO, ORDINAL(MacroRegister::END)};
-    send_command(board, end_cmd, sizeof(end_cmd));
+        uint8_t end_cmd[2] = {MBL_MW_MODULE_MACRO, ORDINAL(MacroRegister::END)};
+        send_command(board, end_cmd, sizeof(end_cmd));
+    }
 
     state->commands_recorded(state->commands_recorded_context, board, response[2]);
 
@@ -59,6 +185,68 @@ static int32_t macro_add_cmd_response_raw(MblMwMetaWearBoard *board, const uint8
     return MBL_MW_STATUS_OK;
 }
 
+// Helper function - stops tracking the upload, begin replies go back to the handler for mbl_mw_macro_end_record
+static void end_upload(MblMwMetaWearBoard *board) {
+    auto state = GET_MACRO_STATE(board);
+    state->uploading = nullptr;
+    board->responses[MACRO_BEGIN] = macro_add_cmd_response;
+}
+
+// Helper function - end the upload and report the result
+static void complete_upload(MblMwMetaWearBoard *board, MblMwMacroBuilder* builder, int32_t status) {
+    end_upload(board);
+
+    builder->result.upload_time_ms = (uint32_t) duration_cast<milliseconds>(steady_clock::now() - builder->upload_start).count();
+    builder->uploaded(builder->uploaded_context, board, &builder->result, status);
+}
+
+// Helper function - the board answers reads in order, so the info reply means the end command was processed
+static int32_t macro_builder_info_response(MblMwMetaWearBoard *board, const uint8_t *response, uint8_t len) {
+    auto state = GET_MACRO_STATE(board);
+    auto builder = state->uploading;
+    board->responses.erase(MACRO_INFO);
+    if (builder == nullptr) {
+        // late reply to an upload that already timed out
+        return MBL_MW_STATUS_OK;
+    }
+    response_received(builder->timeout);
+
+    complete_upload(board, builder, MBL_MW_STATUS_OK);
+
+    return MBL_MW_STATUS_OK;
+}
+
+// Helper function - macro builder id received, the commands can be streamed without waiting on the board
+static int32_t macro_builder_begin_response(MblMwMetaWearBoard *board, const uint8_t *response, uint8_t len) {
+    auto state = GET_MACRO_STATE(board);
+    auto builder = state->uploading;
+    if (builder == nullptr) {
+        return MBL_MW_STATUS_OK;
+    }
+    response_received(builder->timeout);
+    builder->result.id = response[2];
+
+    board->responses[MACRO_INFO] = macro_builder_info_response;
+    builder->timeout = schedule_response_timeout(board, [board, builder](void) -> void {
+        complete_upload(board, builder, MBL_MW_STATUS_ERROR_TIMEOUT);
+    }, 1);
+
+    {
+        WriteBatch batch(board);
+        for(const auto& it: builder->packets) {
+            send_pipelined_command(board, it.data(), (uint8_t) it.size());
+        }
+
+        uint8_t end_cmd[2] = {MBL_MW_MODULE_MACRO, ORDINAL(MacroRegister::END)};
+        send_command(board, end_cmd, sizeof(end_cmd));
+
+        uint8_t info_cmd[2] = {MBL_MW_MODULE_MACRO, READ_REGISTER(0x0)};
+        send_command(board, info_cmd, sizeof(info_cmd));
+    }
+
+    return MBL_MW_STATUS_OK;
+}
+
 // Helper function - init module
 void init_macro_module(MblMwMetaWearBoard *board) {
     board->responses.emplace(piecewise_construct, forward_as_tuple(MBL_MW_MODULE_MACRO, ORDINAL(MacroRegister::BEGIN)),
@@ -69,6 +257,12 @@ void init_macro_module(MblMwMetaWearBoard *board) {
     }
 }
 
+// Helper function - disconnect
+void disconnect_macro(MblMwMetaWearBoard* board) {
+    // module discovery reads the info register again on the next connection
+    board->responses.erase(MACRO_INFO);
+}
+
 // Helper function - free module
 void free_macro_module(void *state) {
     delete (MacroState*) state;
@@ -100,7 +294,7 @@ void mbl_mw_macro_end_record(MblMwMetaWearBoard *board, void *context, MblMwFnBo
     state->commands_recorded_context = context;
     state->commands_recorded = commands_recorded;
 
-    ThreadPool::schedule([state, board](void) -> void {
+    schedule_task(board, [state, board](void) -> void {
         uint8_t command[3]= {MBL_MW_MODULE_MACRO, ORDINAL(MacroRegister::BEGIN), state->exec_on_boot};
         send_command(board, command, sizeof(command));
     }, 2000);
@@ -119,22 +313,86 @@ void mbl_mw_macro_erase_all(MblMwMetaWearBoard *board) {
 }
 
 // Record macro
+bool is_recording_macro(const MblMwMetaWearBoard *board) {
+    auto state = GET_MACRO_STATE(board);
+    return state != nullptr && state->is_recording;
+}
+
 void record_macro(const MblMwMetaWearBoard *board, const uint8_t* command, uint8_t len) {
     auto state = GET_MACRO_STATE(board);
     if (state != nullptr && state->is_recording) {
-        if (len >= MW_CMD_MAX_LENGTH) {
-            vector<uint8_t> macro_cmd = { MBL_MW_MODULE_MACRO, ORDINAL(MacroRegister::ADD_PARTIAL) };
-            macro_cmd.insert(macro_cmd.end(), command, command + PARTIAL_LENGTH);
-            state->commands.push_back(macro_cmd);
-
-            macro_cmd = { MBL_MW_MODULE_MACRO, ORDINAL(MacroRegister::ADD_COMMAND) };
-            macro_cmd.insert(macro_cmd.end(), command + PARTIAL_LENGTH, command + (len - PARTIAL_LENGTH));
-            state->commands.push_back(macro_cmd);
+        if (state->builder != nullptr) {
+            state->builder->commands.push_back({ vector<uint8_t>(command, command + len), false });
         } else {
-            vector<uint8_t> macro_cmd = { MBL_MW_MODULE_MACRO, ORDINAL(MacroRegister::ADD_COMMAND) };
-            macro_cmd.insert(macro_cmd.end(), command, command + len);
-
-            state->commands.push_back(macro_cmd);
+            encode_macro_command(state->commands, command, len);
         }
     }
 }
+
+void flag_macro_config_command(const MblMwMetaWearBoard *board) {
+    auto state = GET_MACRO_STATE(board);
+    if (state != nullptr && state->builder != nullptr && !state->builder->commands.empty()) {
+        state->builder->commands.back().config = true;
+    }
+}
+
+// Macro builder
+MblMwMacroBuilder* mbl_mw_macro_builder_create(MblMwMetaWearBoard *board, uint8_t exec_on_boot) {
+    return new MblMwMacroBuilder(board, exec_on_boot);
+}
+
+void mbl_mw_macro_builder_record(MblMwMacroBuilder* builder) {
+    auto state = GET_MACRO_STATE(builder->board);
+    state->builder = builder;
+    state->is_recording = true;
+}
+
+void mbl_mw_macro_builder_end_record(MblMwMacroBuilder* builder) {
+    auto state = GET_MACRO_STATE(builder->board);
+    if (state->builder == builder) {
+        state->builder = nullptr;
+        state->is_recording = false;
+    }
+}
+
+void mbl_mw_macro_builder_add_command(MblMwMacroBuilder* builder, const uint8_t* command, uint8_t len) {
+    builder->commands.push_back({ vector<uint8_t>(command, command + len), false });
+}
+
+uint32_t mbl_mw_macro_builder_get_n_commands(const MblMwMacroBuilder* builder) {
+    return (uint32_t) compile_macro(builder).size();
+}
+
+uint32_t mbl_mw_macro_builder_get_size(const MblMwMacroBuilder* builder) {
+    return estimate_macro_size(compile_macro(builder));
+}
+
+void mbl_mw_macro_builder_upload(MblMwMacroBuilder* builder, void *context, MblMwFnMacroUploaded uploaded) {
+    auto board = builder->board;
+    auto state = GET_MACRO_STATE(board);
+
+    prepare_upload(builder);
+    builder->uploaded_context = context;
+    builder->uploaded = uploaded;
+    builder->upload_start = steady_clock::now();
+
+    state->uploading = builder;
+    board->responses[MACRO_BEGIN] = macro_builder_begin_response;
+    builder->timeout = schedule_response_timeout(board, [board, builder](void) -> void {
+        complete_upload(board, builder, MBL_MW_STATUS_ERROR_TIMEOUT);
+    }, 1);
+
+    uint8_t command[3]= {MBL_MW_MODULE_MACRO, ORDINAL(MacroRegister::BEGIN), builder->exec_on_boot};
+    send_command(board, command, sizeof(command));
+}
+
+void mbl_mw_macro_builder_free(MblMwMacroBuilder* builder) {
+    mbl_mw_macro_builder_end_record(builder);
+
+    auto state = GET_MACRO_STATE(builder->board);
+    if (state->uploading == builder) {
+        builder->timeout->cancel();
+        end_upload(builder->board);
+    }
+    delete builder;
+}
@@ -2,4 +2,8 @@
 
 void init_macro_module(MblMwMetaWearBoard *board);
 void free_macro_module(void *state);
+void disconnect_macro(MblMwMetaWearBoard* board);
 void record_macro(const MblMwMetaWearBoard *board, const uint8_t* command, uint8_t len);
+bool is_recording_macro(const MblMwMetaWearBoard *board);
+/** marks the last command collected by a macro builder as a config register write */
+void flag_macro_config_command(const MblMwMetaWearBoard *board);
@@ -1,23 +1,31 @@
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <stdint.h>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "moduleinfo.h"
 #include "responseheader.h"
+#include "rtt_estimator.h"
 #include "version.h"
 
 #include "metawear/core/datasignal_fwd.h"
 #include "metawear/core/event_fwd.h"
+#include "metawear/core/metawearboard.h"
 #include "metawear/core/metawearboard_fwd.h"
 #include "metawear/core/timer_fwd.h"
 #include "metawear/dfu/cpp/dfu_operations.h"
 #include "metawear/platform/btle_connection.h"
+#include "metawear/platform/cpp/executor.h"
 #include "metawear/platform/cpp/task.h"
 
 #define SEND_COMMAND send_command(board, command, sizeof(command))
 #define SEND_COMMAND_BOARD(board) send_command(board, command, sizeof(command))
+#define SEND_CONFIG_COMMAND send_config_command(board, command, sizeof(command))
 
 enum class SerializationFormat : uint8_t {
     INIT = 0,
@@ -29,6 +37,8 @@ typedef int32_t (*ResponseHandler)(MblMwMetaWearBoard *board, const uint8_t*, ui
 /** UUIDs for the MetaWear DFU characteristic */
 const MblMwGattChar DFU_PACKET_CHAR = { 0x000015301212EFDE, 0x1523785FEABCD123, 0x000015321212EFDE, 0x1523785FEABCD123 };
 const MblMwGattChar DFU_CONTROL_POINT_CHAR = { 0x000015301212EFDE, 0x1523785FEABCD123, 0x000015311212EFDE, 0x1523785FEABCD123 };
+/** UUIDs for the MetaWear notify characteristic */
+const MblMwGattChar METAWEAR_SERVICE_NOTIFY_CHAR = { 0x326a900085cb9195, 0xd9dd464cfbbae75a, 0x326a900685cb9195, 0xd9dd464cfbbae75a };
 
 struct MblMwMetaWearBoard {
     MblMwMetaWearBoard();
@@ -38,6 +48,10 @@ struct MblMwMetaWearBoard {
     std::unordered_map<ResponseHeader, ResponseHandler> responses;
     std::unordered_map<uint8_t, ModuleInfo> module_info;
     std::unordered_map<uint8_t, void*> module_config;
+    /** last value written to each config register, keyed by module id and register id */
+    mutable std::unordered_map<uint16_t, std::vector<uint8_t>> config_shadow;
+    /** config registers also written by events or macros, the board can change these without the API knowing */
+    mutable std::unordered_set<uint16_t> unshadowed_config;
 
     std::shared_ptr<void> logger_state, timer_state, event_state, dp_state, macro_state, debug_state;
     MblMwFnBoardPtrInt initialized;
@@ -50,16 +64,62 @@ struct MblMwMetaWearBoard {
     std::string module_number, hardware_revision, serial_number, manufacturer;
     std::unique_ptr<DfuOperations> operations;
     const char* filename;
+    /** strand of the session manager the board was added to, null if it has not been added to one */
+    std::shared_ptr<Executor> executor;
+    /** held while the API works on the board, null unless serialization is enabled */
+    std::shared_ptr<std::recursive_mutex> serial_lock;
 
+    MblMwConfigWriteMode config_write_mode;
     int64_t time_per_response;
+    /** shortest response timeout when sizing them from measured round trip times, 0 to use time_per_response */
+    int64_t min_time_per_response;
+    std::shared_ptr<RttEstimator> rtt;
+    uint16_t mtu;
+    MblMwFnWriteGattChars write_gatt_chars;
+    void (*dfu_transfer_rate)(void *context, float bytes_per_second);
     int8_t module_discovery_index, dev_info_index;
 
-    inline void write_gatt_char(const MblMwGattChar* gatt_char, MblMwGattCharWriteType type, const uint8_t* value, uint8_t len) const {
-        btle_conn.write_gatt_char(btle_conn.context, this, type, gatt_char, value, len);
-    }
+    /** writes the value, or queues it if the calling thread has a WriteBatch open for this board */
+    void write_gatt_char(const MblMwGattChar* gatt_char, MblMwGattCharWriteType type, const uint8_t* value, uint8_t len) const;
 };
 
+/**
+ * Queues the board's writes while in scope and hands them to the connection together when the outermost batch ends, 
+ * through write_gatt_chars if one was set.  Only wrap code that does not wait on the board's responses.  
+ * Batches belong to the thread that opened them; writes to the same board from other threads are not held back.
+ */
+class WriteBatch {
+    const MblMwMetaWearBoard* board;
+public:
+    explicit WriteBatch(const MblMwMetaWearBoard* board);
+    ~WriteBatch();
+};
+
+/** locks the board's serial lock, the returned lock does not own anything if serialization is disabled */
+std::unique_lock<std::recursive_mutex> lock_board(const MblMwMetaWearBoard* board);
+/** wraps fn so it holds the board's serial lock while running, fn is returned as is if serialization is disabled */
+std::function<void(void)> serialize(const MblMwMetaWearBoard* board, std::function<void(void)> fn);
+/** how long to wait for one response, in ms */
+int64_t response_time(const MblMwMetaWearBoard* board);
+/** 
+ * runs fn if n_responses responses do not arrive in time, an expired timeout backs off the board's timeouts.  Cancel it 
+ * with response_received when the responses arrive, and cancel the task directly for any other reason.
+ */
+std::shared_ptr<Task> schedule_response_timeout(const MblMwMetaWearBoard* board, std::function<void(void)> fn, size_t n_responses);
+/** same as above, pass fresh = false if the commands were sent before this call so the response is not timed from it */
+std::shared_ptr<Task> schedule_response_timeout(const MblMwMetaWearBoard* board, std::function<void(void)> fn, size_t n_responses, bool fresh);
+/** cancels a timeout from schedule_response_timeout because a response arrived, recording how long it took if it was the only one waited on */
+void response_received(const std::shared_ptr<Task>& timeout);
+/** runs fn after delay ms on the board's executor, or on its own thread if the board has no executor */
+std::shared_ptr<Task> schedule_task(const MblMwMetaWearBoard* board, std::function<void(void)> fn, int64_t delay);
+/** same as mbl_mw_metawearboard_handle_notifications with epoch used for notifications that do not have one */
+uint32_t handle_notifications(const MblMwNotification* notifications, uint32_t n_notifications, int64_t epoch);
+
 void send_command(const MblMwMetaWearBoard* board, const uint8_t* command, uint8_t len);
+/** writes the command without waiting for the board to acknowledge it, the command is not recorded */
+void send_pipelined_command(const MblMwMetaWearBoard* board, const uint8_t* command, uint8_t len);
+void send_config_command(const MblMwMetaWearBoard* board, const uint8_t* command, uint8_t len);
+void clear_config_shadow(const MblMwMetaWearBoard* board);
 
 /** only for acc, gyro, and mag streaming */
 int32_t response_handler_packed_data(MblMwMetaWearBoard *board, const uint8_t *response, uint8_t len);
@@ -0,0 +1,136 @@
+#include "metawear/core/poll_scheduler.h"
+
+#include "metawear/core/cpp/metawearboard_def.h"
+#include "metawear/platform/cpp/threadpool.h"
+#include "metawear/platform/cpp/timer_queue.h"
+
+#include <chrono>
+#include <mutex>
+#include <unordered_set>
+
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+using std::function;
+using std::lock_guard;
+using std::make_shared;
+using std::mutex;
+using std::shared_ptr;
+using std::unordered_set;
+
+/**
+ * Executor every board added to the scheduler shares.  Posted functions are queued as timeouts that are already due.
+ */
+class PollExecutor : public Executor {
+public:
+    explicit PollExecutor(MblMwPollScheduler* scheduler);
+    virtual ~PollExecutor();
+
+    virtual void post(function<void(void)> fn);
+    virtual shared_ptr<Task> schedule(function<void(void)> fn, int64_t delay);
+
+private:
+    MblMwPollScheduler* const scheduler;
+};
+
+struct MblMwPollScheduler {
+    void *clock_context;
+    int64_t (*clock)(void *context);
+
+    mutex lock;
+    TimerQueue timers;
+    shared_ptr<PollExecutor> executor;
+    unordered_set<MblMwMetaWearBoard*> boards;
+};
+
+// Helper function - default clock, steady clock time in milliseconds
+static int64_t steady_now(void *context) {
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+PollExecutor::PollExecutor(MblMwPollScheduler* scheduler) : scheduler(scheduler) { }
+
+PollExecutor::~PollExecutor() { }
+
+void PollExecutor::post(function<void(void)> fn) {
+    int64_t now = mbl_mw_poll_scheduler_now(scheduler);
+
+    lock_guard<mutex> lock(scheduler->lock);
+    scheduler->timers.push(nullptr, fn, now);
+}
+
+shared_ptr<Task> PollExecutor::schedule(function<void(void)> fn, int64_t delay) {
+    if (delay == INDEFINITE_TIMEOUT) {
+        return make_shared<TimerEntry>(nullptr, fn);
+    }
+
+    int64_t now = mbl_mw_poll_scheduler_now(scheduler);
+
+    lock_guard<mutex> lock(scheduler->lock);
+    return scheduler->timers.push(nullptr, fn, now + delay);
+}
+
+MblMwPollScheduler* mbl_mw_poll_scheduler_create(void *context, int64_t (*now)(void *context)) {
+    auto scheduler = new MblMwPollScheduler;
+    scheduler->clock_context = context;
+    scheduler->clock = now == nullptr ? steady_now : now;
+    scheduler->executor = make_shared<PollExecutor>(scheduler);
+
+    return scheduler;
+}
+
+int64_t mbl_mw_poll_scheduler_now(const MblMwPollScheduler* scheduler) {
+    return scheduler->clock(scheduler->clock_context);
+}
+
+void mbl_mw_poll_scheduler_add_board(MblMwPollScheduler* scheduler, MblMwMetaWearBoard* board) {
+    lock_guard<mutex> lock(scheduler->lock);
+    scheduler->boards.insert(board);
+    board->executor = scheduler->executor;
+}
+
+void mbl_mw_poll_scheduler_remove_board(MblMwPollScheduler* scheduler, MblMwMetaWearBoard* board) {
+    lock_guard<mutex> lock(scheduler->lock);
+    if (scheduler->boards.erase(board)) {
+        board->executor.reset();
+    }
+}
+
+int64_t mbl_mw_poll_scheduler_next_deadline(MblMwPollScheduler* scheduler) {
+    lock_guard<mutex> lock(scheduler->lock);
+    int64_t deadline;
+    return scheduler->timers.next_deadline(deadline) ? deadline : -1;
+}
+
+uint32_t mbl_mw_poll_scheduler_process_timeouts(MblMwPollScheduler* scheduler, int64_t now) {
+    uint32_t n_run = 0;
+    while(true) {
+        shared_ptr<TimerEntry> next;
+        {
+            lock_guard<mutex> lock(scheduler->lock);
+            next = scheduler->timers.pop_expired(now);
+        }
+        if (next == nullptr) {
+            return n_run;
+        }
+
+        // timeouts can schedule or cancel other timeouts, the lock cannot be held
+        if (!next->cancelled) {
+            TimerEntry::run(next);
+            n_run++;
+        }
+    }
+}
+
+void mbl_mw_poll_scheduler_free(MblMwPollScheduler* scheduler) {
+    int64_t now = mbl_mw_poll_scheduler_now(scheduler);
+    {
+        lock_guard<mutex> lock(scheduler->lock);
+        for(auto it: scheduler->boards) {
+            it->executor.reset();
+        }
+        scheduler->timers.move_to_thread_pool(now);
+    }
+
+    delete scheduler;
+}
@@ -0,0 +1,431 @@
+#include "metawear/core/datasignal.h"
+#include "metawear/core/logging.h"
+#include "metawear/core/recorder.h"
+#include "metawear/core/status.h"
+#include "metawear/dfu/cpp/miniz.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::atomic;
+using std::condition_variable;
+using std::deque;
+using std::lock_guard;
+using std::memory_order_acquire;
+using std::memory_order_release;
+using std::memcpy;
+using std::move;
+using std::mutex;
+using std::thread;
+using std::unique_lock;
+using std::unique_ptr;
+using std::this_thread::yield;
+using std::vector;
+
+const char RECORDING_MAGIC[8]= {'M', 'B', 'L', 'M', 'W', 'R', 'E', 'C'}, INDEX_MAGIC[8]= {'M', 'B', 'L', 'M', 'W', 'I', 'D', 'X'};
+const uint32_t RECORDING_VERSION= 1;
+const int32_t TYPE_UNSET= -1;
+const size_t EPOCH_WIDTH= sizeof(int64_t), COLUMN_ALIGNMENT= 8, N_POOLED_CHUNKS= 4;
+
+struct RecordingHeader {
+    char magic[8];
+    uint32_t version, chunk_rows;
+    int32_t type_id;
+    uint8_t n_columns, column_width;
+    uint16_t flags;
+    uint8_t reserved[40];
+};
+
+struct ChunkIndexEntry {
+    uint64_t offset;
+    uint32_t n_rows, size;
+    int64_t first_epoch, last_epoch;
+};
+
+struct RecordingTrailer {
+    uint64_t index_offset;
+    uint32_t n_chunks, reserved;
+    char magic[8];
+};
+
+static_assert(sizeof(RecordingHeader) == 64, "RecordingHeader must be 64 bytes");
+static_assert(sizeof(ChunkIndexEntry) == 32, "ChunkIndexEntry must be 32 bytes");
+static_assert(sizeof(RecordingTrailer) == 24, "RecordingTrailer must be 24 bytes");
+
+struct RecorderChunk {
+    RecorderChunk(size_t size);
+
+    vector<uint8_t> buffer;
+    uint32_t n_rows;
+    int64_t first_epoch, last_epoch;
+};
+
+struct MblMwRecorder {
+    MblMwRecorder(FILE* file, uint32_t chunk_rows, uint16_t flags);
+    ~MblMwRecorder();
+
+    FILE* file;
+    uint32_t chunk_rows;
+    atomic<uint32_t> dropped;
+    // held while a sample is copied into the current chunk, only flush and close contend with the callback thread
+    atomic<bool> sampling;
+    uint16_t flags;
+    int32_t type_id, status;
+    uint8_t sample_length, n_columns, column_width;
+    size_t column_stride, chunk_size;
+    uint64_t file_offset;
+    bool header_written, writing, stopping;
+
+    // null when every pooled chunk is waiting to be written
+    unique_ptr<RecorderChunk> current;
+    deque<unique_ptr<RecorderChunk>> closed_chunks, free_chunks;
+    vector<ChunkIndexEntry> index;
+    vector<uint8_t> compressed;
+
+    mutex chunks_mutex;
+    condition_variable chunks_cv;
+    thread writer;
+};
+
+/**
+ * Holds the recorder's current chunk while in scope
+ */
+class SamplingGuard {
+    MblMwRecorder* recorder;
+public:
+    explicit SamplingGuard(MblMwRecorder* recorder);
+    ~SamplingGuard();
+};
+
+RecorderChunk::RecorderChunk(size_t size) : buffer(size), n_rows(0), first_epoch(0), last_epoch(0) {
+}
+
+SamplingGuard::SamplingGuard(MblMwRecorder* recorder) : recorder(recorder) {
+    while(recorder->sampling.exchange(true, memory_order_acquire)) {
+        yield();
+    }
+}
+
+SamplingGuard::~SamplingGuard() {
+    recorder->sampling.store(false, memory_order_release);
+}
+
+MblMwRecorder::MblMwRecorder(FILE* file, uint32_t chunk_rows, uint16_t flags) : file(file), chunk_rows(chunk_rows), dropped(0), sampling(false), flags(flags), type_id(TYPE_UNSET),
+        status(MBL_MW_STATUS_OK), sample_length(0), n_columns(0), column_width(0), column_stride(0), chunk_size(0),
+        file_offset(sizeof(RecordingHeader)), header_written(false), writing(false), stopping(false) {
+}
+
+MblMwRecorder::~MblMwRecorder() {
+    if (file != nullptr) {
+        fclose(file);
+    }
+}
+
+// Helper function - width of the value components for a data type
+static uint8_t column_width_for(MblMwDataTypeId type_id) {
+    switch(type_id) {
+    case MBL_MW_DT_ID_UINT32:
+    case MBL_MW_DT_ID_INT32:
+    case MBL_MW_DT_ID_FLOAT:
+    case MBL_MW_DT_ID_CARTESIAN_FLOAT:
+    case MBL_MW_DT_ID_EULER_ANGLE:
+    case MBL_MW_DT_ID_QUATERNION:
+    case MBL_MW_DT_ID_CORRECTED_CARTESIAN_FLOAT:
+        return 4;
+    case MBL_MW_DT_ID_TCS34725_ADC:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+// Helper function - fixes the recording columns to the first sample and preallocates the chunk buffers
+static void init_columns(MblMwRecorder* recorder, const MblMwData* data) {
+    recorder->type_id= data->type_id;
+    recorder->sample_length= data->length;
+    recorder->column_width= column_width_for(data->type_id);
+    recorder->n_columns= data->length / recorder->column_width;
+
+    size_t column_size= recorder->column_width * recorder->chunk_rows;
+    recorder->column_stride= (column_size + COLUMN_ALIGNMENT - 1) & ~(COLUMN_ALIGNMENT - 1);
+    recorder->chunk_size= EPOCH_WIDTH * recorder->chunk_rows + recorder->n_columns * recorder->column_stride;
+
+    recorder->current.reset(new RecorderChunk(recorder->chunk_size));
+
+    lock_guard<mutex> lock(recorder->chunks_mutex);
+    for(size_t i= 1; i < N_POOLED_CHUNKS; i++) {
+        recorder->free_chunks.emplace_back(new RecorderChunk(recorder->chunk_size));
+    }
+}
+
+// Helper function - makes a free chunk the current one, false if the pool is exhausted
+static bool take_free_chunk(MblMwRecorder* recorder) {
+    lock_guard<mutex> lock(recorder->chunks_mutex);
+    if (recorder->free_chunks.empty()) {
+        return false;
+    }
+
+    recorder->current= move(recorder->free_chunks.front());
+    recorder->free_chunks.pop_front();
+    return true;
+}
+
+// Helper function - hands the current chunk to the writer thread and takes a free one, must be called with the sampling guard held
+static void close_chunk(MblMwRecorder* recorder) {
+    lock_guard<mutex> lock(recorder->chunks_mutex);
+    recorder->closed_chunks.push_back(move(recorder->current));
+    if (!recorder->free_chunks.empty()) {
+        recorder->current= move(recorder->free_chunks.front());
+        recorder->free_chunks.pop_front();
+    }
+    recorder->chunks_cv.notify_all();
+}
+
+// Helper function - writes the file header, describing the columns if any sample was recorded
+static bool write_header(MblMwRecorder* recorder) {
+    RecordingHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, RECORDING_MAGIC, sizeof(header.magic));
+    header.version= RECORDING_VERSION;
+    header.chunk_rows= recorder->chunk_rows;
+    header.type_id= recorder->type_id;
+    header.n_columns= recorder->n_columns;
+    header.column_width= recorder->column_width;
+    header.flags= recorder->flags;
+
+    recorder->header_written= true;
+    return fseek(recorder->file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, recorder->file) == 1;
+}
+
+// Helper function - replaces each row after the first with the wrapping difference from the previous row
+template <class T>
+static void delta_encode(uint8_t* column, uint32_t n_rows) {
+    T previous, current;
+    memcpy(&previous, column, sizeof(T));
+    for(uint32_t i= 1; i < n_rows; i++) {
+        uint8_t* row= column + i * sizeof(T);
+        memcpy(&current, row, sizeof(T));
+
+        T delta= static_cast<T>(current - previous);
+        memcpy(row, &delta, sizeof(T));
+        previous= current;
+    }
+}
+
+// Helper function - zero fills unused rows and applies the delta encoding flag to a closed chunk
+static void encode_chunk(MblMwRecorder* recorder, RecorderChunk* chunk) {
+    uint8_t* base= chunk->buffer.data();
+    uint32_t unused= recorder->chunk_rows - chunk->n_rows;
+    if (unused != 0) {
+        memset(base + chunk->n_rows * EPOCH_WIDTH, 0, unused * EPOCH_WIDTH);
+        for(uint8_t i= 0; i < recorder->n_columns; i++) {
+            memset(base + recorder->chunk_rows * EPOCH_WIDTH + i * recorder->column_stride + chunk->n_rows * recorder->column_width, 0, 
+                    unused * recorder->column_width);
+        }
+    }
+
+    if (!(recorder->flags & MBL_MW_RECORDER_FLAG_DELTA_ENCODE) || chunk->n_rows == 0) {
+        return;
+    }
+
+    delta_encode<uint64_t>(base, chunk->n_rows);
+    switch(recorder->type_id) {
+    case MBL_MW_DT_ID_UINT32:
+    case MBL_MW_DT_ID_INT32:
+        delta_encode<uint32_t>(base + recorder->chunk_rows * EPOCH_WIDTH, chunk->n_rows);
+        break;
+    case MBL_MW_DT_ID_TCS34725_ADC:
+        for(uint8_t i= 0; i < recorder->n_columns; i++) {
+            delta_encode<uint16_t>(base + recorder->chunk_rows * EPOCH_WIDTH + i * recorder->column_stride, chunk->n_rows);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+// Helper function - appends a closed chunk to the file and records its index entry
+static bool write_chunk(MblMwRecorder* recorder, RecorderChunk* chunk) {
+    if (!recorder->header_written && !write_header(recorder)) {
+        return false;
+    }
+
+    encode_chunk(recorder, chunk);
+
+    const uint8_t* contents= chunk->buffer.data();
+    mz_ulong size= static_cast<mz_ulong>(chunk->buffer.size());
+    if (recorder->flags & MBL_MW_RECORDER_FLAG_COMPRESS) {
+        mz_ulong compressed_size= mz_compressBound(size);
+        recorder->compressed.resize(compressed_size);
+        if (mz_compress2(recorder->compressed.data(), &compressed_size, contents, size, MZ_DEFAULT_COMPRESSION) != MZ_OK) {
+            return false;
+        }
+
+        contents= recorder->compressed.data();
+        size= compressed_size;
+    }
+    if (fwrite(contents, size, 1, recorder->file) != 1) {
+        return false;
+    }
+
+    recorder->index.push_back({recorder->file_offset, chunk->n_rows, static_cast<uint32_t>(size), chunk->first_epoch, chunk->last_epoch});
+    recorder->file_offset+= size;
+    return true;
+}
+
+// Helper function - background thread body, drains closed chunks until the recorder is closed
+static void write_closed_chunks(MblMwRecorder* recorder) {
+    unique_lock<mutex> lock(recorder->chunks_mutex);
+    while(true) {
+        recorder->chunks_cv.wait(lock, [recorder]() -> bool { return recorder->stopping || !recorder->closed_chunks.empty(); });
+        if (recorder->closed_chunks.empty()) {
+            break;
+        }
+
+        auto chunk= move(recorder->closed_chunks.front());
+        recorder->closed_chunks.pop_front();
+        recorder->writing= true;
+
+        lock.unlock();
+        bool written= write_chunk(recorder, chunk.get());
+        lock.lock();
+
+        if (!written) {
+            recorder->status= MBL_MW_STATUS_ERROR_IO;
+        }
+        chunk->n_rows= 0;
+        recorder->free_chunks.push_back(move(chunk));
+        recorder->writing= false;
+        recorder->chunks_cv.notify_all();
+    }
+}
+
+MblMwRecorder* mbl_mw_recorder_create(const char* filename, uint32_t chunk_rows) {
+    return mbl_mw_recorder_create_with_flags(filename, chunk_rows, 0);
+}
+
+MblMwRecorder* mbl_mw_recorder_create_with_flags(const char* filename, uint32_t chunk_rows, uint16_t flags) {
+    if (chunk_rows == 0) {
+        return nullptr;
+    }
+
+    FILE* file= fopen(filename, "wb");
+    if (file == nullptr) {
+        return nullptr;
+    }
+
+    MblMwRecorder* recorder= new MblMwRecorder(file, chunk_rows, flags);
+    recorder->writer= thread(write_closed_chunks, recorder);
+    return recorder;
+}
+
+void mbl_mw_recorder_write(void* context, const MblMwData* data) {
+    auto recorder= static_cast<MblMwRecorder*>(context);
+    SamplingGuard sampling(recorder);
+
+    if (recorder->type_id == TYPE_UNSET) {
+        // values are pointers to other samples, nothing fixed width to record
+        if (data->type_id == MBL_MW_DT_ID_DATA_ARRAY) {
+            recorder->dropped++;
+            return;
+        }
+        init_columns(recorder, data);
+    } else if (data->type_id != recorder->type_id || data->length != recorder->sample_length) {
+        recorder->dropped++;
+        return;
+    }
+    // the writer thread fell behind, samples are dropped rather than allocating more chunks
+    if (recorder->current == nullptr && !take_free_chunk(recorder)) {
+        recorder->dropped++;
+        return;
+    }
+
+    auto chunk= recorder->current.get();
+    uint8_t* base= chunk->buffer.data();
+    memcpy(base + chunk->n_rows * EPOCH_WIDTH, &data->epoch, EPOCH_WIDTH);
+
+    const uint8_t* values= static_cast<const uint8_t*>(data->value);
+    uint8_t* column= base + recorder->chunk_rows * EPOCH_WIDTH + chunk->n_rows * recorder->column_width;
+    for(uint8_t i= 0; i < recorder->n_columns; i++, column+= recorder->column_stride, values+= recorder->column_width) {
+        memcpy(column, values, recorder->column_width);
+    }
+
+    if (chunk->n_rows == 0) {
+        chunk->first_epoch= data->epoch;
+    }
+    chunk->last_epoch= data->epoch;
+    chunk->n_rows++;
+
+    if (chunk->n_rows == recorder->chunk_rows) {
+        close_chunk(recorder);
+    }
+}
+
+void mbl_mw_datasignal_record(MblMwDataSignal* signal, MblMwRecorder* recorder) {
+    mbl_mw_datasignal_subscribe(signal, recorder, mbl_mw_recorder_write);
+}
+
+void mbl_mw_logger_record(MblMwDataLogger* logger, MblMwRecorder* recorder) {
+    mbl_mw_logger_subscribe(logger, recorder, mbl_mw_recorder_write);
+}
+
+uint32_t mbl_mw_recorder_get_dropped(const MblMwRecorder* recorder) {
+    return recorder->dropped;
+}
+
+int32_t mbl_mw_recorder_flush(MblMwRecorder* recorder) {
+    {
+        SamplingGuard sampling(recorder);
+        if (recorder->current != nullptr && recorder->current->n_rows != 0) {
+            close_chunk(recorder);
+        }
+    }
+
+    unique_lock<mutex> lock(recorder->chunks_mutex);
+    recorder->chunks_cv.wait(lock, [recorder]() -> bool { return recorder->closed_chunks.empty() && !recorder->writing; });
+
+    if (fflush(recorder->file) != 0) {
+        recorder->status= MBL_MW_STATUS_ERROR_IO;
+    }
+    return recorder->status;
+}
+
+int32_t mbl_mw_recorder_close(MblMwRecorder* recorder) {
+    {
+        SamplingGuard sampling(recorder);
+        if (recorder->current != nullptr && recorder->current->n_rows != 0) {
+            close_chunk(recorder);
+        }
+    }
+    {
+        lock_guard<mutex> lock(recorder->chunks_mutex);
+        recorder->stopping= true;
+        recorder->chunks_cv.notify_all();
+    }
+    recorder->writer.join();
+
+    bool written= recorder->header_written || write_header(recorder);
+    if (written) {
+        RecordingTrailer trailer;
+        memset(&trailer, 0, sizeof(trailer));
+        trailer.index_offset= recorder->file_offset;
+        trailer.n_chunks= static_cast<uint32_t>(recorder->index.size());
+        memcpy(trailer.magic, INDEX_MAGIC, sizeof(trailer.magic));
+
+        written= (recorder->index.empty() || fwrite(recorder->index.data(), sizeof(ChunkIndexEntry), recorder->index.size(), recorder->file) == recorder->index.size()) &&
+                fwrite(&trailer, sizeof(trailer), 1, recorder->file) == 1;
+    }
+    written= fclose(recorder->file) == 0 && written;
+    recorder->file= nullptr;
+
+    int32_t status= written ? recorder->status : MBL_MW_STATUS_ERROR_IO;
+    delete recorder;
+    return status;
+}
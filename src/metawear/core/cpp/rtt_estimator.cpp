@@ -0,0 +1,43 @@
+#include "rtt_estimator.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+using std::lock_guard;
+using std::max;
+using std::min;
+using std::mutex;
+
+/** estimates are in microseconds, the smallest variation term is one millisecond */
+const int64_t CLOCK_GRANULARITY= 1000;
+const uint8_t MAX_BACKOFFS= 6;
+
+RttEstimator::RttEstimator() : measured(false), srtt(0), rttvar(0), n_backoffs(0) { }
+
+void RttEstimator::add_sample(int64_t rtt) {
+    lock_guard<mutex> lock(this->lock);
+    if (measured) {
+        // rttvar is updated first, with the srtt the sample is compared against
+        rttvar = (3 * rttvar + std::llabs(srtt - rtt)) / 4;
+        srtt = (7 * srtt + rtt) / 8;
+    } else {
+        srtt = rtt;
+        rttvar = rtt / 2;
+        measured = true;
+    }
+    n_backoffs = 0;
+}
+
+void RttEstimator::back_off() {
+    lock_guard<mutex> lock(this->lock);
+    if (n_backoffs < MAX_BACKOFFS) {
+        n_backoffs++;
+    }
+}
+
+int64_t RttEstimator::timeout(int64_t fallback, int64_t min_timeout, int64_t max_timeout) const {
+    lock_guard<mutex> lock(this->lock);
+    int64_t timeout = measured ? (srtt + max(CLOCK_GRANULARITY, 4 * rttvar) + 999) / 1000 : fallback;
+    timeout = max(timeout, min_timeout) << n_backoffs;
+    return min(timeout, max_timeout);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <mutex>
+#include <stdint.h>
+
+/**
+ * Tracks a connection's smoothed round trip time and its variation the way TCP does (RFC 6298).  Response timeouts are 
+ * sized from the estimate, and are doubled each time one expires until the next response is measured.
+ */
+class RttEstimator {
+public:
+    RttEstimator();
+
+    /** adds the time, in microseconds, one response took to arrive */
+    void add_sample(int64_t rtt);
+    /** a response did not arrive in time, the next timeouts wait twice as long */
+    void back_off();
+    /** 
+     * time to wait for one response in ms, the smoothed round trip time plus four times its variation, between min and 
+     * max.  fallback is used instead of the estimate until a response has been measured.
+     */
+    int64_t timeout(int64_t fallback, int64_t min, int64_t max) const;
+
+private:
+    mutable std::mutex lock;
+    bool measured;
+    int64_t srtt, rttvar;
+    uint8_t n_backoffs;
+};
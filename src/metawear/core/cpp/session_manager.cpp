@@ -0,0 +1,411 @@
+#include "metawear/core/session_manager.h"
+
+#include "metawear/core/cpp/metawearboard_def.h"
+#include "metawear/platform/cpp/threadpool.h"
+#include "metawear/platform/cpp/timer_queue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using std::atomic;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+using std::chrono::system_clock;
+using std::condition_variable;
+using std::deque;
+using std::enable_shared_from_this;
+using std::function;
+using std::lock_guard;
+using std::make_shared;
+using std::min_element;
+using std::mutex;
+using std::queue;
+using std::shared_ptr;
+using std::thread;
+using std::unique_lock;
+using std::unique_ptr;
+using std::unordered_map;
+using std::vector;
+
+/** functions a strand runs before going to the back of its worker's queue, keeps one busy board from starving the rest */
+const size_t STRAND_BATCH_SIZE= 32;
+
+class Strand;
+
+/** work queued on a worker, either a strand with pending functions or a submitted function */
+struct Runnable {
+    shared_ptr<Strand> strand;
+    function<void(void)> fn;
+};
+
+struct Worker {
+    mutex lock;
+    deque<Runnable> runnables;
+    thread th;
+    uint32_t n_boards;
+};
+
+/**
+ * Serializes one board's work.  A strand is queued on at most one worker at a time, and only while it has functions
+ * to run, so a board never runs on two workers at once.
+ */
+class Strand : public Executor, public enable_shared_from_this<Strand> {
+public:
+    Strand(MblMwSessionManager* manager, size_t worker);
+    virtual ~Strand();
+
+    virtual void post(function<void(void)> fn);
+    virtual shared_ptr<Task> schedule(function<void(void)> fn, int64_t delay);
+
+    /** runs up to STRAND_BATCH_SIZE functions, returns true if there are more to run */
+    bool run();
+    /** blocks until the strand has no functions left to run */
+    void wait_idle();
+
+    MblMwSessionManager* const manager;
+    const size_t worker;
+
+private:
+    mutex lock;
+    condition_variable idle;
+    queue<function<void(void)>> fns;
+    bool queued;
+};
+
+struct MblMwSessionManager {
+    vector<unique_ptr<Worker>> workers;
+    atomic<uint32_t> next_submit;
+
+    // sleeping workers wait for n_runnables to be non-zero
+    mutex sleep_lock;
+    condition_variable work_ready;
+    atomic<size_t> n_runnables;
+    bool stopping;
+
+    // one thread for every board's timeouts, deadlines are on the steady clock
+    mutex timer_lock;
+    condition_variable timers_changed;
+    TimerQueue timers;
+    bool timers_stopping;
+    thread timer_thread;
+
+    mutex boards_lock;
+    unordered_map<MblMwMetaWearBoard*, shared_ptr<Strand>> strands;
+};
+
+static thread_local const MblMwSessionManager* current_manager= nullptr;
+static thread_local size_t current_worker= 0;
+static thread_local const Strand* current_strand= nullptr;
+
+// Helper function - queues the runnable on a worker and wakes a sleeping one
+static void enqueue(MblMwSessionManager* manager, size_t worker, Runnable runnable) {
+    {
+        lock_guard<mutex> lock(manager->workers[worker]->lock);
+        manager->workers[worker]->runnables.push_back(std::move(runnable));
+    }
+    manager->n_runnables++;
+
+    // taking the lock orders this with a worker checking n_runnables before it sleeps
+    {
+        lock_guard<mutex> lock(manager->sleep_lock);
+    }
+    manager->work_ready.notify_one();
+}
+
+// Helper function - takes the next runnable from the worker's own queue, or steals the oldest from another worker
+static bool take(MblMwSessionManager* manager, size_t worker, Runnable& runnable) {
+    size_t n_workers = manager->workers.size();
+    for(size_t i = 0; i < n_workers; i++) {
+        auto& it = manager->workers[(worker + i) % n_workers];
+        lock_guard<mutex> lock(it->lock);
+        if (!it->runnables.empty()) {
+            if (i == 0) {
+                runnable = std::move(it->runnables.front());
+                it->runnables.pop_front();
+            } else {
+                runnable = std::move(it->runnables.back());
+                it->runnables.pop_back();
+            }
+            manager->n_runnables--;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Helper function - worker thread loop, exits once the manager is stopping and every queue is empty
+static void run_worker(MblMwSessionManager* manager, size_t worker) {
+    current_manager = manager;
+    current_worker = worker;
+
+    Runnable runnable;
+    while(true) {
+        if (take(manager, worker, runnable)) {
+            if (runnable.strand) {
+                current_strand = runnable.strand.get();
+                if (runnable.strand->run()) {
+                    enqueue(manager, worker, std::move(runnable));
+                }
+                current_strand = nullptr;
+            } else {
+                runnable.fn();
+            }
+            runnable = Runnable();
+            continue;
+        }
+
+        unique_lock<mutex> lock(manager->sleep_lock);
+        manager->work_ready.wait(lock, [manager]() { return manager->stopping || manager->n_runnables > 0; });
+        if (manager->n_runnables == 0) {
+            break;
+        }
+    }
+}
+
+// Helper function - current steady clock time in milliseconds
+static int64_t steady_now() {
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Helper function - timer thread loop, posts expired timeouts to their strands
+static void run_timers(MblMwSessionManager* manager) {
+    unique_lock<mutex> lock(manager->timer_lock);
+    while(!manager->timers_stopping) {
+        int64_t deadline;
+        if (!manager->timers.next_deadline(deadline)) {
+            manager->timers_changed.wait(lock);
+            continue;
+        }
+
+        auto next = manager->timers.pop_expired(steady_now());
+        if (next == nullptr) {
+            manager->timers_changed.wait_until(lock, steady_clock::time_point(milliseconds(deadline)));
+            continue;
+        }
+
+        lock.unlock();
+        TimerEntry::run(next);
+        lock.lock();
+    }
+}
+
+Strand::Strand(MblMwSessionManager* manager, size_t worker) : manager(manager), worker(worker), queued(false) { }
+
+Strand::~Strand() { }
+
+void Strand::post(function<void(void)> fn) {
+    {
+        lock_guard<mutex> lock(this->lock);
+        fns.push(fn);
+        if (queued) {
+            return;
+        }
+        queued = true;
+    }
+    enqueue(manager, worker, { shared_from_this(), nullptr });
+}
+
+shared_ptr<Task> Strand::schedule(function<void(void)> fn, int64_t delay) {
+    if (delay == INDEFINITE_TIMEOUT) {
+        return make_shared<TimerEntry>(shared_from_this(), fn);
+    }
+
+    shared_ptr<TimerEntry> entry;
+    bool earliest;
+    {
+        lock_guard<mutex> lock(manager->timer_lock);
+        int64_t deadline;
+        entry = manager->timers.push(shared_from_this(), fn, steady_now() + delay);
+        earliest = manager->timers.next_deadline(deadline) && deadline == entry->deadline;
+    }
+    if (earliest) {
+        manager->timers_changed.notify_one();
+    }
+    return entry;
+}
+
+bool Strand::run() {
+    for(size_t i = 0; i <= STRAND_BATCH_SIZE; i++) {
+        function<void(void)> fn;
+        {
+            lock_guard<mutex> lock(this->lock);
+            if (fns.empty()) {
+                queued = false;
+                idle.notify_all();
+                return false;
+            }
+            if (i == STRAND_BATCH_SIZE) {
+                return true;
+            }
+            fn = std::move(fns.front());
+            fns.pop();
+        }
+        fn();
+    }
+    return true;
+}
+
+void Strand::wait_idle() {
+    unique_lock<mutex> lock(this->lock);
+    idle.wait(lock, [this]() { return !queued; });
+}
+
+MblMwSessionManager* mbl_mw_session_manager_create(uint32_t n_workers) {
+    if (n_workers == 0) {
+        n_workers = std::max(thread::hardware_concurrency(), 1u);
+    }
+
+    auto manager = new MblMwSessionManager;
+    manager->next_submit = 0;
+    manager->n_runnables = 0;
+    manager->stopping = false;
+    manager->timers_stopping = false;
+
+    for(uint32_t i = 0; i < n_workers; i++) {
+        manager->workers.emplace_back(new Worker);
+        manager->workers.back()->n_boards = 0;
+    }
+    for(uint32_t i = 0; i < n_workers; i++) {
+        manager->workers[i]->th = thread(run_worker, manager, i);
+    }
+    manager->timer_thread = thread(run_timers, manager);
+
+    return manager;
+}
+
+uint32_t mbl_mw_session_manager_get_n_workers(const MblMwSessionManager* manager) {
+    return (uint32_t) manager->workers.size();
+}
+
+void mbl_mw_session_manager_add_board(MblMwSessionManager* manager, MblMwMetaWearBoard* board) {
+    lock_guard<mutex> lock(manager->boards_lock);
+    if (manager->strands.count(board)) {
+        return;
+    }
+
+    auto worker = min_element(manager->workers.begin(), manager->workers.end(), [](const unique_ptr<Worker>& left, const unique_ptr<Worker>& right) {
+        return left->n_boards < right->n_boards;
+    });
+    (*worker)->n_boards++;
+
+    auto strand = make_shared<Strand>(manager, worker - manager->workers.begin());
+    manager->strands.emplace(board, strand);
+    board->executor = strand;
+}
+
+void mbl_mw_session_manager_remove_board(MblMwSessionManager* manager, MblMwMetaWearBoard* board) {
+    shared_ptr<Strand> strand;
+    {
+        lock_guard<mutex> lock(manager->boards_lock);
+        auto it = manager->strands.find(board);
+        if (it == manager->strands.end()) {
+            return;
+        }
+
+        strand = it->second;
+        manager->workers[strand->worker]->n_boards--;
+        manager->strands.erase(it);
+        board->executor.reset();
+    }
+
+    // the strand can remove its own board, it cannot wait on itself
+    if (current_strand != strand.get()) {
+        strand->wait_idle();
+    }
+}
+
+void mbl_mw_session_manager_post(MblMwSessionManager* manager, MblMwMetaWearBoard* board, void *context, void (*fn)(void *context)) {
+    if (board->executor) {
+        board->executor->post(serialize(board, [context, fn](void) -> void {
+            fn(context);
+        }));
+    } else {
+        mbl_mw_session_manager_submit(manager, context, fn);
+    }
+}
+
+void mbl_mw_session_manager_submit(MblMwSessionManager* manager, void *context, void (*fn)(void *context)) {
+    // work submitted from a worker stays on it, idle workers steal it if that worker is busy
+    size_t worker = current_manager == manager ? current_worker : manager->next_submit++ % manager->workers.size();
+    enqueue(manager, worker, { nullptr, [context, fn](void) -> void {
+        fn(context);
+    }});
+}
+
+/** copies of one board's notifications, the values outlive the caller's buffers */
+struct NotificationRun {
+    vector<uint8_t> values;
+    vector<MblMwNotification> notifications;
+};
+
+void mbl_mw_session_manager_handle_notifications(MblMwSessionManager* manager, const MblMwNotification* notifications, uint32_t n_notifications) {
+    int64_t epoch = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+    uint32_t i = 0;
+
+    while(i < n_notifications) {
+        MblMwMetaWearBoard* board = notifications[i].board;
+        uint32_t end = i;
+        size_t n_bytes = 0;
+        for(; end < n_notifications && notifications[end].board == board; end++) {
+            n_bytes += notifications[end].length;
+        }
+
+        if (board->executor) {
+            auto run = make_shared<NotificationRun>();
+            run->values.reserve(n_bytes);
+            for(uint32_t j = i; j < end; j++) {
+                run->values.insert(run->values.end(), notifications[j].value, notifications[j].value + notifications[j].length);
+            }
+
+            run->notifications.reserve(end - i);
+            const uint8_t* value = run->values.data();
+            for(uint32_t j = i; j < end; j++) {
+                run->notifications.push_back({ board, value, notifications[j].length, notifications[j].epoch });
+                value += notifications[j].length;
+            }
+
+            board->executor->post([run, epoch](void) -> void {
+                handle_notifications(run->notifications.data(), (uint32_t) run->notifications.size(), epoch);
+            });
+        } else {
+            handle_notifications(notifications + i, end - i, epoch);
+        }
+        i = end;
+    }
+}
+
+void mbl_mw_session_manager_free(MblMwSessionManager* manager) {
+    {
+        lock_guard<mutex> lock(manager->timer_lock);
+        manager->timers_stopping = true;
+    }
+    manager->timers_changed.notify_all();
+    manager->timer_thread.join();
+
+    {
+        lock_guard<mutex> lock(manager->sleep_lock);
+        manager->stopping = true;
+    }
+    manager->work_ready.notify_all();
+    for(auto& it: manager->workers) {
+        it->th.join();
+    }
+
+    for(auto& it: manager->strands) {
+        it.first->executor.reset();
+    }
+
+    // timeouts scheduled before, or while, the workers finished go back to their own threads
+    manager->timers.move_to_thread_pool(steady_now());
+
+    delete manager;
+}
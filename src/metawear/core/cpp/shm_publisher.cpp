@@ -0,0 +1,272 @@
+#include "metawear/core/datasignal.h"
+#include "metawear/core/logging.h"
+#include "metawear/core/shm_publisher.h"
+
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <string>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using std::atomic;
+using std::atomic_thread_fence;
+using std::memcpy;
+using std::memory_order_acquire;
+using std::memory_order_relaxed;
+using std::memory_order_release;
+using std::string;
+
+const char SHM_RING_MAGIC[8]= {'M', 'B', 'L', 'M', 'W', 'S', 'H', 'M'};
+const uint32_t SHM_RING_VERSION= 1;
+
+/**
+ * Each slot is guarded by its own sequence number.  For the sample with write index i, the writer stores 2i + 1
+ * before modifying the slot and 2i + 2 once the sample is complete, so a reader knows the slot holds sample i,
+ * untouched, if it sees 2i + 2 both before and after copying it.
+ */
+struct ShmSlot {
+    atomic<uint64_t> sequence;
+    int64_t epoch;
+    int32_t type_id;
+    uint8_t length, reserved[3];
+    uint8_t value[MBL_MW_SHM_MAX_VALUE_LENGTH];
+};
+
+struct ShmRingHeader {
+    char magic[8];
+    uint32_t version, capacity, slot_size, reserved;
+    // keep the writer's cursor on its own cache line
+    alignas(64) atomic<uint64_t> write_index;
+};
+
+static_assert(sizeof(ShmSlot) == 64, "ShmSlot must be 64 bytes");
+static_assert(sizeof(ShmRingHeader) == 128, "ShmRingHeader must be 128 bytes");
+
+struct ShmRing {
+    ShmRing();
+
+    int fd;
+    size_t size;
+    ShmRingHeader* header;
+    ShmSlot* slots;
+    uint64_t mask;
+};
+
+struct MblMwShmPublisher {
+    ShmRing ring;
+    string name;
+    uint64_t write_index;
+};
+
+struct MblMwShmReader {
+    ShmRing ring;
+    uint64_t read_index, dropped;
+    uint8_t value[MBL_MW_SHM_MAX_VALUE_LENGTH];
+};
+
+ShmRing::ShmRing() : fd(-1), size(0), header(nullptr), slots(nullptr), mask(0) {
+}
+
+#ifndef _WIN32
+// Helper function - unmaps and closes a shared memory ring
+static void unmap_ring(ShmRing& ring) {
+    if (ring.header != nullptr) {
+        munmap(ring.header, ring.size);
+    }
+    if (ring.fd != -1) {
+        close(ring.fd);
+    }
+}
+
+// Helper function - maps the shared memory object into the process
+static bool map_ring(ShmRing& ring, int prot) {
+    void* memory= mmap(nullptr, ring.size, prot, MAP_SHARED, ring.fd, 0);
+    if (memory == MAP_FAILED) {
+        return false;
+    }
+
+    ring.header= static_cast<ShmRingHeader*>(memory);
+    ring.slots= reinterpret_cast<ShmSlot*>(static_cast<uint8_t*>(memory) + sizeof(ShmRingHeader));
+    return true;
+}
+
+MblMwShmPublisher* mbl_mw_shm_publisher_create(const char* name, uint32_t capacity) {
+    uint64_t n_slots= 1;
+    while(n_slots < capacity) {
+        n_slots<<= 1;
+    }
+
+    MblMwShmPublisher* publisher= new MblMwShmPublisher;
+    publisher->name= name;
+    publisher->write_index= 0;
+    publisher->ring.mask= n_slots - 1;
+    publisher->ring.size= sizeof(ShmRingHeader) + n_slots * sizeof(ShmSlot);
+
+    shm_unlink(name);
+    publisher->ring.fd= shm_open(name, O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (publisher->ring.fd == -1 || ftruncate(publisher->ring.fd, publisher->ring.size) != 0 || !map_ring(publisher->ring, PROT_READ | PROT_WRITE)) {
+        unmap_ring(publisher->ring);
+        shm_unlink(name);
+        delete publisher;
+        return nullptr;
+    }
+
+    // ftruncate zero fills the object, so every slot starts with sequence 0 i.e. never written
+    ShmRingHeader* header= new (publisher->ring.header) ShmRingHeader;
+    header->version= SHM_RING_VERSION;
+    header->capacity= static_cast<uint32_t>(n_slots);
+    header->slot_size= sizeof(ShmSlot);
+    header->write_index.store(0, memory_order_relaxed);
+    for(uint64_t i= 0; i < n_slots; i++) {
+        new (&publisher->ring.slots[i]) ShmSlot;
+        publisher->ring.slots[i].sequence.store(0, memory_order_relaxed);
+    }
+
+    // readers check the magic last, publish it once the ring is initialized
+    atomic_thread_fence(memory_order_release);
+    memcpy(header->magic, SHM_RING_MAGIC, sizeof(header->magic));
+    return publisher;
+}
+
+void mbl_mw_shm_publisher_write(void* context, const MblMwData* data) {
+    auto publisher= static_cast<MblMwShmPublisher*>(context);
+    if (data->length > MBL_MW_SHM_MAX_VALUE_LENGTH || data->type_id == MBL_MW_DT_ID_DATA_ARRAY) {
+        return;
+    }
+
+    uint64_t index= publisher->write_index;
+    ShmSlot& slot= publisher->ring.slots[index & publisher->ring.mask];
+
+    slot.sequence.store(2 * index + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    slot.epoch= data->epoch;
+    slot.type_id= data->type_id;
+    slot.length= data->length;
+    memcpy(slot.value, data->value, data->length);
+    slot.sequence.store(2 * index + 2, memory_order_release);
+
+    publisher->write_index= index + 1;
+    publisher->ring.header->write_index.store(index + 1, memory_order_release);
+}
+
+void mbl_mw_shm_publisher_close(MblMwShmPublisher* publisher) {
+    unmap_ring(publisher->ring);
+    shm_unlink(publisher->name.c_str());
+    delete publisher;
+}
+
+MblMwShmReader* mbl_mw_shm_reader_open(const char* name) {
+    MblMwShmReader* reader= new MblMwShmReader;
+    reader->dropped= 0;
+
+    struct stat info;
+    reader->ring.fd= shm_open(name, O_RDONLY, 0);
+    if (reader->ring.fd == -1 || fstat(reader->ring.fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(ShmRingHeader)) {
+        unmap_ring(reader->ring);
+        delete reader;
+        return nullptr;
+    }
+
+    reader->ring.size= info.st_size;
+    if (!map_ring(reader->ring, PROT_READ)) {
+        unmap_ring(reader->ring);
+        delete reader;
+        return nullptr;
+    }
+
+    const ShmRingHeader* header= reader->ring.header;
+    bool valid= memcmp(header->magic, SHM_RING_MAGIC, sizeof(header->magic)) == 0;
+    atomic_thread_fence(memory_order_acquire);
+    if (!valid || header->version != SHM_RING_VERSION || header->slot_size != sizeof(ShmSlot) ||
+            reader->ring.size != sizeof(ShmRingHeader) + static_cast<size_t>(header->capacity) * sizeof(ShmSlot)) {
+        unmap_ring(reader->ring);
+        delete reader;
+        return nullptr;
+    }
+
+    reader->ring.mask= header->capacity - 1;
+    reader->read_index= header->write_index.load(memory_order_acquire);
+    return reader;
+}
+
+int32_t mbl_mw_shm_reader_next(MblMwShmReader* reader, MblMwData* data) {
+    uint64_t capacity= reader->ring.mask + 1;
+    while(true) {
+        uint64_t write_index= reader->ring.header->write_index.load(memory_order_acquire);
+        if (reader->read_index == write_index) {
+            return 0;
+        }
+        if (write_index - reader->read_index > capacity) {
+            reader->dropped+= write_index - reader->read_index - capacity;
+            reader->read_index= write_index - capacity;
+        }
+
+        const ShmSlot& slot= reader->ring.slots[reader->read_index & reader->ring.mask];
+        uint64_t expected= 2 * reader->read_index + 2;
+        if (slot.sequence.load(memory_order_acquire) == expected) {
+            data->epoch= slot.epoch;
+            data->type_id= static_cast<MblMwDataTypeId>(slot.type_id);
+            data->length= slot.length < MBL_MW_SHM_MAX_VALUE_LENGTH ? slot.length : MBL_MW_SHM_MAX_VALUE_LENGTH;
+            memcpy(reader->value, slot.value, data->length);
+
+            atomic_thread_fence(memory_order_acquire);
+            if (slot.sequence.load(memory_order_relaxed) == expected) {
+                data->value= reader->value;
+                data->extra= nullptr;
+                reader->read_index++;
+                return 1;
+            }
+        }
+
+        // publisher lapped the reader while the slot was being read, skip the sample
+        reader->dropped++;
+        reader->read_index++;
+    }
+}
+
+void mbl_mw_shm_reader_close(MblMwShmReader* reader) {
+    unmap_ring(reader->ring);
+    delete reader;
+}
+#else
+MblMwShmPublisher* mbl_mw_shm_publisher_create(const char* name, uint32_t capacity) {
+    return nullptr;
+}
+
+void mbl_mw_shm_publisher_write(void* context, const MblMwData* data) {
+}
+
+void mbl_mw_shm_publisher_close(MblMwShmPublisher* publisher) {
+    delete publisher;
+}
+
+MblMwShmReader* mbl_mw_shm_reader_open(const char* name) {
+    return nullptr;
+}
+
+int32_t mbl_mw_shm_reader_next(MblMwShmReader* reader, MblMwData* data) {
+    return 0;
+}
+
+void mbl_mw_shm_reader_close(MblMwShmReader* reader) {
+    delete reader;
+}
+#endif
+
+void mbl_mw_datasignal_publish(MblMwDataSignal* signal, MblMwShmPublisher* publisher) {
+    mbl_mw_datasignal_subscribe(signal, publisher, mbl_mw_shm_publisher_write);
+}
+
+void mbl_mw_logger_publish(MblMwDataLogger* logger, MblMwShmPublisher* publisher) {
+    mbl_mw_logger_subscribe(logger, publisher, mbl_mw_shm_publisher_write);
+}
+
+uint64_t mbl_mw_shm_reader_get_dropped(const MblMwShmReader* reader) {
+    return reader->dropped;
+}
@@ -3,7 +3,6 @@
 #include "metawear/core/status.h"
 #include "metawear/core/timer.h"
 #include "metawear/platform/cpp/async_creator.h"
-#include "metawear/platform/cpp/threadpool.h"
 
 #include "metawearboard_def.h"
 #include "timer_private.h"
@@ -30,7 +29,7 @@ struct TimerState : public AsyncCreator {
 static int32_t timer_created(MblMwMetaWearBoard *board, const uint8_t *response, uint8_t len) {
     auto state = GET_TIMER_STATE(board);
 
-    state->timeout->cancel();
+    response_received(state->timeout);
 
     MblMwTimer *new_timer = new MblMwTimer(ResponseHeader(MBL_MW_MODULE_TIMER, ORDINAL(TimerRegister::NOTIFY), response[2]), board);
     board->module_events.emplace(new_timer->header, new_timer);
@@ -94,10 +93,10 @@ void mbl_mw_timer_create(MblMwMetaWearBoard *board, uint32_t period, uint16_t re
 
         state->timer_callback= received_timer;
         state->timer_context= context;
-        state->timeout= ThreadPool::schedule([context, state, received_timer](void) -> void {
+        state->timeout= schedule_response_timeout(board, [context, state, received_timer](void) -> void {
             received_timer(context, nullptr);
             state->create_next(true);
-        }, board->time_per_response);
+        }, 1);
 
         SEND_COMMAND;
     });
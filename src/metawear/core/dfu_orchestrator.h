@@ -0,0 +1,68 @@
+/**
+ * @copyright MbientLab License
+ * @file dfu_orchestrator.h
+ * @brief Runs DFU on many boards concurrently
+ * @details
+ * The orchestrator opens the firmware package once and every board it updates shares it.  Plain images are mapped into 
+ * memory once, zip packages are inflated separately for each board as its packets are sent, in small chunks.  Up to 
+ * max_concurrent boards are updated at a time; when one finishes, successfully or not, the next queued board starts.  
+ * Callbacks are invoked from whichever thread delivered a board's DFU notification, one at a time and in the order the 
+ * updates happened, without the orchestrator's lock held.  A thread finding another one invoking callbacks leaves its 
+ * own to that thread, so callbacks may wait on other boards, e.g. with mbl_mw_metawearboard_execute.  Do not call 
+ * orchestrator functions from within them.
+ */
+#pragma once
+
+#include "dfu_orchestrator_fwd.h"
+#include "metawearboard_fwd.h"
+
+#include "metawear/platform/dllmarker.h"
+
+#include <stdint.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/**
+ * Wrapper class containing functions for receiving callbacks throughout the orchestrated DFU process
+ */
+typedef struct {
+    void *context;
+    /** Called when a board's update finishes, error is null if the update succeeded */
+    void (*on_board_finished)(void *context, MblMwMetaWearBoard* board, const char *error);
+    /** Called when the average transfer percentage across all boards changes */
+    void (*on_progress)(void *context, int32_t percentage);
+    /** Called once every board has finished */
+    void (*on_finished)(void *context, int32_t n_succeeded, int32_t n_failed);
+} MblMwDfuOrchestratorDelegate;
+
+/**
+ * Creates an orchestrator, opening the firmware package
+ * @param filename          Path to firmware bin or zip file
+ * @param max_concurrent    Maximum number of boards to update at the same time, 0 for no limit
+ * @param delegate          Struct the orchestrator will forward progress updates to
+ * @return Pointer to the orchestrator, null if the firmware package could not be opened
+ */
+METAWEAR_API MblMwDfuOrchestrator* mbl_mw_dfu_orchestrator_create(const char *filename, uint32_t max_concurrent, 
+        const MblMwDfuOrchestratorDelegate *delegate);
+/**
+ * Queues a board for updating.  Boards must be added before the orchestrator is started.
+ * @param orchestrator      Orchestrator to add the board to
+ * @param board             Board to update, must be connected to its bootloader
+ */
+METAWEAR_API void mbl_mw_dfu_orchestrator_add_board(MblMwDfuOrchestrator* orchestrator, MblMwMetaWearBoard* board);
+/**
+ * Starts updating the queued boards
+ * @param orchestrator      Orchestrator to start
+ */
+METAWEAR_API void mbl_mw_dfu_orchestrator_start(MblMwDfuOrchestrator* orchestrator);
+/**
+ * Frees the orchestrator.  Only call this function once all boards have finished, and not from within a callback.
+ * @param orchestrator      Orchestrator to free
+ */
+METAWEAR_API void mbl_mw_dfu_orchestrator_free(MblMwDfuOrchestrator* orchestrator);
+
+#ifdef	__cplusplus
+}
+#endif
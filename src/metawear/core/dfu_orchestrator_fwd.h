@@ -0,0 +1,15 @@
+/**
+ * @copyright MbientLab License
+ * @file dfu_orchestrator_fwd.h
+ * @brief Forward declaration for the DFU orchestrator type
+ */
+#pragma once
+
+/**
+ * Uploads the same firmware package to many boards, a limited number at a time
+ */
+#ifdef	__cplusplus
+struct MblMwDfuOrchestrator;
+#else
+typedef struct MblMwDfuOrchestrator MblMwDfuOrchestrator;
+#endif
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include "event_fwd.h"
 #include "metawearboard_fwd.h"
 
@@ -15,6 +17,44 @@
 extern "C" {
 #endif
 
+/**
+ * Definition for callback functions that issue the commands an event should execute.  Every MetaWear command called 
+ * from the function is recorded for the event instead of being executed immediately.
+ * @param context       Pointer to the <code>context</code> field of the binding
+ * @param event         Event the commands are recorded for
+ */
+typedef void (*MblMwFnEventCommands)(void *context, MblMwEvent* event);
+
+/**
+ * Pairs an event with the commands to execute when it fires
+ */
+typedef struct {
+    MblMwEvent* event;                  ///< Event that triggers the commands
+    void *context;                      ///< Pointer to additional data for the record function
+    MblMwFnEventCommands record;        ///< Called once to issue the commands to execute when the event fires
+} MblMwEventBinding;
+
+/**
+ * On-board ids assigned to the commands of one MblMwEventBinding
+ */
+typedef struct {
+    MblMwEvent* event;                  ///< Event the commands were programmed for
+    const uint8_t* entry_ids;           ///< Ids of the programmed commands, in the order they were issued
+    uint32_t n_entry_ids;               ///< Number of programmed commands
+} MblMwEventBindingResult;
+
+/**
+ * Definition for callback functions that are executed when a batch of event bindings is programmed
+ * @param context       Pointer to the context the enclosing function was called with
+ * @param board         Board the bindings were programmed on
+ * @param results       Programmed ids for each binding, in the same order as the bindings, only valid for the duration 
+ *                      of the callback
+ * @param n_results     Number of elements in the results array
+ * @param status        MBL_MW_STATUS_OK if every command was programmed, MBL_MW_STATUS_ERROR_TIMEOUT if the board 
+ *                      stopped responding, in which case the results only hold the commands that were programmed
+ */
+typedef void (*MblMwFnEventBindingResults)(void *context, MblMwMetaWearBoard* board, const MblMwEventBindingResult* results, uint32_t n_results, int32_t status);
+
 /**
  * Retrieves the MblMwMetaWearBoard the event belongs to.
  * @param event     Event to lookup
@@ -40,6 +80,21 @@ METAWEAR_API void mbl_mw_event_record_commands(MblMwEvent *event);
  */
 METAWEAR_API void mbl_mw_event_end_record(MblMwEvent *event, void *context, MblMwFnEventPtrInt commands_recorded);
 
+/**
+ * Programs a set of event to command bindings as one transaction.  Each binding's record function is called in order 
+ * to collect its commands, then all commands are streamed to the board with a bounded number of unacknowledged 
+ * commands in flight.  The completion callback is executed once when every command is acknowledged or the board 
+ * stops responding.  Do not record commands with mbl_mw_event_record_commands until the callback is executed.  Batches 
+ * programmed while another one is in progress are queued and programmed in order once it completes.
+ * @param board                 Board to program
+ * @param bindings              Events and the functions issuing their commands
+ * @param n_bindings            Number of elements in the bindings array
+ * @param context               Pointer to additional data for the callback function
+ * @param programmed            Callback function to be executed when the bindings are programmed
+ */
+METAWEAR_API void mbl_mw_event_program(MblMwMetaWearBoard* board, const MblMwEventBinding* bindings, uint32_t n_bindings, 
+        void *context, MblMwFnEventBindingResults programmed);
+
 /**
  * Remove all recorded events from the board.
  * @param board                 Calling object
@@ -158,7 +158,8 @@ METAWEAR_API int64_t mbl_mw_logging_get_reference_time(const MblMwMetaWearBoard
 
 /**
  * Set the device boot time for a given reset_uid.  This reference time
- * is used to calcuated real timestamps from logged data.
+ * is used to calcuated real timestamps from logged data.  Reset ids
+ * outside of [0, 7] are ignored.
  * @param board                 Board to use
  * @param reset_uid             Reset id
  * @param reference_epoch       New reference epoch (in milliseconds) to use
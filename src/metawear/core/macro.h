@@ -5,6 +5,7 @@
  */
 #pragma once
 
+#include "macro_fwd.h"
 #include "metawearboard_fwd.h"
 #include "metawear/platform/dllmarker.h"
 
@@ -12,6 +13,27 @@
 extern "C" {
 #endif
 
+/**
+ * Summary of a macro uploaded with mbl_mw_macro_builder_upload
+ */
+typedef struct {
+    uint8_t id;                         ///< Numerical id of the macro, only valid if the upload succeeded
+    uint32_t n_commands;                ///< Number of commands stored in the macro
+    uint32_t n_dropped;                 ///< Number of recorded config writes removed because they were redundant
+    uint32_t size;                      ///< Command bytes written to the macro add registers
+    uint32_t upload_time_ms;            ///< Time from the begin request until the board acknowledged the end of the macro
+} MblMwMacroUploadResult;
+
+/**
+ * Definition for callback functions that are executed when a compiled macro is uploaded
+ * @param context       Pointer to the context the enclosing function was called with
+ * @param board         Board the macro was uploaded to
+ * @param result        Summary of the upload, only valid for the duration of the callback
+ * @param status        MBL_MW_STATUS_OK if the macro was stored, MBL_MW_STATUS_ERROR_TIMEOUT if the board did not 
+ *                      respond to the begin request or did not acknowledge the end of the macro
+ */
+typedef void (*MblMwFnMacroUploaded)(void *context, MblMwMetaWearBoard* board, const MblMwMacroUploadResult* result, int32_t status);
+
 /**
  * Begin macro recording.  
  * Used to command the board on boot. Commands will survive a reset.
@@ -49,6 +71,60 @@ METAWEAR_API void mbl_mw_macro_execute(MblMwMetaWearBoard *board, uint8_t id);
  */
 METAWEAR_API void mbl_mw_macro_erase_all(MblMwMetaWearBoard *board);
 
+/**
+ * Creates a macro builder.  Commands are collected on the host and compiled into a macro when uploaded, which 
+ * removes redundant config writes and sends the macro in one burst rather than one acknowledged write per command.
+ * @param board             Board the macro is for
+ * @param exec_on_boot      True if the commands should be executed when the board powers on
+ * @return Pointer to the builder, free it with mbl_mw_macro_builder_free
+ */
+METAWEAR_API MblMwMacroBuilder* mbl_mw_macro_builder_create(MblMwMetaWearBoard *board, uint8_t exec_on_boot);
+/**
+ * Starts collecting commands into the builder.  Commands issued with the API are still sent to the board, as with 
+ * mbl_mw_macro_record, and config register writes are flagged so the compiler can deduplicate them.
+ * @param builder           Calling object
+ */
+METAWEAR_API void mbl_mw_macro_builder_record(MblMwMacroBuilder* builder);
+/**
+ * Stops collecting commands into the builder
+ * @param builder           Calling object
+ */
+METAWEAR_API void mbl_mw_macro_builder_end_record(MblMwMacroBuilder* builder);
+/**
+ * Appends a raw command to the builder.  Raw commands are never removed by the compiler.
+ * @param builder           Calling object
+ * @param command           Command bytes, starting with the module and register id
+ * @param len               Number of bytes in the command
+ */
+METAWEAR_API void mbl_mw_macro_builder_add_command(MblMwMacroBuilder* builder, const uint8_t* command, uint8_t len);
+/**
+ * Compiles the collected commands and returns how many will be stored in the macro
+ * @param builder           Calling object
+ * @return Number of commands left after redundant config writes are removed
+ */
+METAWEAR_API uint32_t mbl_mw_macro_builder_get_n_commands(const MblMwMacroBuilder* builder);
+/**
+ * Compiles the collected commands and counts the bytes the macro add registers will store
+ * @param builder           Calling object
+ * @return Size of the macro, in bytes
+ */
+METAWEAR_API uint32_t mbl_mw_macro_builder_get_size(const MblMwMacroBuilder* builder);
+/**
+ * Compiles the collected commands and uploads them as a new macro.  The commands are written back to back without 
+ * response after the begin request is answered, and the upload completes once the board acknowledges the end of the 
+ * macro.  The builder must not be freed or modified until the callback is executed.
+ * @param builder           Calling object
+ * @param context           Pointer to additional data for the callback function
+ * @param uploaded          Callback function to be executed when the macro is uploaded
+ */
+METAWEAR_API void mbl_mw_macro_builder_upload(MblMwMacroBuilder* builder, void *context, MblMwFnMacroUploaded uploaded);
+/**
+ * Frees the memory allocated for the builder.  Freeing a builder that is still uploading abandons the upload, its 
+ * callback is never called.
+ * @param builder           Calling object
+ */
+METAWEAR_API void mbl_mw_macro_builder_free(MblMwMacroBuilder* builder);
+
 #ifdef	__cplusplus
 }
 #endif
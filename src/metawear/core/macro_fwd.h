@@ -0,0 +1,15 @@
+/**
+ * @copyright MbientLab License
+ * @file macro_fwd.h
+ * @brief Forward declaration of the MblMwMacroBuilder type
+ */
+#pragma once
+
+/**
+ * Host side compiler that turns a list of MetaWear commands into a macro
+ */
+#ifdef	__cplusplus
+struct MblMwMacroBuilder;
+#else
+typedef struct MblMwMacroBuilder MblMwMacroBuilder;
+#endif
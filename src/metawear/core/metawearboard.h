@@ -32,6 +32,33 @@ typedef struct {
     const char* hardware_revision;      ///< Revision of the hardware on the device, characteristic 0x2A27
 } MblMwDeviceInformation;
 
+/**
+ * How config register writes are sent to the board
+ */
+typedef enum {
+    MBL_MW_CONFIG_WRITE_CHANGED = 0,        ///< Skip config registers whose value matches the last value written to them
+    MBL_MW_CONFIG_WRITE_ALL                 ///< Always send every config register
+} MblMwConfigWriteMode;
+
+/**
+ * Commands sent by mbl_mw_metawearboard_tear_down_with_summary
+ */
+typedef struct {
+    uint32_t n_commands;                ///< Number of commands sent to the board
+    uint32_t n_per_object_commands;     ///< Number of commands needed to remove every known object individually
+    uint32_t n_freed;                   ///< Number of host side objects freed
+} MblMwTearDownSummary;
+
+/**
+ * Notification from a board's MetaWear notify characteristic, passed to mbl_mw_metawearboard_handle_notifications
+ */
+typedef struct {
+    MblMwMetaWearBoard* board;          ///< Board that sent the notification
+    const uint8_t* value;               ///< Characteristic value
+    uint8_t length;                     ///< Number of bytes in the value
+    int64_t epoch;                      ///< Time the notification was received, in milliseconds since the Unix epoch, 0 to use the time it is handled
+} MblMwNotification;
+
 typedef struct {
     const char* name;
     const uint8_t* extra;
@@ -63,6 +90,73 @@ METAWEAR_API void mbl_mw_metawearboard_free(MblMwMetaWearBoard *board);
  */
 METAWEAR_API void mbl_mw_metawearboard_set_time_for_response(MblMwMetaWearBoard* board, uint16_t response_time_ms);
 
+/**
+ * Sizes response timeouts from the round trip times measured on the connection, like TCP sizes its retransmission 
+ * timeout, instead of using the value set with mbl_mw_metawearboard_set_time_for_response.  Each timeout waits for the 
+ * smoothed round trip time plus four times its variation, between min_response_time_ms and 4000ms, and doubles every 
+ * time a response does not arrive until the next one is measured.  The value set with 
+ * mbl_mw_metawearboard_set_time_for_response is used until a response has been measured, and 0ms still disables timeouts.
+ * @param board                 Board to configure
+ * @param min_response_time_ms  Shortest time to wait for a response, 0 to go back to the fixed response time
+ */
+METAWEAR_API void mbl_mw_metawearboard_set_adaptive_timeouts(MblMwMetaWearBoard* board, uint16_t min_response_time_ms);
+/**
+ * Retrieves how long the API currently waits for a response
+ * @param board                 Board to query
+ * @return Response time in ms, 0 if timeouts are disabled
+ */
+METAWEAR_API uint16_t mbl_mw_metawearboard_get_time_for_response(const MblMwMetaWearBoard* board);
+
+/**
+ * Sets the ATT MTU negotiated for the connection.  The DFU process sizes its packets to fill the MTU, 
+ * up to 244 bytes; the default is 23 bytes, i.e. 20 byte packets.
+ * @param board                 Board to configure
+ * @param mtu                   Negotiated MTU, in bytes
+ */
+METAWEAR_API void mbl_mw_metawearboard_set_mtu(MblMwMetaWearBoard* board, uint16_t mtu);
+/**
+ * Sets the function that bursts of writes, such as starting sensor fusion, tearing down the board, uploading macros, 
+ * and DFU transfers, are passed to in one call.  It is called with the context of the MblMwBtleConnection the board 
+ * was created with.  Without one, or after setting it to null, every write goes through MblMwBtleConnection.write_gatt_char.
+ * @param board                 Board to configure
+ * @param write_gatt_chars      Function that writes several characteristic values, null to write them one at a time
+ */
+METAWEAR_API void mbl_mw_metawearboard_set_write_gatt_chars(MblMwMetaWearBoard* board, MblMwFnWriteGattChars write_gatt_chars);
+
+/**
+ * Sets whether sensor config writes, such as mbl_mw_acc_write_acceleration_config or mbl_mw_sensor_fusion_write_config, 
+ * skip registers that already hold the value being written.  The default mode is MBL_MW_CONFIG_WRITE_ALL.  
+ * Either mode also forgets the previously written values, so the next write of every register is sent in full.  
+ * Registers written while an event or macro is being recorded are never skipped afterwards, since the board can 
+ * rewrite them on its own; setting the mode again resumes skipping them.
+ * @param board                 Board to configure
+ * @param mode                  New config write mode
+ */
+METAWEAR_API void mbl_mw_metawearboard_set_config_write_mode(MblMwMetaWearBoard* board, MblMwConfigWriteMode mode);
+
+/**
+ * Serializes the work the API does for the board behind a per-board lock.  Notifications, read responses, timeouts, 
+ * disconnects, mbl_mw_metawearboard_initialize, and functions run with mbl_mw_metawearboard_execute never overlap, so 
+ * application threads can use different boards in parallel without a global lock.  Callbacks are invoked with the lock 
+ * held and can call back into the API for the same board.  No other API function takes the lock: calls made directly 
+ * from an application thread are not serialized and must be made from a function passed to 
+ * mbl_mw_metawearboard_execute instead.  Serialization cannot be disabled and must be enabled before the board is 
+ * initialized.
+ * @param board         Board to serialize
+ */
+METAWEAR_API void mbl_mw_metawearboard_enable_serialization(MblMwMetaWearBoard* board);
+
+/**
+ * Runs a function on the calling thread, serialized with the board's notifications and timeouts if serialization is 
+ * enabled.  This is the only way to serialize API calls made from an application thread; functions called outside of 
+ * it, other than mbl_mw_metawearboard_initialize, do not take the board's lock.  
+ * Do not wait from inside the function on another thread that uses the same board.
+ * @param board         Board the function uses
+ * @param context       Pointer to additional data for the callback function
+ * @param fn            Function to run
+ */
+METAWEAR_API void mbl_mw_metawearboard_execute(MblMwMetaWearBoard* board, void *context, void (*fn)(void *context, MblMwMetaWearBoard* board));
+
 /**
  * Initialize the API's internal state.  
  * This function is non-blocking and will alert the caller when the operation is complete.
@@ -72,11 +166,30 @@ METAWEAR_API void mbl_mw_metawearboard_set_time_for_response(MblMwMetaWearBoard*
  */
 METAWEAR_API void mbl_mw_metawearboard_initialize(MblMwMetaWearBoard *board, void *context, MblMwFnBoardPtrInt initialized);
 
+/**
+ * Handles many notifications, from one board or several, in one call.  This is the bulk alternative to calling the handler 
+ * given to <code>enable_notifications</code> once per packet, for backends that read several notifications at a time.  
+ * Notifications must be in the order they were received.  Data is timestamped with the notification's epoch field, or 
+ * with the time of the call if it is 0, and commands the board's responses trigger are written as one batch per run of notifications from the same board.
+ * @param notifications         Notifications to handle
+ * @param n_notifications       Number of notifications
+ * @return Number of notifications the API did not handle, e.g. data nothing is subscribed to
+ */
+METAWEAR_API uint32_t mbl_mw_metawearboard_handle_notifications(const MblMwNotification* notifications, uint32_t n_notifications);
+
 /**
  * Removes all data processors and timers from the MetaWear board.
  * @param board         Board to tear down
  */
 METAWEAR_API void mbl_mw_metawearboard_tear_down(MblMwMetaWearBoard *board);
+/**
+ * Variant of mbl_mw_metawearboard_tear_down that reports how many commands were sent.  Processors, events, and 
+ * loggers are cleared with their module's remove all command, only timers, which have no such command, are removed 
+ * one by one.
+ * @param board         Board to tear down
+ * @param summary       Filled with the command counts, can be null
+ */
+METAWEAR_API void mbl_mw_metawearboard_tear_down_with_summary(MblMwMetaWearBoard *board, MblMwTearDownSummary* summary);
 
 /**
  * Checks if the board is initialized.
@@ -172,6 +285,15 @@ typedef struct {
  */
 METAWEAR_API void mbl_mw_metawearboard_perform_dfu(MblMwMetaWearBoard *board, const MblMwDfuDelegate *delegate, const char *filename);
 
+/**
+ * Sets the function that receives the measured firmware upload throughput.  It is called with the delegate's context 
+ * on every packet receipt of the DFU processes started afterwards.
+ * @param board                 Board to configure
+ * @param on_transfer_rate      Function to call with the throughput in bytes per second, null to stop reporting it
+ */
+METAWEAR_API void mbl_mw_metawearboard_set_dfu_transfer_rate_handler(MblMwMetaWearBoard *board, 
+        void (*on_transfer_rate)(void *context, float bytes_per_second));
+
 #ifdef __cplusplus
 }
 #endif
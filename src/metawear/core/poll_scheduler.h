@@ -0,0 +1,78 @@
+/**
+ * @copyright MbientLab License
+ * @file poll_scheduler.h
+ * @brief Runs boards' timeouts from the application's event loop
+ * @details
+ * By default every response timeout waits on a thread of its own.  Boards added to a poll scheduler instead queue their 
+ * timeouts on the scheduler, and they only run when the application calls mbl_mw_poll_scheduler_process_timeouts, on 
+ * the calling thread.  Together with a connection that delivers notifications from the same loop, the API then creates 
+ * no threads.
+ *
+ * Deadlines are in milliseconds on the scheduler's clock.  A typical loop waits until mbl_mw_poll_scheduler_next_deadline 
+ * or until a Bluetooth LE event arrives, whichever is first, then processes the timeouts that are due.  API calls and 
+ * notifications can add earlier deadlines so read the next deadline again before waiting.  Supplying a clock lets tests 
+ * step through timeouts without waiting on real time.
+ */
+#pragma once
+
+#include "metawearboard_fwd.h"
+#include "poll_scheduler_fwd.h"
+
+#include "metawear/platform/dllmarker.h"
+
+#include <stdint.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/**
+ * Creates a poll scheduler
+ * @param context           Pointer to additional data for the clock function
+ * @param now               Returns the current time in milliseconds, null to use a monotonic system clock
+ * @return Pointer to the poll scheduler
+ */
+METAWEAR_API MblMwPollScheduler* mbl_mw_poll_scheduler_create(void *context, int64_t (*now)(void *context));
+/**
+ * Reads the scheduler's clock
+ * @param scheduler         Poll scheduler to read the clock of
+ * @return Current time in milliseconds
+ */
+METAWEAR_API int64_t mbl_mw_poll_scheduler_now(const MblMwPollScheduler* scheduler);
+/**
+ * Adds a board to the scheduler.  Add a board before it is initialized or while it has no operations in progress.
+ * @param scheduler         Poll scheduler to add the board to
+ * @param board             Board to add, must not belong to a session manager or another poll scheduler
+ */
+METAWEAR_API void mbl_mw_poll_scheduler_add_board(MblMwPollScheduler* scheduler, MblMwMetaWearBoard* board);
+/**
+ * Removes a board from the scheduler.  Timeouts the board already queued are still run by the scheduler, later ones 
+ * run on their own threads.
+ * @param scheduler         Poll scheduler to remove the board from
+ * @param board             Board to remove
+ */
+METAWEAR_API void mbl_mw_poll_scheduler_remove_board(MblMwPollScheduler* scheduler, MblMwMetaWearBoard* board);
+/**
+ * Retrieves when the earliest queued timeout is due
+ * @param scheduler         Poll scheduler to query
+ * @return Deadline in milliseconds on the scheduler's clock, -1 if no timeouts are queued
+ */
+METAWEAR_API int64_t mbl_mw_poll_scheduler_next_deadline(MblMwPollScheduler* scheduler);
+/**
+ * Runs every queued timeout due at or before now, earliest first, on the calling thread
+ * @param scheduler         Poll scheduler to process
+ * @param now               Current time in milliseconds on the scheduler's clock
+ * @return Number of timeouts run
+ */
+METAWEAR_API uint32_t mbl_mw_poll_scheduler_process_timeouts(MblMwPollScheduler* scheduler, int64_t now);
+/**
+ * Frees the scheduler.  Boards still added to it go back to running their timeouts on their own threads, timeouts still 
+ * queued are moved there.  The scheduler must be idle: do not call this function while mbl_mw_poll_scheduler_process_timeouts 
+ * runs, or while another thread uses the scheduler or one of the boards added to it.
+ * @param scheduler         Poll scheduler to free
+ */
+METAWEAR_API void mbl_mw_poll_scheduler_free(MblMwPollScheduler* scheduler);
+
+#ifdef	__cplusplus
+}
+#endif
@@ -0,0 +1,15 @@
+/**
+ * @copyright MbientLab License
+ * @file poll_scheduler_fwd.h
+ * @brief Forward declaration for the poll scheduler type
+ */
+#pragma once
+
+/**
+ * Holds boards' timeouts until the application's event loop processes them
+ */
+#ifdef	__cplusplus
+struct MblMwPollScheduler;
+#else
+typedef struct MblMwPollScheduler MblMwPollScheduler;
+#endif
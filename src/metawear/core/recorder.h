@@ -0,0 +1,114 @@
+/**
+ * @copyright MbientLab License
+ * @file recorder.h
+ * @brief Records streamed or logged data into columnar files
+ * @details
+ * A recording is a sequence of fixed size chunks, each holding up to <code>chunk_rows</code> samples stored column by 
+ * column.  All integers are little endian and every column starts on an 8 byte boundary so the file can be memory 
+ * mapped and scanned without parsing individual samples.
+ * 
+ * | Section      | Layout                                                                                      |
+ * |--------------|---------------------------------------------------------------------------------------------|
+ * | File header  | char magic[8] = "MBLMWREC", uint32 version, uint32 chunk_rows, int32 type_id,               |
+ * |              | uint8 n_columns, uint8 column_width, uint16 flags, 40 bytes reserved (64 bytes total)       |
+ * | Chunk        | int64 epoch[chunk_rows], followed by n_columns value columns of                             |
+ * |              | column_width * chunk_rows bytes, each padded to a multiple of 8 bytes                       |
+ * | Index entry  | uint64 offset, uint32 n_rows, uint32 size, int64 first_epoch, int64 last_epoch (32 bytes)   |
+ * | Trailer      | uint64 index_offset, uint32 n_chunks, uint32 reserved, char magic[8] = "MBLMWIDX"           |
+ * 
+ * The index is written after the last chunk, one entry per chunk in recording order, and the trailer occupies the last 
+ * 24 bytes of the file.  Value columns hold the components of MblMwData::value in order e.g. x, y, z for 
+ * MblMwCartesianFloat.  Types with 32-bit components use 4 byte columns, MblMwTcs34725ColorAdc uses 2 byte columns, 
+ * and all other types are stored as one column per byte.
+ * 
+ * The header <code>flags</code> field holds the MblMwRecorderFlag values the recording was created with.  With 
+ * MBL_MW_RECORDER_FLAG_DELTA_ENCODE, the epoch column and the value columns of MBL_MW_DT_ID_UINT32, MBL_MW_DT_ID_INT32, 
+ * and MBL_MW_DT_ID_TCS34725_ADC recordings store the first row as is and every following row as the wrapping difference 
+ * from the previous row.  Only the epoch column of floating point recordings, such as acceleration and angular velocity, 
+ * is delta encoded; samples reach the recorder already converted to floats, the raw fixed point values are not 
+ * available to difference, and the float columns are stored as is.  With MBL_MW_RECORDER_FLAG_COMPRESS, each chunk is stored as a zlib stream of the layout above 
+ * and the index entry <code>size</code> field is the compressed size.  Unused rows of partial chunks are zero filled.
+ */
+#pragma once
+
+#include "data.h"
+#include "datasignal_fwd.h"
+#include "logging_fwd.h"
+#include "recorder_fwd.h"
+
+#include "metawear/platform/dllmarker.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/**
+ * Options for how chunks are stored on disk, combined as bit flags
+ */
+typedef enum {
+    MBL_MW_RECORDER_FLAG_COMPRESS = 0x1,            ///< Compress each chunk with zlib
+    MBL_MW_RECORDER_FLAG_DELTA_ENCODE = 0x2         ///< Store the epoch and integer columns as row to row differences, float columns are not encoded
+} MblMwRecorderFlag;
+
+/**
+ * Creates a recorder that writes to the given file, replacing any existing content.  Full chunks are written to disk 
+ * by a background thread so the callback thread only copies samples into a preallocated chunk.  Chunks come from a 
+ * fixed pool of 4 allocated with the first sample; samples arriving while every chunk waits to be written are dropped.
+ * @param filename              Path of the recording file
+ * @param chunk_rows            Number of samples stored per chunk
+ * @return Pointer to the recorder, null if the file could not be opened or chunk_rows is 0
+ */
+METAWEAR_API MblMwRecorder* mbl_mw_recorder_create(const char* filename, uint32_t chunk_rows);
+/**
+ * Variant of mbl_mw_recorder_create that encodes chunks according to the flags.  Delta encoding and compression run 
+ * on the background writer thread, adding no work to the callback thread.
+ * @param filename              Path of the recording file
+ * @param chunk_rows            Number of samples stored per chunk
+ * @param flags                 Bitwise or of MblMwRecorderFlag values
+ * @return Pointer to the recorder, null if the file could not be opened or chunk_rows is 0
+ */
+METAWEAR_API MblMwRecorder* mbl_mw_recorder_create_with_flags(const char* filename, uint32_t chunk_rows, uint16_t flags);
+/**
+ * Appends a sample to the recording.  The data type of the first sample determines the columns of the recording, 
+ * samples with a different type or length are dropped.  This function has the MblMwFnData signature and can be 
+ * passed directly to mbl_mw_datasignal_subscribe or mbl_mw_logger_subscribe with the recorder as the context.
+ * @param recorder              Recorder to append to, cast as a void pointer
+ * @param data                  Sample to record
+ */
+METAWEAR_API void mbl_mw_recorder_write(void* recorder, const MblMwData* data);
+/**
+ * Subscribes to a data signal, recording all received data
+ * @param signal                Data signal to record
+ * @param recorder              Recorder to write the data to
+ */
+METAWEAR_API void mbl_mw_datasignal_record(MblMwDataSignal* signal, MblMwRecorder* recorder);
+/**
+ * Subscribes to a data logger, recording all downloaded data
+ * @param logger                Logger to record
+ * @param recorder              Recorder to write the data to
+ */
+METAWEAR_API void mbl_mw_logger_record(MblMwDataLogger* logger, MblMwRecorder* recorder);
+/**
+ * Retrieves the number of samples that were dropped because they did not match the recording's data type, or because 
+ * the background thread fell behind and no free chunk was left
+ * @param recorder              Recorder to query
+ * @return Number of dropped samples
+ */
+METAWEAR_API uint32_t mbl_mw_recorder_get_dropped(const MblMwRecorder* recorder);
+/**
+ * Closes the current chunk, even if it is not full, and blocks until all closed chunks are written to disk
+ * @param recorder              Recorder to flush
+ * @return MBL_MW_STATUS_OK if all chunks were written, MBL_MW_STATUS_ERROR_IO otherwise
+ */
+METAWEAR_API int32_t mbl_mw_recorder_flush(MblMwRecorder* recorder);
+/**
+ * Flushes remaining samples, writes the chunk index, and closes the file.  The recorder is freed and must not be used 
+ * again; unsubscribe any signals or loggers writing to it before calling this function.
+ * @param recorder              Recorder to close
+ * @return MBL_MW_STATUS_OK if the recording was completely written, MBL_MW_STATUS_ERROR_IO otherwise
+ */
+METAWEAR_API int32_t mbl_mw_recorder_close(MblMwRecorder* recorder);
+
+#ifdef	__cplusplus
+}
+#endif
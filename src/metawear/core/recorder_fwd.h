@@ -0,0 +1,16 @@
+/**
+ * @copyright MbientLab License
+ * @file recorder_fwd.h
+ * @brief Forward declaration for the MblMwRecorder type
+ */
+#pragma once
+
+/**
+ * Sink that writes received data to a columnar, chunked recording file.  An MblMwRecorder pointer is used as the
+ * context for the mbl_mw_recorder_write callback
+ */
+#ifdef	__cplusplus
+struct MblMwRecorder;
+#else
+typedef struct MblMwRecorder MblMwRecorder;
+#endif
@@ -0,0 +1,91 @@
+/**
+ * @copyright MbientLab License
+ * @file session_manager.h
+ * @brief Drives many boards from a fixed set of worker threads
+ * @details
+ * Boards added to a session manager run their response timeouts, and any work posted for them, on the manager's
+ * worker threads instead of a thread per timeout.  Each board is assigned to one worker and gets its own strand: work
+ * for the same board runs one function at a time, in the order it was posted, while different boards run in parallel.
+ * Workers that run out of work take queued boards and submitted work from busier workers, so the number of threads
+ * stays fixed no matter how many boards are added.
+ *
+ * Notifications handed to mbl_mw_session_manager_handle_notifications are decoded on the board's strand, serialized
+ * with its timeouts, so callbacks for a managed board are invoked from the worker threads.
+ */
+#pragma once
+
+#include "metawearboard.h"
+#include "session_manager_fwd.h"
+
+#include "metawear/platform/dllmarker.h"
+
+#include <stdint.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/**
+ * Creates a session manager and starts its worker threads
+ * @param n_workers         Number of worker threads, 0 to use one per hardware thread
+ * @return Pointer to the session manager
+ */
+METAWEAR_API MblMwSessionManager* mbl_mw_session_manager_create(uint32_t n_workers);
+/**
+ * Retrieves the number of worker threads the manager runs
+ * @param manager           Session manager to query
+ * @return Number of worker threads
+ */
+METAWEAR_API uint32_t mbl_mw_session_manager_get_n_workers(const MblMwSessionManager* manager);
+/**
+ * Adds a board to the manager, assigning it to the worker with the fewest boards.  Add a board before it is
+ * initialized or while it has no operations in progress.
+ * @param manager           Session manager to add the board to
+ * @param board             Board to add, must not belong to another manager
+ */
+METAWEAR_API void mbl_mw_session_manager_add_board(MblMwSessionManager* manager, MblMwMetaWearBoard* board);
+/**
+ * Removes a board from the manager, waiting for work already posted for it to finish.  The board goes back to
+ * running its timeouts on their own threads.  Remove a board before freeing it.
+ * @param manager           Session manager to remove the board from
+ * @param board             Board to remove
+ */
+METAWEAR_API void mbl_mw_session_manager_remove_board(MblMwSessionManager* manager, MblMwMetaWearBoard* board);
+/**
+ * Runs a function on the board's strand, after any work already posted for the board
+ * @param manager           Session manager the board was added to
+ * @param board             Board to run the function for, if it was not added, the function runs on any worker
+ * @param context           Pointer to additional data for the callback function
+ * @param fn                Function to run
+ */
+METAWEAR_API void mbl_mw_session_manager_post(MblMwSessionManager* manager, MblMwMetaWearBoard* board, void *context,
+        void (*fn)(void *context));
+/**
+ * Runs a function on whichever worker is free first.  Submitted functions are not ordered with respect to each other
+ * and can run in parallel, use them for decoding or processing that does not touch a board.
+ * @param manager           Session manager to run the function on
+ * @param context           Pointer to additional data for the callback function
+ * @param fn                Function to run
+ */
+METAWEAR_API void mbl_mw_session_manager_submit(MblMwSessionManager* manager, void *context, void (*fn)(void *context));
+/**
+ * Hands notifications to their boards' strands.  The values are copied so the caller can reuse them as soon as the
+ * function returns.  Notifications without an epoch are timestamped when this function is called.  Notifications for boards that were not added
+ * to a manager are handled on the calling thread.
+ * @param manager           Session manager the boards were added to
+ * @param notifications     Notifications in the order they were received
+ * @param n_notifications   Number of notifications
+ */
+METAWEAR_API void mbl_mw_session_manager_handle_notifications(MblMwSessionManager* manager,
+        const MblMwNotification* notifications, uint32_t n_notifications);
+/**
+ * Frees the manager once all posted and submitted work has run.  Boards still added to the manager go back to running
+ * their timeouts on their own threads, timeouts still pending are moved there.  Do not call this function from a
+ * worker thread.
+ * @param manager           Session manager to free
+ */
+METAWEAR_API void mbl_mw_session_manager_free(MblMwSessionManager* manager);
+
+#ifdef	__cplusplus
+}
+#endif
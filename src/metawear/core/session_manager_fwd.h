@@ -0,0 +1,15 @@
+/**
+ * @copyright MbientLab License
+ * @file session_manager_fwd.h
+ * @brief Forward declaration for the session manager type
+ */
+#pragma once
+
+/**
+ * Runs the work of many boards on a fixed set of worker threads
+ */
+#ifdef	__cplusplus
+struct MblMwSessionManager;
+#else
+typedef struct MblMwSessionManager MblMwSessionManager;
+#endif
@@ -0,0 +1,91 @@
+/**
+ * @copyright MbientLab License
+ * @file shm_publisher.h
+ * @brief Fans out data to other local processes through a POSIX shared memory ring
+ * @details
+ * A publisher is the single writer of a fixed size ring of samples.  Any number of readers, in this or other processes, 
+ * map the same ring and follow the writer with their own cursor; neither side makes a system call or takes a lock per 
+ * sample.  Readers that fall more than a ring's worth of samples behind skip ahead to the oldest sample still in the 
+ * ring and count the skipped samples as dropped.  Shared memory is not available on Windows, where the create and open 
+ * functions return null.
+ */
+#pragma once
+
+#include "data.h"
+#include "datasignal_fwd.h"
+#include "logging_fwd.h"
+#include "shm_publisher_fwd.h"
+
+#include "metawear/platform/dllmarker.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/** Largest MblMwData value, in bytes, that can be published */
+const uint8_t MBL_MW_SHM_MAX_VALUE_LENGTH = 40;
+
+/**
+ * Creates a shared memory ring, replacing any existing ring with the same name
+ * @param name                  Name of the shared memory object, must start with '/' e.g. "/metawear-acc"
+ * @param capacity              Number of samples the ring holds, rounded up to a power of 2
+ * @return Pointer to the publisher, null if the ring could not be created
+ */
+METAWEAR_API MblMwShmPublisher* mbl_mw_shm_publisher_create(const char* name, uint32_t capacity);
+/**
+ * Publishes a sample to all readers.  Samples whose value is longer than MBL_MW_SHM_MAX_VALUE_LENGTH, or that hold 
+ * pointers (MBL_MW_DT_ID_DATA_ARRAY), are dropped.  This function has the MblMwFnData signature and can be passed 
+ * directly to mbl_mw_datasignal_subscribe or mbl_mw_logger_subscribe with the publisher as the context.
+ * @param publisher             Publisher to write to, cast as a void pointer
+ * @param data                  Sample to publish
+ */
+METAWEAR_API void mbl_mw_shm_publisher_write(void* publisher, const MblMwData* data);
+/**
+ * Subscribes to a data signal, publishing all received data
+ * @param signal                Data signal to publish
+ * @param publisher             Publisher to write the data to
+ */
+METAWEAR_API void mbl_mw_datasignal_publish(MblMwDataSignal* signal, MblMwShmPublisher* publisher);
+/**
+ * Subscribes to a data logger, publishing all downloaded data
+ * @param logger                Logger to publish
+ * @param publisher             Publisher to write the data to
+ */
+METAWEAR_API void mbl_mw_logger_publish(MblMwDataLogger* logger, MblMwShmPublisher* publisher);
+/**
+ * Unmaps and removes the shared memory ring.  Readers that already opened the ring can still read the samples in it.  
+ * Unsubscribe any signals or loggers writing to the publisher before calling this function.
+ * @param publisher             Publisher to close
+ */
+METAWEAR_API void mbl_mw_shm_publisher_close(MblMwShmPublisher* publisher);
+
+/**
+ * Opens an existing shared memory ring for reading.  The reader starts at the ring's current write position and only 
+ * sees samples published after it was opened.
+ * @param name                  Name the ring was created with
+ * @return Pointer to the reader, null if the ring does not exist or is not a valid ring
+ */
+METAWEAR_API MblMwShmReader* mbl_mw_shm_reader_open(const char* name);
+/**
+ * Retrieves the next sample from the ring.  The value pointer refers to memory owned by the reader and remains valid 
+ * until the next call with the same reader.
+ * @param reader                Reader to retrieve the sample from
+ * @param data                  Filled in with the next sample
+ * @return 1 if a sample was retrieved, 0 if the reader has caught up with the publisher
+ */
+METAWEAR_API int32_t mbl_mw_shm_reader_next(MblMwShmReader* reader, MblMwData* data);
+/**
+ * Retrieves the number of samples the reader skipped because the publisher overwrote them before they were read
+ * @param reader                Reader to query
+ * @return Number of skipped samples
+ */
+METAWEAR_API uint64_t mbl_mw_shm_reader_get_dropped(const MblMwShmReader* reader);
+/**
+ * Unmaps the ring and frees the reader
+ * @param reader                Reader to close
+ */
+METAWEAR_API void mbl_mw_shm_reader_close(MblMwShmReader* reader);
+
+#ifdef	__cplusplus
+}
+#endif
@@ -0,0 +1,24 @@
+/**
+ * @copyright MbientLab License
+ * @file shm_publisher_fwd.h
+ * @brief Forward declarations for the shared memory publisher and reader types
+ */
+#pragma once
+
+/**
+ * Writes received data into a named shared memory ring that other processes can read from
+ */
+#ifdef	__cplusplus
+struct MblMwShmPublisher;
+#else
+typedef struct MblMwShmPublisher MblMwShmPublisher;
+#endif
+
+/**
+ * Reads data from a shared memory ring created by an MblMwShmPublisher, possibly in another process
+ */
+#ifdef	__cplusplus
+struct MblMwShmReader;
+#else
+typedef struct MblMwShmReader MblMwShmReader;
+#endif
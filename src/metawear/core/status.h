@@ -24,3 +24,7 @@ const int32_t MBL_MW_STATUS_ERROR_TIMEOUT = 16;
 const int32_t MBL_MW_STATUS_ERROR_SERIALIZATION_FORMAT = 32;
 /** Failed to enable notifications */
 const int32_t MBL_MW_STATUS_ERROR_ENABLE_NOTIFY = 64;
+/** Failed to read from or write to a file */
+const int32_t MBL_MW_STATUS_ERROR_IO = 128;
+/** Board does not have enough free resources, such as data processor slots, to complete the request */
+const int32_t MBL_MW_STATUS_ERROR_CAPACITY_EXCEEDED = 256;
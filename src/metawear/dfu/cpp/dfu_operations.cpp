@@ -1,8 +1,12 @@
 #include "dfu_operations.h"
 
+#include "metawear/core/cpp/metawearboard_def.h"
+
 #include <string.h>
 
-DfuOperations::DfuOperations(const MblMwMetaWearBoard* board, const MblMwDfuDelegate *delegate) : dfuRequests(new DFUOperationsDetails(board)), fileRequests(new FileOperations(*this, board)) {
+DfuOperations::DfuOperations(const MblMwMetaWearBoard* board, const MblMwDfuDelegate *delegate) : transferEngine(board->mtu), 
+        dfuRequests(new DFUOperationsDetails(board)), fileRequests(new FileOperations(*this, board, transferEngine)), 
+        onTransferRate(board->dfu_transfer_rate), bootloaderBoard(board) {
     memcpy(&this->dfuDelegate, delegate, sizeof(MblMwDfuDelegate));
 }
 
@@ -52,7 +56,9 @@ void DfuOperations::perfromDFUOnZipFile(const char *zipFilename) {
     //isStartingSecondFile = NO;
     //[self initParameters];
     //self.dfuFirmwareType = firmwareType;
-    fileRequests->openZip(zipFilename);
+    if (!fileRequests->open(zipFilename)) {
+        return;
+    }
     //[dfuRequests enableNotification];
     dfuRequests->startDFU(APPLICATION);
     dfuRequests->writeFileSize(static_cast<uint32_t>(fileRequests->binFileSize));
@@ -64,7 +70,9 @@ void DfuOperations::performOldDFUOnFile(const char *firmwareFilename) {
     if (firmwareFilename) {
 //        [self initFirstMBL_FileOperations];
 //        [self initParameters];
-        fileRequests->openFile(firmwareFilename);
+        if (!fileRequests->open(firmwareFilename)) {
+            return;
+        }
 //        [dfuRequests enableNotification];
         dfuRequests->startOldDFU();
         dfuRequests->writeFileSizeForOldDFU(static_cast<uint32_t>(fileRequests->binFileSize));
@@ -109,7 +117,9 @@ void DfuOperations::startSendingFile() {
     //        });
     //    }
     //    else {
-    dfuRequests->enablePacketNotification();
+    WriteBatch batch(bootloaderBoard);
+    transferEngine.start();
+    dfuRequests->enablePacketNotification(transferEngine.getReceiptInterval());
     dfuRequests->receiveFirmwareImage();
     fileRequests->writeNextPacket();
     dfuDelegate.on_dfu_started(dfuDelegate.context);
@@ -249,8 +259,26 @@ void DfuOperations::processValidateFirmwareResponseStatus() {
     }
 }
 
-void DfuOperations::processPacketNotification() {
+void DfuOperations::processPacketNotification(const uint8_t *data, uint8_t len) {
     //NSLog(@"received Packet Received Notification");
+    WriteBatch batch(bootloaderBoard);
+    if (len >= 5) {
+        uint32_t bytesReceived;
+        memcpy(&bytesReceived, data + 1, sizeof(bytesReceived));
+
+        uint16_t prevInterval = transferEngine.getReceiptInterval();
+        if (!transferEngine.onReceipt(bytesReceived)) {
+            dfuDelegate.on_error(dfuDelegate.context, "Error on Packet Receipt: bytes received does not match bytes sent");
+            dfuRequests->resetSystem();
+            return;
+        }
+        if (onTransferRate) {
+            onTransferRate(dfuDelegate.context, transferEngine.getBytesPerSecond());
+        }
+        if (fileRequests->writingPacketNumber < fileRequests->numberOfPackets && prevInterval != transferEngine.getReceiptInterval()) {
+            dfuRequests->enablePacketNotification(transferEngine.getReceiptInterval());
+        }
+    }
 //    if (isStartingSecondFile) {
 //        if (fileRequests2.writingPacketNumber < fileRequests2.numberOfPackets) {
 //            [fileRequests2 writeNextPacket];
@@ -270,7 +298,7 @@ void DfuOperations::processDFUResponse(const uint8_t *data, uint8_t len) {
         processRequestedCode();
     }
     else if (dfuResponse.responseCode == PACKET_RECEIPT_NOTIFICATION_RESPONSE) {
-        processPacketNotification();
+        processPacketNotification(data, len);
     }
 }
 
@@ -341,3 +369,9 @@ void DfuOperations::onError(const std::string &errorMessage) {
 //    NSLog(@"MBL_DFUOperations: onError");
     dfuDelegate.on_error(dfuDelegate.context, errorMessage.c_str());
 }
+
+void DfuOperations::onReadError(const std::string &errorMessage) {
+    // the bootloader is already receiving the image, reset it so the board does not stay in DFU mode
+    dfuDelegate.on_error(dfuDelegate.context, errorMessage.c_str());
+    dfuRequests->resetSystem();
+}
@@ -16,6 +16,7 @@
 #include "dfu_operations_details.h"
 #include "dfu_utility.h"
 #include "file_operations.h"
+#include "transfer_engine.h"
 #include "metawear/core/metawearboard.h"
 //#import "MBL_BLEOperations.h"
 
@@ -49,6 +50,7 @@ class DfuOperations : public FileOperationsDelegate {
     //@property (nonatomic) CBCharacteristic *dfuControlPointCharacteristic;
     //
     //@property (nonatomic) MBL_BLEOperations *bleOperations;
+    DfuTransferEngine transferEngine;
     std::unique_ptr<DFUOperationsDetails> dfuRequests;
     std::unique_ptr<FileOperations> fileRequests;
     //@property (nonatomic) MBL_FileOperations *fileRequests2;
@@ -59,6 +61,8 @@ class DfuOperations : public FileOperationsDelegate {
     struct DFUResponse dfuResponse;
     
     MblMwDfuDelegate dfuDelegate;
+    void (*onTransferRate)(void *context, float bytes_per_second);
+    const MblMwMetaWearBoard* bootloaderBoard;
     
     bool isVersionCharacteristicExist;
     bool isPerformedOldDFU;
@@ -70,7 +74,7 @@ class DfuOperations : public FileOperationsDelegate {
     void processValidateFirmwareResponseStatus();
     void processInitPacketResponseStatus();
     
-    void processPacketNotification();
+    void processPacketNotification(const uint8_t *data, uint8_t len);
     
     void startSendingFile();
 
@@ -79,6 +83,7 @@ class DfuOperations : public FileOperationsDelegate {
     void onAllPacketsTranferred();
     void onFileOpened(size_t);
     void onError(const std::string &);
+    void onReadError(const std::string &);
     
 public:
     DfuOperations(const MblMwMetaWearBoard* board, const MblMwDfuDelegate *delegate);
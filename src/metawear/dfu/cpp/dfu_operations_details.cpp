@@ -48,8 +48,8 @@ void DFUOperationsDetails::writeFileSizeForOldDFU(uint32_t firmwareSize) {
     bootloaderBoard->write_gatt_char(&DFU_PACKET_CHAR, MBL_MW_GATT_CHAR_WRITE_WITHOUT_RESPONSE, (uint8_t *)&firmwareSize, sizeof(firmwareSize));
 }
 
-void DFUOperationsDetails::enablePacketNotification() {
-    uint8_t value[] = { PACKET_RECEIPT_NOTIFICATION_REQUEST, (uint8_t)MBL_PACKETS_NOTIFICATION_INTERVAL, 0} ;
+void DFUOperationsDetails::enablePacketNotification(uint16_t interval) {
+    uint8_t value[] = { PACKET_RECEIPT_NOTIFICATION_REQUEST, (uint8_t)(interval & 0xff), (uint8_t)(interval >> 8)} ;
     bootloaderBoard->write_gatt_char(&DFU_CONTROL_POINT_CHAR, MBL_MW_GATT_CHAR_WRITE_WITH_RESPONSE, value, sizeof(value)/sizeof(value[0]));
 }
 void DFUOperationsDetails::receiveFirmwareImage() {
@@ -72,11 +72,13 @@ void DFUOperationsDetails::resetSystem() {
     bootloaderBoard->write_gatt_char(&DFU_CONTROL_POINT_CHAR, MBL_MW_GATT_CHAR_WRITE_WITH_RESPONSE, value, sizeof(value)/sizeof(value[0]));
 }
 
-void DFUOperationsDetails::sendInitPacket(uint8_t *fileData, int fileDataLength) {
+void DFUOperationsDetails::sendInitPacket(const uint8_t *fileData, int fileDataLength) {
     int numberOfPackets = std::ceil((double)fileDataLength / (double)MBL_PACKET_SIZE);
-    int bytesInLastPacket = fileDataLength % 20;
+    int bytesInLastPacket = fileDataLength - (numberOfPackets - 1) * MBL_PACKET_SIZE;
     //NSLog(@"metaDataFile length: %lu and number of packets: %d",(unsigned long)[fileData length], numberOfPackets);
     
+    WriteBatch batch(bootloaderBoard);
+
     //send initPacket with parameter value set to Receive Init Packet [0] to dfu Control Point Characteristic
     uint8_t initPacketStart[] = {INITIALIZE_DFU_PARAMETERS_REQUEST, START_INIT_PACKET};
     bootloaderBoard->write_gatt_char(&DFU_CONTROL_POINT_CHAR, MBL_MW_GATT_CHAR_WRITE_WITH_RESPONSE, (uint8_t *)&initPacketStart, sizeof(initPacketStart));
@@ -85,12 +87,12 @@ void DFUOperationsDetails::sendInitPacket(uint8_t *fileData, int fileDataLength)
     // for longer .dat file the data need to be chopped into 20 bytes
     for (int index = 0; index < numberOfPackets-1; index++) {
         //chopping data into 20 bytes packet
-        uint8_t *packetData = &fileData[index * MBL_PACKET_SIZE];
+        const uint8_t *packetData = &fileData[index * MBL_PACKET_SIZE];
         //writing 20 bytes packet to peripheral
         bootloaderBoard->write_gatt_char(&DFU_PACKET_CHAR, MBL_MW_GATT_CHAR_WRITE_WITHOUT_RESPONSE, packetData, MBL_PACKET_SIZE);
     }
     //chopping data for last packet that can be less than 20 bytes
-    uint8_t *packetData = &fileData[(numberOfPackets - 1) * MBL_PACKET_SIZE];
+    const uint8_t *packetData = &fileData[(numberOfPackets - 1) * MBL_PACKET_SIZE];
     //writing last packet
     bootloaderBoard->write_gatt_char(&DFU_PACKET_CHAR, MBL_MW_GATT_CHAR_WRITE_WITHOUT_RESPONSE, packetData, bytesInLastPacket);
     
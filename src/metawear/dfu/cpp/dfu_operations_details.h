@@ -19,12 +19,12 @@ public:
     void writeFileSize(uint32_t firmwareSize);
     //void writeFilesSizes:(uint32_t)softdeviceSize bootloaderSize:(uint32_t)bootloaderSize;
     void writeFileSizeForOldDFU(uint32_t firmwareSize);
-    void enablePacketNotification();
+    void enablePacketNotification(uint16_t interval);
     void receiveFirmwareImage();
     void validateFirmware();
     void activateAndReset();
     void resetSystem();
     
     //Init Packet is included in new DFU in SDK 7.0
-    void sendInitPacket(uint8_t *fileData, int fileDataLength);
+    void sendInitPacket(const uint8_t *fileData, int fileDataLength);
 };
@@ -0,0 +1,260 @@
+#include "metawear/core/dfu_orchestrator.h"
+#include "metawear/core/metawearboard.h"
+
+#include "firmware_image.h"
+
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using std::deque;
+using std::function;
+using std::lock_guard;
+using std::memcpy;
+using std::mutex;
+using std::shared_ptr;
+using std::string;
+using std::unique_lock;
+using std::unique_ptr;
+using std::vector;
+
+struct DfuSession {
+    MblMwDfuOrchestrator* orchestrator;
+    MblMwMetaWearBoard* board;
+    int32_t percentage;
+    bool finished;
+};
+
+struct MblMwDfuOrchestrator {
+    string filename;
+    // keeps the image cached for every session
+    shared_ptr<const FirmwareImage> image;
+    uint32_t max_concurrent;
+    MblMwDfuOrchestratorDelegate delegate;
+    MblMwDfuDelegate session_delegate;
+
+    mutex lock;
+    vector<unique_ptr<DfuSession>> sessions;
+    size_t next_session;
+    uint32_t n_active;
+    int32_t n_succeeded, n_failed, percentage;
+    // delegate callbacks waiting to be invoked, in the order they happened, and whether a thread is invoking them
+    deque<function<void(void)>> reports;
+    bool delivering;
+};
+
+// Helper function - queues a delegate callback with the lock held, returns true if the caller has to deliver the queue
+static bool queue_report(MblMwDfuOrchestrator* orchestrator, function<void(void)> report) {
+    orchestrator->reports.push_back(std::move(report));
+    if (orchestrator->delivering) {
+        return false;
+    }
+    orchestrator->delivering = true;
+    return true;
+}
+
+// Helper function - invokes the queued callbacks in order without the lock held, the dfu handlers hold their board's 
+// lock so a delegate waiting on another board would otherwise deadlock with it
+static void deliver_reports(MblMwDfuOrchestrator* orchestrator) {
+    unique_lock<mutex> lock(orchestrator->lock);
+    while(!orchestrator->reports.empty()) {
+        auto report = std::move(orchestrator->reports.front());
+        orchestrator->reports.pop_front();
+        // on_finished is reported last, the orchestrator may be freed as soon as it is called
+        bool last = orchestrator->reports.empty() && 
+                static_cast<size_t>(orchestrator->n_succeeded + orchestrator->n_failed) == orchestrator->sessions.size();
+        lock.unlock();
+
+        report();
+        if (last) {
+            return;
+        }
+        lock.lock();
+    }
+    orchestrator->delivering = false;
+}
+
+// Helper function - starts queued sessions until the concurrency limit is reached
+static void start_sessions(MblMwDfuOrchestrator* orchestrator) {
+    vector<DfuSession*> starting;
+    {
+        lock_guard<mutex> lock(orchestrator->lock);
+        while(orchestrator->next_session < orchestrator->sessions.size() &&
+                (orchestrator->max_concurrent == 0 || orchestrator->n_active < orchestrator->max_concurrent)) {
+            starting.push_back(orchestrator->sessions[orchestrator->next_session].get());
+            orchestrator->next_session++;
+            orchestrator->n_active++;
+        }
+    }
+
+    // the perform_dfu call can finish a session before returning so the lock cannot be held
+    for(auto it: starting) {
+        MblMwDfuDelegate delegate = it->orchestrator->session_delegate;
+        delegate.context = it;
+        mbl_mw_metawearboard_perform_dfu(it->board, &delegate, orchestrator->filename.c_str());
+    }
+}
+
+// Helper function - recomputes the average percentage with the lock held, returns true if it changed
+static bool update_percentage(MblMwDfuOrchestrator* orchestrator) {
+    int64_t sum = 0;
+    for(auto& it: orchestrator->sessions) {
+        sum += it->percentage;
+    }
+
+    int32_t percentage = static_cast<int32_t>(sum / orchestrator->sessions.size());
+    if (percentage == orchestrator->percentage) {
+        return false;
+    }
+    orchestrator->percentage = percentage;
+    return true;
+}
+
+// Helper function - records a finished session and moves on to the next queued one
+static void session_finished(DfuSession* session, const char *error) {
+    auto orchestrator = session->orchestrator;
+    auto delegate = orchestrator->delegate;
+    auto board = session->board;
+    // copied as the error message only lives for the duration of the dfu callback
+    string message = error ? error : "";
+    bool done, deliver;
+    {
+        lock_guard<mutex> lock(orchestrator->lock);
+        if (session->finished) {
+            return;
+        }
+
+        session->finished = true;
+        session->percentage = 100;
+        orchestrator->n_active--;
+        if (error) {
+            orchestrator->n_failed++;
+        } else {
+            orchestrator->n_succeeded++;
+        }
+
+        deliver = queue_report(orchestrator, [delegate, board, message, error]() {
+            if (delegate.on_board_finished) {
+                delegate.on_board_finished(delegate.context, board, error ? message.c_str() : nullptr);
+            }
+        });
+        if (update_percentage(orchestrator) && delegate.on_progress) {
+            int32_t percentage = orchestrator->percentage;
+            queue_report(orchestrator, [delegate, percentage]() {
+                delegate.on_progress(delegate.context, percentage);
+            });
+        }
+
+        int32_t n_succeeded = orchestrator->n_succeeded, n_failed = orchestrator->n_failed;
+        done = static_cast<size_t>(n_succeeded + n_failed) == orchestrator->sessions.size();
+        if (done) {
+            queue_report(orchestrator, [delegate, n_succeeded, n_failed]() {
+                if (delegate.on_finished) {
+                    delegate.on_finished(delegate.context, n_succeeded, n_failed);
+                }
+            });
+        }
+    }
+
+    if (!done) {
+        start_sessions(orchestrator);
+    }
+    if (deliver) {
+        deliver_reports(orchestrator);
+    }
+}
+
+static void on_dfu_started(void *context) {
+}
+
+static void on_dfu_cancelled(void *context) {
+    session_finished(static_cast<DfuSession*>(context), "DFU cancelled");
+}
+
+static void on_transfer_percentage(void *context, int32_t percentage) {
+    auto session = static_cast<DfuSession*>(context);
+    auto orchestrator = session->orchestrator;
+    auto delegate = orchestrator->delegate;
+    bool deliver;
+    {
+        lock_guard<mutex> lock(orchestrator->lock);
+        if (session->finished) {
+            return;
+        }
+
+        // the upload reaches 100% before the firmware is validated, only a finished session counts in full
+        session->percentage = percentage < 100 ? percentage : 99;
+        if (!update_percentage(orchestrator) || !delegate.on_progress) {
+            return;
+        }
+
+        int32_t average = orchestrator->percentage;
+        deliver = queue_report(orchestrator, [delegate, average]() {
+            delegate.on_progress(delegate.context, average);
+        });
+    }
+
+    if (deliver) {
+        deliver_reports(orchestrator);
+    }
+}
+
+static void on_successful_file_transferred(void *context) {
+    session_finished(static_cast<DfuSession*>(context), nullptr);
+}
+
+static void on_error(void *context, const char *errorMessage) {
+    session_finished(static_cast<DfuSession*>(context), errorMessage);
+}
+
+MblMwDfuOrchestrator* mbl_mw_dfu_orchestrator_create(const char *filename, uint32_t max_concurrent,
+        const MblMwDfuOrchestratorDelegate *delegate) {
+    string error;
+    auto image = openFirmwareImage(filename, error);
+    if (!image) {
+        return nullptr;
+    }
+
+    MblMwDfuOrchestrator* orchestrator = new MblMwDfuOrchestrator;
+    orchestrator->filename = filename;
+    orchestrator->image = image;
+    orchestrator->max_concurrent = max_concurrent;
+    memcpy(&orchestrator->delegate, delegate, sizeof(MblMwDfuOrchestratorDelegate));
+    orchestrator->session_delegate = { nullptr, on_dfu_started, on_dfu_cancelled, on_transfer_percentage, on_successful_file_transferred,
+            on_error };
+    orchestrator->next_session = 0;
+    orchestrator->n_active = 0;
+    orchestrator->n_succeeded = 0;
+    orchestrator->n_failed = 0;
+    orchestrator->percentage = 0;
+    orchestrator->delivering = false;
+    return orchestrator;
+}
+
+void mbl_mw_dfu_orchestrator_add_board(MblMwDfuOrchestrator* orchestrator, MblMwMetaWearBoard* board) {
+    lock_guard<mutex> lock(orchestrator->lock);
+    orchestrator->sessions.emplace_back(new DfuSession{ orchestrator, board, 0, false });
+}
+
+void mbl_mw_dfu_orchestrator_start(MblMwDfuOrchestrator* orchestrator) {
+    bool empty;
+    {
+        lock_guard<mutex> lock(orchestrator->lock);
+        empty = orchestrator->sessions.empty();
+    }
+    if (empty) {
+        if (orchestrator->delegate.on_finished) {
+            orchestrator->delegate.on_finished(orchestrator->delegate.context, 0, 0);
+        }
+        return;
+    }
+    start_sessions(orchestrator);
+}
+
+void mbl_mw_dfu_orchestrator_free(MblMwDfuOrchestrator* orchestrator) {
+    delete orchestrator;
+}
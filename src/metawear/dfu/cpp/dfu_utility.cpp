@@ -1,4 +1,6 @@
 #include "dfu_utility.h"
 
-int  MBL_PACKETS_NOTIFICATION_INTERVAL = 10;
+int const MBL_PACKETS_NOTIFICATION_INTERVAL = 10;
+int const MBL_MAX_PACKETS_NOTIFICATION_INTERVAL = 100;
 int const MBL_PACKET_SIZE = 20;
+int const MBL_MAX_PACKET_SIZE = 244;
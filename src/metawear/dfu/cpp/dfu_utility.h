@@ -25,8 +25,12 @@
 //
 //
 
-extern int MBL_PACKETS_NOTIFICATION_INTERVAL;
+/** Packets sent between receipt notifications when a transfer starts */
+extern int const MBL_PACKETS_NOTIFICATION_INTERVAL;
+extern int const MBL_MAX_PACKETS_NOTIFICATION_INTERVAL;
+/** Packet size for the default 23 byte MTU */
 extern int const MBL_PACKET_SIZE;
+extern int const MBL_MAX_PACKET_SIZE;
 
 struct DFUResponse
 {
@@ -1,10 +1,16 @@
 #pragma once
 
+#include <memory>
 #include <stdint.h>
+#include <string>
 #include <vector>
 
 #include "metawear/core/metawearboard_fwd.h"
 
+class DfuTransferEngine;
+class FirmwareImage;
+class FirmwareReader;
+
 struct FileOperationsDelegate {
     virtual ~FileOperationsDelegate() = 0;
     // define callback interface functions
@@ -12,28 +18,33 @@ struct FileOperationsDelegate {
     virtual void onAllPacketsTranferred() = 0;
     virtual void onFileOpened(size_t) = 0;
     virtual void onError(const std::string &) = 0;
+    // the image could not be read after the transfer started
+    virtual void onReadError(const std::string &) = 0;
 };
 
 class FileOperations {
-    uint8_t *binFile;
+    std::shared_ptr<const FirmwareImage> image;
+    std::unique_ptr<FirmwareReader> reader;
+    std::vector<uint8_t> packet;
     int bytesInLastPacket;
     int prevPercentage;
     
     FileOperationsDelegate &fileDelegate;
     const MblMwMetaWearBoard* bootloaderBoard;
+    DfuTransferEngine &transferEngine;
+
+    void slicePackets();
 public:
     size_t binFileSize;
     int numberOfPackets;
     int writingPacketNumber;
     
-    uint8_t *metaDataFile;
+    const uint8_t *metaDataFile;
     size_t metaDataFileSize;
     
-    FileOperations(FileOperationsDelegate &fileDelegate, const MblMwMetaWearBoard* board);
+    FileOperations(FileOperationsDelegate &fileDelegate, const MblMwMetaWearBoard* board, DfuTransferEngine &transferEngine);
     ~FileOperations();
     
-    void openFile(const char* filename);
+    bool open(const char* filename);
     void writeNextPacket();
-    
-    void openZip(const char *filename);
 };
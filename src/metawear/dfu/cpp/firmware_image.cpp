@@ -0,0 +1,314 @@
+#include "firmware_image.h"
+
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "miniz.h"
+#include "json.hpp"
+
+using std::lock_guard;
+using std::memcpy;
+using std::min;
+using std::mutex;
+using std::shared_ptr;
+using std::string;
+using std::unique_ptr;
+using std::unordered_map;
+using std::vector;
+using std::weak_ptr;
+
+FirmwareReader::~FirmwareReader() {
+}
+
+FirmwareImage::FirmwareImage() : binFileSize(0) {
+}
+
+FirmwareImage::~FirmwareImage() {
+}
+
+/**
+ * Plain firmware file, memory-mapped so every session reads from the same pages.  Windows has no mmap, the file is 
+ * read into memory instead.
+ */
+class MappedImage : public FirmwareImage {
+    class Reader : public FirmwareReader {
+        const MappedImage &image;
+        size_t offset;
+    public:
+        Reader(const MappedImage &image) : image(image), offset(0) {
+        }
+
+        size_t read(uint8_t *buffer, size_t length) {
+            size_t n = min(length, image.binFileSize - offset);
+            memcpy(buffer, image.contents + offset, n);
+            offset += n;
+            return n;
+        }
+
+        bool finish(string &error) {
+            return true;
+        }
+    };
+
+    const uint8_t *contents;
+#ifdef _WIN32
+    vector<uint8_t> buffer;
+#endif
+
+public:
+    MappedImage() : contents(nullptr) {
+    }
+
+    ~MappedImage() {
+#ifndef _WIN32
+        if (contents) {
+            munmap(const_cast<uint8_t *>(contents), binFileSize);
+        }
+#endif
+    }
+
+    bool open(const char *filename, string &error) {
+#ifndef _WIN32
+        int fd = ::open(filename, O_RDONLY);
+        if (fd == -1) {
+            error = "failed to open file";
+            return false;
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) == -1 || info.st_size <= 0) {
+            close(fd);
+            error = "0 length file";
+            return false;
+        }
+
+        void *memory = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // the mapping holds its own reference to the file
+        close(fd);
+        if (memory == MAP_FAILED) {
+            error = "failed to map file";
+            return false;
+        }
+        binFileSize = info.st_size;
+        contents = static_cast<const uint8_t *>(memory);
+        return true;
+#else
+        std::ifstream file(filename, std::ifstream::in | std::ifstream::binary);
+        if (!file) {
+            error = "failed to open file";
+            return false;
+        }
+        file.seekg(0, std::ios::end);
+        std::streampos length(file.tellg());
+        if (length <= 0) {
+            error = "0 length file";
+            return false;
+        }
+
+        file.seekg(0, std::ios::beg);
+        buffer.resize(static_cast<size_t>(length));
+        if (!file.read((char *)buffer.data(), buffer.size())) {
+            error = "failed to read file";
+            return false;
+        }
+        binFileSize = buffer.size();
+        contents = buffer.data();
+        return true;
+#endif
+    }
+
+    unique_ptr<FirmwareReader> openReader(string &error) const {
+        return unique_ptr<FirmwareReader>(new Reader(*this));
+    }
+};
+
+/**
+ * Nordic DFU zip package.  Only the manifest and init packet are held in memory, each reader inflates the application 
+ * binary from the archive in small chunks.
+ */
+class ZipImage : public FirmwareImage {
+    class Reader : public FirmwareReader {
+        mz_zip_archive archive;
+        mz_zip_reader_extract_iter_state *state;
+    public:
+        Reader() : state(nullptr) {
+            memset(&archive, 0, sizeof(archive));
+        }
+
+        ~Reader() {
+            if (state) {
+                mz_zip_reader_extract_iter_free(state);
+            }
+            mz_zip_reader_end(&archive);
+        }
+
+        bool open(const ZipImage &image, string &error) {
+            if (!mz_zip_reader_init_file(&archive, image.filename.c_str(), MZ_ZIP_FLAG_DO_NOT_SORT_CENTRAL_DIRECTORY)) {
+                error = "mz_zip_reader_init_file() failed!";
+                return false;
+            }
+            state = mz_zip_reader_extract_file_iter_new(&archive, image.firmwareFilename.c_str(), 0);
+            if (!state) {
+                error = "mz_zip_reader_extract_file_iter_new() failed!";
+                return false;
+            }
+            return true;
+        }
+
+        size_t read(uint8_t *buffer, size_t length) {
+            return mz_zip_reader_extract_iter_read(state, buffer, length);
+        }
+
+        bool finish(string &error) {
+            // freeing the state compares the inflated size and crc with the archive's
+            bool intact = mz_zip_reader_extract_iter_free(state) != MZ_FALSE;
+            state = nullptr;
+            if (!intact) {
+                error = "firmware image failed the zip crc check";
+            }
+            return intact;
+        }
+    };
+
+    string filename, firmwareFilename;
+
+public:
+    bool open(const char *filename, string &error) {
+        int i;
+        size_t uncomp_size;
+        mz_zip_archive zip_archive;
+        void *p;
+        string metadataFilename;
+
+        memset(&zip_archive, 0, sizeof(zip_archive));
+        if (!mz_zip_reader_init_file(&zip_archive, filename, MZ_ZIP_FLAG_DO_NOT_SORT_CENTRAL_DIRECTORY)) {
+            error = "mz_zip_reader_init_file() failed!";
+            return false;
+        }
+        
+        for (i = 0; i < (int)mz_zip_reader_get_num_files(&zip_archive); i++) {
+            mz_zip_archive_file_stat file_stat;
+            if (!mz_zip_reader_file_stat(&zip_archive, i, &file_stat)) {
+                error = "mz_zip_reader_file_stat() failed!";
+                mz_zip_reader_end(&zip_archive);
+                return false;
+            }
+            if (string(file_stat.m_filename) == "manifest.json") {
+                // Try to extract the manifest to the heap
+                p = mz_zip_reader_extract_file_to_heap(&zip_archive, file_stat.m_filename, &uncomp_size, 0);
+                if (!p) {
+                    error = "mz_zip_reader_extract_file_to_heap() failed!";
+                    mz_zip_reader_end(&zip_archive);
+                    return false;
+                }
+                // Pull out the firmware and data filenames
+                auto manifest = nlohmann::json::parse(string((const char *)p, uncomp_size));
+                auto it = manifest.find("manifest");
+                if (it != manifest.end()) {
+                    auto it1 = it->find("application");
+                    if (it1 != it->end()) {
+                        auto it2 = it1->find("bin_file");
+                        if (it2 != it1->end()) {
+                            firmwareFilename = *it2;
+                        }
+                        auto it3 = it1->find("dat_file");
+                        if (it3 != it1->end()) {
+                            metadataFilename = *it3;
+                        }
+                    }
+                }
+                // We're done.
+                mz_free(p);
+            }
+        }
+        
+        if (metadataFilename.empty() || firmwareFilename.empty()) {
+            error = "error parsing manifest";
+            mz_zip_reader_end(&zip_archive);
+            return false;
+        }
+
+        // The init packet is a few dozen bytes, keep it in memory
+        p = mz_zip_reader_extract_file_to_heap(&zip_archive, metadataFilename.c_str(), &uncomp_size, 0);
+        if (!p) {
+            error = "mz_zip_reader_extract_file_to_heap() failed!";
+            mz_zip_reader_end(&zip_archive);
+            return false;
+        }
+        metaDataFile.assign(static_cast<uint8_t *>(p), static_cast<uint8_t *>(p) + uncomp_size);
+        mz_free(p);
+
+        // Only the binary's size is needed up front, it is inflated as it is sent
+        int index = mz_zip_reader_locate_file(&zip_archive, firmwareFilename.c_str(), nullptr, 0);
+        mz_zip_archive_file_stat file_stat;
+        if (index < 0 || !mz_zip_reader_file_stat(&zip_archive, index, &file_stat)) {
+            error = "mz_zip_reader_locate_file() failed!";
+            mz_zip_reader_end(&zip_archive);
+            return false;
+        }
+        binFileSize = static_cast<size_t>(file_stat.m_uncomp_size);
+        
+        mz_zip_reader_end(&zip_archive);
+        this->filename = filename;
+        return true;
+    }
+
+    unique_ptr<FirmwareReader> openReader(string &error) const {
+        unique_ptr<Reader> reader(new Reader());
+        if (!reader->open(*this, error)) {
+            return nullptr;
+        }
+        return std::move(reader);
+    }
+};
+
+static mutex cacheLock;
+static unordered_map<string, weak_ptr<const FirmwareImage>> cache;
+
+// Helper function - has suffix
+static bool hasSuffix(const string &str, const string &suffix) {
+    return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+shared_ptr<const FirmwareImage> openFirmwareImage(const char *filename, string &error) {
+    lock_guard<mutex> lock(cacheLock);
+
+    auto it = cache.find(filename);
+    if (it != cache.end()) {
+        if (auto cached = it->second.lock()) {
+            return cached;
+        }
+        cache.erase(it);
+    }
+
+    shared_ptr<FirmwareImage> image;
+    if (hasSuffix(filename, "zip")) {
+        auto zip = std::make_shared<ZipImage>();
+        if (!zip->open(filename, error)) {
+            return nullptr;
+        }
+        image = zip;
+    } else {
+        auto mapped = std::make_shared<MappedImage>();
+        if (!mapped->open(filename, error)) {
+            return nullptr;
+        }
+        image = mapped;
+    }
+    if (image->binFileSize == 0) {
+        error = "0 length file";
+        return nullptr;
+    }
+
+    cache[filename] = image;
+    return image;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * Reads a firmware image's application binary from start to end.  Each DFU session has its own reader.
+ */
+class FirmwareReader {
+public:
+    virtual ~FirmwareReader() = 0;
+    /**
+     * Copies the next bytes of the binary into the buffer
+     * @return Number of bytes copied, less than length only at the end of the binary or on error
+     */
+    virtual size_t read(uint8_t *buffer, size_t length) = 0;
+    /**
+     * Checks the binary was read intact, called once every byte has been read
+     * @param error     Set to the reason the check failed
+     * @return True if the binary is intact
+     */
+    virtual bool finish(std::string &error) = 0;
+};
+
+/**
+ * Firmware package, read-only once opened and shared by every DFU session uploading the same file.  Plain files are 
+ * memory-mapped and zip entries are inflated as they are read, so a session's memory use does not depend on the 
+ * firmware size.
+ */
+class FirmwareImage {
+public:
+    size_t binFileSize;
+    std::vector<uint8_t> metaDataFile;
+
+    FirmwareImage();
+    virtual ~FirmwareImage() = 0;
+    /**
+     * Creates a reader positioned at the start of the binary
+     * @param error     Set to the reason the reader could not be created
+     * @return Null if the reader could not be created
+     */
+    virtual std::unique_ptr<FirmwareReader> openReader(std::string &error) const = 0;
+};
+
+/**
+ * Opens a firmware image.  Images stay cached while a session holds them so concurrent uploads of the same file 
+ * open it once.
+ * @param filename      Path to the firmware bin or zip file
+ * @param error         Set to the reason the file could not be opened
+ * @return Null if the file could not be opened
+ */
+std::shared_ptr<const FirmwareImage> openFirmwareImage(const char *filename, std::string &error);
@@ -0,0 +1,71 @@
+#include "transfer_engine.h"
+#include "dfu_utility.h"
+
+#include <algorithm>
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using std::max;
+using std::micro;
+using std::min;
+
+// ATT write commands carry 3 bytes of header
+const uint16_t ATT_HEADER_SIZE = 3;
+// window time per packet, relative to the smoothed time, that is treated as congestion
+const double CONGESTION_RATIO = 1.5, SMOOTHING_GAIN = 0.125;
+
+DfuTransferEngine::DfuTransferEngine(uint16_t mtu) : 
+        packetSize(static_cast<uint8_t>(min<int>(MBL_MAX_PACKET_SIZE, max<int>(MBL_PACKET_SIZE, mtu - ATT_HEADER_SIZE)))), 
+        receiptInterval(MBL_PACKETS_NOTIFICATION_INTERVAL), bytesSent(0), packetsInWindow(0), smoothedPacketTime(0), 
+        bytesPerSecond(0) {
+}
+
+uint8_t DfuTransferEngine::getPacketSize() const {
+    return packetSize;
+}
+
+uint16_t DfuTransferEngine::getReceiptInterval() const {
+    return receiptInterval;
+}
+
+float DfuTransferEngine::getBytesPerSecond() const {
+    return bytesPerSecond;
+}
+
+void DfuTransferEngine::start() {
+    receiptInterval = MBL_PACKETS_NOTIFICATION_INTERVAL;
+    bytesSent = 0;
+    packetsInWindow = 0;
+    smoothedPacketTime = 0;
+    bytesPerSecond = 0;
+    transferStart = windowStart = steady_clock::now();
+}
+
+void DfuTransferEngine::onPacketSent(uint8_t length) {
+    bytesSent += length;
+    packetsInWindow++;
+}
+
+bool DfuTransferEngine::onReceipt(uint32_t bytesReceived) {
+    if (bytesReceived != bytesSent) {
+        return false;
+    }
+
+    auto now = steady_clock::now();
+    double packetTime = duration<double, micro>(now - windowStart).count() / max<uint16_t>(1, packetsInWindow);
+    if (smoothedPacketTime != 0 && packetTime > smoothedPacketTime * CONGESTION_RATIO) {
+        receiptInterval = max(1, receiptInterval / 2);
+    } else {
+        receiptInterval = min<int>(MBL_MAX_PACKETS_NOTIFICATION_INTERVAL, receiptInterval + max(1, receiptInterval / 4));
+    }
+    smoothedPacketTime = smoothedPacketTime == 0 ? packetTime : smoothedPacketTime + SMOOTHING_GAIN * (packetTime - smoothedPacketTime);
+
+    double elapsed = duration<double>(now - transferStart).count();
+    if (elapsed > 0) {
+        bytesPerSecond = static_cast<float>(bytesSent / elapsed);
+    }
+
+    windowStart = now;
+    packetsInWindow = 0;
+    return true;
+}
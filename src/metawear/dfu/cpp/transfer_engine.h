@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+#include <stdint.h>
+
+/**
+ * Paces the firmware image transfer.  Packets are as large as the connection's MTU allows and the number of packets 
+ * sent between receipt notifications adapts to the link: it grows while receipts arrive on time and is halved when 
+ * the time per packet jumps, i.e. the link is congested.
+ */
+class DfuTransferEngine {
+    uint8_t packetSize;
+    uint16_t receiptInterval;
+    uint32_t bytesSent;
+    uint16_t packetsInWindow;
+    // smoothed time per packet, in microseconds, 0 until the first receipt
+    double smoothedPacketTime;
+    float bytesPerSecond;
+    std::chrono::steady_clock::time_point transferStart, windowStart;
+
+public:
+    explicit DfuTransferEngine(uint16_t mtu);
+
+    uint8_t getPacketSize() const;
+    uint16_t getReceiptInterval() const;
+    float getBytesPerSecond() const;
+
+    void start();
+    void onPacketSent(uint8_t length);
+    /**
+     * Updates the receipt interval from the time the last window took to be acknowledged
+     * @return False if the board received a different number of bytes than were sent
+     */
+    bool onReceipt(uint32_t bytesReceived);
+};
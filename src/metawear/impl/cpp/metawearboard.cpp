@@ -1,8 +1,10 @@
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <functional>
+#include <mutex>
 #include <string>
 #include <tuple>
 #include <typeinfo>
@@ -64,6 +66,7 @@ using namespace std::chrono;
 const int32_t MBL_MW_MODULE_TYPE_NA = -1;
 const uint8_t CARTESIAN_FLOAT_SIZE= 6;
 const uint16_t MAX_TIME_PER_RESPONSE= 4000;
+const uint16_t DEFAULT_MTU= 23;
 
 #define CLEAR_READ_MODIFIERS(x) (x & 0x3f)
 
@@ -112,6 +115,14 @@ static bool invoke_signal_handler(MblMwDataSignal* signal, int64_t epoch, const
     return false;
 }
 
+// set while the thread handles bulk notifications to the time the current one was received, 0 otherwise
+static thread_local int64_t bulk_notification_epoch = 0;
+
+// Helper function - time to stamp received data with
+static int64_t notification_epoch() {
+    return bulk_notification_epoch ? bulk_notification_epoch : duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
 // Helper function - forward response
 static int32_t forward_response(const ResponseHeader& header, MblMwMetaWearBoard *board, const uint8_t *response, uint8_t len) {
     auto it = board->module_events.find(header);
@@ -121,7 +132,7 @@ static int32_t forward_response(const ResponseHeader& header, MblMwMetaWearBoard
 
     auto signal = dynamic_cast<MblMwDataSignal*>(it->second);
     bool handled= false;
-    int64_t epoch = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+    int64_t epoch = notification_epoch();
 
     MblMwDataProcessor* processor = dynamic_cast<MblMwDataProcessor*>(signal);
     const uint8_t* start = response;
@@ -149,7 +160,9 @@ static int32_t forward_response(const ResponseHeader& header, MblMwMetaWearBoard
                         pack_size = get_packer_length(processor) - (parent == nullptr ? 0 : get_accounter_length(parent));
 
                 do {
-                    int64_t real_epoch = parent == nullptr ? epoch : extract_accounter_epoch(parent, epoch, &start, len, &extra);
+                    // without an accounter, the last sample is the newest and the others are spread back by the sample period
+                    int64_t real_epoch = parent == nullptr ? epoch - (int64_t) ((count - 1 - i) * processor->sample_period) :
+                            extract_accounter_epoch(parent, epoch, &start, len, &extra);
                     handled|= invoke_signal_handler(signal, real_epoch, start, pack_size, &extra);
                     i++;
                     len-= pack_size;
@@ -191,7 +204,7 @@ int32_t response_handler_packed_data(MblMwMetaWearBoard *board, const uint8_t *r
         return MBL_MW_STATUS_WARNING_UNEXPECTED_SENSOR_DATA;
     }
 
-    int64_t now = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+    int64_t now = notification_epoch();
     for(uint8_t i= 2; i < len; i+= CARTESIAN_FLOAT_SIZE) {
         MblMwData* data = data_response_converters.at(signal->interpreter)(false, signal, response + i, len - i);
         data->epoch= now;
@@ -254,8 +267,6 @@ const unordered_map<uint8_t, void(*)(MblMwMetaWearBoard*, uint8_t**)> CONFIG_DES
     { MBL_MW_MODULE_SENSOR_FUSION, deserialize_sensor_fusion_config }
 };
 
-const MblMwGattChar METAWEAR_SERVICE_NOTIFY_CHAR = { 0x326a900085cb9195, 0xd9dd464cfbbae75a, 0x326a900685cb9195, 0xd9dd464cfbbae75a };
-
 const uint64_t DEVICE_INFO_SERVICE_UUID_HIGH = 0x0000180a00001000,
         DEVICE_INFO_SERVICE_UUID_LOW = 0x800000805f9b34fb;
 
@@ -319,7 +330,7 @@ MblMwMetaWearBoard::MblMwMetaWearBoard() : logger_state(nullptr, [](void *ptr) -
         dp_state(nullptr, [](void *ptr) -> void { free_dataprocessor_module(ptr); }),
         macro_state(nullptr, [](void *ptr) -> void { free_macro_module(ptr); }),
         debug_state(nullptr, [](void *ptr) -> void { free_debug_module(ptr); }),
-        time_per_response(150), module_discovery_index(-1) {
+        config_write_mode(MBL_MW_CONFIG_WRITE_ALL), time_per_response(150), min_time_per_response(0), rtt(make_shared<RttEstimator>()), mtu(DEFAULT_MTU), write_gatt_chars(nullptr), dfu_transfer_rate(nullptr), module_discovery_index(-1) {
 }
 
 MblMwMetaWearBoard::~MblMwMetaWearBoard() {
@@ -361,6 +372,33 @@ void mbl_mw_metawearboard_set_time_for_response(MblMwMetaWearBoard* board, uint1
     board->time_per_response= response_time_ms > MAX_TIME_PER_RESPONSE ? MAX_TIME_PER_RESPONSE : response_time_ms;
 }
 
+void mbl_mw_metawearboard_set_adaptive_timeouts(MblMwMetaWearBoard* board, uint16_t min_response_time_ms) {
+    board->min_time_per_response= min_response_time_ms > MAX_TIME_PER_RESPONSE ? MAX_TIME_PER_RESPONSE : min_response_time_ms;
+}
+
+uint16_t mbl_mw_metawearboard_get_time_for_response(const MblMwMetaWearBoard* board) {
+    return (uint16_t) response_time(board);
+}
+
+void mbl_mw_metawearboard_set_mtu(MblMwMetaWearBoard* board, uint16_t mtu) {
+    board->mtu= mtu;
+}
+
+void mbl_mw_metawearboard_set_write_gatt_chars(MblMwMetaWearBoard* board, MblMwFnWriteGattChars write_gatt_chars) {
+    board->write_gatt_chars= write_gatt_chars;
+}
+
+void mbl_mw_metawearboard_enable_serialization(MblMwMetaWearBoard* board) {
+    if (!board->serial_lock) {
+        board->serial_lock = make_shared<recursive_mutex>();
+    }
+}
+
+void mbl_mw_metawearboard_execute(MblMwMetaWearBoard* board, void *context, void (*fn)(void *context, MblMwMetaWearBoard* board)) {
+    auto lock = lock_board(board);
+    fn(context, board);
+}
+
 const unordered_map<uint8_t, tuple<const char*, void(*)(MblMwMetaWearBoard*)>> MODULE_ATTRS = {
     { MBL_MW_MODULE_SWITCH, make_tuple("Switch", init_switch_module) },
     { MBL_MW_MODULE_LED, make_tuple("Led", nullptr) },
@@ -401,9 +439,7 @@ static inline void service_discovery_completed(MblMwMetaWearBoard* board) {
     if (signal != nullptr) {
         mbl_mw_datasignal_subscribe(signal, board, [](void *context, const MblMwData* data) {
             MblMwMetaWearBoard* board = static_cast<MblMwMetaWearBoard*>(context);
-            if (board->initialized_timeout != nullptr) {
-                board->initialized_timeout->cancel();
-            }
+            response_received(board->initialized_timeout);
 
             mbl_mw_datasignal_unsubscribe(mbl_mw_logging_get_time_data_signal(board));
 
@@ -415,9 +451,7 @@ static inline void service_discovery_completed(MblMwMetaWearBoard* board) {
         });
         mbl_mw_datasignal_read(signal);
     } else {
-        if (board->initialized_timeout != nullptr) {
-            board->initialized_timeout->cancel();
-        }
+        response_received(board->initialized_timeout);
         board->initialized(board->initialized_context, board, MBL_MW_STATUS_OK);
     }
 }
@@ -440,10 +474,12 @@ static inline void queue_next_query(MblMwMetaWearBoard *board) {
 // Helper function - char handler
 static int32_t char_changed_handler(const void* caller, const uint8_t* value, uint8_t length) {
     MblMwMetaWearBoard* board = (MblMwMetaWearBoard*) caller;
+    auto lock = lock_board(board);
     ResponseHeader header(value[0], value[1]);
 
-    if (board->responses.count(header)) {
-        return board->responses.at(header)(board, value, length);
+    auto it = board->responses.find(header);
+    if (it != board->responses.end()) {
+        return it->second(board, value, length);
     } else if (header.register_id == READ_INFO_REGISTER) {
         board->module_info.emplace(piecewise_construct, forward_as_tuple(value[0]), forward_as_tuple(value, length));
         queue_next_query(board);
@@ -473,6 +509,7 @@ static void queue_next_read(MblMwMetaWearBoard* board) {
 // Helper function - read gatt char handler
 static int32_t read_gatt_char_handler(const void* caller, const uint8_t* value, uint8_t length) {
     auto board = (MblMwMetaWearBoard*) caller;
+    auto lock = lock_board(board);
     get<1>(BOARD_DEV_INFO_CHARS[board->dev_info_index])(board, value, length);
     queue_next_read(board);
 
@@ -482,12 +519,13 @@ static int32_t read_gatt_char_handler(const void* caller, const uint8_t* value,
 // Helper function - enable notif
 static void enable_notify_ready(const void* caller, int32_t value) {
     auto board = (MblMwMetaWearBoard*) caller;
+    auto lock = lock_board(board);
 
     if (value == MBL_MW_STATUS_OK) {
         board->dev_info_index = -1;
-        board->initialized_timeout= ThreadPool::schedule([board](void) {
+        board->initialized_timeout= schedule_response_timeout(board, [board](void) {
             board->initialized(board->initialized_context, board, MBL_MW_STATUS_ERROR_TIMEOUT);
-        }, (MODULE_DISCOVERY_CMDS.size() + BOARD_DEV_INFO_CHARS.size() + 1) * board->time_per_response);
+        }, MODULE_DISCOVERY_CMDS.size() + BOARD_DEV_INFO_CHARS.size() + 1);
         queue_next_read(board);
     } else {
         board->initialized(board->initialized_context, board, MBL_MW_STATUS_ERROR_ENABLE_NOTIFY);
@@ -497,12 +535,14 @@ static void enable_notify_ready(const void* caller, int32_t value) {
 const unordered_set<void(*)(MblMwMetaWearBoard*)> MODULE_DISCONNECT_HANDLERS = {
     disconnect_logging,
     disconnect_timer,
-    disconnect_dataprocessor
+    disconnect_dataprocessor,
+    disconnect_macro
 };
 
 // Helper function - disconn
 static void disconnect_handler(const void* caller, int32_t value) {
     auto board = (MblMwMetaWearBoard*) caller;
+    auto lock = lock_board(board);
 
     for(auto it: MODULE_DISCONNECT_HANDLERS) {
         it(board);
@@ -511,67 +551,369 @@ static void disconnect_handler(const void* caller, int32_t value) {
 
 // Board init
 void mbl_mw_metawearboard_initialize(MblMwMetaWearBoard *board, void *context, MblMwFnBoardPtrInt initialized) {
+    auto lock = lock_board(board);
     board->initialized_context = context;
     board->initialized = initialized;
     board->dev_info_index = -1;
     board->module_discovery_index = -1;
+    // board may have been reset since the last connection, nothing is known about its registers
+    clear_config_shadow(board);
 
     board->btle_conn.on_disconnect(board->btle_conn.context, board, disconnect_handler);
     board->btle_conn.enable_notifications(board->btle_conn.context, board, &METAWEAR_SERVICE_NOTIFY_CHAR, char_changed_handler, enable_notify_ready);
 }
 
+uint32_t mbl_mw_metawearboard_handle_notifications(const MblMwNotification* notifications, uint32_t n_notifications) {
+    return handle_notifications(notifications, n_notifications, duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count());
+}
+
+uint32_t handle_notifications(const MblMwNotification* notifications, uint32_t n_notifications, int64_t epoch) {
+    // a handler can itself handle notifications, restore the outer call's timestamp afterwards
+    int64_t previous_epoch = bulk_notification_epoch;
+    uint32_t n_unhandled = 0, i = 0;
+
+    while(i < n_notifications) {
+        MblMwMetaWearBoard* board = notifications[i].board;
+        WriteBatch batch(board);
+        for(; i < n_notifications && notifications[i].board == board; i++) {
+            bulk_notification_epoch = notifications[i].epoch ? notifications[i].epoch : epoch;
+            if (notifications[i].length < 2 || char_changed_handler(board, notifications[i].value, notifications[i].length) != MBL_MW_STATUS_OK) {
+                n_unhandled++;
+            }
+        }
+    }
+
+    bulk_notification_epoch = previous_epoch;
+    return n_unhandled;
+}
+
+// Helper function - module is absent from the board, if module discovery has run
+static bool is_module_absent(const MblMwMetaWearBoard *board, uint8_t module) {
+    auto it = board->module_info.find(module);
+    return it != board->module_info.end() && !it->second.present;
+}
+
 // Board tear down
 void mbl_mw_metawearboard_tear_down(MblMwMetaWearBoard *board) {
-    vector<ResponseHeader> spawned_keys;
+    mbl_mw_metawearboard_tear_down_with_summary(board, nullptr);
+}
+
+void mbl_mw_metawearboard_tear_down_with_summary(MblMwMetaWearBoard *board, MblMwTearDownSummary* summary) {
+    WriteBatch batch(board);
+    MblMwTearDownSummary result = { 0, 0, 0 };
+    vector<MblMwTimer*> timers;
 
+    result.n_per_object_commands += count_logger_entries(board->logger_state.get());
     tear_down_logging(board->logger_state.get(), true);
 
-    for (auto it: board->module_events) {
-        if (it.second->header.module_id == MBL_MW_MODULE_DATA_PROCESSOR || it.second->header.module_id == MBL_MW_MODULE_TIMER) {
-            spawned_keys.push_back(it.first);
+    // spawned objects are freed in one pass, their on-board entries go with the remove all commands below
+    for (auto it = board->module_events.begin(); it != board->module_events.end();) {
+        auto event = it->second;
+        result.n_per_object_commands += (uint32_t) event->event_command_ids.size();
+
+        if (it->first.module_id == MBL_MW_MODULE_TIMER) {
+            timers.push_back(dynamic_cast<MblMwTimer*>(event));
+            result.n_per_object_commands++;
+            it = board->module_events.erase(it);
+        } else if (it->first.module_id == MBL_MW_MODULE_DATA_PROCESSOR) {
+            if (CLEAR_READ(it->first.register_id) == ORDINAL(DataProcessorRegister::NOTIFY)) {
+                result.n_per_object_commands++;
+            }
+            event->remove = false;
+            delete event;
+            result.n_freed++;
+            it = board->module_events.erase(it);
         } else {
-            it.second->event_command_ids.clear();
+            event->event_command_ids.clear();
+            it++;
         }
     }
-    sort(spawned_keys.begin(), spawned_keys.end());
-    for (auto it: spawned_keys) {
-        auto event= board->module_events.at(it);
 
-        if (it.module_id == MBL_MW_MODULE_TIMER) {
-            dynamic_cast<MblMwTimer*>(event)->remove_from_board();
-        }
+    tear_down_dataprocessor(board);
 
-        event->remove = false;
-        delete event;
+    sort(timers.begin(), timers.end(), [](const MblMwTimer* a, const MblMwTimer* b) { return a->header < b->header; });
+    for (auto it: timers) {
+        it->remove_from_board();
+        result.n_commands++;
 
-        board->module_events.erase(it);
+        it->remove = false;
+        delete it;
+        result.n_freed++;
     }
 
-    uint8_t command[2]= { MBL_MW_MODULE_DATA_PROCESSOR, ORDINAL(DataProcessorRegister::REMOVE_ALL) };
-    SEND_COMMAND;
-
-    command[0]= MBL_MW_MODULE_EVENT;
-    command[1]= ORDINAL(EventRegister::REMOVE_ALL);
-    SEND_COMMAND;
+    uint8_t command[2];
+    const uint8_t remove_all[3][2] = {
+        { MBL_MW_MODULE_DATA_PROCESSOR, ORDINAL(DataProcessorRegister::REMOVE_ALL) },
+        { MBL_MW_MODULE_EVENT, ORDINAL(EventRegister::REMOVE_ALL) },
+        { MBL_MW_MODULE_LOGGING, ORDINAL(LoggingRegister::REMOVE_ALL) }
+    };
+    for (auto it: remove_all) {
+        if (!is_module_absent(board, it[0])) {
+            command[0] = it[0];
+            command[1] = it[1];
+            SEND_COMMAND;
+            result.n_commands++;
+        }
+    }
 
-    command[0]= MBL_MW_MODULE_LOGGING;
-    command[1]= ORDINAL(LoggingRegister::REMOVE_ALL);
-    SEND_COMMAND;
+    if (summary != nullptr) {
+        *summary = result;
+    }
 }
 
 // Helper function - send command
 void send_command(const MblMwMetaWearBoard* board, const uint8_t* command, uint8_t len) {
     if (!record_command(board, command, len)) {
-        board->btle_conn.write_gatt_char(
-            board->btle_conn.context,
-            board,
+        board->write_gatt_char(&METAWEAR_COMMAND_CHAR, 
             command[0] == MBL_MW_MODULE_MACRO ? MBL_MW_GATT_CHAR_WRITE_WITH_RESPONSE : MBL_MW_GATT_CHAR_WRITE_WITHOUT_RESPONSE,
-            &METAWEAR_COMMAND_CHAR, command, len
+            command, len
         );
         record_macro(board, command, len);
     }
 }
 
+struct PendingWrite {
+    MblMwGattCharWriteType type;
+    const MblMwGattChar* gatt_char;
+    vector<uint8_t> value;
+};
+
+struct OpenWriteBatch {
+    const MblMwMetaWearBoard* board;
+    uint32_t depth;
+    vector<PendingWrite> pending;
+};
+
+// batches the calling thread has open, rarely more than one
+static thread_local vector<OpenWriteBatch> open_write_batches;
+
+// Helper function - finds the calling thread's open batch for the board
+static vector<OpenWriteBatch>::iterator find_write_batch(const MblMwMetaWearBoard* board) {
+    return find_if(open_write_batches.begin(), open_write_batches.end(), [board](const OpenWriteBatch& it) { return it.board == board; });
+}
+
+void MblMwMetaWearBoard::write_gatt_char(const MblMwGattChar* gatt_char, MblMwGattCharWriteType type, const uint8_t* value, uint8_t len) const {
+    if (!open_write_batches.empty()) {
+        auto it = find_write_batch(this);
+        if (it != open_write_batches.end()) {
+            it->pending.push_back({ type, gatt_char, vector<uint8_t>(value, value + len) });
+            return;
+        }
+    }
+    btle_conn.write_gatt_char(btle_conn.context, this, type, gatt_char, value, len);
+}
+
+unique_lock<recursive_mutex> lock_board(const MblMwMetaWearBoard* board) {
+    return board->serial_lock ? unique_lock<recursive_mutex>(*board->serial_lock) : unique_lock<recursive_mutex>();
+}
+
+function<void(void)> serialize(const MblMwMetaWearBoard* board, function<void(void)> fn) {
+    if (!board->serial_lock) {
+        return fn;
+    }
+
+    // captures the lock rather than the board, fn may only reference module state that outlives the board
+    auto serial_lock = board->serial_lock;
+    return [serial_lock, fn](void) -> void {
+        lock_guard<recursive_mutex> lock(*serial_lock);
+        fn();
+    };
+}
+
+/**
+ * Timeout for a serialized board.  The timeout can fire while a response holding the board's lock is cancelling it, 
+ * so whether it was cancelled is checked again once the lock is acquired.
+ */
+class SerializedTask : public Task {
+public:
+    SerializedTask();
+    virtual ~SerializedTask();
+
+    virtual void cancel();
+
+    shared_ptr<atomic_bool> cancelled;
+    shared_ptr<Task> inner;
+};
+
+SerializedTask::SerializedTask() : cancelled(make_shared<atomic_bool>(false)) { }
+
+SerializedTask::~SerializedTask() { }
+
+void SerializedTask::cancel() {
+    *cancelled = true;
+    inner->cancel();
+}
+
+shared_ptr<Task> schedule_task(const MblMwMetaWearBoard* board, function<void(void)> fn, int64_t delay) {
+    if (!board->serial_lock) {
+        return board->executor ? board->executor->schedule(fn, delay) : ThreadPool::schedule(fn, delay);
+    }
+
+    auto task = make_shared<SerializedTask>();
+    auto cancelled = task->cancelled;
+    fn = serialize(board, [cancelled, fn](void) -> void {
+        if (!*cancelled) {
+            fn();
+        }
+    });
+    task->inner = board->executor ? board->executor->schedule(fn, delay) : ThreadPool::schedule(fn, delay);
+    return task;
+}
+
+int64_t response_time(const MblMwMetaWearBoard* board) {
+    if (board->time_per_response == INDEFINITE_TIMEOUT || board->min_time_per_response == 0) {
+        return board->time_per_response;
+    }
+    return board->rtt->timeout(board->time_per_response, board->min_time_per_response, MAX_TIME_PER_RESPONSE);
+}
+
+/**
+ * Timeout waiting on the board's responses.  Only responses arriving are timed, not teardown or rescheduling cancels.
+ */
+class ResponseTimeout : public Task {
+public:
+    ResponseTimeout(shared_ptr<RttEstimator> rtt, bool measure);
+    virtual ~ResponseTimeout();
+
+    virtual void cancel();
+    void received();
+
+    shared_ptr<RttEstimator> rtt;
+    bool measure;
+    steady_clock::time_point start;
+    // set by whichever of cancel and the timeout happens first
+    shared_ptr<atomic_bool> finished;
+    shared_ptr<Task> inner;
+};
+
+ResponseTimeout::ResponseTimeout(shared_ptr<RttEstimator> rtt, bool measure) : rtt(rtt), measure(measure), start(steady_clock::now()), 
+        finished(make_shared<atomic_bool>(false)) { }
+
+ResponseTimeout::~ResponseTimeout() { }
+
+void ResponseTimeout::cancel() {
+    finished->exchange(true);
+    inner->cancel();
+}
+
+void ResponseTimeout::received() {
+    if (!finished->exchange(true) && measure) {
+        rtt->add_sample(duration_cast<microseconds>(steady_clock::now() - start).count());
+    }
+    inner->cancel();
+}
+
+void response_received(const shared_ptr<Task>& timeout) {
+    auto response_timeout = dynamic_cast<ResponseTimeout*>(timeout.get());
+    if (response_timeout != nullptr) {
+        response_timeout->received();
+    } else if (timeout != nullptr) {
+        timeout->cancel();
+    }
+}
+
+shared_ptr<Task> schedule_response_timeout(const MblMwMetaWearBoard* board, function<void(void)> fn, size_t n_responses) {
+    return schedule_response_timeout(board, fn, n_responses, true);
+}
+
+shared_ptr<Task> schedule_response_timeout(const MblMwMetaWearBoard* board, function<void(void)> fn, size_t n_responses, bool fresh) {
+    // a response is only timed when it is the one command outstanding, others in flight would delay it
+    auto task = make_shared<ResponseTimeout>(board->rtt, fresh && n_responses == 1);
+    auto finished = task->finished;
+    auto rtt = board->rtt;
+
+    task->inner = schedule_task(board, [finished, rtt, fn](void) -> void {
+        if (!finished->exchange(true)) {
+            rtt->back_off();
+        }
+        fn();
+    }, n_responses * response_time(board));
+    return task;
+}
+
+WriteBatch::WriteBatch(const MblMwMetaWearBoard* board) : board(board) {
+    auto it = find_write_batch(board);
+    if (it == open_write_batches.end()) {
+        open_write_batches.push_back({ board, 1, {} });
+    } else {
+        it->depth++;
+    }
+}
+
+WriteBatch::~WriteBatch() {
+    auto it = find_write_batch(board);
+    if (--it->depth) {
+        return;
+    }
+
+    // the connection can respond synchronously and trigger more writes, those are sent on their own
+    vector<PendingWrite> pending;
+    pending.swap(it->pending);
+    open_write_batches.erase(it);
+    if (pending.empty()) {
+        return;
+    }
+
+    if (board->write_gatt_chars == nullptr) {
+        for(const auto& it: pending) {
+            board->btle_conn.write_gatt_char(board->btle_conn.context, board, it.type, it.gatt_char, it.value.data(), (uint8_t) it.value.size());
+        }
+    } else {
+        vector<MblMwGattCharWrite> writes;
+        writes.reserve(pending.size());
+        for(const auto& it: pending) {
+            writes.push_back({ it.type, it.gatt_char, it.value.data(), (uint8_t) it.value.size() });
+        }
+        board->write_gatt_chars(board->btle_conn.context, board, writes.data(), (uint32_t) writes.size());
+    }
+}
+
+// Helper function - send command without response
+void send_pipelined_command(const MblMwMetaWearBoard* board, const uint8_t* command, uint8_t len) {
+    board->write_gatt_char(&METAWEAR_COMMAND_CHAR, MBL_MW_GATT_CHAR_WRITE_WITHOUT_RESPONSE, command, len);
+}
+
+// Helper function - send config register write, skipped if the register already holds the value
+void send_config_command(const MblMwMetaWearBoard* board, const uint8_t* command, uint8_t len) {
+    uint16_t key = (command[0] << 8) | command[1];
+
+    // recorded commands run at an unknown later time, they carry the full config and the register can no longer be shadowed
+    if (is_recording_commands(board) || is_recording_macro(board)) {
+        board->config_shadow.erase(key);
+        board->unshadowed_config.insert(key);
+        send_command(board, command, len);
+        if (!is_recording_commands(board)) {
+            flag_macro_config_command(board);
+        }
+        return;
+    }
+    if (board->unshadowed_config.count(key)) {
+        send_command(board, command, len);
+        return;
+    }
+
+    auto& shadow = board->config_shadow[key];
+    if (board->config_write_mode == MBL_MW_CONFIG_WRITE_CHANGED && shadow.size() == (size_t) (len - 2) && 
+            equal(shadow.begin(), shadow.end(), command + 2)) {
+        return;
+    }
+
+    send_command(board, command, len);
+    shadow.assign(command + 2, command + len);
+}
+
+// Helper function - forget the values written to config registers
+void clear_config_shadow(const MblMwMetaWearBoard* board) {
+    board->config_shadow.clear();
+}
+
+// Config write mode
+void mbl_mw_metawearboard_set_config_write_mode(MblMwMetaWearBoard* board, MblMwConfigWriteMode mode) {
+    board->config_write_mode = mode;
+    board->unshadowed_config.clear();
+    clear_config_shadow(board);
+}
+
 // Board is init
 int32_t mbl_mw_metawearboard_is_initialized(const MblMwMetaWearBoard *board) {
     return board->module_discovery_index == (int8_t) MODULE_DISCOVERY_CMDS.size();
@@ -880,6 +1222,7 @@ static bool has_suffix(const std::string &str, const std::string &suffix) {
 
 // Helper function - dfu
 static int32_t dfu_char_changed_handler(const void* caller, const uint8_t* value, uint8_t length) {
+    auto lock = lock_board((MblMwMetaWearBoard*) caller);
     ((MblMwMetaWearBoard*) caller)->operations->processDFUResponse(value, length);
     return MBL_MW_STATUS_OK;
 }
@@ -887,6 +1230,7 @@ static int32_t dfu_char_changed_handler(const void* caller, const uint8_t* value
 // Helper function - dfu
 static void dfu_enable_notify_ready(const void* caller, int32_t value) {
     auto board = (MblMwMetaWearBoard*) caller;
+    auto lock = lock_board(board);
 
     if (value == MBL_MW_STATUS_OK) {
         if (has_suffix(board->filename, "zip")) {
@@ -900,6 +1244,10 @@ static void dfu_enable_notify_ready(const void* caller, int32_t value) {
 }
 
 // DFU
+void mbl_mw_metawearboard_set_dfu_transfer_rate_handler(MblMwMetaWearBoard *board, void (*on_transfer_rate)(void *context, float bytes_per_second)) {
+    board->dfu_transfer_rate = on_transfer_rate;
+}
+
 void mbl_mw_metawearboard_perform_dfu(MblMwMetaWearBoard *board, const MblMwDfuDelegate *delegate, const char *filename) {
     board->operations.reset(new DfuOperations(board, delegate));
     board->filename = filename;
@@ -29,6 +29,16 @@ typedef struct {
     uint64_t uuid_low;                  ///< Low 64 bits of the characteristic uuid
 } MblMwGattChar;
 
+/**
+ * One characteristic write in a batch passed to a MblMwFnWriteGattChars function
+ */
+typedef struct {
+    MblMwGattCharWriteType write_type;          ///< Write type to use
+    const MblMwGattChar* characteristic;        ///< Gatt characteristic to write
+    const uint8_t* value;                       ///< Value to write as a byte array
+    uint8_t length;                             ///< Length of the byte array
+} MblMwGattCharWrite;
+
 /**
  * Definition for callback functions that accept a void pointer and byte array.
  * @param caller        Object the callback is designated for
@@ -44,6 +54,16 @@ typedef int32_t(*MblMwFnIntVoidPtrArray)(const void* caller, const uint8_t* star
  */
 typedef void(*MblMwFnVoidVoidPtrInt)(const void* caller, int32_t value);
 
+/**
+ * Definition for functions that write several characteristic values to the device, in order.  The writes, and the 
+ * values they point to, are only valid for the duration of the call.
+ * @param context       Pointer to the <code>context</code> field of the board's MblMwBtleConnection
+ * @param caller        Object using this function pointer
+ * @param writes        Writes to perform
+ * @param n_writes      Number of writes
+ */
+typedef void(*MblMwFnWriteGattChars)(void *context, const void* caller, const MblMwGattCharWrite* writes, uint32_t n_writes);
+
 /**
  * Wrapper class containing functions for communicating with the MetaWear through a Bluetooth Low Energy connection.
  */
@@ -0,0 +1,3 @@
+#include "executor.h"
+
+Executor::~Executor() { }
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "task.h"
+
+#include <functional>
+#include <memory>
+#include <stdint.h>
+
+/**
+ * Runs a board's deferred work.  Functions are run one at a time, in the order they were posted.
+ */
+class Executor {
+public:
+    virtual ~Executor();
+
+    virtual void post(std::function<void(void)> fn)= 0;
+    /** posts fn once delay milliseconds have passed, unless the returned task is cancelled first */
+    virtual std::shared_ptr<Task> schedule(std::function<void(void)> fn, int64_t delay)= 0;
+};
@@ -0,0 +1,476 @@
+#include "metawear/platform/socket_connection.h"
+#include "metawear/core/metawearboard.h"
+#include "metawear/core/status.h"
+#include "metawear/core/cpp/metawearboard_def.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using std::atomic_bool;
+using std::deque;
+using std::lock_guard;
+using std::memcmp;
+using std::memcpy;
+using std::memmove;
+using std::memset;
+using std::mutex;
+using std::pair;
+using std::strcpy;
+using std::strlen;
+using std::thread;
+using std::vector;
+
+enum class FrameType : uint8_t {
+    OPEN = 0x01,
+    DECLARE = 0x02,
+    WRITE = 0x03,
+    READ = 0x04,
+    ENABLE_NOTIFY = 0x05,
+    NOTIFY = 0x81,
+    READ_RESPONSE = 0x82,
+    NOTIFY_ENABLED = 0x83,
+    DISCONNECTED = 0x84
+};
+
+struct FrameHeader {
+    uint8_t type, reserved;
+    uint16_t length;
+};
+
+const size_t FRAME_HEADER_SIZE = sizeof(FrameHeader), MAX_FRAME_PAYLOAD = UINT16_MAX, WRITE_ENTRY_HEADER_SIZE = 3,
+        // each write takes 2 iovecs, stay well under IOV_MAX
+        MAX_WRITES_PER_FRAME = 256;
+const uint8_t MAX_CHARACTERISTICS = UINT8_MAX;
+
+static_assert(sizeof(FrameHeader) == 4, "FrameHeader must be 4 bytes");
+
+struct CharacteristicState {
+    MblMwGattChar gatt_char;
+    MblMwFnIntVoidPtrArray notify_handler;
+    MblMwFnVoidVoidPtrInt notify_ready;
+    deque<MblMwFnIntVoidPtrArray> read_handlers;
+};
+
+struct MblMwSocketConnection {
+    MblMwBtleConnection btle_conn;
+    int fd;
+    atomic_bool closing;
+
+    // guards the socket's write side and everything below
+    mutex lock;
+    const void* caller;
+    MblMwFnVoidVoidPtrInt dc_handler;
+    // status the disconnect is reported with, set when a frame could not be sent
+    int32_t error;
+    // set once the disconnect is reported, the peer's disconnected frame is followed by the socket closing
+    bool disconnected;
+    vector<CharacteristicState> characteristics;
+    thread receiver;
+};
+
+#ifndef _WIN32
+// Helper function - writes all iovecs, picking up where a short write left off
+static bool send_frame(int fd, struct iovec* iov, size_t count) {
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+    while(count) {
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+
+        ssize_t sent = sendmsg(fd, &msg, flags);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        while(count && static_cast<size_t>(sent) >= iov->iov_len) {
+            sent -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count) {
+            iov->iov_base = static_cast<uint8_t*>(iov->iov_base) + sent;
+            iov->iov_len -= sent;
+        }
+    }
+    return true;
+}
+
+// Helper function - sends a frame whose payload is in one buffer
+static bool send_frame(int fd, FrameType type, const void* payload, size_t len) {
+    FrameHeader header = { static_cast<uint8_t>(type), 0, static_cast<uint16_t>(len) };
+    struct iovec iov[2] = {
+        { &header, FRAME_HEADER_SIZE },
+        { const_cast<void*>(payload), len }
+    };
+    return send_frame(fd, iov, len ? 2 : 1);
+}
+
+// Helper function - gives up on the stream, the receive thread then reports the disconnect with status; call with the lock held
+static void fail_connection(MblMwSocketConnection* conn, int32_t status) {
+    // a failed send can leave part of a frame behind, nothing sent afterwards would be understood by the peer
+    if (conn->error == MBL_MW_STATUS_OK) {
+        conn->error = status;
+        shutdown(conn->fd, SHUT_RDWR);
+    }
+}
+
+// Helper function - finds the characteristic's id, declaring it to the peer if it is new, fails the connection if 
+// it cannot be declared; call with the lock held
+static int32_t lookup_characteristic(MblMwSocketConnection* conn, const MblMwGattChar* gatt_char) {
+    for(size_t i = 0; i < conn->characteristics.size(); i++) {
+        if (!memcmp(&conn->characteristics[i].gatt_char, gatt_char, sizeof(MblMwGattChar))) {
+            return static_cast<int32_t>(i);
+        }
+    }
+    if (conn->characteristics.size() >= MAX_CHARACTERISTICS) {
+        fail_connection(conn, MBL_MW_STATUS_ERROR_CAPACITY_EXCEEDED);
+        return -1;
+    }
+
+    uint8_t id = static_cast<uint8_t>(conn->characteristics.size());
+    uint8_t payload[1 + sizeof(MblMwGattChar)];
+    payload[0] = id;
+    memcpy(payload + 1, gatt_char, sizeof(MblMwGattChar));
+    if (!send_frame(conn->fd, FrameType::DECLARE, payload, sizeof(payload))) {
+        fail_connection(conn, MBL_MW_STATUS_ERROR_IO);
+        return -1;
+    }
+
+    conn->characteristics.push_back({ *gatt_char, nullptr, nullptr, {} });
+    return id;
+}
+
+static void write_gatt_chars(void *context, const void* caller, const MblMwGattCharWrite* writes, uint32_t n_writes) {
+    auto conn = static_cast<MblMwSocketConnection*>(context);
+    lock_guard<mutex> lock(conn->lock);
+
+    vector<uint8_t> entries;
+    vector<struct iovec> iov;
+    uint32_t i = 0;
+    while(i < n_writes) {
+        FrameHeader header = { static_cast<uint8_t>(FrameType::WRITE), 0, 0 };
+        entries.resize(MAX_WRITES_PER_FRAME * WRITE_ENTRY_HEADER_SIZE);
+        iov.clear();
+        iov.push_back({ &header, FRAME_HEADER_SIZE });
+
+        size_t n_entries = 0, length = 0;
+        for(; i < n_writes && n_entries < MAX_WRITES_PER_FRAME && length + WRITE_ENTRY_HEADER_SIZE + writes[i].length <= MAX_FRAME_PAYLOAD; i++) {
+            int32_t id = lookup_characteristic(conn, writes[i].characteristic);
+            if (id < 0) {
+                // later writes must not go out without this one
+                return;
+            }
+
+            uint8_t* entry = entries.data() + n_entries * WRITE_ENTRY_HEADER_SIZE;
+            entry[0] = static_cast<uint8_t>(id);
+            entry[1] = static_cast<uint8_t>(writes[i].write_type);
+            entry[2] = writes[i].length;
+            iov.push_back({ entry, WRITE_ENTRY_HEADER_SIZE });
+            if (writes[i].length) {
+                iov.push_back({ const_cast<uint8_t*>(writes[i].value), writes[i].length });
+            }
+
+            n_entries++;
+            length += WRITE_ENTRY_HEADER_SIZE + writes[i].length;
+        }
+
+        if (n_entries) {
+            header.length = static_cast<uint16_t>(length);
+            if (!send_frame(conn->fd, iov.data(), iov.size())) {
+                fail_connection(conn, MBL_MW_STATUS_ERROR_IO);
+                return;
+            }
+        }
+    }
+}
+
+static void write_gatt_char(void *context, const void* caller, MblMwGattCharWriteType write_type, const MblMwGattChar* characteristic,
+        const uint8_t* value, uint8_t length) {
+    MblMwGattCharWrite write = { write_type, characteristic, value, length };
+    write_gatt_chars(context, caller, &write, 1);
+}
+
+static void read_gatt_char(void *context, const void* caller, const MblMwGattChar* characteristic, MblMwFnIntVoidPtrArray handler) {
+    auto conn = static_cast<MblMwSocketConnection*>(context);
+    lock_guard<mutex> lock(conn->lock);
+
+    conn->caller = caller;
+    int32_t id = lookup_characteristic(conn, characteristic);
+    if (id >= 0) {
+        uint8_t payload = static_cast<uint8_t>(id);
+        // the response cannot be matched before the lock is released
+        if (send_frame(conn->fd, FrameType::READ, &payload, sizeof(payload))) {
+            conn->characteristics[id].read_handlers.push_back(handler);
+        } else {
+            fail_connection(conn, MBL_MW_STATUS_ERROR_IO);
+        }
+    }
+}
+
+static void enable_notifications(void *context, const void* caller, const MblMwGattChar* characteristic, MblMwFnIntVoidPtrArray handler,
+        MblMwFnVoidVoidPtrInt ready) {
+    auto conn = static_cast<MblMwSocketConnection*>(context);
+    bool sent = false;
+    {
+        lock_guard<mutex> lock(conn->lock);
+
+        conn->caller = caller;
+        int32_t id = lookup_characteristic(conn, characteristic);
+        if (id >= 0) {
+            uint8_t payload = static_cast<uint8_t>(id);
+            conn->characteristics[id].notify_handler = handler;
+            conn->characteristics[id].notify_ready = ready;
+            sent = send_frame(conn->fd, FrameType::ENABLE_NOTIFY, &payload, sizeof(payload));
+            if (!sent) {
+                fail_connection(conn, MBL_MW_STATUS_ERROR_IO);
+            }
+        }
+    }
+
+    if (!sent) {
+        ready(caller, MBL_MW_STATUS_ERROR_ENABLE_NOTIFY);
+    }
+}
+
+static void on_disconnect(void *context, const void* caller, MblMwFnVoidVoidPtrInt handler) {
+    auto conn = static_cast<MblMwSocketConnection*>(context);
+    lock_guard<mutex> lock(conn->lock);
+
+    conn->caller = caller;
+    conn->dc_handler = handler;
+}
+
+// Helper function - hands the notifications in a frame to their handlers, MetaWear notifications are passed on in one call
+static void dispatch_notifications(MblMwSocketConnection* conn, const uint8_t* payload, size_t len) {
+    vector<MblMwNotification> bulk;
+    vector<pair<MblMwFnIntVoidPtrArray, size_t>> others;
+    const void* caller;
+    {
+        lock_guard<mutex> lock(conn->lock);
+        caller = conn->caller;
+        for(size_t i = 0; i + 2 <= len && i + 2 + payload[i + 1] <= len; i += 2 + payload[i + 1]) {
+            if (payload[i] >= conn->characteristics.size() || conn->characteristics[payload[i]].notify_handler == nullptr) {
+                continue;
+            }
+
+            const auto& state = conn->characteristics[payload[i]];
+            if (!memcmp(&state.gatt_char, &METAWEAR_SERVICE_NOTIFY_CHAR, sizeof(MblMwGattChar))) {
+                bulk.push_back({ (MblMwMetaWearBoard*) caller, payload + i + 2, payload[i + 1], 0 });
+            } else {
+                others.emplace_back(state.notify_handler, i);
+            }
+        }
+    }
+
+    if (!bulk.empty()) {
+        mbl_mw_metawearboard_handle_notifications(bulk.data(), static_cast<uint32_t>(bulk.size()));
+    }
+    for(const auto& it: others) {
+        it.first(caller, payload + it.second + 2, payload[it.second + 1]);
+    }
+}
+
+// Helper function - calls the board's disconnect handler, only the first time the connection is lost
+static void report_disconnect(MblMwSocketConnection* conn, int32_t status) {
+    MblMwFnVoidVoidPtrInt dc_handler;
+    const void* caller;
+    {
+        lock_guard<mutex> lock(conn->lock);
+        if (conn->disconnected) {
+            return;
+        }
+        conn->disconnected = true;
+        dc_handler = conn->dc_handler;
+        caller = conn->caller;
+    }
+    if (dc_handler) {
+        dc_handler(caller, status);
+    }
+}
+
+// Helper function - processes one frame from the peer
+static void handle_frame(MblMwSocketConnection* conn, FrameType type, const uint8_t* payload, size_t len) {
+    switch(type) {
+    case FrameType::NOTIFY:
+        dispatch_notifications(conn, payload, len);
+        break;
+    case FrameType::READ_RESPONSE: {
+        MblMwFnIntVoidPtrArray handler = nullptr;
+        const void* caller = nullptr;
+        if (len >= 1) {
+            lock_guard<mutex> lock(conn->lock);
+            caller = conn->caller;
+            if (payload[0] < conn->characteristics.size() && !conn->characteristics[payload[0]].read_handlers.empty()) {
+                handler = conn->characteristics[payload[0]].read_handlers.front();
+                conn->characteristics[payload[0]].read_handlers.pop_front();
+            }
+        }
+        if (handler) {
+            handler(caller, payload + 1, static_cast<uint8_t>(len - 1));
+        }
+        break;
+    }
+    case FrameType::NOTIFY_ENABLED: {
+        MblMwFnVoidVoidPtrInt ready = nullptr;
+        const void* caller = nullptr;
+        int32_t status;
+        if (len >= 1 + sizeof(status)) {
+            lock_guard<mutex> lock(conn->lock);
+            caller = conn->caller;
+            if (payload[0] < conn->characteristics.size()) {
+                ready = conn->characteristics[payload[0]].notify_ready;
+                conn->characteristics[payload[0]].notify_ready = nullptr;
+            }
+        }
+        if (ready) {
+            memcpy(&status, payload + 1, sizeof(status));
+            ready(caller, status);
+        }
+        break;
+    }
+    case FrameType::DISCONNECTED: {
+        int32_t status = 0;
+        if (len >= sizeof(status)) {
+            memcpy(&status, payload, sizeof(status));
+        }
+        report_disconnect(conn, status);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// Helper function - reads frames until the socket is closed
+static void receive_frames(MblMwSocketConnection* conn) {
+    // frames are handled in place, notification values point straight into this buffer
+    vector<uint8_t> buffer(2 * (FRAME_HEADER_SIZE + MAX_FRAME_PAYLOAD));
+    size_t filled = 0;
+
+    while(true) {
+        struct iovec iov = { buffer.data() + filled, buffer.size() - filled };
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+
+        ssize_t received = recvmsg(conn->fd, &msg, 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            break;
+        }
+        filled += received;
+
+        size_t start = 0;
+        while(filled - start >= FRAME_HEADER_SIZE) {
+            FrameHeader header;
+            memcpy(&header, buffer.data() + start, FRAME_HEADER_SIZE);
+            if (filled - start < FRAME_HEADER_SIZE + header.length) {
+                break;
+            }
+
+            handle_frame(conn, static_cast<FrameType>(header.type), buffer.data() + start + FRAME_HEADER_SIZE, header.length);
+            start += FRAME_HEADER_SIZE + header.length;
+        }
+
+        // move the partial frame to the front, the buffer always has room for a whole frame after it
+        if (start) {
+            memmove(buffer.data(), buffer.data() + start, filled - start);
+            filled -= start;
+        }
+    }
+
+    // the peer went away without being asked to, or a frame could not be sent
+    if (!conn->closing) {
+        int32_t status;
+        {
+            lock_guard<mutex> lock(conn->lock);
+            status = conn->error;
+        }
+        report_disconnect(conn, status);
+    }
+}
+#endif
+
+MblMwSocketConnection* mbl_mw_socket_connection_open(const char* path, const char* device) {
+#ifdef _WIN32
+    return nullptr;
+#else
+    struct sockaddr_un address;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        return nullptr;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+#ifdef SO_NOSIGPIPE
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+    if (connect(fd, (struct sockaddr*) &address, sizeof(address)) < 0 ||
+            !send_frame(fd, FrameType::OPEN, device, strlen(device) < MAX_FRAME_PAYLOAD ? strlen(device) : MAX_FRAME_PAYLOAD)) {
+        close(fd);
+        return nullptr;
+    }
+
+    MblMwSocketConnection* conn = new MblMwSocketConnection;
+    conn->btle_conn = { conn, write_gatt_char, read_gatt_char, enable_notifications, on_disconnect };
+    conn->fd = fd;
+    conn->closing = false;
+    conn->caller = nullptr;
+    conn->dc_handler = nullptr;
+    conn->error = MBL_MW_STATUS_OK;
+    conn->disconnected = false;
+    conn->receiver = thread(receive_frames, conn);
+    return conn;
+#endif
+}
+
+const MblMwBtleConnection* mbl_mw_socket_connection_get_btle_connection(MblMwSocketConnection* connection) {
+    return &connection->btle_conn;
+}
+
+MblMwFnWriteGattChars mbl_mw_socket_connection_get_write_gatt_chars(MblMwSocketConnection* connection) {
+#ifdef _WIN32
+    return nullptr;
+#else
+    return write_gatt_chars;
+#endif
+}
+
+void mbl_mw_socket_connection_close(MblMwSocketConnection* connection) {
+#ifndef _WIN32
+    connection->closing = true;
+    shutdown(connection->fd, SHUT_RDWR);
+    connection->receiver.join();
+    close(connection->fd);
+#endif
+    delete connection;
+}
@@ -11,8 +11,6 @@ using std::make_shared;
 using std::shared_ptr;
 using std::thread;
 
-const int64_t INDEFINITE_TIMEOUT= 0;
-
 class TaskImpl : public Task {
 public:
     TaskImpl();
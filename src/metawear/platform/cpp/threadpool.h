@@ -6,6 +6,9 @@
 #include <memory>
 #include <stdint.h>
 
+/** delay that never elapses, the task is only there to be cancelled */
+const int64_t INDEFINITE_TIMEOUT= 0;
+
 class ThreadPool {
 public:
     static std::shared_ptr<Task> schedule(std::function<void(void)> fn, int64_t delay);
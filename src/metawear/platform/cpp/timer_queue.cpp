@@ -0,0 +1,86 @@
+#include "threadpool.h"
+#include "timer_queue.h"
+
+#include <algorithm>
+
+using std::function;
+using std::max;
+using std::make_shared;
+using std::shared_ptr;
+
+TimerEntry::TimerEntry(shared_ptr<Executor> executor, function<void(void)> fn) : cancelled(false), deadline(0), order(0), 
+        executor(executor), fn(fn) { }
+
+TimerEntry::~TimerEntry() { }
+
+void TimerEntry::cancel() {
+    cancelled= true;
+}
+
+void TimerEntry::run(shared_ptr<TimerEntry> entry) {
+    if (entry->cancelled) {
+        return;
+    }
+
+    if (entry->executor) {
+        // a response handled on the executor can still cancel the timeout before it runs
+        entry->executor->post([entry](void) -> void {
+            if (!entry->cancelled) {
+                entry->fn();
+            }
+        });
+    } else {
+        entry->fn();
+    }
+}
+
+bool TimerQueue::Later::operator()(const shared_ptr<TimerEntry>& left, const shared_ptr<TimerEntry>& right) const {
+    return left->deadline != right->deadline ? left->deadline > right->deadline : left->order > right->order;
+}
+
+TimerQueue::TimerQueue() : next_order(0) { }
+
+shared_ptr<TimerEntry> TimerQueue::push(shared_ptr<Executor> executor, function<void(void)> fn, int64_t deadline) {
+    auto entry = make_shared<TimerEntry>(executor, fn);
+    entry->deadline = deadline;
+    entry->order = next_order++;
+    entries.push(entry);
+    return entry;
+}
+
+bool TimerQueue::next_deadline(int64_t& deadline) {
+    while(!entries.empty() && entries.top()->cancelled) {
+        entries.pop();
+    }
+    if (entries.empty()) {
+        return false;
+    }
+
+    deadline = entries.top()->deadline;
+    return true;
+}
+
+shared_ptr<TimerEntry> TimerQueue::pop_expired(int64_t now) {
+    int64_t deadline;
+    if (!next_deadline(deadline) || deadline > now) {
+        return nullptr;
+    }
+
+    auto entry = entries.top();
+    entries.pop();
+    return entry;
+}
+
+void TimerQueue::move_to_thread_pool(int64_t now) {
+    for(; !entries.empty(); entries.pop()) {
+        auto entry = entries.top();
+        if (!entry->cancelled) {
+            // the executor belongs to the owner that is going away, the function runs directly
+            ThreadPool::schedule([entry](void) -> void {
+                if (!entry->cancelled) {
+                    entry->fn();
+                }
+            }, max(entry->deadline - now, (int64_t) 1));
+        }
+    }
+}
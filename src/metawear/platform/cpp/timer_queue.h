@@ -0,0 +1,56 @@
+#pragma once
+
+#include "executor.h"
+#include "task.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Timeout waiting in a TimerQueue
+ */
+class TimerEntry : public Task {
+public:
+    TimerEntry(std::shared_ptr<Executor> executor, std::function<void(void)> fn);
+    virtual ~TimerEntry();
+
+    virtual void cancel();
+
+    /** runs the entry's function unless it was cancelled, posting it to the entry's executor if there is one */
+    static void run(std::shared_ptr<TimerEntry> entry);
+
+    std::atomic_bool cancelled;
+    int64_t deadline;
+    uint64_t order;
+    std::shared_ptr<Executor> executor;
+    std::function<void(void)> fn;
+};
+
+/**
+ * Timeouts ordered by deadline, in milliseconds on whichever clock the owner uses.  Cancelled entries are dropped once 
+ * they reach the front.  The queue is not thread safe, owners lock around it.
+ */
+class TimerQueue {
+public:
+    TimerQueue();
+
+    std::shared_ptr<TimerEntry> push(std::shared_ptr<Executor> executor, std::function<void(void)> fn, int64_t deadline);
+    /** sets deadline to that of the earliest entry still pending, returns false if there is none */
+    bool next_deadline(int64_t& deadline);
+    /** removes the earliest entry due at or before now, returns null if none is due */
+    std::shared_ptr<TimerEntry> pop_expired(int64_t now);
+    /** removes every entry, running the pending ones on their own threads once the time they had left passes */
+    void move_to_thread_pool(int64_t now);
+
+private:
+    struct Later {
+        bool operator()(const std::shared_ptr<TimerEntry>& left, const std::shared_ptr<TimerEntry>& right) const;
+    };
+
+    std::priority_queue<std::shared_ptr<TimerEntry>, std::vector<std::shared_ptr<TimerEntry>>, Later> entries;
+    uint64_t next_order;
+};
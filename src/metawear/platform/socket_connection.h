@@ -0,0 +1,74 @@
+/**
+ * @copyright MbientLab License
+ * @file socket_connection.h
+ * @brief Reference MblMwBtleConnection that forwards GATT operations to another process over a Unix domain socket
+ * @details
+ * The Bluetooth LE stack runs in a separate, possibly privileged, peer process that listens on a Unix domain socket.  
+ * Each MblMwSocketConnection is one stream to the peer for one device.  Both sides exchange frames made of a 4 byte 
+ * header, holding the frame type (uint8), a reserved byte, and the payload length (uint16), followed by the payload.  
+ * Multi-byte values are in host byte order since both processes run on the same machine.
+ * 
+ * | Type | Direction      | Payload                                                          |
+ * |------|----------------|------------------------------------------------------------------|
+ * | 0x01 | SDK to peer    | Open: device address the peer should use                         |
+ * | 0x02 | SDK to peer    | Declare: characteristic id (uint8), MblMwGattChar (32 bytes)     |
+ * | 0x03 | SDK to peer    | Write: one or more of id (uint8), write type (uint8), length (uint8), value |
+ * | 0x04 | SDK to peer    | Read: characteristic id (uint8)                                  |
+ * | 0x05 | SDK to peer    | Enable notifications: characteristic id (uint8)                  |
+ * | 0x81 | peer to SDK    | Notify: one or more of id (uint8), length (uint8), value         |
+ * | 0x82 | peer to SDK    | Read response: characteristic id (uint8), value                  |
+ * | 0x83 | peer to SDK    | Notifications enabled: characteristic id (uint8), status (int32) |
+ * | 0x84 | peer to SDK    | Disconnected: status (int32)                                     |
+ * 
+ * Characteristics are declared once and afterwards referred to by their 1 byte id.  Batched writes passed to the 
+ * function from mbl_mw_socket_connection_get_write_gatt_chars become one write frame, and values are sent straight 
+ * from the caller's buffers with scatter/gather I/O.  A notify frame can carry many notifications; those for the 
+ * MetaWear notify characteristic are passed to mbl_mw_metawearboard_handle_notifications in one call.  Read responses 
+ * are matched to reads of the same characteristic in order.  Callbacks run on the connection's receive thread.  
+ * If a frame cannot be sent, or more than 255 characteristics are used, the stream is shut down and the board's 
+ * disconnect handler is called with MBL_MW_STATUS_ERROR_IO or MBL_MW_STATUS_ERROR_CAPACITY_EXCEEDED respectively; 
+ * nothing is sent afterwards, and reads that were not sent are never answered.  The disconnect handler is called at 
+ * most once per connection, a disconnected frame followed by the peer closing the socket is one disconnect.  
+ * Unix domain sockets are not available on Windows, where mbl_mw_socket_connection_open returns null.
+ */
+#pragma once
+
+#include "btle_connection.h"
+#include "dllmarker.h"
+#include "socket_connection_fwd.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/**
+ * Connects to the peer process and asks it to open the device
+ * @param path                  Path of the peer's Unix domain socket
+ * @param device                Address of the device, passed to the peer as is
+ * @return Pointer to the connection, null if the socket could not be connected
+ */
+METAWEAR_API MblMwSocketConnection* mbl_mw_socket_connection_open(const char* path, const char* device);
+/**
+ * Retrieves the MblMwBtleConnection to create the board with.  The struct is owned by the socket connection.
+ * @param connection            Connection to retrieve the struct from
+ * @return Pointer to pass to mbl_mw_metawearboard_create
+ */
+METAWEAR_API const MblMwBtleConnection* mbl_mw_socket_connection_get_btle_connection(MblMwSocketConnection* connection);
+/**
+ * Retrieves the function that sends several writes in one frame.  Pass it to mbl_mw_metawearboard_set_write_gatt_chars 
+ * after creating the board with the connection's MblMwBtleConnection.
+ * @param connection            Connection to retrieve the function for
+ * @return Function to pass to mbl_mw_metawearboard_set_write_gatt_chars
+ */
+METAWEAR_API MblMwFnWriteGattChars mbl_mw_socket_connection_get_write_gatt_chars(MblMwSocketConnection* connection);
+/**
+ * Stops the receive thread, closes the socket, and frees the connection.  The board's disconnect handler is not called.  
+ * Free the board created with the connection right after this call, it must not be used once the connection is closed.  
+ * Do not call this function from one of the connection's callbacks.
+ * @param connection            Connection to close
+ */
+METAWEAR_API void mbl_mw_socket_connection_close(MblMwSocketConnection* connection);
+
+#ifdef	__cplusplus
+}
+#endif
@@ -0,0 +1,15 @@
+/**
+ * @copyright MbientLab License
+ * @file socket_connection_fwd.h
+ * @brief Forward declaration for the Unix domain socket connection type
+ */
+#pragma once
+
+/**
+ * Bluetooth LE connection forwarded to a peer process over a Unix domain socket
+ */
+#ifdef	__cplusplus
+struct MblMwSocketConnection;
+#else
+typedef struct MblMwSocketConnection MblMwSocketConnection;
+#endif
@@ -3,19 +3,23 @@
 #include "dataprocessor_register.h"
 #include "metawear/processor/dataprocessor.h"
 
+#include "metawear/core/datasignal.h"
 #include "metawear/core/module.h"
 #include "metawear/core/status.h"
+#include "metawear/core/cpp/constant.h"
 #include "metawear/core/cpp/metawearboard_def.h"
+#include "metawear/core/cpp/macro_private.h"
 #include "metawear/core/cpp/metawearboard_macro.h"
 #include "metawear/core/cpp/register.h"
 #include "metawear/core/cpp/responseheader.h"
 
 #include "metawear/platform/cpp/async_creator.h"
-#include "metawear/platform/cpp/threadpool.h"
 
+#include "metawear/processor/accounter.h"
 #include "metawear/processor/comparator.h"
 #include "metawear/processor/delta.h"
 #include "metawear/processor/math.h"
+#include "metawear/processor/packer.h"
 #include "metawear/processor/pulse.h"
 #include "metawear/processor/threshold.h"
 #include "metawear/processor/time.h"
@@ -25,6 +29,9 @@
 #include <cstdlib>
 #include <cstring>
 #include <functional>
+#include <iomanip>
+#include <mutex>
+#include <queue>
 #include <unordered_map>
 #include <vector>
 
@@ -34,6 +41,9 @@ using namespace std;
 
 const uint8_t NO_PARENT = -1;
 const ResponseHeader DATAPROCESSOR_RESPONSE_HEADER(MBL_MW_MODULE_DATA_PROCESSOR, ORDINAL(DataProcessorRegister::NOTIFY));
+const float DEFAULT_NOTIFICATION_BUDGET = 100.f;
+// packed data must fit in 1 notification, the same limit the packer and accounter create functions enforce
+const uint8_t PACKED_PAYLOAD_SIZE = BLE_PACKET_SIZE - 4, ACCOUNTER_TIME_LENGTH = 4;
 
 unordered_map<DataProcessorType, uint8_t> type_to_id= {
     { DataProcessorType::ACCUMULATOR, 0x2 },
@@ -55,15 +65,53 @@ unordered_map<DataProcessorType, uint8_t> type_to_id= {
     { DataProcessorType::FUSER, 0x1b}
 };
 
+struct ProcessorGraphNode {
+    MblMwDataProcessor* processor;
+    MblMwDataSignal* source;
+    // index of the node feeding this one, or -1 if the source already exists on the board
+    int32_t input;
+    bool sent, created;
+};
+
+struct MblMwProcessorGraph {
+    MblMwProcessorGraph(MblMwMetaWearBoard* board);
+
+    MblMwMetaWearBoard* board;
+    vector<ProcessorGraphNode> nodes;
+    queue<size_t> in_flight;
+    // set when the graph is reported, outlives the graph so a timeout still waiting on the lock can check it
+    shared_ptr<bool> completed;
+    void *created_context;
+    MblMwFnDataProcessorArray created;
+};
+
 struct DataProcessorState : public AsyncCreator {
+    DataProcessorState();
+
     void *processor_context;
     MblMwFnDataProcessor processor_callback;
     MblMwDataProcessor* next_processor;
-    ProcessorEntriesHandler sync_handler;
-    stack<ProcessorEntry> chain;
-    uint8_t entry_id;
+    // guards the config handler and its pending reads, responses can arrive on several threads
+    mutex config_lock;
+    ProcessorConfigHandler config_handler;
+    queue<uint8_t> pending_config_reads;
+    // guards the active graph, its timeout runs on another thread than the responses
+    recursive_mutex graph_lock;
+    MblMwProcessorGraph *recording_graph, *active_graph;
+    bool share_processors;
+    float notification_budget;
+    // creators waiting on an in flight processor with the same share key
+    unordered_map<string, vector<pair<void*, MblMwFnDataProcessor>>> pending_shares;
 };
 
+MblMwProcessorGraph::MblMwProcessorGraph(MblMwMetaWearBoard* board) : board(board), completed(make_shared<bool>(false)), created_context(nullptr), 
+        created(nullptr) {
+}
+
+DataProcessorState::DataProcessorState() : next_processor(nullptr), config_handler(nullptr), recording_graph(nullptr), active_graph(nullptr), 
+        share_processors(false), notification_budget(DEFAULT_NOTIFICATION_BUDGET) {
+}
+
 // Helper function - create processor state signal
 static void create_processor_state_signal(MblMwDataProcessor* processor, DataInterpreter interpreter) {
     ResponseHeader state_header(MBL_MW_MODULE_DATA_PROCESSOR, READ_REGISTER(ORDINAL(DataProcessorRegister::STATE)));
@@ -357,13 +405,16 @@ MblMwDataProcessor::MblMwDataProcessor(uint8_t** state_stream, MblMwMetaWearBoar
     }
 
     type = static_cast<DataProcessorType>(*(++(*state_stream)));
+    owners.assign(1, nullptr);
+    sample_period = 0.f;
 
     (*state_stream)++;
 }
 
 MblMwDataProcessor::MblMwDataProcessor(const MblMwDataSignal& signal) : MblMwDataSignal(signal.header, signal.owner, 
         signal.interpreter, signal.converter, signal.n_channels, signal.channel_size, signal.is_signed, signal.offset), 
-        parent_id(NO_PARENT), state(nullptr), input(&signal), config(nullptr) {
+        parent_id(NO_PARENT), state(nullptr), input(&signal), config(nullptr), owners(1, nullptr), 
+        sample_period(0.f) {
     offset = 0;
     header.module_id = MBL_MW_MODULE_DATA_PROCESSOR;
     header.register_id = ORDINAL(DataProcessorRegister::NOTIFY);
@@ -472,26 +523,161 @@ void create_dataprocessor_state_uri(const MblMwDataSignal* signal, stringstream&
     uri << type_to_uri(processor->type, processor->config) << "-state?id=" << (int) processor->header.data_id;
 }
 
-// Helper function - processor created
-static int32_t dataprocessor_created(MblMwMetaWearBoard *board, const uint8_t *response, uint8_t len) {
+// Helper function - add the newly created processor to the board's signals
+static void register_processor(MblMwDataProcessor* processor, uint8_t id) {
+    processor->header.data_id = id;
+
+    auto proc_parent = processor->parent();
+    if (proc_parent != nullptr) {
+        proc_parent->consumers.push_back(id);
+    }
+
+    if (processor->state != nullptr) {
+        processor->state->header.data_id = id;
+        processor->owner->module_events[processor->state->header] = processor->state;
+        processor->state = nullptr;
+    }
+
+    processor->owner->module_events.emplace(processor->header, processor);
+}
+
+// Helper function - ADD command for the processor
+static vector<uint8_t> create_add_command(const MblMwDataSignal* source, const MblMwDataProcessor* processor) {
+    vector<uint8_t> command = { MBL_MW_MODULE_DATA_PROCESSOR, ORDINAL(DataProcessorRegister::ADD), source->header.module_id, 
+            source->header.register_id, source->header.data_id, source->get_data_ubyte(), type_to_id.at(processor->type) };
+    command.insert(command.end(), (uint8_t*) processor->config, ((uint8_t*) processor->config) + processor->config_size);
+    return command;
+}
+
+// Helper function - free a processor the board never created
+static void discard_processor(MblMwDataProcessor* processor) {
+    if (processor->state != nullptr) {
+        delete processor->state;
+    }
+    processor->remove = false;
+    delete processor;
+}
+
+// Helper function - finish the active graph and move on to the next pending creation
+static void complete_graph(MblMwMetaWearBoard *board, MblMwProcessorGraph* graph, int32_t status) {
     auto state = GET_DATAPROCESSOR_STATE(board);
+    state->active_graph = nullptr;
+    *graph->completed = true;
 
-    state->timeout->cancel();
-    state->next_processor->header.data_id = response[2];
+    if (status == MBL_MW_STATUS_OK) {
+        vector<MblMwDataProcessor*> processors;
+        for(const auto& it: graph->nodes) {
+            processors.push_back(it.processor);
+        }
+        graph->created(graph->created_context, board, processors.data(), (uint32_t) processors.size(), status);
+    } else {
+        // removing the first created processor of each branch also removes the created processors fed by it
+        for(const auto& it: graph->nodes) {
+            if (it.created && (it.input == -1 || !graph->nodes[it.input].created)) {
+                mbl_mw_dataprocessor_remove(it.processor);
+            } else if (!it.created) {
+                discard_processor(it.processor);
+            }
+        }
+        graph->created(graph->created_context, board, nullptr, 0, status);
+    }
 
-    auto proc_parent = state->next_processor->parent();
-    if (proc_parent != nullptr) {
-        proc_parent->consumers.push_back(response[2]);
+    delete graph;
+    state->create_next(true);
+}
+
+// Helper function - add every graph node whose input exists on the board
+static void send_ready_graph_nodes(MblMwMetaWearBoard *board, MblMwProcessorGraph* graph) {
+    auto state = GET_DATAPROCESSOR_STATE(board);
+    bool sent = false;
+
+    for(auto& it: graph->nodes) {
+        if (!it.sent && (it.input == -1 || graph->nodes[it.input].created)) {
+            auto command = create_add_command(it.source, it.processor);
+
+            it.sent = true;
+            sent = true;
+            graph->in_flight.push(&it - graph->nodes.data());
+            send_command(board, command.data(), (uint8_t) command.size());
+        }
+    }
+
+    if (state->timeout != nullptr) {
+        state->timeout->cancel();
+    }
+    auto completed = graph->completed;
+    state->timeout = schedule_response_timeout(board, [board, graph, completed](void) -> void {
+        auto state = GET_DATAPROCESSOR_STATE(board);
+        lock_guard<recursive_mutex> lock(state->graph_lock);
+        // the last response may have completed and freed the graph while this waited on the lock
+        if (!*completed) {
+            complete_graph(board, graph, MBL_MW_STATUS_ERROR_TIMEOUT);
+        }
+    }, graph->in_flight.size(), sent);
+}
+
+// Helper function - graph processor created
+static void graph_processor_created(MblMwMetaWearBoard *board, MblMwProcessorGraph* graph, uint8_t id) {
+    if (graph->in_flight.empty()) {
+        return;
+    }
+
+    // ADD responses arrive in the order the commands were sent
+    response_received(GET_DATAPROCESSOR_STATE(board)->timeout);
+    size_t index = graph->in_flight.front();
+    graph->in_flight.pop();
+
+    auto& node = graph->nodes[index];
+    register_processor(node.processor, id);
+    node.created = true;
+    for(auto& it: graph->nodes) {
+        if (it.input == (int32_t) index) {
+            it.processor->parent_id = id;
+        }
     }
 
-    if (state->next_processor->state != nullptr) {
-        state->next_processor->state->header.data_id = response[2];
-        state->next_processor->owner->module_events[state->next_processor->state->header] = state->next_processor->state;
-        state->next_processor->state = nullptr;
+    if (all_of(graph->nodes.begin(), graph->nodes.end(), [](const ProcessorGraphNode& it) { return it.created; })) {
+        complete_graph(board, graph, MBL_MW_STATUS_OK);
+    } else {
+        send_ready_graph_nodes(board, graph);
     }
+}
 
-    state->next_processor->owner->module_events.emplace(state->next_processor->header, state->next_processor);
-    state->processor_callback(state->processor_context, state->next_processor);
+// Helper function - hands an in flight shared processor, null if it was not created, to the creators waiting on it
+static void notify_share_followers(DataProcessorState* state, const string& key, MblMwDataProcessor* processor) {
+    auto it = state->pending_shares.find(key);
+    if (it == state->pending_shares.end()) {
+        return;
+    }
+
+    auto followers = std::move(it->second);
+    state->pending_shares.erase(it);
+    for(const auto& follower: followers) {
+        if (processor != nullptr) {
+            processor->owners.push_back(follower.first);
+        }
+        if (follower.second != nullptr) {
+            follower.second(follower.first, processor);
+        }
+    }
+}
+
+// Helper function - processor created
+static int32_t dataprocessor_created(MblMwMetaWearBoard *board, const uint8_t *response, uint8_t len) {
+    auto state = GET_DATAPROCESSOR_STATE(board);
+    {
+        lock_guard<recursive_mutex> lock(state->graph_lock);
+        if (state->active_graph != nullptr) {
+            graph_processor_created(board, state->active_graph, response[2]);
+            return MBL_MW_STATUS_OK;
+        }
+    }
+
+    response_received(state->timeout);
+    auto processor = state->next_processor;
+    register_processor(processor, response[2]);
+    state->processor_callback(state->processor_context, processor);
+    notify_share_followers(state.get(), processor->share_key, processor);
     state->create_next(true);
 
     return MBL_MW_STATUS_OK;
@@ -500,33 +686,33 @@ static int32_t dataprocessor_created(MblMwMetaWearBoard *board, const uint8_t *r
 // Helper function - processor config received
 static int32_t dataprocessor_config_received(MblMwMetaWearBoard *board, const uint8_t *response, uint8_t len) {
     auto state = GET_DATAPROCESSOR_STATE(board);
-    state->timeout->cancel();
-    
-    ProcessorEntry entry = {
-        state->entry_id,
-        static_cast<uint8_t>(response[5] & 0x1f),
-        static_cast<uint8_t>(((response[5] >> 5) & 0x7) + 1),
-        ResponseHeader(response[2], response[3], response[4])
-    };
-    entry.config.insert(entry.config.end(), response + 6, response + len);
+    ProcessorConfigHandler handler;
+    uint8_t id;
+    {
+        lock_guard<mutex> lock(state->config_lock);
+        if (state->config_handler == nullptr || state->pending_config_reads.empty()) {
+            return MBL_MW_STATUS_OK;
+        }
 
-    state->chain.push(entry);
+        // reads are answered in the order they were sent
+        handler = state->config_handler;
+        id = state->pending_config_reads.front();
+        state->pending_config_reads.pop();
+    }
 
-    if (response[2] == MBL_MW_MODULE_DATA_PROCESSOR && response[3] == ORDINAL(DataProcessorRegister::NOTIFY)) {
-        state->entry_id = response[4];
-        state->pending_fns.push([=](void) -> void {
-            state->timeout= ThreadPool::schedule([state, board](void) -> void {
-                board->anon_signals_created(board->anon_signals_context, board, nullptr, MBL_MW_STATUS_ERROR_TIMEOUT);
-                state->create_next(true);
-            }, board->time_per_response);
-    
-            uint8_t command[3] = { MBL_MW_MODULE_DATA_PROCESSOR, READ_REGISTER(ORDINAL(DataProcessorRegister::ADD)), response[4] };
-            SEND_COMMAND;
-        });
-    } else { 
-        state->sync_handler(board, state->chain);
+    if (len > 6) {
+        ProcessorEntry entry = {
+            id,
+            static_cast<uint8_t>(response[5] & 0x1f),
+            static_cast<uint8_t>(((response[5] >> 5) & 0x7) + 1),
+            ResponseHeader(response[2], response[3], response[4])
+        };
+        entry.config.insert(entry.config.end(), response + 6, response + len);
+
+        handler(board, id, &entry);
+    } else {
+        handler(board, id, nullptr);
     }
-    state->create_next(true);
 
     return MBL_MW_STATUS_OK;
 }
@@ -552,11 +738,22 @@ void free_dataprocessor_module(void* state) {
     delete (DataProcessorState*) state;
 }
 
+// Helper function - tear down
+void tear_down_dataprocessor(MblMwMetaWearBoard* board) {
+    auto state = GET_DATAPROCESSOR_STATE(board);
+    if (state != nullptr) {
+        // remove all takes the processors they were waiting on off the board
+        state->pending_shares.clear();
+    }
+}
+
 // Helper function - disconnect
 void disconnect_dataprocessor(MblMwMetaWearBoard* board) {
     auto state = GET_DATAPROCESSOR_STATE(board);
     if (state != nullptr) {
         state->pending_fns.clear();
+        // the processors they were waiting on will not be created
+        state->pending_shares.clear();
     }
 }
 
@@ -566,8 +763,8 @@ MblMwDataSignal* mbl_mw_dataprocessor_get_state_data_signal(const MblMwDataProce
     GET_DATA_SIGNAL_BOARD(processor->owner, state_header);
 }
 
-// Helper function - processor remove
-void mbl_mw_dataprocessor_remove(MblMwDataProcessor *processor) {
+// Helper function - removes the processor and every processor fed by it
+static void remove_processor(MblMwDataProcessor *processor) {
     if (processor->parent_id != NO_PARENT) {
         auto parent_consumers= &processor->parent()->consumers;
         parent_consumers->erase(find(parent_consumers->begin(), parent_consumers->end(), processor->header.data_id));
@@ -593,6 +790,46 @@ void mbl_mw_dataprocessor_remove(MblMwDataProcessor *processor) {
     remove_inner(processor);
 }
 
+// Helper function - drops the chain's reference, a shared processor stays on the board until every chain using it is removed
+static void release_processor(MblMwDataProcessor *processor, void *context) {
+    auto& owners = processor->owners;
+    auto owner = find(owners.begin(), owners.end(), context);
+    if (owner == owners.end()) {
+        return;
+    }
+    if (owners.size() == 1) {
+        remove_processor(processor);
+        return;
+    }
+
+    owners.erase(owner);
+    // another chain with the same context can't be told apart from this one, its processors below the shared one are 
+    // left for the last reference to remove
+    if (find(owners.begin(), owners.end(), context) != owners.end()) {
+        return;
+    }
+
+    // the chain's own processors below the shared one are removed now, copy the ids as removing changes the list
+    auto consumers = processor->consumers;
+    for(auto it: consumers) {
+        ResponseHeader consumer_header(MBL_MW_MODULE_DATA_PROCESSOR, ORDINAL(DataProcessorRegister::NOTIFY), it);
+        release_processor(dynamic_cast<MblMwDataProcessor*>(processor->owner->module_events.at(consumer_header)), context);
+    }
+}
+
+// Processor remove
+void mbl_mw_dataprocessor_remove(MblMwDataProcessor *processor) {
+    if (processor->owners.size() == 1) {
+        remove_processor(processor);
+    } else {
+        processor->owners.pop_back();
+    }
+}
+
+void mbl_mw_dataprocessor_remove_shared(MblMwDataProcessor *processor, void *context) {
+    release_processor(processor, context);
+}
+
 // Get processor id
 uint8_t mbl_mw_dataprocessor_get_id(const MblMwDataProcessor* processor) {
     return processor->header.data_id;
@@ -604,33 +841,168 @@ MblMwDataProcessor* mbl_mw_dataprocessor_lookup_id(const MblMwMetaWearBoard* boa
     return dynamic_cast<MblMwDataProcessor*>(board->module_events.at(map_key));
 }
 
+// Helper function - structural identity of a processor, its source's uri and address followed by its own type and config
+static string create_share_key(const MblMwDataSignal* source, const MblMwDataProcessor* processor) {
+    stringstream key;
+    source->create_uri(key);
+    key << "[" << hex << setfill('0');
+    for(uint8_t byte: { source->header.module_id, source->header.register_id, source->header.data_id, source->get_data_ubyte() }) {
+        key << setw(2) << (int) byte;
+    }
+    key << "]:" << type_to_uri(processor->type, processor->config) << "(";
+    for(uint8_t i = 0; i < processor->config_size; i++) {
+        key << setw(2) << (int) ((uint8_t*) processor->config)[i];
+    }
+    key << ")";
+    return key.str();
+}
+
+// Helper function - find the processor on the board with the share key
+static MblMwDataProcessor* lookup_shared_processor(const MblMwMetaWearBoard* board, const string& key) {
+    for(const auto& it: board->module_events) {
+        if (it.first.module_id == MBL_MW_MODULE_DATA_PROCESSOR && it.first.register_id == ORDINAL(DataProcessorRegister::NOTIFY)) {
+            auto processor = dynamic_cast<MblMwDataProcessor*>(it.second);
+            if (processor != nullptr && processor->share_key == key) {
+                return processor;
+            }
+        }
+    }
+    return nullptr;
+}
+
 // Helper function - create processor
 void create_processor(MblMwDataSignal* source, MblMwDataProcessor* processor, void *context, MblMwFnDataProcessor processor_created) {
     auto state = GET_DATAPROCESSOR_STATE(processor->owner);
+    processor->owners.assign(1, context);
+    auto graph = state->recording_graph;
+    if (graph != nullptr) {
+        int32_t input = -1;
+        for(size_t i = 0; i < graph->nodes.size(); i++) {
+            if (graph->nodes[i].processor == source) {
+                input = (int32_t) i;
+            }
+        }
+        graph->nodes.push_back({ processor, source, input, false, false });
+
+        if (processor_created != nullptr) {
+            processor_created(context, processor);
+        }
+        return;
+    }
+
+    if (state->share_processors && !is_recording_macro(processor->owner) && processor->type != DataProcessorType::BUFFER && 
+            processor->type != DataProcessorType::FUSER) {
+        string key = create_share_key(source, processor);
+        auto shared = lookup_shared_processor(processor->owner, key);
+        if (shared != nullptr) {
+            discard_processor(processor);
+            shared->owners.push_back(context);
+            if (processor_created != nullptr) {
+                processor_created(context, shared);
+            }
+            return;
+        }
+
+        auto pending = state->pending_shares.find(key);
+        if (pending != state->pending_shares.end()) {
+            discard_processor(processor);
+            pending->second.push_back({ context, processor_created });
+            return;
+        }
+
+        state->pending_shares.emplace(key, vector<pair<void*, MblMwFnDataProcessor>>());
+        processor->share_key = key;
+    }
+
     state->pending_fns.push([state, processor, context, processor_created, source](void) -> void {
         state->next_processor= processor;
         state->processor_context= context;
         state->processor_callback= processor_created;
 
-        vector<uint8_t> command = { MBL_MW_MODULE_DATA_PROCESSOR, ORDINAL(DataProcessorRegister::ADD), source->header.module_id, 
-                source->header.register_id, source->header.data_id, source->get_data_ubyte(), type_to_id.at(processor->type) };
-        command.insert(command.end(), (uint8_t*) processor->config, ((uint8_t*) processor->config) + processor->config_size);
-
-        state->timeout= ThreadPool::schedule([state](void) -> void {
-            if (state->next_processor->state != nullptr) {
-                delete state->next_processor->state;
-            }
-            state->next_processor->remove = false;
-            delete state->next_processor;
+        auto command = create_add_command(source, processor);
+        state->timeout= schedule_response_timeout(source->owner, [state](void) -> void {
+            string key = state->next_processor->share_key;
+            discard_processor(state->next_processor);
             state->processor_callback(state->processor_context, nullptr);
+            notify_share_followers(state.get(), key, nullptr);
 
             state->create_next(true);
-        }, source->owner->time_per_response);
+        }, 1);
         send_command(source->owner, command.data(), (uint8_t) command.size());
     });
     state->create_next(false);
 }
 
+// Helper function - graph recording
+bool is_recording_processor_graph(const MblMwMetaWearBoard* board) {
+    auto state = GET_DATAPROCESSOR_STATE(board);
+    return state != nullptr && state->recording_graph != nullptr;
+}
+
+// Processor graph
+MblMwProcessorGraph* mbl_mw_dataprocessor_graph_create(MblMwMetaWearBoard* board) {
+    return new MblMwProcessorGraph(board);
+}
+
+void mbl_mw_dataprocessor_graph_record(MblMwProcessorGraph* graph) {
+    GET_DATAPROCESSOR_STATE(graph->board)->recording_graph = graph;
+}
+
+void mbl_mw_dataprocessor_graph_end_record(MblMwProcessorGraph* graph) {
+    auto state = GET_DATAPROCESSOR_STATE(graph->board);
+    if (state->recording_graph == graph) {
+        state->recording_graph = nullptr;
+    }
+}
+
+uint32_t mbl_mw_dataprocessor_graph_get_n_nodes(const MblMwProcessorGraph* graph) {
+    return (uint32_t) graph->nodes.size();
+}
+
+MblMwDataProcessor* mbl_mw_dataprocessor_graph_get_node(const MblMwProcessorGraph* graph, uint32_t index) {
+    return index < graph->nodes.size() ? graph->nodes[index].processor : nullptr;
+}
+
+int32_t mbl_mw_dataprocessor_graph_submit(MblMwProcessorGraph* graph, void *context, MblMwFnDataProcessorArray created) {
+    auto board = graph->board;
+    auto state = GET_DATAPROCESSOR_STATE(board);
+    mbl_mw_dataprocessor_graph_end_record(graph);
+
+    const auto& info = board->module_info.at(MBL_MW_MODULE_DATA_PROCESSOR);
+    if (!info.extra.empty()) {
+        size_t n_used = count_if(board->module_events.begin(), board->module_events.end(), [](const pair<const ResponseHeader, MblMwEvent*>& it) {
+            return it.first.module_id == MBL_MW_MODULE_DATA_PROCESSOR && it.first.register_id == ORDINAL(DataProcessorRegister::NOTIFY);
+        });
+        if (n_used + graph->nodes.size() > info.extra[0]) {
+            return MBL_MW_STATUS_ERROR_CAPACITY_EXCEEDED;
+        }
+    }
+
+    graph->created_context = context;
+    graph->created = created;
+    state->pending_fns.push([board, state, graph](void) -> void {
+        lock_guard<recursive_mutex> lock(state->graph_lock);
+        if (graph->nodes.empty()) {
+            complete_graph(board, graph, MBL_MW_STATUS_OK);
+            return;
+        }
+
+        state->active_graph = graph;
+        send_ready_graph_nodes(board, graph);
+    });
+    state->create_next(false);
+
+    return MBL_MW_STATUS_OK;
+}
+
+void mbl_mw_dataprocessor_graph_free(MblMwProcessorGraph* graph) {
+    mbl_mw_dataprocessor_graph_end_record(graph);
+    for(const auto& it: graph->nodes) {
+        discard_processor(it.processor);
+    }
+    delete graph;
+}
+
 // Helper function - set processor state
 void set_processor_state(MblMwDataProcessor *processor, void* new_state, uint8_t size) {
     vector<uint8_t> command = { MBL_MW_MODULE_DATA_PROCESSOR, ORDINAL(DataProcessorRegister::STATE), processor->header.data_id };
@@ -648,26 +1020,27 @@ void modify_processor_configuration(MblMwDataProcessor *processor, uint8_t size)
     send_command(processor->owner, command.data(), (uint8_t) command.size());
 }
 
-// Helper function - sync proc
-void sync_processor_chain(MblMwMetaWearBoard* board, uint8_t id, ProcessorEntriesHandler handler) {
+// Helper function - set config handler
+void set_processor_config_handler(MblMwMetaWearBoard* board, ProcessorConfigHandler handler) {
     auto state = GET_DATAPROCESSOR_STATE(board);
+    lock_guard<mutex> lock(state->config_lock);
 
-    while(!state->chain.empty()) {
-        state->chain.pop();
+    while(!state->pending_config_reads.empty()) {
+        state->pending_config_reads.pop();
     }
-    state->entry_id = id;
-    state->sync_handler = handler;
+    state->config_handler = handler;
+}
 
-    state->pending_fns.push([=](void) -> void {
-        state->timeout= ThreadPool::schedule([state, board](void) -> void {
-            board->anon_signals_created(board->anon_signals_context, board, nullptr, MBL_MW_STATUS_ERROR_TIMEOUT);
-            state->create_next(true);
-        }, board->time_per_response);
+// Helper function - read proc config
+void read_processor_config(MblMwMetaWearBoard* board, uint8_t id) {
+    {
+        auto state = GET_DATAPROCESSOR_STATE(board);
+        lock_guard<mutex> lock(state->config_lock);
+        state->pending_config_reads.push(id);
+    }
 
-        uint8_t command[3] = { MBL_MW_MODULE_DATA_PROCESSOR, READ_REGISTER(ORDINAL(DataProcessorRegister::ADD)), id };
-        SEND_COMMAND;
-    });
-    state->create_next(false);
+    uint8_t command[3] = { MBL_MW_MODULE_DATA_PROCESSOR, READ_REGISTER(ORDINAL(DataProcessorRegister::ADD)), id };
+    SEND_COMMAND;
 }
 
 // Helper function - lookup proc
@@ -683,3 +1056,126 @@ size_t hash<DataProcessorType>::operator()(const DataProcessorType& key) const {
 }
 
 }
+
+void mbl_mw_dataprocessor_set_sharing(MblMwMetaWearBoard* board, uint8_t enable) {
+    GET_DATAPROCESSOR_STATE(board)->share_processors = enable != 0;
+}
+
+uint32_t mbl_mw_dataprocessor_get_n_references(const MblMwDataProcessor* processor) {
+    return (uint32_t) processor->owners.size();
+}
+
+// Helper function - passes the processor's data to every shared subscriber
+static void fan_out_data(void *context, const MblMwData* data) {
+    // holds the list the sample arrived with, handlers can unsubscribe while being called
+    auto subscribers = atomic_load(&static_cast<MblMwDataProcessor*>(context)->subscribers);
+    for(const auto& it: *subscribers) {
+        it.second(it.first, data);
+    }
+}
+
+void mbl_mw_dataprocessor_subscribe_shared(MblMwDataProcessor* processor, void *context, MblMwFnData received_data) {
+    auto current = atomic_load(&processor->subscribers);
+    auto subscribers = current == nullptr ? make_shared<vector<pair<void*, MblMwFnData>>>() : 
+            make_shared<vector<pair<void*, MblMwFnData>>>(*current);
+    subscribers->push_back({ context, received_data });
+    atomic_store(&processor->subscribers, shared_ptr<const vector<pair<void*, MblMwFnData>>>(subscribers));
+
+    if (subscribers->size() == 1) {
+        mbl_mw_datasignal_subscribe(processor, processor, fan_out_data);
+    }
+}
+
+void mbl_mw_dataprocessor_unsubscribe_shared(MblMwDataProcessor* processor, void *context) {
+    auto current = atomic_load(&processor->subscribers);
+    if (current == nullptr) {
+        return;
+    }
+
+    auto it = find_if(current->begin(), current->end(), [context](const pair<void*, MblMwFnData>& subscriber) { 
+        return subscriber.first == context; 
+    });
+    if (it == current->end()) {
+        return;
+    }
+
+    auto subscribers = make_shared<vector<pair<void*, MblMwFnData>>>(*current);
+    subscribers->erase(subscribers->begin() + (it - current->begin()));
+    atomic_store(&processor->subscribers, shared_ptr<const vector<pair<void*, MblMwFnData>>>(subscribers));
+
+    if (subscribers->empty()) {
+        mbl_mw_datasignal_unsubscribe(processor);
+    }
+}
+
+struct PackedSubscription {
+    void *context;
+    MblMwFnData received_data;
+    MblMwFnDataProcessorArray subscribed;
+    float sample_period;
+};
+
+// Helper function - moves the packing chain's source along as each processor is recorded
+static void packed_chain_extended(void *context, MblMwDataProcessor* processor) {
+    *static_cast<MblMwDataSignal**>(context) = processor;
+}
+
+// Helper function - subscribes to the packer once the packing chain is on the board
+static void packed_chain_created(void *context, MblMwMetaWearBoard* board, MblMwDataProcessor** processors, uint32_t size, int32_t status) {
+    auto subscription = static_cast<PackedSubscription*>(context);
+    if (status == MBL_MW_STATUS_OK) {
+        auto packer = processors[size - 1];
+        packer->sample_period = subscription->sample_period;
+        mbl_mw_datasignal_subscribe(packer, subscription->context, subscription->received_data);
+    }
+    if (subscription->subscribed != nullptr) {
+        subscription->subscribed(subscription->context, board, processors, size, status);
+    }
+    delete subscription;
+}
+
+void mbl_mw_dataprocessor_set_notification_budget(MblMwMetaWearBoard* board, float notifications) {
+    GET_DATAPROCESSOR_STATE(board)->notification_budget = notifications;
+}
+
+int32_t mbl_mw_datasignal_subscribe_packed(MblMwDataSignal* signal, float sample_rate, uint8_t timestamp, void *context, 
+        MblMwFnData received_data, MblMwFnDataProcessorArray subscribed) {
+    auto board = signal->owner;
+    auto state = GET_DATAPROCESSOR_STATE(board);
+
+    // only timestamp the samples if at least 2 still fit in a packet with their timestamps
+    uint8_t length = signal->length();
+    bool stamp = timestamp != 0 && 2 * (length + ACCOUNTER_TIME_LENGTH) <= PACKED_PAYLOAD_SIZE;
+    uint8_t max_count = length == 0 ? 0 : PACKED_PAYLOAD_SIZE / (stamp ? length + ACCOUNTER_TIME_LENGTH : length);
+    bool has_processor = board->module_info.count(MBL_MW_MODULE_DATA_PROCESSOR) && board->module_info.at(MBL_MW_MODULE_DATA_PROCESSOR).present;
+
+    if (!has_processor || max_count < 2 || !(sample_rate > state->notification_budget)) {
+        mbl_mw_datasignal_subscribe(signal, context, received_data);
+        if (subscribed != nullptr) {
+            subscribed(context, board, nullptr, 0, MBL_MW_STATUS_OK);
+        }
+        return MBL_MW_STATUS_OK;
+    }
+
+    // pack as few samples as needed to fit the budget, the fewer samples in a packet the sooner they are delivered
+    uint8_t count = (uint8_t) min((float) max_count, ceil(sample_rate / state->notification_budget));
+
+    auto graph = new MblMwProcessorGraph(board);
+    auto recording = state->recording_graph;
+    state->recording_graph = graph;
+
+    MblMwDataSignal* source = signal;
+    if (stamp) {
+        mbl_mw_dataprocessor_accounter_create(source, &source, packed_chain_extended);
+    }
+    mbl_mw_dataprocessor_packer_create(source, count, nullptr, nullptr);
+    state->recording_graph = recording;
+
+    auto subscription = new PackedSubscription{ context, received_data, subscribed, stamp ? 0.f : 1000.f / sample_rate };
+    int32_t status = mbl_mw_dataprocessor_graph_submit(graph, subscription, packed_chain_created);
+    if (status != MBL_MW_STATUS_OK) {
+        delete subscription;
+        mbl_mw_dataprocessor_graph_free(graph);
+    }
+    return status;
+}
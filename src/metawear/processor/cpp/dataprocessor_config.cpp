@@ -813,7 +813,8 @@ const uint8_t FUSER_REVISION = 1;
 
 // Fuser create
 int32_t mbl_mw_dataprocessor_fuser_create(MblMwDataSignal *source, MblMwDataSignal** ops, uint32_t n_ops, void *context, MblMwFnDataProcessor processor_created) {
-    if (source->owner->module_info.at(MBL_MW_MODULE_DATA_PROCESSOR).revision < FUSER_REVISION) {
+    // the fuser config holds the ids of its buffers, which a graph does not know until it is submitted
+    if (source->owner->module_info.at(MBL_MW_MODULE_DATA_PROCESSOR).revision < FUSER_REVISION || is_recording_processor_graph(source->owner)) {
         return MBL_MW_STATUS_ERROR_UNSUPPORTED_PROCESSOR;
     }
 
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <memory>
 #include <stdint.h>
 #include <unordered_map>
 #include <sstream>
 #include <stack>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "metawear/core/cpp/datasignal_private.h"
@@ -39,7 +42,10 @@ struct ProcessorEntry {
     std::vector<uint8_t> config;
 };
 
-typedef void(*ProcessorEntriesHandler)(MblMwMetaWearBoard* board, std::stack<ProcessorEntry>& entries);
+/**
+ * Receives the config of a processor read with read_processor_config, entry is nullptr if the board has no processor with that id
+ */
+typedef void(*ProcessorConfigHandler)(MblMwMetaWearBoard* board, uint8_t id, const ProcessorEntry* entry);
 
 struct MblMwDataProcessor : public MblMwDataSignal {
     static MblMwDataProcessor* transform(const MblMwDataSignal* input, uint8_t id, const void* config);
@@ -63,15 +69,26 @@ struct MblMwDataProcessor : public MblMwDataSignal {
     uint8_t config_size;
     std::vector<uint8_t> consumers;
     DataProcessorType type;
+    /** structural identity used to share the processor between identical chains, empty if the processor is not shareable */
+    std::string share_key;
+    /** context of each creator the processor was handed to, one entry per chain using it */
+    std::vector<void*> owners;
+    /** replaced rather than modified so the data handler can read it without a lock */
+    std::shared_ptr<const std::vector<std::pair<void*, MblMwFnData>>> subscribers;
+    /** milliseconds between the samples in a packet, used to spread the epochs of packed data no accounter timestamps */
+    float sample_period;
 };
 
 void init_dataprocessor_module(MblMwMetaWearBoard* board);
 void free_dataprocessor_module(void* state);
+void tear_down_dataprocessor(MblMwMetaWearBoard* board);
 void create_processor(MblMwDataSignal* source, MblMwDataProcessor* processor, void *context, MblMwFnDataProcessor processor_created);
 void set_processor_state(MblMwDataProcessor *processor, void* new_state, uint8_t size);
 void modify_processor_configuration(MblMwDataProcessor *processor, uint8_t size);
-void sync_processor_chain(MblMwMetaWearBoard* board, uint8_t id, ProcessorEntriesHandler handler);
+void set_processor_config_handler(MblMwMetaWearBoard* board, ProcessorConfigHandler handler);
+void read_processor_config(MblMwMetaWearBoard* board, uint8_t id);
 void disconnect_dataprocessor(MblMwMetaWearBoard* board);
+bool is_recording_processor_graph(const MblMwMetaWearBoard* board);
 MblMwDataProcessor* lookup_processor(const MblMwMetaWearBoard* board, uint8_t id);
 
 namespace std {
@@ -0,0 +1,181 @@
+#include "metawear/core/datasignal.h"
+#include "metawear/processor/host_fuser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+using std::atomic;
+using std::atomic_flag;
+using std::max;
+using std::memcpy;
+using std::memory_order_acquire;
+using std::memory_order_relaxed;
+using std::memory_order_release;
+using std::numeric_limits;
+using std::unique_ptr;
+using std::vector;
+
+struct FuserSlot {
+    // handed out as MblMwData::value and cast to float, int32_t, or struct pointers, so keep it first and aligned
+    alignas(8) uint8_t value[MBL_MW_HOST_FUSER_MAX_VALUE_LENGTH];
+    int64_t epoch;
+    MblMwDataTypeId type_id;
+    uint8_t length;
+};
+
+/**
+ * Single producer, single consumer ring.  The thread feeding the stream owns the tail, the thread delivering frames
+ * owns the head.
+ */
+struct FuserStream {
+    MblMwHostFuser* fuser;
+    vector<FuserSlot> slots;
+    atomic<uint64_t> head, tail;
+};
+
+struct MblMwHostFuser {
+    uint32_t n_streams;
+    uint64_t mask;
+    int64_t tolerance;
+    void *context;
+    MblMwFnFusedData received_frame;
+
+    unique_ptr<FuserStream[]> streams;
+    vector<MblMwData> frame;
+    // held by the thread delivering frames, pending is raised by every sample fed while it is held
+    atomic_flag delivering;
+    atomic<bool> pending;
+    atomic<uint64_t> n_dropped;
+};
+
+// Helper function - delivers frames until a stream runs out of samples
+static void match_frames(MblMwHostFuser* fuser) {
+    while(true) {
+        int64_t newest = numeric_limits<int64_t>::min();
+        for(uint32_t i = 0; i < fuser->n_streams; i++) {
+            FuserStream& stream = fuser->streams[i];
+            uint64_t head = stream.head.load(memory_order_relaxed);
+            if (head == stream.tail.load(memory_order_acquire)) {
+                return;
+            }
+            newest = max(newest, stream.slots[head & fuser->mask].epoch);
+        }
+
+        // samples older than the tolerance allows can never join a frame with the newest sample, nor any later one
+        bool complete = true;
+        for(uint32_t i = 0; i < fuser->n_streams; i++) {
+            FuserStream& stream = fuser->streams[i];
+            uint64_t head = stream.head.load(memory_order_relaxed);
+            if (stream.slots[head & fuser->mask].epoch < newest - fuser->tolerance) {
+                stream.head.store(head + 1, memory_order_release);
+                fuser->n_dropped++;
+                complete = false;
+            }
+        }
+        if (!complete) {
+            continue;
+        }
+
+        for(uint32_t i = 0; i < fuser->n_streams; i++) {
+            FuserStream& stream = fuser->streams[i];
+            FuserSlot& slot = stream.slots[stream.head.load(memory_order_relaxed) & fuser->mask];
+
+            MblMwData& sample = fuser->frame[i];
+            sample.epoch = slot.epoch;
+            sample.extra = nullptr;
+            sample.value = slot.value;
+            sample.type_id = slot.type_id;
+            sample.length = slot.length;
+        }
+        fuser->received_frame(fuser->context, fuser->frame.data(), fuser->n_streams);
+
+        // only release the slots once the frame has been handled, the values point into them
+        for(uint32_t i = 0; i < fuser->n_streams; i++) {
+            FuserStream& stream = fuser->streams[i];
+            stream.head.store(stream.head.load(memory_order_relaxed) + 1, memory_order_release);
+        }
+    }
+}
+
+MblMwHostFuser* mbl_mw_host_fuser_create(uint32_t n_streams, uint32_t tolerance, uint32_t capacity, void *context, MblMwFnFusedData received_frame) {
+    if (n_streams == 0) {
+        return nullptr;
+    }
+
+    uint64_t n_slots = 1;
+    while(n_slots < capacity) {
+        n_slots <<= 1;
+    }
+
+    MblMwHostFuser* fuser = new MblMwHostFuser;
+    fuser->n_streams = n_streams;
+    fuser->mask = n_slots - 1;
+    fuser->tolerance = tolerance;
+    fuser->context = context;
+    fuser->received_frame = received_frame;
+    fuser->frame.resize(n_streams);
+    fuser->delivering.clear();
+    fuser->pending = false;
+    fuser->n_dropped = 0;
+
+    fuser->streams.reset(new FuserStream[n_streams]);
+    for(uint32_t i = 0; i < n_streams; i++) {
+        FuserStream& stream = fuser->streams[i];
+        stream.fuser = fuser;
+        stream.slots.resize(n_slots);
+        stream.head = 0;
+        stream.tail = 0;
+    }
+    return fuser;
+}
+
+void* mbl_mw_host_fuser_get_stream(MblMwHostFuser* fuser, uint32_t index) {
+    return index < fuser->n_streams ? &fuser->streams[index] : nullptr;
+}
+
+void mbl_mw_host_fuser_process(void* context, const MblMwData* data) {
+    auto stream = static_cast<FuserStream*>(context);
+    auto fuser = stream->fuser;
+
+    uint64_t tail = stream->tail.load(memory_order_relaxed);
+    if (data->length > MBL_MW_HOST_FUSER_MAX_VALUE_LENGTH || data->type_id == MBL_MW_DT_ID_DATA_ARRAY ||
+            tail - stream->head.load(memory_order_acquire) > fuser->mask) {
+        fuser->n_dropped++;
+        return;
+    }
+
+    FuserSlot& slot = stream->slots[tail & fuser->mask];
+    slot.epoch = data->epoch;
+    slot.type_id = data->type_id;
+    slot.length = data->length;
+    memcpy(slot.value, data->value, data->length);
+    stream->tail.store(tail + 1, memory_order_release);
+
+    // if another thread is delivering frames, leave the new sample to it
+    fuser->pending = true;
+    while(!fuser->delivering.test_and_set()) {
+        fuser->pending = false;
+        match_frames(fuser);
+        fuser->delivering.clear();
+
+        if (!fuser->pending) {
+            break;
+        }
+    }
+}
+
+void mbl_mw_datasignal_fuse(MblMwDataSignal* signal, MblMwHostFuser* fuser, uint32_t index) {
+    mbl_mw_datasignal_subscribe(signal, mbl_mw_host_fuser_get_stream(fuser, index), mbl_mw_host_fuser_process);
+}
+
+uint64_t mbl_mw_host_fuser_get_n_dropped(const MblMwHostFuser* fuser) {
+    return fuser->n_dropped;
+}
+
+void mbl_mw_host_fuser_free(MblMwHostFuser* fuser) {
+    delete fuser;
+}
@@ -0,0 +1,711 @@
+#include "dataprocessor_private.h"
+#include "metawear/processor/host_processor.h"
+
+#include "metawear/core/types.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using std::fabs;
+using std::find;
+using std::floor;
+using std::fmod;
+using std::isfinite;
+using std::ldexp;
+using std::max;
+using std::numeric_limits;
+using std::pow;
+using std::sqrt;
+using std::trunc;
+using std::vector;
+
+const uint8_t AVERAGE_LOWPASS= 0, AVERAGE_HIGHPASS= 1;
+
+/**
+ * Samples flowing between host processors, stored channel by channel in one contiguous array
+ */
+struct HostBatch {
+    HostBatch();
+
+    vector<int64_t> epochs;
+    vector<double> values;
+    uint8_t n_channels;
+    bool is_integer, is_signed;
+};
+
+typedef void(*HostKernel)(MblMwHostProcessor* processor, const HostBatch& input, HostBatch& output);
+
+struct MblMwHostProcessor {
+    MblMwHostProcessor(MblMwHostProcessor* source, DataProcessorType type, HostKernel kernel, uint8_t mode, uint32_t size,
+            double param, double param2);
+
+    DataProcessorType type;
+    HostKernel kernel;
+    uint8_t mode;
+    uint32_t size;
+    double param, param2;
+
+    vector<double> window, sums;
+    uint32_t position, count;
+    double reference, area, peak;
+    int64_t last_epoch;
+    bool active, started;
+    HostBatch pending, output;
+
+    void* context;
+    MblMwFnData handler;
+    MblMwHostProcessor* source;
+    vector<MblMwHostProcessor*> consumers;
+};
+
+HostBatch::HostBatch() : n_channels(0), is_integer(false), is_signed(false) {
+}
+
+// Helper function - restores the state a processor is created with
+static void reset_state(MblMwHostProcessor* processor) {
+    processor->window.clear();
+    processor->sums.clear();
+    processor->position= 0;
+    processor->count= processor->type == DataProcessorType::PASSTHROUGH ? processor->size : 0;
+    processor->reference= 0;
+    processor->area= 0;
+    processor->peak= 0;
+    processor->last_epoch= 0;
+    processor->started= false;
+    // threshold state is which side of the boundary the previous value, initially 0, was on
+    processor->active= processor->type == DataProcessorType::THRESHOLD && 0 > processor->param;
+    processor->pending.epochs.clear();
+    processor->pending.values.clear();
+}
+
+MblMwHostProcessor::MblMwHostProcessor(MblMwHostProcessor* source, DataProcessorType type, HostKernel kernel, uint8_t mode,
+        uint32_t size, double param, double param2) : type(type), kernel(kernel), mode(mode), size(size), param(param),
+        param2(param2), context(nullptr), handler(nullptr), source(source) {
+    reset_state(this);
+    if (source != nullptr) {
+        source->consumers.push_back(this);
+    }
+}
+
+// Helper function - sets the layout of a batch's values
+static void set_format(HostBatch& batch, uint8_t n_channels, bool is_integer, bool is_signed) {
+    batch.n_channels= n_channels;
+    batch.is_integer= is_integer;
+    batch.is_signed= is_integer && is_signed;
+}
+
+// Helper function - adds a sample to a batch, truncating integer values like the board's integer arithmetic does
+static void append_sample(HostBatch& batch, int64_t epoch, const double* values) {
+    batch.epochs.push_back(epoch);
+    for(uint8_t i= 0; i < batch.n_channels; i++) {
+        batch.values.push_back(batch.is_integer ? trunc(values[i]) : values[i]);
+    }
+}
+
+static void append_sample(HostBatch& batch, int64_t epoch, double value) {
+    append_sample(batch, epoch, &value);
+}
+
+static void average_kernel(MblMwHostProcessor* processor, const HostBatch& input, HostBatch& output) {
+    uint8_t n= input.n_channels;
+    if (processor->window.size() != processor->size * n) {
+        processor->window.assign(processor->size * n, 0);
+        processor->sums.assign(n, 0);
+        processor->position= 0;
+        processor->count= 0;
+    }
+
+    bool highpass= processor->mode == AVERAGE_HIGHPASS;
+    set_format(output, n, input.is_integer, input.is_signed || highpass);
+    output.epochs= input.epochs;
+    output.values.resize(input.values.size());
+
+    double* sums= processor->sums.data();
+    for(size_t i= 0; i < input.epochs.size(); i++) {
+        const double* x= &input.values[i * n];
+        double* slot= &processor->window[processor->position * n];
+        double* y= &output.values[i * n];
+
+        if (processor->count < processor->size) {
+            processor->count++;
+        }
+        for(uint8_t c= 0; c < n; c++) {
+            sums[c]+= x[c] - slot[c];
+            slot[c]= x[c];
+
+            double average= sums[c] / processor->count;
+            if (input.is_integer) {
+                average= trunc(average);
+            }
+            y[c]= highpass ? x[c] - average : average;
+        }
+        processor->position= (processor->position + 1) % processor->size;
+    }
+}
+
+static void combiner_kernel(MblMwHostProcessor* processor, const HostBatch& input, HostBatch& output) {
+    uint8_t n= input.n_channels;
+    bool rms= processor->type == DataProcessorType::RMS;
+
+    set_format(output, 1, input.is_integer, false);
+    output.epochs= input.epochs;
+    output.values.resize(input.epochs.size());
+    for(size_t i= 0; i < input.epochs.size(); i++) {
+        const double* x= &input.values[i * n];
+        double sum= 0;
+        for(uint8_t c= 0; c < n; c++) {
+            sum+= x[c] * x[c];
+        }
+
+        double combined= sqrt(rms ? sum / n : sum);
+        output.values[i]= input.is_integer ? trunc(combined) : combined;
+    }
+}
+
+static void threshold_kernel(MblMwHostProcessor* processor, const HostBatch& input, HostBatch& output) {
+    bool binary= processor->mode == MBL_MW_THRESHOLD_MODE_BINARY;
+    set_format(output, 1, input.is_integer || binary, input.is_signed || binary);
+    if (input.n_channels != 1) {
+        return;
+    }
+
+    double upper= processor->param + processor->param2, lower= processor->param - processor->param2;
+    for(size_t i= 0; i < input.epochs.size(); i++) {
+        double x= input.values[i];
+        if (!processor->active && x > upper) {
+            processor->active= true;
+            append_sample(output, input.epochs[i], binary ? 1 : x);
+        } else if (processor->active && x < lower) {
+            processor->active= false;
+            append_sample(output, input.epochs[i], binary ? -1 : x);
+        }
+    }
+}
+
+static void delta_kernel(MblMwHostProcessor* processor, const HostBatch& input, HostBatch& output) {
+    set_format(output, 1, input.is_integer || processor->mode == MBL_MW_DELTA_MODE_BINARY,
+            input.is_signed || processor->mode != MBL_MW_DELTA_MODE_ABSOLUTE);
+    if (input.n_channels != 1) {
+        return;
+    }
+
+    double& reference= processor->reference;
+    for(size_t i= 0; i < input.epochs.size(); i++) {
+        double x= input.values[i];
+        if (fabs(x - reference) >= processor->param) {
+            switch(processor->mode) {
+            case MBL_MW_DELTA_MODE_ABSOLUTE:
+                append_sample(output, input.epochs[i], x);
+                break;
+            case MBL_MW_DELTA_MODE_DIFFERENTIAL:
+                append_sample(output, input.epochs[i], x - reference);
+                break;
+            case MBL_MW_DELTA_MODE_BINARY:
+                append_sample(output, input.epochs[i], x > reference ? 1 : -1);
+                break;
+            }
+            reference= x;
+        }
+    }
+}
+
+// Helper function - copies the samples satisfying the predicate, hoisting the comparison out of the per sample loop
+template<class Predicate>
+static void filter_samples(const HostBatch& input, HostBatch& output, Predicate predicate) {
+    for(size_t i= 0; i < input.epochs.size(); i++) {
+        if (predicate(input.values[i])) {
+            output.epochs.push_back(input.epochs[i]);
+            output.values.push_back(input.values[i]);
+        }
+    }
+}
+
+static void comparator_kernel(MblMwHostProcessor* processor, const HostBatch& input, HostBatch& output) {
+    set_format(output, 1, input.is_integer, input.is_signed);
+    if (input.n_channels != 1) {
+        return;
+    }
+
+    double reference= input.is_integer ? trunc(processor->param) : processor->param;
+    switch(processor->mode) {
+    case MBL_MW_COMPARATOR_OP_EQ:
+        filter_samples(input, output, [reference](double x) { return x == reference; });
+        break;
+    case MBL_MW_COMPARATOR_OP_NEQ:
+        filter_samples(input, output, [reference](double x) { return x != reference; });
+        break;
+    case MBL_MW_COMPARATOR_OP_LT:
+        filter_samples(input, output, [reference](double x) { return x < reference; });
+        break;
+    case MBL_MW_COMPARATOR_OP_LTE:
+        filter_samples(input, output, [reference](double x) { return x <= reference; });
+        break;
+    case MBL_MW_COMPARATOR_OP_GT:
+        filter_samples(input, output, [reference](double x) { return x > reference; });
+        break;
+    case MBL_MW_COMPARATOR_OP_GTE:
+        filter_samples(input, output, [reference](double x) { return x >= reference; });
+        break;
+    }
+}
+
+// Helper function - applies the operation to every value, hoisting the operation out of the per value loop
+template<class Operation>
+static void transform_values(const HostBatch& input, HostBatch& output, Operation operation) {
+    const double* x= input.values.data();
+    double* y= output.values.data();
+    for(size_t i= 0; i < input.values.size(); i++) {
+        y[i]= operation(x[i]);
+    }
+    if (output.is_integer) {
+        // integer results are always defined, dividing by zero and other non finite results give 0 as on the board
+        for(size_t i= 0; i < output.values.size(); i++) {
+            y[i]= isfinite(y[i]) ? trunc(y[i]) : 0.0;
+        }
+    }
+}
+
+static void math_kernel(MblMwHostProcessor* processor, const HostBatch& input, HostBatch& output) {
+    // integer signals are processed with an integer rhs, as the board would
+    double rhs= input.is_integer ? trunc(processor->param) : processor->param;
+    set_format(output, input.n_channels, input.is_integer, input.is_signed || rhs < 0 || processor->mode == MBL_MW_MATH_OP_SUBTRACT);
+    output.epochs= input.epochs;
+    output.values.resize(input.values.size());
+
+    bool is_integer= input.is_integer;
+    switch(processor->mode) {
+    case MBL_MW_MATH_OP_ADD:
+        transform_values(input, output, [rhs](double x) { return x + rhs; });
+        break;
+    case MBL_MW_MATH_OP_MULTIPLY:
+        transform_values(input, output, [rhs](double x) { return x * rhs; });
+        break;
+    case MBL_MW_MATH_OP_DIVIDE:
+        transform_values(input, output, [rhs](double x) { return x / rhs; });
+        break;
+    case MBL_MW_MATH_OP_MODULUS:
+        transform_values(input, output, [rhs](double x) { return fmod(x, rhs); });
+        break;
+    case MBL_MW_MATH_OP_EXPONENT:
+        transform_values(input, output, [rhs](double x) { return pow(x, rhs); });
+        break;
+    case MBL_MW_MATH_OP_SQRT:
+        transform_values(input, output, [](double x) { return sqrt(x); });
+        break;
+    case MBL_MW_MATH_OP_LSHIFT:
+        transform_values(input, output, [rhs](double x) { return ldexp(x, static_cast<int>(rhs)); });
+        break;
+    case MBL_MW_MATH_OP_RSHIFT:
+        // shifting an integer right rounds toward negative infinity
+        transform_values(input, output, [rhs, is_integer](double x) {
+            double shifted= ldexp(x, -static_cast<int>(rhs));
+            return is_integer ? floor(shifted) : shifted;
+        });
+        break;
+    case MBL_MW_MATH_OP_SUBTRACT:
+        transform_values(input, output, [rhs](double x) { return x - rhs; });
+        break;
+    case MBL_MW_MATH_OP_ABS_VALUE:
+        transform_values(input, output, [](double x) { return fabs(x); });
+        break;
+    case MBL_MW_MATH_OP_CONSTANT:
+        transform_values(input, output, [rhs](double x) { return rhs; });
+        break;
+    default:
+        output.epochs.clear();
+        output.values.clear();
+        break;
+    }
+}
+
+static void pulse_kernel(MblMwHostProcessor* processor, const HostBatch& input, HostBatch& output) {
+    bool count_output= processor->mode == MBL_MW_PULSE_OUTPUT_WIDTH || processor->mode == MBL_MW_PULSE_OUTPUT_ON_DETECTION;
+    set_format(output, 1, input.is_integer || count_output, !count_output && input.is_signed);
+    if (input.n_channels != 1) {
+        return;
+    }
+
+    for(size_t i= 0; i < input.epochs.size(); i++) {
+        double x= input.values[i];
+        if (x > processor->param) {
+            if (!processor->active) {
+                processor->active= true;
+                processor->count= 0;
+                processor->area= 0;
+                processor->peak= x;
+            }
+            processor->count++;
+            processor->area+= x;
+            processor->peak= max(processor->peak, x);
+            if (processor->mode == MBL_MW_PULSE_OUTPUT_ON_DETECTION && processor->count == processor->size) {
+                append_sample(output, input.epochs[i], 1);
+            }
+        } else if (processor->active) {
+            processor->active= false;
+            if (processor->count >= processor->size) {
+                switch(processor->mode) {
+                case MBL_MW_PULSE_OUTPUT_WIDTH:
+                    append_sample(output, input.epochs[i], processor->count);
+                    break;
+                case MBL_MW_PULSE_OUTPUT_AREA:
+                    append_sample(output, input.epochs[i], processor->area);
+                    break;
+                case MBL_MW_PULSE_OUTPUT_PEAK:
+                    append_sample(output, input.epochs[i], processor->peak);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+static void time_kernel(MblMwHostProcessor* processor, const HostBatch& input, HostBatch& output) {
+    uint8_t n= input.n_channels;
+    bool differential= processor->mode == MBL_MW_TIME_DIFFERENTIAL;
+    set_format(output, n, input.is_integer, input.is_signed || differential);
+    if (processor->sums.size() != n) {
+        processor->sums.assign(n, 0);
+    }
+
+    vector<double> difference(n);
+    for(size_t i= 0; i < input.epochs.size(); i++) {
+        int64_t epoch= input.epochs[i];
+        if (processor->started && epoch - processor->last_epoch < processor->size) {
+            continue;
+        }
+
+        processor->started= true;
+        processor->last_epoch= epoch;
+        const double* x= &input.values[i * n];
+        if (differential) {
+            for(uint8_t c= 0; c < n; c++) {
+                difference[c]= x[c] - processor->sums[c];
+                processor->sums[c]= x[c];
+            }
+            append_sample(output, epoch, difference.data());
+        } else {
+            append_sample(output, epoch, x);
+        }
+    }
+}
+
+static void sample_kernel(MblMwHostProcessor* processor, const HostBatch& input, HostBatch& output) {
+    HostBatch& pending= processor->pending;
+    if (pending.n_channels != input.n_channels || pending.is_integer != input.is_integer || pending.is_signed != input.is_signed) {
+        set_format(pending, input.n_channels, input.is_integer, input.is_signed);
+        pending.epochs.clear();
+        pending.values.clear();
+    }
+    set_format(output, input.n_channels, input.is_integer, input.is_signed);
+
+    for(size_t i= 0; i < input.epochs.size(); i++) {
+        append_sample(pending, input.epochs[i], &input.values[i * input.n_channels]);
+        if (pending.epochs.size() >= processor->size) {
+            output.epochs.insert(output.epochs.end(), pending.epochs.begin(), pending.epochs.end());
+            output.values.insert(output.values.end(), pending.values.begin(), pending.values.end());
+            pending.epochs.clear();
+            pending.values.clear();
+        }
+    }
+}
+
+static void passthrough_kernel(MblMwHostProcessor* processor, const HostBatch& input, HostBatch& output) {
+    set_format(output, input.n_channels, input.is_integer, input.is_signed);
+
+    size_t n_passed;
+    switch(processor->mode) {
+    case MBL_MW_PASSTHROUGH_MODE_ALL:
+        n_passed= input.epochs.size();
+        break;
+    case MBL_MW_PASSTHROUGH_MODE_CONDITIONAL:
+        n_passed= processor->count > 0 ? input.epochs.size() : 0;
+        break;
+    case MBL_MW_PASSTHROUGH_MODE_COUNT:
+        n_passed= std::min<size_t>(processor->count, input.epochs.size());
+        processor->count-= static_cast<uint32_t>(n_passed);
+        break;
+    default:
+        n_passed= 0;
+        break;
+    }
+
+    output.epochs.assign(input.epochs.begin(), input.epochs.begin() + n_passed);
+    output.values.assign(input.values.begin(), input.values.begin() + n_passed * input.n_channels);
+}
+
+static void counter_kernel(MblMwHostProcessor* processor, const HostBatch& input, HostBatch& output) {
+    set_format(output, 1, true, false);
+    output.epochs= input.epochs;
+    output.values.resize(input.epochs.size());
+    for(size_t i= 0; i < input.epochs.size(); i++) {
+        output.values[i]= ++processor->count;
+    }
+}
+
+static void accumulator_kernel(MblMwHostProcessor* processor, const HostBatch& input, HostBatch& output) {
+    uint8_t n= input.n_channels;
+    if (processor->sums.size() != n) {
+        processor->sums.assign(n, 0);
+    }
+
+    set_format(output, n, input.is_integer, input.is_signed);
+    output.epochs= input.epochs;
+    output.values.resize(input.values.size());
+
+    double* sums= processor->sums.data();
+    for(size_t i= 0; i < input.epochs.size(); i++) {
+        for(uint8_t c= 0; c < n; c++) {
+            sums[c]+= input.values[i * n + c];
+            output.values[i * n + c]= sums[c];
+        }
+    }
+}
+
+// Helper function - converts an integer result without undefined behaviour, out of range values saturate
+static int64_t to_int64(double x) {
+    if (!isfinite(x)) {
+        return 0;
+    }
+    // 2^63 is exactly representable, the largest int64_t is not
+    if (x >= 9223372036854775808.0) {
+        return numeric_limits<int64_t>::max();
+    }
+    if (x < -9223372036854775808.0) {
+        return numeric_limits<int64_t>::min();
+    }
+    return static_cast<int64_t>(x);
+}
+
+// Helper function - calls the processor's handler for every sample in its output
+static void emit_output(const MblMwHostProcessor* processor) {
+    const HostBatch& output= processor->output;
+    MblMwData data;
+    data.extra= nullptr;
+
+    float scalar;
+    int32_t signed_value;
+    uint32_t unsigned_value;
+    MblMwCartesianFloat cartesian;
+    if (output.is_integer) {
+        data.type_id= output.is_signed ? MBL_MW_DT_ID_INT32 : MBL_MW_DT_ID_UINT32;
+        data.value= output.is_signed ? static_cast<void*>(&signed_value) : static_cast<void*>(&unsigned_value);
+        data.length= sizeof(uint32_t);
+    } else if (output.n_channels == 3) {
+        data.type_id= MBL_MW_DT_ID_CARTESIAN_FLOAT;
+        data.value= &cartesian;
+        data.length= sizeof(cartesian);
+    } else if (output.n_channels == 1) {
+        data.type_id= MBL_MW_DT_ID_FLOAT;
+        data.value= &scalar;
+        data.length= sizeof(scalar);
+    } else {
+        return;
+    }
+
+    for(size_t i= 0; i < output.epochs.size(); i++) {
+        const double* x= &output.values[i * output.n_channels];
+        switch(data.type_id) {
+        case MBL_MW_DT_ID_INT32:
+            signed_value= static_cast<int32_t>(to_int64(x[0]));
+            break;
+        case MBL_MW_DT_ID_UINT32:
+            unsigned_value= static_cast<uint32_t>(to_int64(x[0]));
+            break;
+        case MBL_MW_DT_ID_CARTESIAN_FLOAT:
+            cartesian.x= static_cast<float>(x[0]);
+            cartesian.y= static_cast<float>(x[1]);
+            cartesian.z= static_cast<float>(x[2]);
+            break;
+        default:
+            scalar= static_cast<float>(x[0]);
+            break;
+        }
+        data.epoch= output.epochs[i];
+        processor->handler(processor->context, &data);
+    }
+}
+
+// Helper function - runs a batch through the processor and everything downstream of it
+static void run_processor(MblMwHostProcessor* processor, const HostBatch& input) {
+    // only the counter acts on samples whose values could not be decoded
+    if (input.n_channels == 0 && processor->type != DataProcessorType::COUNTER) {
+        return;
+    }
+
+    processor->output.epochs.clear();
+    processor->output.values.clear();
+    processor->kernel(processor, input, processor->output);
+    if (processor->output.epochs.empty()) {
+        return;
+    }
+
+    if (processor->handler != nullptr) {
+        emit_output(processor);
+    }
+    for(auto it: processor->consumers) {
+        run_processor(it, processor->output);
+    }
+}
+
+// Helper function - sets the batch layout for the data type, unsupported types have no channels
+static void set_input_format(HostBatch& batch, MblMwDataTypeId type_id) {
+    switch(type_id) {
+    case MBL_MW_DT_ID_FLOAT:
+        set_format(batch, 1, false, true);
+        break;
+    case MBL_MW_DT_ID_CARTESIAN_FLOAT:
+        set_format(batch, 3, false, true);
+        break;
+    case MBL_MW_DT_ID_INT32:
+        set_format(batch, 1, true, true);
+        break;
+    case MBL_MW_DT_ID_UINT32:
+        set_format(batch, 1, true, false);
+        break;
+    default:
+        set_format(batch, 0, false, false);
+        break;
+    }
+}
+
+// Helper function - appends the decoded value of a sample to the batch
+static void decode_sample(HostBatch& batch, const MblMwData* data) {
+    batch.epochs.push_back(data->epoch);
+    switch(data->type_id) {
+    case MBL_MW_DT_ID_FLOAT:
+        batch.values.push_back(*static_cast<float*>(data->value));
+        break;
+    case MBL_MW_DT_ID_CARTESIAN_FLOAT: {
+        auto value= static_cast<MblMwCartesianFloat*>(data->value);
+        batch.values.push_back(value->x);
+        batch.values.push_back(value->y);
+        batch.values.push_back(value->z);
+        break;
+    }
+    case MBL_MW_DT_ID_INT32:
+        batch.values.push_back(*static_cast<int32_t*>(data->value));
+        break;
+    case MBL_MW_DT_ID_UINT32:
+        batch.values.push_back(*static_cast<uint32_t*>(data->value));
+        break;
+    default:
+        break;
+    }
+}
+
+static MblMwHostProcessor* create_host_processor(MblMwHostProcessor* source, DataProcessorType type, HostKernel kernel, uint8_t mode = 0,
+        uint32_t size = 0, double param = 0, double param2 = 0) {
+    return new MblMwHostProcessor(source, type, kernel, mode, size, param, param2);
+}
+
+MblMwHostProcessor* mbl_mw_host_processor_lowpass_create(MblMwHostProcessor* source, uint8_t size) {
+    return create_host_processor(source, DataProcessorType::AVERAGE, average_kernel, AVERAGE_LOWPASS, max<uint8_t>(size, 1));
+}
+
+MblMwHostProcessor* mbl_mw_host_processor_highpass_create(MblMwHostProcessor* source, uint8_t size) {
+    return create_host_processor(source, DataProcessorType::AVERAGE, average_kernel, AVERAGE_HIGHPASS, max<uint8_t>(size, 1));
+}
+
+MblMwHostProcessor* mbl_mw_host_processor_rms_create(MblMwHostProcessor* source) {
+    return create_host_processor(source, DataProcessorType::RMS, combiner_kernel);
+}
+
+MblMwHostProcessor* mbl_mw_host_processor_rss_create(MblMwHostProcessor* source) {
+    return create_host_processor(source, DataProcessorType::RSS, combiner_kernel);
+}
+
+MblMwHostProcessor* mbl_mw_host_processor_threshold_create(MblMwHostProcessor* source, MblMwThresholdMode mode, float boundary, float hysteresis) {
+    return create_host_processor(source, DataProcessorType::THRESHOLD, threshold_kernel, mode, 0, boundary, hysteresis);
+}
+
+MblMwHostProcessor* mbl_mw_host_processor_delta_create(MblMwHostProcessor* source, MblMwDeltaMode mode, float magnitude) {
+    return create_host_processor(source, DataProcessorType::DELTA, delta_kernel, mode, 0, magnitude);
+}
+
+MblMwHostProcessor* mbl_mw_host_processor_comparator_create(MblMwHostProcessor* source, MblMwComparatorOperation op, float reference) {
+    return create_host_processor(source, DataProcessorType::COMPARATOR, comparator_kernel, op, 0, reference);
+}
+
+MblMwHostProcessor* mbl_mw_host_processor_math_create(MblMwHostProcessor* source, MblMwMathOperation op, float rhs) {
+    return create_host_processor(source, DataProcessorType::MATH, math_kernel, op, 0, rhs);
+}
+
+MblMwHostProcessor* mbl_mw_host_processor_pulse_create(MblMwHostProcessor* source, MblMwPulseOutput output, float threshold, uint16_t width) {
+    return create_host_processor(source, DataProcessorType::PULSE, pulse_kernel, output, width, threshold);
+}
+
+MblMwHostProcessor* mbl_mw_host_processor_time_create(MblMwHostProcessor* source, MblMwTimeMode mode, uint32_t period) {
+    return create_host_processor(source, DataProcessorType::TIME, time_kernel, mode, period);
+}
+
+MblMwHostProcessor* mbl_mw_host_processor_sample_create(MblMwHostProcessor* source, uint8_t bin_size) {
+    return create_host_processor(source, DataProcessorType::SAMPLE, sample_kernel, 0, max<uint8_t>(bin_size, 1));
+}
+
+MblMwHostProcessor* mbl_mw_host_processor_passthrough_create(MblMwHostProcessor* source, MblMwPassthroughMode mode, uint16_t count) {
+    return create_host_processor(source, DataProcessorType::PASSTHROUGH, passthrough_kernel, mode, count);
+}
+
+MblMwHostProcessor* mbl_mw_host_processor_counter_create(MblMwHostProcessor* source) {
+    return create_host_processor(source, DataProcessorType::COUNTER, counter_kernel);
+}
+
+MblMwHostProcessor* mbl_mw_host_processor_accumulator_create(MblMwHostProcessor* source) {
+    return create_host_processor(source, DataProcessorType::ACCUMULATOR, accumulator_kernel);
+}
+
+void mbl_mw_host_processor_subscribe(MblMwHostProcessor* processor, void* context, MblMwFnData data_handler) {
+    processor->context= context;
+    processor->handler= data_handler;
+}
+
+void mbl_mw_host_processor_unsubscribe(MblMwHostProcessor* processor) {
+    processor->context= nullptr;
+    processor->handler= nullptr;
+}
+
+void mbl_mw_host_processor_process(void* processor, const MblMwData* data) {
+    mbl_mw_host_processor_process_batch(static_cast<MblMwHostProcessor*>(processor), data, 1);
+}
+
+void mbl_mw_host_processor_process_batch(MblMwHostProcessor* processor, const MblMwData* data, uint32_t size) {
+    HostBatch batch;
+    uint32_t i= 0;
+    // data types can change mid batch, run each stretch of samples with the same type separately
+    while(i < size) {
+        MblMwDataTypeId type_id= data[i].type_id;
+        set_input_format(batch, type_id);
+        batch.epochs.clear();
+        batch.values.clear();
+
+        for(; i < size && data[i].type_id == type_id; i++) {
+            decode_sample(batch, &data[i]);
+        }
+        run_processor(processor, batch);
+    }
+}
+
+void mbl_mw_host_processor_reset(MblMwHostProcessor* processor) {
+    reset_state(processor);
+    for(auto it: processor->consumers) {
+        mbl_mw_host_processor_reset(it);
+    }
+}
+
+// Helper function - frees the processor and everything downstream of it
+static void free_host_processor(MblMwHostProcessor* processor) {
+    for(auto it: processor->consumers) {
+        free_host_processor(it);
+    }
+    delete processor;
+}
+
+void mbl_mw_host_processor_free(MblMwHostProcessor* processor) {
+    if (processor->source != nullptr) {
+        auto& siblings= processor->source->consumers;
+        siblings.erase(find(siblings.begin(), siblings.end(), processor));
+    }
+    free_host_processor(processor);
+}
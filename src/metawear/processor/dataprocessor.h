@@ -6,6 +6,7 @@
 #pragma once
 
 #include "dataprocessor_fwd.h"
+#include "metawear/core/data.h"
 #include "metawear/core/datasignal_fwd.h"
 #include "metawear/core/metawearboard_fwd.h"
 #include "metawear/platform/dllmarker.h"
@@ -23,7 +24,9 @@ extern "C" {
 METAWEAR_API MblMwDataSignal* mbl_mw_dataprocessor_get_state_data_signal(const MblMwDataProcessor* processor);
 
 /**
- * Removes a data processor and its consumers from the board.
+ * Removes a data processor and its consumers from the board.  If the processor is shared, only one reference to it is 
+ * dropped and it stays on the board, along with every consumer, until the last reference is removed.  Use 
+ * mbl_mw_dataprocessor_remove_shared to remove a chain's own consumers right away.
  * @param processor         Processor to remove
  */
 METAWEAR_API void mbl_mw_dataprocessor_remove(MblMwDataProcessor *processor);
@@ -43,6 +46,103 @@ METAWEAR_API uint8_t mbl_mw_dataprocessor_get_id(const MblMwDataProcessor* proce
  */
 METAWEAR_API MblMwDataProcessor* mbl_mw_dataprocessor_lookup_id(const MblMwMetaWearBoard* board, uint8_t id);
 
+/**
+ * Creates an empty processor graph.  Instead of nesting each processor create call inside the callback of the 
+ * previous one, record the whole graph with the usual mbl_mw_dataprocessor_*_create functions and create it with 
+ * mbl_mw_dataprocessor_graph_submit.
+ * @param board             Board the processors will be created on
+ * @return Pointer to the graph
+ */
+METAWEAR_API MblMwProcessorGraph* mbl_mw_dataprocessor_graph_create(MblMwMetaWearBoard* board);
+/**
+ * Starts recording processors into the graph.  While recording, mbl_mw_dataprocessor_*_create functions do not 
+ * communicate with the board, they add a node to the graph and pass a placeholder processor to the callback, if 
+ * provided.  Placeholders can be retrieved with mbl_mw_dataprocessor_graph_get_node and used as the source of other 
+ * processors in the same graph, but nothing else until the graph is submitted.  The fuser processor cannot be recorded.
+ * @param graph             Calling object
+ */
+METAWEAR_API void mbl_mw_dataprocessor_graph_record(MblMwProcessorGraph* graph);
+/**
+ * Stops recording processors into the graph
+ * @param graph             Calling object
+ */
+METAWEAR_API void mbl_mw_dataprocessor_graph_end_record(MblMwProcessorGraph* graph);
+/**
+ * Retrieves the number of processors recorded into the graph
+ * @param graph             Calling object
+ * @return Number of nodes
+ */
+METAWEAR_API uint32_t mbl_mw_dataprocessor_graph_get_n_nodes(const MblMwProcessorGraph* graph);
+/**
+ * Retrieves a processor recorded into the graph
+ * @param graph             Calling object
+ * @param index             Position of the processor, in the order it was recorded
+ * @return Placeholder processor, null if the index is out of range
+ */
+METAWEAR_API MblMwDataProcessor* mbl_mw_dataprocessor_graph_get_node(const MblMwProcessorGraph* graph, uint32_t index);
+/**
+ * Creates the recorded processors on the board.  Every processor whose input already exists is added at once, so 
+ * sibling branches are created together and only dependent processors wait for their input's id.  On success, the 
+ * callback receives the processors in the order they were recorded and the placeholders become those processors.  
+ * On failure, processors already added are removed.  The graph is freed once the callback is executed.
+ * @param graph             Calling object
+ * @param context           Pointer to additional data for the callback function
+ * @param created           Callback function to be executed once the graph is created
+ * @return MBL_MW_STATUS_OK if the graph was submitted, MBL_MW_STATUS_ERROR_CAPACITY_EXCEEDED if the board does not 
+ * have enough free processor slots, in which case the graph is left untouched
+ */
+METAWEAR_API int32_t mbl_mw_dataprocessor_graph_submit(MblMwProcessorGraph* graph, void *context, MblMwFnDataProcessorArray created);
+/**
+ * Frees a graph that was not submitted, along with its placeholder processors
+ * @param graph             Calling object
+ */
+METAWEAR_API void mbl_mw_dataprocessor_graph_free(MblMwProcessorGraph* graph);
+
+/**
+ * Enables or disables sharing processors between identical chains.  While enabled, creating a processor with the same 
+ * type and configuration off the same source as an existing processor, or one still being created, hands back the 
+ * existing processor instead of adding another one to the board.  Since a shared chain's processors are themselves 
+ * shared, building the same chain twice only uses the board's processor slots once.  Buffer and fuser processors, 
+ * processors created in a graph or macro, and processors restored from a serialized state are never shared.  Changing 
+ * the state or configuration of a shared processor affects every chain using it.  Sharing is disabled by default.
+ * @param board             Calling object
+ * @param enable            Zero to disable sharing, non-zero to enable it
+ */
+METAWEAR_API void mbl_mw_dataprocessor_set_sharing(MblMwMetaWearBoard* board, uint8_t enable);
+/**
+ * Retrieves how many times the processor was handed out by the create functions.  The processor stays on the board 
+ * until every chain using it is removed.
+ * @param processor         Processor to lookup
+ * @return Number of chains using the processor
+ */
+METAWEAR_API uint32_t mbl_mw_dataprocessor_get_n_references(const MblMwDataProcessor* processor);
+/**
+ * Adds a data handler to a processor.  Unlike mbl_mw_datasignal_subscribe, which replaces the signal's handler, every 
+ * handler added with this function receives the processor's data, so each chain sharing the processor can subscribe 
+ * with its own handler.  Do not mix this function with mbl_mw_datasignal_subscribe on the same processor.
+ * @param processor         Processor to subscribe to
+ * @param context           Pointer to additional data for the callback function, identifies the handler when unsubscribing
+ * @param received_data     Callback function to handle data received from the processor
+ */
+METAWEAR_API void mbl_mw_dataprocessor_subscribe_shared(MblMwDataProcessor* processor, void *context, MblMwFnData received_data);
+/**
+ * Removes a data handler added with mbl_mw_dataprocessor_subscribe_shared.  The board stops sending the processor's 
+ * data once the last handler is removed.
+ * @param processor         Processor to unsubscribe from
+ * @param context           Context the handler was added with
+ */
+METAWEAR_API void mbl_mw_dataprocessor_unsubscribe_shared(MblMwDataProcessor* processor, void *context);
+/**
+ * Removes one chain from a shared processor.  The chain is identified by the context its processors were created 
+ * with.  The chain's own processors fed by the shared processor are removed right away.  The shared processor and 
+ * any shared processors below it lose one reference, and are removed once no chain uses them.  Chains using the same 
+ * context cannot be told apart, so while another chain with the context still uses the shared processor, only the 
+ * reference is dropped and the chain's own processors are removed with the last reference.
+ * @param processor         Shared processor to remove the chain from
+ * @param context           Context the chain's processors were created with
+ */
+METAWEAR_API void mbl_mw_dataprocessor_remove_shared(MblMwDataProcessor *processor, void *context);
+
 #ifdef	__cplusplus
 }
 #endif
@@ -5,6 +5,8 @@
  */
 #pragma once
 
+#include "metawear/core/metawearboard_fwd.h"
+
 /**
  * Data signal from the on board data processor.  An MblMwDataProcessor pointer can be casted as an 
  * MblMwDataSignal pointer and used with any function tht accepts an MblMwdDataSignal.
@@ -21,3 +23,22 @@ typedef struct MblMwDataProcessor MblMwDataProcessor;
  * @param processor         Processor to be used with the function
  */
 typedef void (*MblMwFnDataProcessor)(void *context, MblMwDataProcessor* processor);
+
+/**
+ * Collection of data processors that are created on the board together
+ */
+#ifdef __cplusplus
+struct MblMwProcessorGraph;
+#else
+typedef struct MblMwProcessorGraph MblMwProcessorGraph;
+#endif
+
+/**
+ * Definition for callback functions that accept an array of MblMwDataProcessor pointers.
+ * @param context           Pointer to the context the enclosing function was called with
+ * @param board             Board the processors were created on
+ * @param processors        Array of MblMwDataProcessor pointers, null if the operation failed
+ * @param size              Number of elements in the array
+ * @param status            MBL_MW_STATUS_OK if every processor was created, an error code otherwise
+ */
+typedef void (*MblMwFnDataProcessorArray)(void *context, MblMwMetaWearBoard* board, MblMwDataProcessor** processors, uint32_t size, int32_t status);
@@ -0,0 +1,87 @@
+/**
+ * @copyright MbientLab License
+ * @file host_fuser.h
+ * @brief Combines samples from several data streams into frames on the host
+ * @details
+ * The host fuser is an alternative to the on board fuser that needs no buffer processors and allocates nothing per
+ * frame.  Every stream feeds a fixed size single producer ring; once each stream has a sample, the oldest samples are
+ * compared and, if their epochs lie within the tolerance of one another, delivered together as one frame.  Samples too
+ * old to ever be part of a frame, e.g. the extra samples of a faster stream, are dropped.  Feeding a stream never
+ * blocks: whichever thread finds frames ready delivers them, while other threads only queue their samples, so frames are
+ * delivered one at a time but not necessarily on the thread that fed the last sample.  Each stream must be fed from one
+ * thread at a time.
+ */
+#pragma once
+
+#include "host_fuser_fwd.h"
+
+#include "metawear/core/data.h"
+#include "metawear/core/datasignal_fwd.h"
+#include "metawear/platform/dllmarker.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/** Largest MblMwData value, in bytes, that can be fused */
+const uint8_t MBL_MW_HOST_FUSER_MAX_VALUE_LENGTH = 40;
+
+/**
+ * Definition for callback functions that accept a frame of fused samples
+ * @param context           Pointer to the context the fuser was created with
+ * @param samples           One sample per stream, in stream index order.  The array and values are only valid
+ *                          for the duration of the callback.
+ * @param n_samples         Number of samples in the array
+ */
+typedef void (*MblMwFnFusedData)(void *context, const MblMwData* samples, uint32_t n_samples);
+
+/**
+ * Creates a host fuser
+ * @param n_streams             Number of streams to join
+ * @param tolerance             Max difference, in milliseconds, between the epochs of samples in the same frame
+ * @param capacity              Number of samples each stream can queue while waiting on the other streams, rounded
+ *                              up to a power of 2
+ * @param context               Pointer to additional data for the callback function
+ * @param received_frame        Callback function to handle fused frames
+ * @return Pointer to the fuser
+ */
+METAWEAR_API MblMwHostFuser* mbl_mw_host_fuser_create(uint32_t n_streams, uint32_t tolerance, uint32_t capacity,
+        void *context, MblMwFnFusedData received_frame);
+/**
+ * Retrieves the context to feed a stream with when calling mbl_mw_host_fuser_process
+ * @param fuser                 Calling object
+ * @param index                 Stream index, between [0, n_streams - 1]
+ * @return Pointer to pass to mbl_mw_host_fuser_process, null if the index is out of range
+ */
+METAWEAR_API void* mbl_mw_host_fuser_get_stream(MblMwHostFuser* fuser, uint32_t index);
+/**
+ * Feeds a sample to one of the fuser's streams.  Samples whose value is longer than MBL_MW_HOST_FUSER_MAX_VALUE_LENGTH,
+ * or that hold pointers (MBL_MW_DT_ID_DATA_ARRAY), are dropped, as are samples arriving when the stream's ring is full.
+ * This function has the MblMwFnData signature and can be passed directly to mbl_mw_datasignal_subscribe or
+ * mbl_mw_logger_subscribe with a stream from mbl_mw_host_fuser_get_stream as the context.
+ * @param stream                Stream to feed, from mbl_mw_host_fuser_get_stream
+ * @param data                  Sample to queue
+ */
+METAWEAR_API void mbl_mw_host_fuser_process(void* stream, const MblMwData* data);
+/**
+ * Subscribes to a data signal, feeding all received data to one of the fuser's streams
+ * @param signal                Data signal to fuse
+ * @param fuser                 Fuser to feed
+ * @param index                 Stream index the signal's data is fed to
+ */
+METAWEAR_API void mbl_mw_datasignal_fuse(MblMwDataSignal* signal, MblMwHostFuser* fuser, uint32_t index);
+/**
+ * Retrieves the number of samples that were dropped rather than delivered in a frame
+ * @param fuser                 Calling object
+ * @return Number of dropped samples
+ */
+METAWEAR_API uint64_t mbl_mw_host_fuser_get_n_dropped(const MblMwHostFuser* fuser);
+/**
+ * Frees the fuser.  Unsubscribe any signals or loggers feeding the fuser before calling this function.
+ * @param fuser                 Fuser to free
+ */
+METAWEAR_API void mbl_mw_host_fuser_free(MblMwHostFuser* fuser);
+
+#ifdef	__cplusplus
+}
+#endif
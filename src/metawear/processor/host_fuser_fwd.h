@@ -0,0 +1,15 @@
+/**
+ * @copyright MbientLab License
+ * @file host_fuser_fwd.h
+ * @brief Forward declaration for the MblMwHostFuser type
+ */
+#pragma once
+
+/**
+ * Joins samples from several data streams by timestamp on the host
+ */
+#ifdef	__cplusplus
+struct MblMwHostFuser;
+#else
+typedef struct MblMwHostFuser MblMwHostFuser;
+#endif
@@ -0,0 +1,188 @@
+/**
+ * @copyright MbientLab License
+ * @file host_processor.h
+ * @brief Runs data processor chains on the host instead of on the board
+ * @details
+ * Host processors apply the same operations as the on board data processors to data that has already been received and
+ * decoded, for boards that are out of processor slots or whose firmware lacks a processor.  Each processor is created
+ * with an optional source processor, forming chains and trees the same way the on board processors do; data fed into a
+ * processor without a source flows through it and every processor downstream of it.  Processors accept
+ * MBL_MW_DT_ID_FLOAT, MBL_MW_DT_ID_INT32, MBL_MW_DT_ID_UINT32, and MBL_MW_DT_ID_CARTESIAN_FLOAT data.  Integer inputs
+ * are processed with the integer arithmetic the board uses, truncating results toward zero, and produce MBL_MW_DT_ID_INT32
+ * or MBL_MW_DT_ID_UINT32 outputs.  Float inputs produce MBL_MW_DT_ID_FLOAT or MBL_MW_DT_ID_CARTESIAN_FLOAT outputs.  As on
+ * the board, processor state that has not seen any data, e.g. the reference value of a delta processor, starts at 0.
+ */
+#pragma once
+
+#include "comparator.h"
+#include "delta.h"
+#include "host_processor_fwd.h"
+#include "math.h"
+#include "passthrough.h"
+#include "pulse.h"
+#include "threshold.h"
+#include "time.h"
+
+#include "metawear/core/data.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a host low-pass filter, outputting the average of the most recent "size" samples.  Until "size" samples have
+ * been received, the average is computed over the samples received so far.
+ * @param source                Processor providing the input, null if data will be fed in with mbl_mw_host_processor_process
+ * @param size                  Number of samples to average over
+ * @return Pointer to the processor
+ */
+METAWEAR_API MblMwHostProcessor* mbl_mw_host_processor_lowpass_create(MblMwHostProcessor* source, uint8_t size);
+/**
+ * Create a host high-pass filter, outputting the difference of the current value from the average of the most recent
+ * "size" samples
+ * @param source                Processor providing the input, null if data will be fed in with mbl_mw_host_processor_process
+ * @param size                  Number of samples to average over
+ * @return Pointer to the processor
+ */
+METAWEAR_API MblMwHostProcessor* mbl_mw_host_processor_highpass_create(MblMwHostProcessor* source, uint8_t size);
+/**
+ * Create a host rms processor, combining the channels of each sample into their root mean square
+ * @param source                Processor providing the input, null if data will be fed in with mbl_mw_host_processor_process
+ * @return Pointer to the processor
+ */
+METAWEAR_API MblMwHostProcessor* mbl_mw_host_processor_rms_create(MblMwHostProcessor* source);
+/**
+ * Create a host rss processor, combining the channels of each sample into their root sum square
+ * @param source                Processor providing the input, null if data will be fed in with mbl_mw_host_processor_process
+ * @return Pointer to the processor
+ */
+METAWEAR_API MblMwHostProcessor* mbl_mw_host_processor_rss_create(MblMwHostProcessor* source);
+/**
+ * Create a host threshold processor, allowing data through that crosses a boundary.  Single channel inputs only.
+ * @param source                Processor providing the input, null if data will be fed in with mbl_mw_host_processor_process
+ * @param mode                  Processor output mode
+ * @param boundary              Limit that triggers an output when data crosses it
+ * @param hysteresis            Min distance between the limit and value to signal a successful crossing
+ * @return Pointer to the processor
+ */
+METAWEAR_API MblMwHostProcessor* mbl_mw_host_processor_threshold_create(MblMwHostProcessor* source, MblMwThresholdMode mode,
+        float boundary, float hysteresis);
+/**
+ * Create a host delta processor, only allowing data through that is a min distance from the previously allowed value.
+ * Single channel inputs only.
+ * @param source                Processor providing the input, null if data will be fed in with mbl_mw_host_processor_process
+ * @param mode                  Processor output mode
+ * @param magnitude             Min distance from the reference value to allow the input to pass
+ * @return Pointer to the processor
+ */
+METAWEAR_API MblMwHostProcessor* mbl_mw_host_processor_delta_create(MblMwHostProcessor* source, MblMwDeltaMode mode, float magnitude);
+/**
+ * Create a host comparator, only allowing data through that satisfies a comparison.  Single channel inputs only.
+ * @param source                Processor providing the input, null if data will be fed in with mbl_mw_host_processor_process
+ * @param op                    Comparison operation to execute
+ * @param reference             Reference value to compare the input to
+ * @return Pointer to the processor
+ */
+METAWEAR_API MblMwHostProcessor* mbl_mw_host_processor_comparator_create(MblMwHostProcessor* source, MblMwComparatorOperation op,
+        float reference);
+/**
+ * Create a host math processor, applying the operation to every channel of the input
+ * @param source                Processor providing the input, null if data will be fed in with mbl_mw_host_processor_process
+ * @param op                    Math operation to compute
+ * @param rhs                   Right hand side of the operation that requires 2 inputs
+ * @return Pointer to the processor
+ */
+METAWEAR_API MblMwHostProcessor* mbl_mw_host_processor_math_create(MblMwHostProcessor* source, MblMwMathOperation op, float rhs);
+/**
+ * Create a host pulse detector.  Single channel inputs only.
+ * @param source                Processor providing the input, null if data will be fed in with mbl_mw_host_processor_process
+ * @param output                Output type of the processor
+ * @param threshold             Value the data must exceed for a valid pulse
+ * @param width                 Number of samples that must exceed the threshold for a valid pulse
+ * @return Pointer to the processor
+ */
+METAWEAR_API MblMwHostProcessor* mbl_mw_host_processor_pulse_create(MblMwHostProcessor* source, MblMwPulseOutput output,
+        float threshold, uint16_t width);
+/**
+ * Create a host time delay processor, allowing data through at most once per period.  The period is measured with the
+ * epoch of the input data so results are the same whether data is processed live or afterwards.
+ * @param source                Processor providing the input, null if data will be fed in with mbl_mw_host_processor_process
+ * @param mode                  Operation mode of the processor
+ * @param period                How often to allow data through, in milliseconds
+ * @return Pointer to the processor
+ */
+METAWEAR_API MblMwHostProcessor* mbl_mw_host_processor_time_create(MblMwHostProcessor* source, MblMwTimeMode mode, uint32_t period);
+/**
+ * Create a host sample delay processor, holding data until "bin_size" samples have been collected and then letting them
+ * all through
+ * @param source                Processor providing the input, null if data will be fed in with mbl_mw_host_processor_process
+ * @param bin_size              Number of samples to hold before letting data through
+ * @return Pointer to the processor
+ */
+METAWEAR_API MblMwHostProcessor* mbl_mw_host_processor_sample_create(MblMwHostProcessor* source, uint8_t bin_size);
+/**
+ * Create a host passthrough processor
+ * @param source                Processor providing the input, null if data will be fed in with mbl_mw_host_processor_process
+ * @param mode                  Processor's operation mode
+ * @param count                 Internal count to initialize the processor with
+ * @return Pointer to the processor
+ */
+METAWEAR_API MblMwHostProcessor* mbl_mw_host_processor_passthrough_create(MblMwHostProcessor* source, MblMwPassthroughMode mode,
+        uint16_t count);
+/**
+ * Create a host counter, outputting the number of samples received as an MBL_MW_DT_ID_UINT32 value.  Unlike the other
+ * processors, the counter also counts data whose type is not supported.
+ * @param source                Processor providing the input, null if data will be fed in with mbl_mw_host_processor_process
+ * @return Pointer to the processor
+ */
+METAWEAR_API MblMwHostProcessor* mbl_mw_host_processor_counter_create(MblMwHostProcessor* source);
+/**
+ * Create a host accumulator, outputting a running sum of every channel of the input
+ * @param source                Processor providing the input, null if data will be fed in with mbl_mw_host_processor_process
+ * @return Pointer to the processor
+ */
+METAWEAR_API MblMwHostProcessor* mbl_mw_host_processor_accumulator_create(MblMwHostProcessor* source);
+
+/**
+ * Subscribes to the output of a host processor, replacing any previous handler
+ * @param processor             Processor to subscribe to
+ * @param context               Pointer to additional data for the callback function
+ * @param data_handler          Callback function to handle data received from the processor
+ */
+METAWEAR_API void mbl_mw_host_processor_subscribe(MblMwHostProcessor* processor, void* context, MblMwFnData data_handler);
+/**
+ * Removes the data handler from a host processor.  Downstream processors still receive its output.
+ * @param processor             Processor to unsubscribe from
+ */
+METAWEAR_API void mbl_mw_host_processor_unsubscribe(MblMwHostProcessor* processor);
+/**
+ * Feeds one sample into a host processor.  This function has the MblMwFnData signature and can be passed directly to
+ * mbl_mw_datasignal_subscribe or mbl_mw_logger_subscribe with the processor as the context.
+ * @param processor             Processor to feed, cast as a void pointer
+ * @param data                  Sample to process
+ */
+METAWEAR_API void mbl_mw_host_processor_process(void* processor, const MblMwData* data);
+/**
+ * Feeds a batch of samples into a host processor.  Each processor handles the whole batch before passing its output
+ * downstream, so the handlers of a processor are called for all of its outputs from the batch before any of the
+ * handlers downstream of it.  The outputs are the same as when feeding the samples in one at a time.
+ * @param processor             Processor to feed
+ * @param data                  Array of samples to process
+ * @param size                  Number of samples in the array
+ */
+METAWEAR_API void mbl_mw_host_processor_process_batch(MblMwHostProcessor* processor, const MblMwData* data, uint32_t size);
+/**
+ * Restores a host processor, and all processors downstream of it, to the state it was created in
+ * @param processor             Processor to reset
+ */
+METAWEAR_API void mbl_mw_host_processor_reset(MblMwHostProcessor* processor);
+/**
+ * Frees a host processor and all processors downstream of it, detaching it from its source.  Unsubscribe any signals
+ * or loggers feeding the processor before calling this function.
+ * @param processor             Processor to free
+ */
+METAWEAR_API void mbl_mw_host_processor_free(MblMwHostProcessor* processor);
+
+#ifdef	__cplusplus
+}
+#endif
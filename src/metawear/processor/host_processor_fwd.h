@@ -0,0 +1,15 @@
+/**
+ * @copyright MbientLab License
+ * @file host_processor_fwd.h
+ * @brief Forward declaration for the MblMwHostProcessor type
+ */
+#pragma once
+
+/**
+ * Data processor that runs on the host, mirroring the behavior of an on board data processor
+ */
+#ifdef	__cplusplus
+struct MblMwHostProcessor;
+#else
+typedef struct MblMwHostProcessor MblMwHostProcessor;
+#endif
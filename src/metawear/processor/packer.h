@@ -7,6 +7,9 @@
 
 #include "processor_common.h"
 
+#include "metawear/core/data.h"
+#include "metawear/core/metawearboard_fwd.h"
+
 #ifdef	__cplusplus
 extern "C" {
 #endif
@@ -22,6 +25,31 @@ extern "C" {
  * @param processor_created     Callback function to be executed when the processor is created
  */
 METAWEAR_API int32_t mbl_mw_dataprocessor_packer_create(MblMwDataSignal *source, uint8_t count, void *context, MblMwFnDataProcessor processor_created);
+/**
+ * Sets how many notifications per second the connection can reliably carry, used by mbl_mw_datasignal_subscribe_packed 
+ * to decide which signals to pack.  The default budget is 100 notifications per second.
+ * @param board                 Calling object
+ * @param notifications         Notifications per second the connection can carry
+ */
+METAWEAR_API void mbl_mw_dataprocessor_set_notification_budget(MblMwMetaWearBoard* board, float notifications);
+/**
+ * Subscribes to a data signal, packing its data on the board if the signal is faster than the notification budget.  
+ * Packed data is unpacked on the host and passed to the callback one sample at a time, exactly like an unpacked 
+ * subscription.  Samples are timestamped by an accounter on the board if requested and the signal is small enough to 
+ * pack with its timestamp, otherwise each sample's epoch is spread back from the packet's epoch by the sample period.
+ * @param signal                Data signal to subscribe to
+ * @param sample_rate           Rate, in Hz, the signal produces data at
+ * @param timestamp             Non-zero to timestamp the samples on the board with an accounter
+ * @param context               Pointer to additional data for the callback functions
+ * @param received_data         Callback function to handle data received from the signal
+ * @param subscribed            Callback function to be executed once the subscription is active, receiving the created 
+ *                              processors ordered from the signal to the packer, none if the signal was subscribed to 
+ *                              directly.  Remove the first processor to undo the packing.
+ * @return MBL_MW_STATUS_OK if the subscription was queued, MBL_MW_STATUS_ERROR_CAPACITY_EXCEEDED if the board 
+ * cannot fit the processors
+ */
+METAWEAR_API int32_t mbl_mw_datasignal_subscribe_packed(MblMwDataSignal* signal, float sample_rate, uint8_t timestamp, void *context, 
+        MblMwFnData received_data, MblMwFnDataProcessorArray subscribed);
 
 #ifdef	__cplusplus
 }
@@ -582,6 +582,8 @@ static void init_accelerometer_bosch(MblMwMetaWearBoard *board, void *config) {
 
     board->responses.emplace(piecewise_construct, forward_as_tuple(MBL_MW_MODULE_ACCELEROMETER, READ_REGISTER(ORDINAL(AccelerometerBmi160Register::DATA_CONFIG))),
         forward_as_tuple(received_config_response));
+    board->responses.emplace(piecewise_construct, forward_as_tuple(MBL_MW_MODULE_ACCELEROMETER, READ_REGISTER(ORDINAL(AccelerometerBmi160Register::DATA_INTERRUPT_ENABLE))),
+        forward_as_tuple(received_power_response));
     board->responses.emplace(BOSCH_MOTION_DETECTOR, response_handler_data_no_id);
     board->responses.emplace(BOSCH_TAP_DETECTOR, response_handler_data_no_id);
     board->responses.emplace(BOSCH_ORIENTATION_DETECTOR, response_handler_data_no_id);
@@ -1046,19 +1048,19 @@ void mbl_mw_acc_bosch_write_acceleration_config(const MblMwMetaWearBoard *board)
     case MBL_MW_MODULE_ACC_TYPE_BMI160: {
         auto config= ((AccBmi160Config*) board->module_config.at(MBL_MW_MODULE_ACCELEROMETER))->acc;
         memcpy(command + 2, &config, sizeof(config));
-        SEND_COMMAND;
+        SEND_CONFIG_COMMAND;
         break;
     }
     case MBL_MW_MODULE_ACC_TYPE_BMA255: {
         auto config= ((AccBma255Config*) board->module_config.at(MBL_MW_MODULE_ACCELEROMETER))->acc;
         memcpy(command + 2, &config, sizeof(config));
-        SEND_COMMAND;
+        SEND_CONFIG_COMMAND;
         break;
     }
     case MBL_MW_MODULE_ACC_TYPE_BMI270: {
         auto config= ((AccBmi270Config*) board->module_config.at(MBL_MW_MODULE_ACCELEROMETER))->acc;
         memcpy(command + 2, &config, sizeof(config));
-        SEND_COMMAND;
+        SEND_CONFIG_COMMAND;
         break;
     }
     default:
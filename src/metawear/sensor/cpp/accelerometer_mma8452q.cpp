@@ -362,7 +362,7 @@ void mbl_mw_acc_mma8452q_write_acceleration_config(const MblMwMetaWearBoard *boa
     auto config = ((Mma8452qConfig*) board->module_config.at(MBL_MW_MODULE_ACCELEROMETER))->acc;
     memcpy(command + 2, &config, sizeof(config));
 
-    SEND_COMMAND;
+    SEND_CONFIG_COMMAND;
 }
 
 // Read config
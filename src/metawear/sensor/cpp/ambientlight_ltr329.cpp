@@ -197,7 +197,7 @@ float mbl_mw_als_ltr329_get_measurement_rate(MblMwMetaWearBoard *board) {
 void mbl_mw_als_ltr329_write_config(const MblMwMetaWearBoard *board) {
     uint8_t command[4]= {MBL_MW_MODULE_AMBIENT_LIGHT, ORDINAL(AmbientLightLtr329Register::CONFIG)};
     memcpy(command + 2, board->module_config.at(MBL_MW_MODULE_AMBIENT_LIGHT), sizeof(Ltr329Config));
-    SEND_COMMAND;
+    SEND_CONFIG_COMMAND;
 }
 
 void mbl_mw_als_ltr329_read_config(const MblMwMetaWearBoard *board, void *context, MblMwFnBoardPtrInt completed) {
@@ -144,7 +144,7 @@ float mbl_mw_baro_bosch_set_standby_time(MblMwMetaWearBoard *board, float standb
 void mbl_mw_baro_bosch_write_config(const MblMwMetaWearBoard *board) {
     uint8_t command[4]= {MBL_MW_MODULE_BAROMETER, ORDINAL(BarometerBmp280Register::CONFIG)};
     memcpy(command + 2, board->module_config.at(MBL_MW_MODULE_BAROMETER), sizeof(BoschBaroConfig));
-    SEND_COMMAND;
+    SEND_CONFIG_COMMAND;
 }
 
 // Start the barometer
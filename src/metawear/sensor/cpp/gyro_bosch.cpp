@@ -454,7 +454,7 @@ void mbl_mw_gyro_bmi160_write_config(const MblMwMetaWearBoard *board) {
     uint8_t command[4]= {MBL_MW_MODULE_GYRO, ORDINAL(GyroBmi160Register::CONFIG)};
     auto config= &((GyroBoschConfig*) board->module_config.at(MBL_MW_MODULE_GYRO))->config;
     memcpy(command + 2, config, sizeof(*config));
-    SEND_COMMAND;
+    SEND_CONFIG_COMMAND;
 }
 
 // Set the bmi270 odr
@@ -514,7 +514,7 @@ void mbl_mw_gyro_bmi270_write_config(const MblMwMetaWearBoard *board) {
     uint8_t command[4]= {MBL_MW_MODULE_GYRO, ORDINAL(GyroBmi270Register::CONFIG)};
     auto config= &((GyroBoschConfig*) board->module_config.at(MBL_MW_MODULE_GYRO))->config;
     memcpy(command + 2, config, sizeof(*config));
-    SEND_COMMAND;
+    SEND_CONFIG_COMMAND;
 }
 
 uint8_t mbl_mw_gyro_is_active(const MblMwMetaWearBoard *board) {
@@ -0,0 +1,470 @@
+#include "metawear/sensor/host_sensor_fusion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::asin;
+using std::atan2;
+using std::condition_variable;
+using std::deque;
+using std::fill;
+using std::max;
+using std::min;
+using std::move;
+using std::mutex;
+using std::sqrt;
+using std::thread;
+using std::unique_lock;
+using std::vector;
+
+static const float DEG_TO_RAD = 0.017453292519943295f, RAD_TO_DEG = 57.29577951308232f;
+static const uint8_t N_OUTPUTS = MBL_MW_SENSOR_FUSION_DATA_LINEAR_ACC - MBL_MW_SENSOR_FUSION_DATA_QUATERNION + 1;
+
+struct FusionOutput {
+    void *context;
+    MblMwFnData received_data;
+};
+
+struct FusionBatch {
+    vector<MblMwCartesianFloat> acc, gyro, mag;
+    vector<int64_t> epochs;
+};
+
+/**
+ * Inputs of one filter step, split into one array per axis.  Gyro data is in rad/s, accelerometer and magnetometer
+ * data are unit vectors, or all zeros when unavailable.
+ */
+struct FusionSteps {
+    vector<float> gx, gy, gz, ax, ay, az, mx, my, mz;
+};
+
+struct MblMwHostSensorFusion {
+    MblMwHostSensorFusionAlgorithm algorithm;
+    float dt, gain;
+    float q0, q1, q2, q3;
+    // last received samples, acc is also kept unnormalized for the linear acceleration
+    float acc[3], acc_unit[3], mag_unit[3];
+    FusionOutput outputs[N_OUTPUTS];
+    FusionSteps steps;
+
+    // guarded by the mutex of the pool the filter was submitted to
+    deque<FusionBatch> batches;
+    bool scheduled;
+};
+
+struct MblMwHostSensorFusionPool {
+    vector<thread> workers;
+    mutex queue_mutex;
+    condition_variable batch_ready, all_done;
+    deque<MblMwHostSensorFusion*> ready;
+    uint64_t n_outstanding;
+    bool stopping;
+};
+
+// Helper function - scales (x, y, z) in place to a unit vector, leaving all zeros if its norm is 0
+static inline void normalize(float& x, float& y, float& z) {
+    float norm = sqrt(x * x + y * y + z * z);
+    float scale = norm > 0.f ? 1.f / norm : 0.f;
+    x *= scale;
+    y *= scale;
+    z *= scale;
+}
+
+static void madgwick_step(MblMwHostSensorFusion* fusion, float gx, float gy, float gz, float ax, float ay, float az,
+        float mx, float my, float mz) {
+    float q0 = fusion->q0, q1 = fusion->q1, q2 = fusion->q2, q3 = fusion->q3;
+
+    float qDot0 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+    float qDot1 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+    float qDot2 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+    float qDot3 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+    if (ax != 0.f || ay != 0.f || az != 0.f) {
+        float s0, s1, s2, s3;
+        float _2q0 = 2.f * q0, _2q1 = 2.f * q1, _2q2 = 2.f * q2, _2q3 = 2.f * q3;
+        float q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+
+        if (mx != 0.f || my != 0.f || mz != 0.f) {
+            float _2q0mx = 2.f * q0 * mx, _2q0my = 2.f * q0 * my, _2q0mz = 2.f * q0 * mz, _2q1mx = 2.f * q1 * mx;
+            float _2q0q2 = 2.f * q0 * q2, _2q2q3 = 2.f * q2 * q3;
+            float q0q1 = q0 * q1, q0q2 = q0 * q2, q0q3 = q0 * q3, q1q2 = q1 * q2, q1q3 = q1 * q3, q2q3 = q2 * q3;
+
+            // reference direction of the earth's magnetic field
+            float hx = mx * q0q0 - _2q0my * q3 + _2q0mz * q2 + mx * q1q1 + _2q1 * my * q2 + _2q1 * mz * q3 - mx * q2q2 - mx * q3q3;
+            float hy = _2q0mx * q3 + my * q0q0 - _2q0mz * q1 + _2q1mx * q2 - my * q1q1 + my * q2q2 + _2q2 * mz * q3 - my * q3q3;
+            float _2bx = sqrt(hx * hx + hy * hy);
+            float _2bz = -_2q0mx * q2 + _2q0my * q1 + mz * q0q0 + _2q1mx * q3 - mz * q1q1 + _2q2 * my * q3 - mz * q2q2 + mz * q3q3;
+            float _4bx = 2.f * _2bx, _4bz = 2.f * _2bz;
+
+            float fax = 2.f * q1q3 - _2q0q2 - ax, fay = 2.f * q0q1 + _2q2q3 - ay, faz = 1.f - 2.f * q1q1 - 2.f * q2q2 - az;
+            float fmx = _2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx;
+            float fmy = _2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my;
+            float fmz = _2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz;
+
+            s0 = -_2q2 * fax + _2q1 * fay - _2bz * q2 * fmx + (-_2bx * q3 + _2bz * q1) * fmy + _2bx * q2 * fmz;
+            s1 = _2q3 * fax + _2q0 * fay - 4.f * q1 * faz + _2bz * q3 * fmx + (_2bx * q2 + _2bz * q0) * fmy + (_2bx * q3 - _4bz * q1) * fmz;
+            s2 = -_2q0 * fax + _2q3 * fay - 4.f * q2 * faz + (-_4bx * q2 - _2bz * q0) * fmx + (_2bx * q1 + _2bz * q3) * fmy + (_2bx * q0 - _4bz * q2) * fmz;
+            s3 = _2q1 * fax + _2q2 * fay + (-_4bx * q3 + _2bz * q1) * fmx + (-_2bx * q0 + _2bz * q2) * fmy + _2bx * q1 * fmz;
+        } else {
+            float _4q0 = 4.f * q0, _4q1 = 4.f * q1, _4q2 = 4.f * q2, _8q1 = 8.f * q1, _8q2 = 8.f * q2;
+
+            s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+            s1 = _4q1 * q3q3 - _2q3 * ax + 4.f * q0q0 * q1 - _2q0 * ay - _4q1 + _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az;
+            s2 = 4.f * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 + _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az;
+            s3 = 4.f * q1q1 * q3 - _2q1 * ax + 4.f * q2q2 * q3 - _2q2 * ay;
+        }
+
+        float norm = sqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+        if (norm > 0.f) {
+            float scale = fusion->gain / norm;
+            qDot0 -= scale * s0;
+            qDot1 -= scale * s1;
+            qDot2 -= scale * s2;
+            qDot3 -= scale * s3;
+        }
+    }
+
+    q0 += qDot0 * fusion->dt;
+    q1 += qDot1 * fusion->dt;
+    q2 += qDot2 * fusion->dt;
+    q3 += qDot3 * fusion->dt;
+
+    float scale = 1.f / sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    fusion->q0 = q0 * scale;
+    fusion->q1 = q1 * scale;
+    fusion->q2 = q2 * scale;
+    fusion->q3 = q3 * scale;
+}
+
+static void mahony_step(MblMwHostSensorFusion* fusion, float gx, float gy, float gz, float ax, float ay, float az,
+        float mx, float my, float mz) {
+    float q0 = fusion->q0, q1 = fusion->q1, q2 = fusion->q2, q3 = fusion->q3;
+
+    if (ax != 0.f || ay != 0.f || az != 0.f) {
+        float q0q0 = q0 * q0, q0q1 = q0 * q1, q0q2 = q0 * q2, q0q3 = q0 * q3, q1q1 = q1 * q1, q1q2 = q1 * q2,
+                q1q3 = q1 * q3, q2q2 = q2 * q2, q2q3 = q2 * q3, q3q3 = q3 * q3;
+
+        // error is the cross product between the measured and estimated directions of gravity, and magnetic field
+        float halfvx = q1q3 - q0q2, halfvy = q0q1 + q2q3, halfvz = q0q0 - 0.5f + q3q3;
+        float halfex = ay * halfvz - az * halfvy, halfey = az * halfvx - ax * halfvz, halfez = ax * halfvy - ay * halfvx;
+
+        if (mx != 0.f || my != 0.f || mz != 0.f) {
+            float hx = 2.f * (mx * (0.5f - q2q2 - q3q3) + my * (q1q2 - q0q3) + mz * (q1q3 + q0q2));
+            float hy = 2.f * (mx * (q1q2 + q0q3) + my * (0.5f - q1q1 - q3q3) + mz * (q2q3 - q0q1));
+            float bx = sqrt(hx * hx + hy * hy);
+            float bz = 2.f * (mx * (q1q3 - q0q2) + my * (q2q3 + q0q1) + mz * (0.5f - q1q1 - q2q2));
+
+            float halfwx = bx * (0.5f - q2q2 - q3q3) + bz * (q1q3 - q0q2);
+            float halfwy = bx * (q1q2 - q0q3) + bz * (q0q1 + q2q3);
+            float halfwz = bx * (q0q2 + q1q3) + bz * (0.5f - q1q1 - q2q2);
+
+            halfex += my * halfwz - mz * halfwy;
+            halfey += mz * halfwx - mx * halfwz;
+            halfez += mx * halfwy - my * halfwx;
+        }
+
+        float twoKp = 2.f * fusion->gain;
+        gx += twoKp * halfex;
+        gy += twoKp * halfey;
+        gz += twoKp * halfez;
+    }
+
+    gx *= 0.5f * fusion->dt;
+    gy *= 0.5f * fusion->dt;
+    gz *= 0.5f * fusion->dt;
+
+    float qa = q0, qb = q1, qc = q2;
+    q0 += -qb * gx - qc * gy - q3 * gz;
+    q1 += qa * gx + qc * gz - q3 * gy;
+    q2 += qa * gy - qb * gz + q3 * gx;
+    q3 += qa * gz + qb * gy - qc * gx;
+
+    float scale = 1.f / sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    fusion->q0 = q0 * scale;
+    fusion->q1 = q1 * scale;
+    fusion->q2 = q2 * scale;
+    fusion->q3 = q3 * scale;
+}
+
+// Helper function - sends the current orientation to the subscribed outputs
+static void emit_outputs(MblMwHostSensorFusion* fusion, int64_t epoch, const float* acc) {
+    float q0 = fusion->q0, q1 = fusion->q1, q2 = fusion->q2, q3 = fusion->q3;
+    MblMwData data;
+    data.epoch = epoch;
+    data.extra = nullptr;
+
+    FusionOutput* output = &fusion->outputs[0];
+    if (output->received_data != nullptr) {
+        MblMwQuaternion value = { q0, q1, q2, q3 };
+        data.value = &value;
+        data.type_id = MBL_MW_DT_ID_QUATERNION;
+        data.length = sizeof(value);
+        output->received_data(output->context, &data);
+    }
+
+    output = &fusion->outputs[MBL_MW_SENSOR_FUSION_DATA_EULER_ANGLE - MBL_MW_SENSOR_FUSION_DATA_QUATERNION];
+    if (output->received_data != nullptr) {
+        float yaw = atan2(2.f * (q0 * q3 + q1 * q2), 1.f - 2.f * (q2 * q2 + q3 * q3)) * RAD_TO_DEG;
+        MblMwEulerAngles value;
+        value.heading = yaw < 0.f ? yaw + 360.f : yaw;
+        value.pitch = asin(max(-1.f, min(1.f, 2.f * (q0 * q2 - q3 * q1)))) * RAD_TO_DEG;
+        value.roll = atan2(2.f * (q0 * q1 + q2 * q3), 1.f - 2.f * (q1 * q1 + q2 * q2)) * RAD_TO_DEG;
+        value.yaw = yaw;
+
+        data.value = &value;
+        data.type_id = MBL_MW_DT_ID_EULER_ANGLE;
+        data.length = sizeof(value);
+        output->received_data(output->context, &data);
+    }
+
+    // gravity direction in the sensor frame, in g like the accelerometer input
+    float gx = 2.f * (q1 * q3 - q0 * q2), gy = 2.f * (q0 * q1 + q2 * q3), gz = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+    output = &fusion->outputs[MBL_MW_SENSOR_FUSION_DATA_GRAVITY_VECTOR - MBL_MW_SENSOR_FUSION_DATA_QUATERNION];
+    if (output->received_data != nullptr) {
+        MblMwCartesianFloat value = { gx, gy, gz };
+        data.value = &value;
+        data.type_id = MBL_MW_DT_ID_CARTESIAN_FLOAT;
+        data.length = sizeof(value);
+        output->received_data(output->context, &data);
+    }
+
+    output = &fusion->outputs[MBL_MW_SENSOR_FUSION_DATA_LINEAR_ACC - MBL_MW_SENSOR_FUSION_DATA_QUATERNION];
+    if (output->received_data != nullptr) {
+        MblMwCartesianFloat value = { acc[0] - gx, acc[1] - gy, acc[2] - gz };
+        data.value = &value;
+        data.type_id = MBL_MW_DT_ID_CARTESIAN_FLOAT;
+        data.length = sizeof(value);
+        output->received_data(output->context, &data);
+    }
+}
+
+// Helper function - runs the configured filter for one step
+static inline void filter_step(MblMwHostSensorFusion* fusion, float gx, float gy, float gz, float ax, float ay, float az,
+        float mx, float my, float mz) {
+    if (fusion->algorithm == MBL_MW_HOST_SENSOR_FUSION_ALGORITHM_MAHONY) {
+        mahony_step(fusion, gx, gy, gz, ax, ay, az, mx, my, mz);
+    } else {
+        madgwick_step(fusion, gx, gy, gz, ax, ay, az, mx, my, mz);
+    }
+}
+
+MblMwHostSensorFusion* mbl_mw_host_sensor_fusion_create(MblMwHostSensorFusionAlgorithm algorithm, float sample_rate, float gain) {
+    if (!(sample_rate > 0.f)) {
+        return nullptr;
+    }
+
+    MblMwHostSensorFusion* fusion = new MblMwHostSensorFusion;
+    fusion->algorithm = algorithm;
+    fusion->dt = 1.f / sample_rate;
+    fusion->gain = gain;
+    for(uint8_t i = 0; i < N_OUTPUTS; i++) {
+        fusion->outputs[i] = { nullptr, nullptr };
+    }
+    fusion->scheduled = false;
+    mbl_mw_host_sensor_fusion_reset(fusion);
+    return fusion;
+}
+
+void mbl_mw_host_sensor_fusion_subscribe(MblMwHostSensorFusion* fusion, MblMwSensorFusionData data, void *context, MblMwFnData received_data) {
+    if (data >= MBL_MW_SENSOR_FUSION_DATA_QUATERNION && data <= MBL_MW_SENSOR_FUSION_DATA_LINEAR_ACC) {
+        fusion->outputs[data - MBL_MW_SENSOR_FUSION_DATA_QUATERNION] = { context, received_data };
+    }
+}
+
+void mbl_mw_host_sensor_fusion_unsubscribe(MblMwHostSensorFusion* fusion, MblMwSensorFusionData data) {
+    mbl_mw_host_sensor_fusion_subscribe(fusion, data, nullptr, nullptr);
+}
+
+void mbl_mw_host_sensor_fusion_process_acc(void* context, const MblMwData* data) {
+    auto fusion = static_cast<MblMwHostSensorFusion*>(context);
+    auto value = static_cast<const MblMwCartesianFloat*>(data->value);
+
+    fusion->acc[0] = fusion->acc_unit[0] = value->x;
+    fusion->acc[1] = fusion->acc_unit[1] = value->y;
+    fusion->acc[2] = fusion->acc_unit[2] = value->z;
+    normalize(fusion->acc_unit[0], fusion->acc_unit[1], fusion->acc_unit[2]);
+}
+
+void mbl_mw_host_sensor_fusion_process_gyro(void* context, const MblMwData* data) {
+    auto fusion = static_cast<MblMwHostSensorFusion*>(context);
+    auto value = static_cast<const MblMwCartesianFloat*>(data->value);
+
+    filter_step(fusion, value->x * DEG_TO_RAD, value->y * DEG_TO_RAD, value->z * DEG_TO_RAD,
+            fusion->acc_unit[0], fusion->acc_unit[1], fusion->acc_unit[2],
+            fusion->mag_unit[0], fusion->mag_unit[1], fusion->mag_unit[2]);
+    emit_outputs(fusion, data->epoch, fusion->acc);
+}
+
+void mbl_mw_host_sensor_fusion_process_mag(void* context, const MblMwData* data) {
+    auto fusion = static_cast<MblMwHostSensorFusion*>(context);
+    auto value = static_cast<const MblMwCartesianFloat*>(data->value);
+
+    fusion->mag_unit[0] = value->x;
+    fusion->mag_unit[1] = value->y;
+    fusion->mag_unit[2] = value->z;
+    normalize(fusion->mag_unit[0], fusion->mag_unit[1], fusion->mag_unit[2]);
+}
+
+void mbl_mw_host_sensor_fusion_process_batch(MblMwHostSensorFusion* fusion, const MblMwCartesianFloat* acc,
+        const MblMwCartesianFloat* gyro, const MblMwCartesianFloat* mag, const int64_t* epochs, uint32_t n_samples) {
+    FusionSteps& steps = fusion->steps;
+    for(auto it: { &steps.gx, &steps.gy, &steps.gz, &steps.ax, &steps.ay, &steps.az, &steps.mx, &steps.my, &steps.mz }) {
+        it->resize(n_samples);
+    }
+
+    // unit conversions and normalization have no dependency between samples, do them up front in flat loops the
+    // compiler can vectorize, leaving only the recurrence for the per sample loop
+    for(uint32_t i = 0; i < n_samples; i++) {
+        steps.gx[i] = gyro[i].x * DEG_TO_RAD;
+        steps.gy[i] = gyro[i].y * DEG_TO_RAD;
+        steps.gz[i] = gyro[i].z * DEG_TO_RAD;
+    }
+    for(uint32_t i = 0; i < n_samples; i++) {
+        float x = acc[i].x, y = acc[i].y, z = acc[i].z, norm = sqrt(x * x + y * y + z * z);
+        float scale = norm > 0.f ? 1.f / norm : 0.f;
+        steps.ax[i] = x * scale;
+        steps.ay[i] = y * scale;
+        steps.az[i] = z * scale;
+    }
+    if (mag == nullptr) {
+        fill(steps.mx.begin(), steps.mx.end(), 0.f);
+        fill(steps.my.begin(), steps.my.end(), 0.f);
+        fill(steps.mz.begin(), steps.mz.end(), 0.f);
+    } else {
+        for(uint32_t i = 0; i < n_samples; i++) {
+            float x = mag[i].x, y = mag[i].y, z = mag[i].z, norm = sqrt(x * x + y * y + z * z);
+            float scale = norm > 0.f ? 1.f / norm : 0.f;
+            steps.mx[i] = x * scale;
+            steps.my[i] = y * scale;
+            steps.mz[i] = z * scale;
+        }
+    }
+
+    for(uint32_t i = 0; i < n_samples; i++) {
+        filter_step(fusion, steps.gx[i], steps.gy[i], steps.gz[i], steps.ax[i], steps.ay[i], steps.az[i],
+                steps.mx[i], steps.my[i], steps.mz[i]);
+
+        float raw_acc[3] = { acc[i].x, acc[i].y, acc[i].z };
+        emit_outputs(fusion, epochs[i], raw_acc);
+    }
+
+    if (n_samples > 0) {
+        uint32_t last = n_samples - 1;
+        fusion->acc[0] = acc[last].x;
+        fusion->acc[1] = acc[last].y;
+        fusion->acc[2] = acc[last].z;
+        fusion->acc_unit[0] = steps.ax[last];
+        fusion->acc_unit[1] = steps.ay[last];
+        fusion->acc_unit[2] = steps.az[last];
+        if (mag != nullptr) {
+            fusion->mag_unit[0] = steps.mx[last];
+            fusion->mag_unit[1] = steps.my[last];
+            fusion->mag_unit[2] = steps.mz[last];
+        }
+    }
+}
+
+void mbl_mw_host_sensor_fusion_reset(MblMwHostSensorFusion* fusion) {
+    fusion->q0 = 1.f;
+    fusion->q1 = fusion->q2 = fusion->q3 = 0.f;
+    for(uint8_t i = 0; i < 3; i++) {
+        fusion->acc[i] = fusion->acc_unit[i] = fusion->mag_unit[i] = 0.f;
+    }
+}
+
+void mbl_mw_host_sensor_fusion_free(MblMwHostSensorFusion* fusion) {
+    delete fusion;
+}
+
+// Helper function - processes queued batches until the pool is stopped
+static void run_worker(MblMwHostSensorFusionPool* pool) {
+    unique_lock<mutex> lock(pool->queue_mutex);
+    while(true) {
+        pool->batch_ready.wait(lock, [pool] { return pool->stopping || !pool->ready.empty(); });
+        if (pool->ready.empty()) {
+            return;
+        }
+
+        // a filter sits in the ready queue at most once, so no other worker can step it until it is requeued
+        MblMwHostSensorFusion* fusion = pool->ready.front();
+        pool->ready.pop_front();
+        FusionBatch batch(move(fusion->batches.front()));
+        fusion->batches.pop_front();
+
+        lock.unlock();
+        mbl_mw_host_sensor_fusion_process_batch(fusion, batch.acc.data(), batch.gyro.data(),
+                batch.mag.empty() ? nullptr : batch.mag.data(), batch.epochs.data(), (uint32_t) batch.epochs.size());
+        lock.lock();
+
+        if (fusion->batches.empty()) {
+            fusion->scheduled = false;
+        } else {
+            pool->ready.push_back(fusion);
+            pool->batch_ready.notify_one();
+        }
+
+        pool->n_outstanding--;
+        if (pool->n_outstanding == 0) {
+            pool->all_done.notify_all();
+        }
+    }
+}
+
+MblMwHostSensorFusionPool* mbl_mw_host_sensor_fusion_pool_create(uint32_t n_threads) {
+    if (n_threads == 0) {
+        n_threads = max(1u, thread::hardware_concurrency());
+    }
+
+    MblMwHostSensorFusionPool* pool = new MblMwHostSensorFusionPool;
+    pool->n_outstanding = 0;
+    pool->stopping = false;
+    for(uint32_t i = 0; i < n_threads; i++) {
+        pool->workers.emplace_back(run_worker, pool);
+    }
+    return pool;
+}
+
+void mbl_mw_host_sensor_fusion_pool_submit(MblMwHostSensorFusionPool* pool, MblMwHostSensorFusion* fusion,
+        const MblMwCartesianFloat* acc, const MblMwCartesianFloat* gyro, const MblMwCartesianFloat* mag,
+        const int64_t* epochs, uint32_t n_samples) {
+    FusionBatch batch;
+    batch.acc.assign(acc, acc + n_samples);
+    batch.gyro.assign(gyro, gyro + n_samples);
+    if (mag != nullptr) {
+        batch.mag.assign(mag, mag + n_samples);
+    }
+    batch.epochs.assign(epochs, epochs + n_samples);
+
+    unique_lock<mutex> lock(pool->queue_mutex);
+    fusion->batches.push_back(move(batch));
+    pool->n_outstanding++;
+    if (!fusion->scheduled) {
+        fusion->scheduled = true;
+        pool->ready.push_back(fusion);
+        pool->batch_ready.notify_one();
+    }
+}
+
+void mbl_mw_host_sensor_fusion_pool_wait(MblMwHostSensorFusionPool* pool) {
+    unique_lock<mutex> lock(pool->queue_mutex);
+    pool->all_done.wait(lock, [pool] { return pool->n_outstanding == 0; });
+}
+
+void mbl_mw_host_sensor_fusion_pool_free(MblMwHostSensorFusionPool* pool) {
+    mbl_mw_host_sensor_fusion_pool_wait(pool);
+    {
+        unique_lock<mutex> lock(pool->queue_mutex);
+        pool->stopping = true;
+    }
+    pool->batch_ready.notify_all();
+
+    for(auto& it: pool->workers) {
+        it.join();
+    }
+    delete pool;
+}
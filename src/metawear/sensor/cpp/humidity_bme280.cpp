@@ -36,7 +36,7 @@ MblMwDataSignal* mbl_mw_humidity_bme280_get_percentage_data_signal(const MblMwMe
 // Set oversampling
 void mbl_mw_humidity_bme280_set_oversampling(const MblMwMetaWearBoard *board, MblMwHumidityBme280Oversampling oversampling) {
     uint8_t command[3]= { MBL_MW_MODULE_HUMIDITY, ORDINAL(HumidityBme280Register::MODE), static_cast<uint8_t>(oversampling) };
-    SEND_COMMAND;
+    SEND_CONFIG_COMMAND;
 }
 
 // Name for the loggers
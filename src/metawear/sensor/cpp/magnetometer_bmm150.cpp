@@ -65,10 +65,10 @@ void mbl_mw_mag_bmm150_configure(const MblMwMetaWearBoard *board, uint16_t xy_re
 
     uint8_t data_rep_cmd[4]= { MBL_MW_MODULE_MAGNETOMETER, ORDINAL(MagnetometerBmm150Register::DATA_REPETITIONS), 
             static_cast<uint8_t>((xy_reps - 1) / 2), static_cast<uint8_t>(z_reps - 1) };
-    send_command(board, data_rep_cmd, sizeof(data_rep_cmd));
+    send_config_command(board, data_rep_cmd, sizeof(data_rep_cmd));
 
     uint8_t data_rate_cmd[3]= { MBL_MW_MODULE_MAGNETOMETER, ORDINAL(MagnetometerBmm150Register::DATA_RATE), static_cast<uint8_t>(odr) };
-    send_command(board, data_rate_cmd, sizeof(data_rate_cmd));
+    send_config_command(board, data_rate_cmd, sizeof(data_rate_cmd));
 }
 
 // Set the mode of the magnetometer
@@ -238,7 +238,7 @@ void mbl_mw_sensor_fusion_write_config(MblMwMetaWearBoard* board) {
 
     uint8_t command[4] = {MBL_MW_MODULE_SENSOR_FUSION, ORDINAL(SensorFusionRegister::MODE)};
     memcpy(command + 2, &(state->config), sizeof(state->config));
-    SEND_COMMAND;
+    SEND_CONFIG_COMMAND;
 
     switch(board->module_info.at(MBL_MW_MODULE_GYRO).implementation) {
     case MBL_MW_MODULE_GYRO_TYPE_BMI160:
@@ -342,6 +342,7 @@ void mbl_mw_sensor_fusion_clear_enabled_mask(MblMwMetaWearBoard* board) {
 
 // Start sensor fusion
 void mbl_mw_sensor_fusion_start(const MblMwMetaWearBoard* board) {
+    WriteBatch batch(board);
     switch(board->module_info.at(MBL_MW_MODULE_GYRO).implementation) {
     case MBL_MW_MODULE_GYRO_TYPE_BMI160:
         switch(((SensorFusionState*) board->module_config.at(MBL_MW_MODULE_SENSOR_FUSION))->config.mode) {
@@ -415,6 +416,7 @@ void mbl_mw_sensor_fusion_start(const MblMwMetaWearBoard* board) {
 
 // Stop sensor fusion
 void mbl_mw_sensor_fusion_stop(const MblMwMetaWearBoard* board) {
+    WriteBatch batch(board);
     uint8_t stop_cmd[3] = {MBL_MW_MODULE_SENSOR_FUSION, ORDINAL(SensorFusionRegister::ENABLE), 0x0};
     send_command(board, stop_cmd, sizeof(stop_cmd));
 
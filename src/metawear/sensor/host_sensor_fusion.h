@@ -0,0 +1,135 @@
+/**
+ * @copyright MbientLab License
+ * @file host_sensor_fusion.h
+ * @brief Computes orientation on the host from raw accelerometer, gyro, and magnetometer data
+ * @details
+ * The host sensor fusion filters are an alternative to the on board sensor fusion module for boards streaming raw, or
+ * packed, IMU data.  Accelerometer data is expected in g's, gyro data in degrees per second, and magnetometer data in
+ * any consistent unit.  The filter steps once for every gyro sample, using the most recent accelerometer and, if any
+ * were received, magnetometer samples, and produces the same data types as the on board algorithm.  Each filter is
+ * single threaded; use a pool to run the filters of many boards in parallel.
+ */
+#pragma once
+
+#include "host_sensor_fusion_fwd.h"
+#include "sensor_fusion.h"
+
+#include "metawear/core/data.h"
+#include "metawear/core/types.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/**
+ * Orientation filters available on the host
+ */
+typedef enum {
+    MBL_MW_HOST_SENSOR_FUSION_ALGORITHM_MADGWICK = 0,      ///< Gradient descent filter, gain is the beta parameter
+    MBL_MW_HOST_SENSOR_FUSION_ALGORITHM_MAHONY             ///< Complementary filter, gain is the proportional gain
+} MblMwHostSensorFusionAlgorithm;
+
+/**
+ * Creates a host sensor fusion filter, starting at the identity orientation
+ * @param algorithm             Filter to run
+ * @param sample_rate           Gyro sample rate, in Hz, used as the filter's time step
+ * @param gain                  Weight given to the accelerometer and magnetometer corrections
+ * @return Pointer to the filter, null if the sample rate is not positive
+ */
+METAWEAR_API MblMwHostSensorFusion* mbl_mw_host_sensor_fusion_create(MblMwHostSensorFusionAlgorithm algorithm, 
+        float sample_rate, float gain);
+/**
+ * Subscribes to one of the filter's outputs.  Only quaternion, Euler angle, gravity vector, and linear acceleration
+ * outputs are computed on the host; subscribing to the corrected sensor data does nothing.  The gravity vector and 
+ * linear acceleration are in g, the same unit as the accelerometer samples fed to the filter.
+ * @param fusion                Calling object
+ * @param data                  Output to subscribe to
+ * @param context               Pointer to additional data for the callback function
+ * @param received_data         Callback function to handle the output
+ */
+METAWEAR_API void mbl_mw_host_sensor_fusion_subscribe(MblMwHostSensorFusion* fusion, MblMwSensorFusionData data, 
+        void *context, MblMwFnData received_data);
+/**
+ * Removes the callback function from one of the filter's outputs
+ * @param fusion                Calling object
+ * @param data                  Output to unsubscribe from
+ */
+METAWEAR_API void mbl_mw_host_sensor_fusion_unsubscribe(MblMwHostSensorFusion* fusion, MblMwSensorFusionData data);
+/**
+ * Feeds an accelerometer sample to the filter.  This function, along with the gyro and magnetometer variants, has the 
+ * MblMwFnData signature and can be passed directly to mbl_mw_datasignal_subscribe with the filter as the context.
+ * @param fusion                Filter to feed, as a void pointer
+ * @param data                  MblMwCartesianFloat sample
+ */
+METAWEAR_API void mbl_mw_host_sensor_fusion_process_acc(void* fusion, const MblMwData* data);
+/**
+ * Feeds a gyro sample to the filter, stepping it once and sending the outputs to the subscribers
+ * @param fusion                Filter to feed, as a void pointer
+ * @param data                  MblMwCartesianFloat sample
+ */
+METAWEAR_API void mbl_mw_host_sensor_fusion_process_gyro(void* fusion, const MblMwData* data);
+/**
+ * Feeds a magnetometer sample to the filter
+ * @param fusion                Filter to feed, as a void pointer
+ * @param data                  MblMwCartesianFloat sample
+ */
+METAWEAR_API void mbl_mw_host_sensor_fusion_process_mag(void* fusion, const MblMwData* data);
+/**
+ * Steps the filter over a batch of time aligned samples, sending the outputs of every step to the subscribers
+ * @param fusion                Calling object
+ * @param acc                   Accelerometer samples
+ * @param gyro                  Gyro samples
+ * @param mag                   Magnetometer samples, null to only use the accelerometer for corrections
+ * @param epochs                Epoch of each step, copied into the outputs
+ * @param n_samples             Number of samples in each array
+ */
+METAWEAR_API void mbl_mw_host_sensor_fusion_process_batch(MblMwHostSensorFusion* fusion, const MblMwCartesianFloat* acc,
+        const MblMwCartesianFloat* gyro, const MblMwCartesianFloat* mag, const int64_t* epochs, uint32_t n_samples);
+/**
+ * Returns the filter to the identity orientation and forgets the last received samples
+ * @param fusion                Calling object
+ */
+METAWEAR_API void mbl_mw_host_sensor_fusion_reset(MblMwHostSensorFusion* fusion);
+/**
+ * Frees the filter.  Unsubscribe any signals feeding the filter, and wait on any pool it was submitted to, before 
+ * calling this function.
+ * @param fusion                Filter to free
+ */
+METAWEAR_API void mbl_mw_host_sensor_fusion_free(MblMwHostSensorFusion* fusion);
+
+/**
+ * Creates a pool of worker threads for running filters
+ * @param n_threads             Number of worker threads, 0 to use one per hardware thread
+ * @return Pointer to the pool
+ */
+METAWEAR_API MblMwHostSensorFusionPool* mbl_mw_host_sensor_fusion_pool_create(uint32_t n_threads);
+/**
+ * Queues a batch to be processed by one of the pool's workers.  The arrays are copied so they can be reused as soon as 
+ * the function returns.  Batches submitted for the same filter are processed one at a time in submission order, while 
+ * batches for different filters run in parallel; subscribers are called from the worker threads.  A filter must not 
+ * be submitted to more than one pool, nor be fed directly, while it has batches queued.
+ * @param pool                  Calling object
+ * @param fusion                Filter to step
+ * @param acc                   Accelerometer samples
+ * @param gyro                  Gyro samples
+ * @param mag                   Magnetometer samples, null to only use the accelerometer for corrections
+ * @param epochs                Epoch of each step, copied into the outputs
+ * @param n_samples             Number of samples in each array
+ */
+METAWEAR_API void mbl_mw_host_sensor_fusion_pool_submit(MblMwHostSensorFusionPool* pool, MblMwHostSensorFusion* fusion, 
+        const MblMwCartesianFloat* acc, const MblMwCartesianFloat* gyro, const MblMwCartesianFloat* mag, 
+        const int64_t* epochs, uint32_t n_samples);
+/**
+ * Blocks until every batch submitted to the pool has been processed
+ * @param pool                  Calling object
+ */
+METAWEAR_API void mbl_mw_host_sensor_fusion_pool_wait(MblMwHostSensorFusionPool* pool);
+/**
+ * Waits for the queued batches to be processed then stops the worker threads and frees the pool
+ * @param pool                  Pool to free
+ */
+METAWEAR_API void mbl_mw_host_sensor_fusion_pool_free(MblMwHostSensorFusionPool* pool);
+
+#ifdef	__cplusplus
+}
+#endif
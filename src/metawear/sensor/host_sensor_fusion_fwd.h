@@ -0,0 +1,24 @@
+/**
+ * @copyright MbientLab License
+ * @file host_sensor_fusion_fwd.h
+ * @brief Forward declarations for the host sensor fusion types
+ */
+#pragma once
+
+/**
+ * Orientation filter run on the host from raw accelerometer, gyro, and magnetometer data
+ */
+#ifdef	__cplusplus
+struct MblMwHostSensorFusion;
+#else
+typedef struct MblMwHostSensorFusion MblMwHostSensorFusion;
+#endif
+
+/**
+ * Worker threads that run host sensor fusion filters in parallel
+ */
+#ifdef	__cplusplus
+struct MblMwHostSensorFusionPool;
+#else
+typedef struct MblMwHostSensorFusionPool MblMwHostSensorFusionPool;
+#endif
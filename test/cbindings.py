@@ -51,6 +51,14 @@ class BleAdType:
     CONNECTED_UNDIRECTED = 0
     CONNECTED_DIRECTED = 1
 
+class ConfigWriteMode:
+    CHANGED = 0
+    ALL = 1
+
+class RecorderFlag:
+    COMPRESS = 1
+    DELTA_ENCODE = 2
+
 class DataTypeId:
     UINT32 = 0
     FLOAT = 1
@@ -442,6 +450,10 @@ class SensorFusionData:
     GRAVITY_VECTOR = 5
     LINEAR_ACC = 6
 
+class HostSensorFusionAlgorithm:
+    MADGWICK = 0
+    MAHONY = 1
+
 class WhitelistFilter:
     ALLOW_FROM_ANY = 0
     SCAN_REQUESTS = 1
@@ -538,6 +550,7 @@ class AlsLtr329Gain:
 FnVoid_VoidP_Int = CFUNCTYPE(None, c_void_p, c_int)
 FnInt_VoidP_UByteP_UByte = CFUNCTYPE(c_int, c_void_p, POINTER(c_ubyte), c_ubyte)
 FnVoid_VoidP = CFUNCTYPE(None, c_void_p)
+FnVoid_VoidP_Float = CFUNCTYPE(None, c_void_p, c_float)
 class Data(Structure):
     _fields_ = [
         ("epoch" , c_longlong),
@@ -583,6 +596,96 @@ class CalibrationData(Structure):
 FnVoid_VoidP_VoidP_CalibrationDataP = CFUNCTYPE(None, c_void_p, c_void_p, POINTER(CalibrationData))
 FnVoid_VoidP_VoidP = CFUNCTYPE(None, c_void_p, c_void_p)
 FnVoid_VoidP_VoidP_VoidP_UInt = CFUNCTYPE(None, c_void_p, c_void_p, c_void_p, c_uint)
+FnVoid_VoidP_VoidP_VoidPP_UInt_Int = CFUNCTYPE(None, c_void_p, c_void_p, POINTER(c_void_p), c_uint, c_int)
+FnVoid_VoidP_DataP_UInt = CFUNCTYPE(None, c_void_p, POINTER(Data), c_uint)
+class EventBinding(Structure):
+    _fields_ = [
+        ("event" , c_void_p),
+        ("context" , c_void_p),
+        ("record" , FnVoid_VoidP_VoidP)
+    ]
+
+    def __neq__(self, other):
+        return not self.__eq__(other)
+
+    def __eq__(self, other):
+        return (self.event == other.event and self.context == other.context and self.record == other.record)
+
+    def __repr__(self):
+        return "{event : %d, context : %d, record : %d}" % (self.event, self.context, self.record)
+
+    def __deepcopy__(self, memo):
+        return EventBinding(event = self.event, context = self.context, record = self.record)
+
+class EventBindingResult(Structure):
+    _fields_ = [
+        ("event" , c_void_p),
+        ("entry_ids" , POINTER(c_ubyte)),
+        ("n_entry_ids" , c_uint)
+    ]
+
+    def __neq__(self, other):
+        return not self.__eq__(other)
+
+    def __eq__(self, other):
+        return (self.event == other.event and array_ubyte_eq(self.entry_ids, self.n_entry_ids, other.entry_ids, other.n_entry_ids) and self.n_entry_ids == other.n_entry_ids)
+
+    def __repr__(self):
+        return "{event : %d, entry_ids : %s, n_entry_ids : %d}" % (self.event, array_ubyte_to_hex_string(self.entry_ids, self.n_entry_ids), self.n_entry_ids)
+
+    def __deepcopy__(self, memo):
+        return EventBindingResult(event = self.event, entry_ids = array_ubyte_deep_copy(self.entry_ids, self.n_entry_ids), n_entry_ids = self.n_entry_ids)
+
+FnVoid_VoidP_VoidP_EventBindingResultP_UInt_Int = CFUNCTYPE(None, c_void_p, c_void_p, POINTER(EventBindingResult), c_uint, c_int)
+class MacroUploadResult(Structure):
+    _fields_ = [
+        ("id" , c_ubyte),
+        ("n_commands" , c_uint),
+        ("n_dropped" , c_uint),
+        ("size" , c_uint),
+        ("upload_time_ms" , c_uint)
+    ]
+
+    def __neq__(self, other):
+        return not self.__eq__(other)
+
+    def __eq__(self, other):
+        return (self.id == other.id and self.n_commands == other.n_commands and self.n_dropped == other.n_dropped and self.size == other.size and self.upload_time_ms == other.upload_time_ms)
+
+    def __repr__(self):
+        return "{id : %d, n_commands : %d, n_dropped : %d, size : %d, upload_time_ms : %d}" % (self.id, self.n_commands, self.n_dropped, self.size, self.upload_time_ms)
+
+    def __deepcopy__(self, memo):
+        return MacroUploadResult(id = self.id, n_commands = self.n_commands, n_dropped = self.n_dropped, size = self.size, upload_time_ms = self.upload_time_ms)
+
+FnVoid_VoidP_VoidP_MacroUploadResultP_Int = CFUNCTYPE(None, c_void_p, c_void_p, POINTER(MacroUploadResult), c_int)
+class TearDownSummary(Structure):
+    _fields_ = [
+        ("n_commands" , c_uint),
+        ("n_per_object_commands" , c_uint),
+        ("n_freed" , c_uint)
+    ]
+
+    def __neq__(self, other):
+        return not self.__eq__(other)
+
+    def __eq__(self, other):
+        return (self.n_commands == other.n_commands and self.n_per_object_commands == other.n_per_object_commands and self.n_freed == other.n_freed)
+
+    def __repr__(self):
+        return "{n_commands : %d, n_per_object_commands : %d, n_freed : %d}" % (self.n_commands, self.n_per_object_commands, self.n_freed)
+
+    def __deepcopy__(self, memo):
+        return TearDownSummary(n_commands = self.n_commands, n_per_object_commands = self.n_per_object_commands, n_freed = self.n_freed)
+
+class Notification(Structure):
+    _fields_ = [
+        ("board" , c_void_p),
+        ("value" , POINTER(c_ubyte)),
+        ("length" , c_ubyte),
+        ("epoch" , c_longlong)
+    ]
+
 class GattChar(Structure):
     _fields_ = [
         ("service_uuid_high" , c_ulonglong),
@@ -607,6 +710,16 @@ FnVoid_VoidP_VoidP_GattCharWriteType_GattCharP_UByteP_UByte = CFUNCTYPE(None, c_
 FnVoid_VoidP_VoidP_GattCharP_FnIntVoidPtrArray = CFUNCTYPE(None, c_void_p, c_void_p, POINTER(GattChar), FnInt_VoidP_UByteP_UByte)
 FnVoid_VoidP_VoidP_GattCharP_FnIntVoidPtrArray_FnVoidVoidPtrInt = CFUNCTYPE(None, c_void_p, c_void_p, POINTER(GattChar), FnInt_VoidP_UByteP_UByte, FnVoid_VoidP_Int)
 FnVoid_VoidP_VoidP_FnVoidVoidPtrInt = CFUNCTYPE(None, c_void_p, c_void_p, FnVoid_VoidP_Int)
+class GattCharWrite(Structure):
+    _fields_ = [
+        ("write_type" , c_int),
+        ("characteristic" , POINTER(GattChar)),
+        ("value" , POINTER(c_ubyte)),
+        ("length" , c_ubyte)
+    ]
+
+FnVoid_VoidP_VoidP_GattCharWriteP_UInt = CFUNCTYPE(None, c_void_p, c_void_p, POINTER(GattCharWrite), c_uint)
+FnLong_VoidP = CFUNCTYPE(c_longlong, c_void_p)
 class BtleConnection(Structure):
     _fields_ = [
         ("context" , c_void_p),
@@ -957,6 +1070,19 @@ class DfuDelegate(Structure):
     def __neq__(self, other):
         return not self.__eq__(other)
 
+FnVoid_VoidP_VoidP_charP = CFUNCTYPE(None, c_void_p, c_void_p, c_char_p)
+FnVoid_VoidP_Int_Int = CFUNCTYPE(None, c_void_p, c_int, c_int)
+class DfuOrchestratorDelegate(Structure):
+    _fields_ = [
+        ("context" , c_void_p),
+        ("on_board_finished" , FnVoid_VoidP_VoidP_charP),
+        ("on_progress" , FnVoid_VoidP_Int),
+        ("on_finished" , FnVoid_VoidP_Int_Int)
+    ]
+
+    def __neq__(self, other):
+        return not self.__eq__(other)
+
     def __eq__(self, other):
         return (self.context == other.context and self.on_dfu_started == other.on_dfu_started and self.on_dfu_cancelled == other.on_dfu_cancelled and self.on_transfer_percentage == other.on_transfer_percentage and self.on_successful_file_transferred == other.on_successful_file_transferred and self.on_error == other.on_error)
 
@@ -1080,6 +1206,9 @@ class Const:
     STATUS_OK = 0
     STATUS_ERROR_SERIALIZATION_FORMAT = 32
     STATUS_ERROR_ENABLE_NOTIFY = 64
+    STATUS_ERROR_IO = 128
+    STATUS_ERROR_CAPACITY_EXCEEDED = 256
+    SHM_MAX_VALUE_LENGTH = 40
     SETTINGS_BATTERY_CHARGE_INDEX = 1
     CD_TCS34725_ADC_GREEN_INDEX = 2
     GYRO_ROTATION_X_AXIS_INDEX = 0
@@ -1470,6 +1599,15 @@ def init_libmetawear(libmetawear):
     libmetawear.mbl_mw_metawearboard_set_time_for_response.restype = None
     libmetawear.mbl_mw_metawearboard_set_time_for_response.argtypes = [c_void_p, c_ushort]
 
+    libmetawear.mbl_mw_metawearboard_set_mtu.restype = None
+    libmetawear.mbl_mw_metawearboard_set_mtu.argtypes = [c_void_p, c_ushort]
+
+    libmetawear.mbl_mw_metawearboard_set_write_gatt_chars.restype = None
+    libmetawear.mbl_mw_metawearboard_set_write_gatt_chars.argtypes = [c_void_p, FnVoid_VoidP_VoidP_GattCharWriteP_UInt]
+
+    libmetawear.mbl_mw_metawearboard_set_dfu_transfer_rate_handler.restype = None
+    libmetawear.mbl_mw_metawearboard_set_dfu_transfer_rate_handler.argtypes = [c_void_p, FnVoid_VoidP_Float]
+
     libmetawear.mbl_mw_gyro_bmi270_get_packed_rotation_data_signal.restype = c_void_p
     libmetawear.mbl_mw_gyro_bmi270_get_packed_rotation_data_signal.argtypes = [c_void_p]
 
@@ -2226,3 +2364,329 @@ def init_libmetawear(libmetawear):
     libmetawear.mbl_mw_als_ltr329_stop.restype = None
     libmetawear.mbl_mw_als_ltr329_stop.argtypes = [c_void_p]
 
+    libmetawear.mbl_mw_recorder_create.restype = c_void_p
+    libmetawear.mbl_mw_recorder_create.argtypes = [c_char_p, c_uint]
+
+    libmetawear.mbl_mw_recorder_create_with_flags.restype = c_void_p
+    libmetawear.mbl_mw_recorder_create_with_flags.argtypes = [c_char_p, c_uint, c_ushort]
+
+    libmetawear.mbl_mw_recorder_write.restype = None
+    libmetawear.mbl_mw_recorder_write.argtypes = [c_void_p, POINTER(Data)]
+
+    libmetawear.mbl_mw_datasignal_record.restype = None
+    libmetawear.mbl_mw_datasignal_record.argtypes = [c_void_p, c_void_p]
+
+    libmetawear.mbl_mw_logger_record.restype = None
+    libmetawear.mbl_mw_logger_record.argtypes = [c_void_p, c_void_p]
+
+    libmetawear.mbl_mw_recorder_get_dropped.restype = c_uint
+    libmetawear.mbl_mw_recorder_get_dropped.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_recorder_flush.restype = c_int
+    libmetawear.mbl_mw_recorder_flush.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_recorder_close.restype = c_int
+    libmetawear.mbl_mw_recorder_close.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_shm_publisher_create.restype = c_void_p
+    libmetawear.mbl_mw_shm_publisher_create.argtypes = [c_char_p, c_uint]
+
+    libmetawear.mbl_mw_shm_publisher_write.restype = None
+    libmetawear.mbl_mw_shm_publisher_write.argtypes = [c_void_p, POINTER(Data)]
+
+    libmetawear.mbl_mw_datasignal_publish.restype = None
+    libmetawear.mbl_mw_datasignal_publish.argtypes = [c_void_p, c_void_p]
+
+    libmetawear.mbl_mw_logger_publish.restype = None
+    libmetawear.mbl_mw_logger_publish.argtypes = [c_void_p, c_void_p]
+
+    libmetawear.mbl_mw_shm_publisher_close.restype = None
+    libmetawear.mbl_mw_shm_publisher_close.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_shm_reader_open.restype = c_void_p
+    libmetawear.mbl_mw_shm_reader_open.argtypes = [c_char_p]
+
+    libmetawear.mbl_mw_shm_reader_next.restype = c_int
+    libmetawear.mbl_mw_shm_reader_next.argtypes = [c_void_p, POINTER(Data)]
+
+    libmetawear.mbl_mw_shm_reader_get_dropped.restype = c_ulonglong
+    libmetawear.mbl_mw_shm_reader_get_dropped.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_shm_reader_close.restype = None
+    libmetawear.mbl_mw_shm_reader_close.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_metawearboard_set_config_write_mode.restype = None
+    libmetawear.mbl_mw_metawearboard_set_config_write_mode.argtypes = [c_void_p, c_int]
+
+    libmetawear.mbl_mw_event_program.restype = None
+    libmetawear.mbl_mw_event_program.argtypes = [c_void_p, POINTER(EventBinding), c_uint, c_void_p, FnVoid_VoidP_VoidP_EventBindingResultP_UInt_Int]
+
+    libmetawear.mbl_mw_macro_builder_create.restype = c_void_p
+    libmetawear.mbl_mw_macro_builder_create.argtypes = [c_void_p, c_ubyte]
+
+    libmetawear.mbl_mw_macro_builder_record.restype = None
+    libmetawear.mbl_mw_macro_builder_record.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_macro_builder_end_record.restype = None
+    libmetawear.mbl_mw_macro_builder_end_record.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_macro_builder_add_command.restype = None
+    libmetawear.mbl_mw_macro_builder_add_command.argtypes = [c_void_p, POINTER(c_ubyte), c_ubyte]
+
+    libmetawear.mbl_mw_macro_builder_get_n_commands.restype = c_uint
+    libmetawear.mbl_mw_macro_builder_get_n_commands.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_macro_builder_get_size.restype = c_uint
+    libmetawear.mbl_mw_macro_builder_get_size.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_macro_builder_upload.restype = None
+    libmetawear.mbl_mw_macro_builder_upload.argtypes = [c_void_p, c_void_p, FnVoid_VoidP_VoidP_MacroUploadResultP_Int]
+
+    libmetawear.mbl_mw_macro_builder_free.restype = None
+    libmetawear.mbl_mw_macro_builder_free.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_metawearboard_tear_down_with_summary.restype = None
+    libmetawear.mbl_mw_metawearboard_tear_down_with_summary.argtypes = [c_void_p, POINTER(TearDownSummary)]
+
+    libmetawear.mbl_mw_dataprocessor_graph_create.restype = c_void_p
+    libmetawear.mbl_mw_dataprocessor_graph_create.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_dataprocessor_graph_record.restype = None
+    libmetawear.mbl_mw_dataprocessor_graph_record.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_dataprocessor_graph_end_record.restype = None
+    libmetawear.mbl_mw_dataprocessor_graph_end_record.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_dataprocessor_graph_get_n_nodes.restype = c_uint
+    libmetawear.mbl_mw_dataprocessor_graph_get_n_nodes.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_dataprocessor_graph_get_node.restype = c_void_p
+    libmetawear.mbl_mw_dataprocessor_graph_get_node.argtypes = [c_void_p, c_uint]
+
+    libmetawear.mbl_mw_dataprocessor_graph_submit.restype = c_int
+    libmetawear.mbl_mw_dataprocessor_graph_submit.argtypes = [c_void_p, c_void_p, FnVoid_VoidP_VoidP_VoidPP_UInt_Int]
+
+    libmetawear.mbl_mw_dataprocessor_graph_free.restype = None
+    libmetawear.mbl_mw_dataprocessor_graph_free.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_host_processor_lowpass_create.restype = c_void_p
+    libmetawear.mbl_mw_host_processor_lowpass_create.argtypes = [c_void_p, c_ubyte]
+
+    libmetawear.mbl_mw_host_processor_highpass_create.restype = c_void_p
+    libmetawear.mbl_mw_host_processor_highpass_create.argtypes = [c_void_p, c_ubyte]
+
+    libmetawear.mbl_mw_host_processor_rms_create.restype = c_void_p
+    libmetawear.mbl_mw_host_processor_rms_create.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_host_processor_rss_create.restype = c_void_p
+    libmetawear.mbl_mw_host_processor_rss_create.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_host_processor_threshold_create.restype = c_void_p
+    libmetawear.mbl_mw_host_processor_threshold_create.argtypes = [c_void_p, c_int, c_float, c_float]
+
+    libmetawear.mbl_mw_host_processor_delta_create.restype = c_void_p
+    libmetawear.mbl_mw_host_processor_delta_create.argtypes = [c_void_p, c_int, c_float]
+
+    libmetawear.mbl_mw_host_processor_comparator_create.restype = c_void_p
+    libmetawear.mbl_mw_host_processor_comparator_create.argtypes = [c_void_p, c_int, c_float]
+
+    libmetawear.mbl_mw_host_processor_math_create.restype = c_void_p
+    libmetawear.mbl_mw_host_processor_math_create.argtypes = [c_void_p, c_int, c_float]
+
+    libmetawear.mbl_mw_host_processor_pulse_create.restype = c_void_p
+    libmetawear.mbl_mw_host_processor_pulse_create.argtypes = [c_void_p, c_int, c_float, c_ushort]
+
+    libmetawear.mbl_mw_host_processor_time_create.restype = c_void_p
+    libmetawear.mbl_mw_host_processor_time_create.argtypes = [c_void_p, c_int, c_uint]
+
+    libmetawear.mbl_mw_host_processor_sample_create.restype = c_void_p
+    libmetawear.mbl_mw_host_processor_sample_create.argtypes = [c_void_p, c_ubyte]
+
+    libmetawear.mbl_mw_host_processor_passthrough_create.restype = c_void_p
+    libmetawear.mbl_mw_host_processor_passthrough_create.argtypes = [c_void_p, c_int, c_ushort]
+
+    libmetawear.mbl_mw_host_processor_counter_create.restype = c_void_p
+    libmetawear.mbl_mw_host_processor_counter_create.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_host_processor_accumulator_create.restype = c_void_p
+    libmetawear.mbl_mw_host_processor_accumulator_create.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_host_processor_subscribe.restype = None
+    libmetawear.mbl_mw_host_processor_subscribe.argtypes = [c_void_p, c_void_p, FnVoid_VoidP_DataP]
+
+    libmetawear.mbl_mw_host_processor_unsubscribe.restype = None
+    libmetawear.mbl_mw_host_processor_unsubscribe.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_host_processor_process.restype = None
+    libmetawear.mbl_mw_host_processor_process.argtypes = [c_void_p, POINTER(Data)]
+
+    libmetawear.mbl_mw_host_processor_process_batch.restype = None
+    libmetawear.mbl_mw_host_processor_process_batch.argtypes = [c_void_p, POINTER(Data), c_uint]
+
+    libmetawear.mbl_mw_host_processor_reset.restype = None
+    libmetawear.mbl_mw_host_processor_reset.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_host_processor_free.restype = None
+    libmetawear.mbl_mw_host_processor_free.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_dataprocessor_set_sharing.restype = None
+    libmetawear.mbl_mw_dataprocessor_set_sharing.argtypes = [c_void_p, c_ubyte]
+
+    libmetawear.mbl_mw_dataprocessor_get_n_references.restype = c_uint
+    libmetawear.mbl_mw_dataprocessor_get_n_references.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_dataprocessor_subscribe_shared.restype = None
+    libmetawear.mbl_mw_dataprocessor_subscribe_shared.argtypes = [c_void_p, c_void_p, FnVoid_VoidP_DataP]
+
+    libmetawear.mbl_mw_dataprocessor_unsubscribe_shared.restype = None
+    libmetawear.mbl_mw_dataprocessor_unsubscribe_shared.argtypes = [c_void_p, c_void_p]
+
+    libmetawear.mbl_mw_dataprocessor_remove_shared.restype = None
+    libmetawear.mbl_mw_dataprocessor_remove_shared.argtypes = [c_void_p, c_void_p]
+
+    libmetawear.mbl_mw_host_fuser_create.restype = c_void_p
+    libmetawear.mbl_mw_host_fuser_create.argtypes = [c_uint, c_uint, c_uint, c_void_p, FnVoid_VoidP_DataP_UInt]
+
+    libmetawear.mbl_mw_host_fuser_get_stream.restype = c_void_p
+    libmetawear.mbl_mw_host_fuser_get_stream.argtypes = [c_void_p, c_uint]
+
+    libmetawear.mbl_mw_host_fuser_process.restype = None
+    libmetawear.mbl_mw_host_fuser_process.argtypes = [c_void_p, POINTER(Data)]
+
+    libmetawear.mbl_mw_datasignal_fuse.restype = None
+    libmetawear.mbl_mw_datasignal_fuse.argtypes = [c_void_p, c_void_p, c_uint]
+
+    libmetawear.mbl_mw_host_fuser_get_n_dropped.restype = c_ulonglong
+    libmetawear.mbl_mw_host_fuser_get_n_dropped.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_host_fuser_free.restype = None
+    libmetawear.mbl_mw_host_fuser_free.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_host_sensor_fusion_create.restype = c_void_p
+    libmetawear.mbl_mw_host_sensor_fusion_create.argtypes = [c_int, c_float, c_float]
+
+    libmetawear.mbl_mw_host_sensor_fusion_subscribe.restype = None
+    libmetawear.mbl_mw_host_sensor_fusion_subscribe.argtypes = [c_void_p, c_int, c_void_p, FnVoid_VoidP_DataP]
+
+    libmetawear.mbl_mw_host_sensor_fusion_unsubscribe.restype = None
+    libmetawear.mbl_mw_host_sensor_fusion_unsubscribe.argtypes = [c_void_p, c_int]
+
+    libmetawear.mbl_mw_host_sensor_fusion_process_acc.restype = None
+    libmetawear.mbl_mw_host_sensor_fusion_process_acc.argtypes = [c_void_p, POINTER(Data)]
+
+    libmetawear.mbl_mw_host_sensor_fusion_process_gyro.restype = None
+    libmetawear.mbl_mw_host_sensor_fusion_process_gyro.argtypes = [c_void_p, POINTER(Data)]
+
+    libmetawear.mbl_mw_host_sensor_fusion_process_mag.restype = None
+    libmetawear.mbl_mw_host_sensor_fusion_process_mag.argtypes = [c_void_p, POINTER(Data)]
+
+    libmetawear.mbl_mw_host_sensor_fusion_process_batch.restype = None
+    libmetawear.mbl_mw_host_sensor_fusion_process_batch.argtypes = [c_void_p, POINTER(CartesianFloat), POINTER(CartesianFloat), POINTER(CartesianFloat), POINTER(c_longlong), c_uint]
+
+    libmetawear.mbl_mw_host_sensor_fusion_reset.restype = None
+    libmetawear.mbl_mw_host_sensor_fusion_reset.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_host_sensor_fusion_free.restype = None
+    libmetawear.mbl_mw_host_sensor_fusion_free.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_host_sensor_fusion_pool_create.restype = c_void_p
+    libmetawear.mbl_mw_host_sensor_fusion_pool_create.argtypes = [c_uint]
+
+    libmetawear.mbl_mw_host_sensor_fusion_pool_submit.restype = None
+    libmetawear.mbl_mw_host_sensor_fusion_pool_submit.argtypes = [c_void_p, c_void_p, POINTER(CartesianFloat), POINTER(CartesianFloat), POINTER(CartesianFloat), POINTER(c_longlong), c_uint]
+
+    libmetawear.mbl_mw_host_sensor_fusion_pool_wait.restype = None
+    libmetawear.mbl_mw_host_sensor_fusion_pool_wait.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_host_sensor_fusion_pool_free.restype = None
+    libmetawear.mbl_mw_host_sensor_fusion_pool_free.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_dataprocessor_set_notification_budget.restype = None
+    libmetawear.mbl_mw_dataprocessor_set_notification_budget.argtypes = [c_void_p, c_float]
+
+    libmetawear.mbl_mw_datasignal_subscribe_packed.restype = c_int
+    libmetawear.mbl_mw_datasignal_subscribe_packed.argtypes = [c_void_p, c_float, c_ubyte, c_void_p, FnVoid_VoidP_DataP, FnVoid_VoidP_VoidP_VoidPP_UInt_Int]
+
+    libmetawear.mbl_mw_dfu_orchestrator_create.restype = c_void_p
+    libmetawear.mbl_mw_dfu_orchestrator_create.argtypes = [c_char_p, c_uint, POINTER(DfuOrchestratorDelegate)]
+
+    libmetawear.mbl_mw_dfu_orchestrator_add_board.restype = None
+    libmetawear.mbl_mw_dfu_orchestrator_add_board.argtypes = [c_void_p, c_void_p]
+
+    libmetawear.mbl_mw_dfu_orchestrator_start.restype = None
+    libmetawear.mbl_mw_dfu_orchestrator_start.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_dfu_orchestrator_free.restype = None
+    libmetawear.mbl_mw_dfu_orchestrator_free.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_metawearboard_handle_notifications.restype = c_uint
+    libmetawear.mbl_mw_metawearboard_handle_notifications.argtypes = [POINTER(Notification), c_uint]
+
+    libmetawear.mbl_mw_socket_connection_open.restype = c_void_p
+    libmetawear.mbl_mw_socket_connection_open.argtypes = [c_char_p, c_char_p]
+
+    libmetawear.mbl_mw_socket_connection_get_btle_connection.restype = POINTER(BtleConnection)
+    libmetawear.mbl_mw_socket_connection_get_btle_connection.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_socket_connection_get_write_gatt_chars.restype = FnVoid_VoidP_VoidP_GattCharWriteP_UInt
+    libmetawear.mbl_mw_socket_connection_get_write_gatt_chars.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_socket_connection_close.restype = None
+    libmetawear.mbl_mw_socket_connection_close.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_session_manager_create.restype = c_void_p
+    libmetawear.mbl_mw_session_manager_create.argtypes = [c_uint]
+
+    libmetawear.mbl_mw_session_manager_get_n_workers.restype = c_uint
+    libmetawear.mbl_mw_session_manager_get_n_workers.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_session_manager_add_board.restype = None
+    libmetawear.mbl_mw_session_manager_add_board.argtypes = [c_void_p, c_void_p]
+
+    libmetawear.mbl_mw_session_manager_remove_board.restype = None
+    libmetawear.mbl_mw_session_manager_remove_board.argtypes = [c_void_p, c_void_p]
+
+    libmetawear.mbl_mw_session_manager_post.restype = None
+    libmetawear.mbl_mw_session_manager_post.argtypes = [c_void_p, c_void_p, c_void_p, FnVoid_VoidP]
+
+    libmetawear.mbl_mw_session_manager_submit.restype = None
+    libmetawear.mbl_mw_session_manager_submit.argtypes = [c_void_p, c_void_p, FnVoid_VoidP]
+
+    libmetawear.mbl_mw_session_manager_handle_notifications.restype = None
+    libmetawear.mbl_mw_session_manager_handle_notifications.argtypes = [c_void_p, POINTER(Notification), c_uint]
+
+    libmetawear.mbl_mw_session_manager_free.restype = None
+    libmetawear.mbl_mw_session_manager_free.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_metawearboard_enable_serialization.restype = None
+    libmetawear.mbl_mw_metawearboard_enable_serialization.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_metawearboard_execute.restype = None
+    libmetawear.mbl_mw_metawearboard_execute.argtypes = [c_void_p, c_void_p, FnVoid_VoidP_VoidP]
+
+    libmetawear.mbl_mw_poll_scheduler_create.restype = c_void_p
+    libmetawear.mbl_mw_poll_scheduler_create.argtypes = [c_void_p, FnLong_VoidP]
+
+    libmetawear.mbl_mw_poll_scheduler_now.restype = c_longlong
+    libmetawear.mbl_mw_poll_scheduler_now.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_poll_scheduler_add_board.restype = None
+    libmetawear.mbl_mw_poll_scheduler_add_board.argtypes = [c_void_p, c_void_p]
+
+    libmetawear.mbl_mw_poll_scheduler_remove_board.restype = None
+    libmetawear.mbl_mw_poll_scheduler_remove_board.argtypes = [c_void_p, c_void_p]
+
+    libmetawear.mbl_mw_poll_scheduler_next_deadline.restype = c_longlong
+    libmetawear.mbl_mw_poll_scheduler_next_deadline.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_poll_scheduler_process_timeouts.restype = c_uint
+    libmetawear.mbl_mw_poll_scheduler_process_timeouts.argtypes = [c_void_p, c_longlong]
+
+    libmetawear.mbl_mw_poll_scheduler_free.restype = None
+    libmetawear.mbl_mw_poll_scheduler_free.argtypes = [c_void_p]
+
+    libmetawear.mbl_mw_metawearboard_set_adaptive_timeouts.restype = None
+    libmetawear.mbl_mw_metawearboard_set_adaptive_timeouts.argtypes = [c_void_p, c_ushort]
+
+    libmetawear.mbl_mw_metawearboard_get_time_for_response.restype = c_ushort
+    libmetawear.mbl_mw_metawearboard_get_time_for_response.argtypes = [c_void_p]
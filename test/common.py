@@ -1,7 +1,7 @@
 from ctypes import *
 from cbindings import *
 #from mbientlab.metawear.cbindings import *
-from threading import Timer, Event
+from threading import Timer, Event, Lock
 import copy
 import os
 import queue
@@ -19,6 +19,9 @@ class TestMetaWearBase(unittest.TestCase):
     METAWEAR_MOTION_RL_BOARD= 7
     METAWEAR_MOTION_S_BOARD= 8
 
+    # tests that keep several reads in flight set this so responses cannot race each other
+    serialize_responses= False
+
     @classmethod
     def setUpClass(cls):
         cls.libmetawear= CDLL(os.environ["METAWEAR_LIB_SO_NAME"])
@@ -301,6 +304,7 @@ class TestMetaWearBase(unittest.TestCase):
         self.command_history= []
         self.full_history= []
         self.pending_responses = queue.Queue()
+        self.response_lock = Lock()
 
         self.eventId= 0
         self.timerId= 0
@@ -528,8 +532,13 @@ class TestMetaWearBase(unittest.TestCase):
             if (not self.pending_responses.empty()):
                 self.notify_mw_char(self.pending_responses.get())
 
+        def send_serialized_response():
+            # deliver responses one at a time and in order, as a BLE stack would
+            with self.response_lock:
+                send_response()
+
         self.pending_responses.put(response)
-        Timer(0.020, send_response).start()
+        Timer(0.020, send_serialized_response if self.serialize_responses else send_response).start()
 
 def to_string_buffer(bytes):
     buffer= create_string_buffer(len(bytes))
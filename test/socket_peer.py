@@ -0,0 +1,176 @@
+"""
+Stand-in for the Bluetooth LE process mbl_mw_socket_connection_open connects to.  It answers as a MetaWear R board
+would, the same way common.TestMetaWearBase does in process, and prints "ready" once it is listening.
+
+usage: socket_peer.py <socket path> [--stream n] [--batch n] [--log path] [--stop-reading] [--disconnect]
+    --stream n      Send n switch notifications once the switch is subscribed to
+    --batch n       Notifications per notify frame when streaming, default 32
+    --log path      Write the frames received from the SDK to path as json when the SDK disconnects
+    --stop-reading  Stop reading once the led is played, then send a switch notification so the SDK's sends fail from 
+                    then on
+    --disconnect    Send a disconnected frame once the led is played, then close the socket
+"""
+import argparse
+import json
+import os
+import socket
+import struct
+import sys
+import time
+
+OPEN = 0x01
+DECLARE = 0x02
+WRITE = 0x03
+READ = 0x04
+ENABLE_NOTIFY = 0x05
+NOTIFY = 0x81
+READ_RESPONSE = 0x82
+NOTIFY_ENABLED = 0x83
+DISCONNECTED = 0x84
+
+NOTIFY_CHAR_UUID_HIGH = 0x326a900685cb9195
+
+DEV_INFO = {
+    0x00002a2400001000: b'0',
+    0x00002a2600001000: b'1.1.3',
+    0x00002a2700001000: b'0.1',
+    0x00002a2900001000: b'deadbeef',
+    0x00002a2500001000: b'cafebabe'
+}
+
+SERVICES = {
+    0x01: b'\x01\x80\x00\x00',
+    0x02: b'\x02\x80\x00\x00',
+    0x03: b'\x03\x80\x00\x01',
+    0x04: b'\x04\x80\x01\x00\x00\x01',
+    0x05: b'\x05\x80\x00\x00',
+    0x06: b'\x06\x80\x00\x00',
+    0x07: b'\x07\x80\x00\x00',
+    0x08: b'\x08\x80\x00\x00',
+    0x09: b'\x09\x80\x00\x00\x1C',
+    0x0a: b'\x0A\x80\x00\x00\x1C',
+    0x0b: b'\x0B\x80\x00\x02\x08\x80\x31\x00\x00',
+    0x0c: b'\x0C\x80\x00\x00\x08',
+    0x0d: b'\x0D\x80\x00\x00',
+    0x0f: b'\x0F\x80\x00\x00',
+    0x10: b'\x10\x80',
+    0x11: b'\x11\x80\x00\x00',
+    0x12: b'\x12\x80',
+    0x13: b'\x13\x80',
+    0x14: b'\x14\x80',
+    0x15: b'\x15\x80',
+    0x16: b'\x16\x80',
+    0x17: b'\x17\x80',
+    0x18: b'\x18\x80',
+    0x19: b'\x19\x80',
+    0xfe: b'\xFE\x80\x00\x02'
+}
+
+def frame(type, payload):
+    return struct.pack('=BBH', type, 0, len(payload)) + payload
+
+def notify_frame(char_id, values):
+    return frame(NOTIFY, b''.join(struct.pack('=BB', char_id, len(value)) + value for value in values))
+
+class Peer:
+    def __init__(self, conn, args):
+        self.conn = conn
+        self.args = args
+        self.characteristics = {}
+        self.notify_id = None
+        self.frames = []
+
+    def respond(self, command):
+        if len(command) >= 2 and command[1] == 0x80:
+            return [SERVICES[command[0]]]
+        if command[:2] == b'\x0b\x84':
+            return [b'\x0b\x84\x15\x04\x00\x00\x05']
+        if command[:2] == b'\x0b\x85':
+            return [b'\x0b\x85\x9e\x01\x00\x00']
+        if command[:2] == b'\x04\x81':
+            # 32 C in 1/8 degree units
+            return [command + b'\x00\x01']
+        return []
+
+    def stream(self):
+        for start in range(0, self.args.stream, self.args.batch):
+            values = [bytes([0x01, 0x01, i & 0x1]) for i in range(start, min(start + self.args.batch, self.args.stream))]
+            self.conn.sendall(notify_frame(self.notify_id, values))
+
+    def handle(self, type, payload):
+        if type == DECLARE:
+            (uuid_high,) = struct.unpack_from('=Q', payload, 17)
+            self.characteristics[payload[0]] = uuid_high
+            if uuid_high == NOTIFY_CHAR_UUID_HIGH:
+                self.notify_id = payload[0]
+        elif type == READ:
+            self.conn.sendall(frame(READ_RESPONSE, bytes([payload[0]]) + DEV_INFO.get(self.characteristics[payload[0]], b'')))
+        elif type == ENABLE_NOTIFY:
+            self.conn.sendall(frame(NOTIFY_ENABLED, struct.pack('=Bi', payload[0], 0)))
+        elif type == WRITE:
+            entries = []
+            i = 0
+            while i < len(payload):
+                (char_id, write_type, length) = struct.unpack_from('=BBB', payload, i)
+                entries.append(payload[i + 3:i + 3 + length])
+                i += 3 + length
+            self.frames.append({'type': type, 'entries': [list(entry) for entry in entries]})
+
+            # answer every write in the frame with one notify frame
+            responses = [response for entry in entries for response in self.respond(entry)]
+            if responses:
+                self.conn.sendall(notify_frame(self.notify_id, responses))
+            if self.args.stream and b'\x01\x01\x01' in entries:
+                self.stream()
+            if self.args.stop_reading and b'\x02\x01\x01' in entries:
+                self.conn.shutdown(socket.SHUT_RD)
+                self.conn.sendall(notify_frame(self.notify_id, [b'\x01\x01\x01']))
+                # keep the stream open so the SDK sees its sends fail rather than the peer leaving
+                time.sleep(2)
+            if self.args.disconnect and b'\x02\x01\x01' in entries:
+                self.conn.sendall(frame(DISCONNECTED, struct.pack('=i', 0)))
+                self.conn.shutdown(socket.SHUT_RDWR)
+
+    def run(self):
+        buffer = b''
+        while True:
+            received = self.conn.recv(65536)
+            if not received:
+                break
+            buffer += received
+            while len(buffer) >= 4:
+                (type, reserved, length) = struct.unpack_from('=BBH', buffer)
+                if len(buffer) < 4 + length:
+                    break
+                self.handle(type, buffer[4:4 + length])
+                buffer = buffer[4 + length:]
+
+        if self.args.log:
+            with open(self.args.log, 'w') as f:
+                json.dump(self.frames, f)
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('path')
+    parser.add_argument('--stream', type= int, default= 0)
+    parser.add_argument('--batch', type= int, default= 32)
+    parser.add_argument('--log')
+    parser.add_argument('--stop-reading', action= 'store_true')
+    parser.add_argument('--disconnect', action= 'store_true')
+    args = parser.parse_args()
+
+    if os.path.exists(args.path):
+        os.remove(args.path)
+    server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    server.bind(args.path)
+    server.listen(1)
+    print('ready', flush= True)
+
+    (conn, address) = server.accept()
+    Peer(conn, args).run()
+    conn.close()
+    server.close()
+    os.remove(args.path)
+
+if __name__ == '__main__':
+    main()
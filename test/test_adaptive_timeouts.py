@@ -0,0 +1,123 @@
+from common import TestMetaWearBase
+from cbindings import *
+from threading import Event, Timer
+
+class TestAdaptiveTimeouts(TestMetaWearBase):
+    def setUp(self):
+        super().setUp()
+
+        # None to never answer timer creates, otherwise the response delay in seconds
+        self.response_delay= 0
+        self.created= []
+        self.created_event= Event()
+        self.timer_fn= FnVoid_VoidP_VoidP(self.timer_created)
+        self.libmetawear.mbl_mw_metawearboard_set_time_for_response(self.board, 1000)
+
+    def commandLogger(self, context, board, writeType, characteristic, command, length):
+        if length >= 2 and command[0] == 0x0c and command[1] == 0x02 and self.response_delay != 0:
+            if self.response_delay is not None:
+                response= create_string_buffer(bytes([0x0c, 0x02, len(self.created)]), 3)
+                Timer(self.response_delay, lambda: self.notify_mw_char(response)).start()
+            return
+        super().commandLogger(context, board, writeType, characteristic, command, length)
+
+    def timer_created(self, context, timer):
+        self.created.append(timer)
+        self.created_event.set()
+
+    def create_timer(self):
+        self.created_event.clear()
+        self.libmetawear.mbl_mw_timer_create(self.board, 1000, 0, 0, None, self.timer_fn)
+
+    def time_for_response(self):
+        return self.libmetawear.mbl_mw_metawearboard_get_time_for_response(self.board)
+
+    def test_fixed_by_default(self):
+        self.create_timer()
+
+        self.assertEqual(self.time_for_response(), 1000)
+
+    def test_unmeasured(self):
+        self.libmetawear.mbl_mw_metawearboard_set_adaptive_timeouts(self.board, 20)
+
+        self.assertEqual(self.time_for_response(), 1000)
+
+    def test_fast_link(self):
+        self.libmetawear.mbl_mw_metawearboard_set_adaptive_timeouts(self.board, 20)
+        self.create_timer()
+        self.assertTrue(self.created_event.wait(5))
+
+        # the mock answers within a few tens of milliseconds
+        self.assertGreaterEqual(self.time_for_response(), 20)
+        self.assertLess(self.time_for_response(), 500)
+
+    def test_slow_link(self):
+        self.libmetawear.mbl_mw_metawearboard_set_adaptive_timeouts(self.board, 20)
+        self.response_delay= 0.1
+        for i in range(5):
+            self.create_timer()
+            self.assertTrue(self.created_event.wait(5))
+
+        self.assertNotIn(None, self.created)
+        # the estimate includes the variance, which jitter in the mock's timers inflates on a busy machine
+        self.assertGreater(self.time_for_response(), 100)
+        self.assertLess(self.time_for_response(), 1000)
+
+    def test_back_off(self):
+        now= [0]
+        clock_fn= FnLong_VoidP(lambda context: now[0])
+        scheduler= self.libmetawear.mbl_mw_poll_scheduler_create(None, clock_fn)
+        self.libmetawear.mbl_mw_poll_scheduler_add_board(scheduler, self.board)
+        self.libmetawear.mbl_mw_metawearboard_set_time_for_response(self.board, 100)
+        self.libmetawear.mbl_mw_metawearboard_set_adaptive_timeouts(self.board, 20)
+
+        self.response_delay= None
+        self.create_timer()
+        self.assertEqual(self.libmetawear.mbl_mw_poll_scheduler_next_deadline(scheduler), 100)
+        now[0]= 100
+        self.libmetawear.mbl_mw_poll_scheduler_process_timeouts(scheduler, now[0])
+        self.assertEqual(self.created, [None])
+        self.assertEqual(self.time_for_response(), 200)
+
+        # a measured response ends the back off
+        self.create_timer()
+        self.assertEqual(self.libmetawear.mbl_mw_poll_scheduler_next_deadline(scheduler), 300)
+        self.notify_mw_char(create_string_buffer(b'\x0c\x02\x00', 3))
+        self.assertEqual(self.time_for_response(), 20)
+
+        self.libmetawear.mbl_mw_poll_scheduler_remove_board(scheduler, self.board)
+        self.libmetawear.mbl_mw_poll_scheduler_free(scheduler)
+
+    def test_overlapping_not_measured(self):
+        self.libmetawear.mbl_mw_metawearboard_set_adaptive_timeouts(self.board, 20)
+        created= Event()
+        created_fn= FnVoid_VoidP_VoidP_VoidPP_UInt_Int(lambda context, board, processors, size, status: created.set())
+        no_callback= FnVoid_VoidP_VoidP()
+        switch_signal= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.board)
+
+        # both counters are sent at once, neither response only waited on its own command
+        graph= self.libmetawear.mbl_mw_dataprocessor_graph_create(self.board)
+        self.libmetawear.mbl_mw_dataprocessor_graph_record(graph)
+        self.libmetawear.mbl_mw_dataprocessor_counter_create(switch_signal, None, no_callback)
+        self.libmetawear.mbl_mw_dataprocessor_counter_create(switch_signal, None, no_callback)
+        self.libmetawear.mbl_mw_dataprocessor_graph_end_record(graph)
+        self.libmetawear.mbl_mw_dataprocessor_graph_submit(graph, None, created_fn)
+        self.assertTrue(created.wait(5))
+
+        self.assertEqual(self.time_for_response(), 1000)
+
+    def test_disable(self):
+        self.libmetawear.mbl_mw_metawearboard_set_adaptive_timeouts(self.board, 20)
+        self.create_timer()
+        self.assertTrue(self.created_event.wait(5))
+        self.libmetawear.mbl_mw_metawearboard_set_adaptive_timeouts(self.board, 0)
+
+        self.assertEqual(self.time_for_response(), 1000)
+
+    def test_indefinite(self):
+        self.libmetawear.mbl_mw_metawearboard_set_adaptive_timeouts(self.board, 20)
+        self.create_timer()
+        self.assertTrue(self.created_event.wait(5))
+        self.libmetawear.mbl_mw_metawearboard_set_time_for_response(self.board, 0)
+
+        self.assertEqual(self.time_for_response(), 0)
@@ -4,6 +4,8 @@ from cbindings import *
 from threading import Event
 
 class AnonymousSignalBase(TestMetaWearBase):
+    serialize_responses= True
+
     def __init__(self, *args, **kwargs):
         super().__init__(*args, **kwargs)
 
@@ -26,6 +28,10 @@ class AnonymousSignalBase(TestMetaWearBase):
         if (prev != curr):
             if (command[0] == 0x03 and command[1] == 0x83):
                 response = to_string_buffer([0x03, 0x83, 40, self.acc_range])
+            elif ((command[0] == 0x03 or command[0] == 0x13) and command[1] == 0x82):
+                response = to_string_buffer([command[0], 0x82, 0x00, 0x00])
+            elif (command[0] == 0x14 and command[1] == 0x82):
+                response = to_string_buffer([0x14, 0x82, 0x18, 0x03])
             elif (command[0] == 0x13 and command[1] == 0x83):
                 response = to_string_buffer([0x13, 0x83, 40, self.gyr_range])
             elif(command[0] == 0x19 and command[1] == 0x82):
@@ -285,6 +291,37 @@ class TestMultipleLoggers(AnonymousSignalBase):
         print("TestMultipleLoggers \n")
         self.assertEqual(self.result['length'], 2)
 
+    def test_pipelined_queries(self):
+        # the first 4 logger reads go out before any of them are answered
+        expected_cmds= [
+            [0x0b, 0x82, 0x00],
+            [0x0b, 0x82, 0x01],
+            [0x0b, 0x82, 0x02],
+            [0x0b, 0x82, 0x03]
+        ]
+
+        first = self.full_history.index([0x0b, 0x82, 0x00])
+        print("TestMultipleLoggers \n")
+        self.assertEqual(self.full_history[first:first + 4], expected_cmds)
+
+class TestConcurrentResponses(AnonymousSignalBase):
+    # responses to the pipelined reads are delivered from several threads at once
+    serialize_responses= False
+
+    def commandLogger(self, context, board, writeType, characteristic, command, length):
+        prev = len(self.full_history)
+        super().commandLogger(context, board, writeType, characteristic, command, length)
+        curr = len(self.full_history)
+
+        if (prev != curr and command[0] == 0xb and command[1] == 0x82):
+            self.schedule_response(to_string_buffer([0x0b, 0x82]))
+
+    def test_repeated_sync(self):
+        results = [self.sync_loggers() for i in range(20)]
+
+        print("TestConcurrentResponses \n")
+        self.assertEqual([it['length'] for it in results], [0] * 20)
+
 class TestTemperature(AnonymousSignalBase):
     def sensorDataHandler(self, context, data):
         self.actual.append(cast(data.contents.value, POINTER(c_float)).contents.value)
@@ -354,6 +391,10 @@ class TestTimeout(AnonymousSignalBase):
                 response = to_string_buffer([0x03, 0x83, 40, 8])
             elif (command[0] == 0x13 and command[1] == 0x83):
                 response = to_string_buffer([0x13, 0x83, 40, 3])
+            elif ((command[0] == 0x03 or command[0] == 0x13) and command[1] == 0x82):
+                response = to_string_buffer([command[0], 0x82, 0x00, 0x00])
+            elif (command[0] == 0x14 and command[1] == 0x82):
+                response = to_string_buffer([0x14, 0x82, 0x18, 0x03])
             elif(command[0] == 0x19 and command[1] == 0x82):
                 response = to_string_buffer([0x19, 0x82, 0x1, 0xf])
             elif (self.sync_logger and command[0] == 0xb and command[1] == 0x82):
@@ -1364,3 +1364,337 @@ class TestFuserAccounter(TestMetaWearBase):
 
         print("TestFuserAccounter \n")
         self.assertEqual(self.command_history, expected)
+
+class TestProcessorGraph(TestMetaWearBase):
+    serialize_responses= True
+
+    def setUp(self):
+        self.boardType= TestMetaWearBase.METAWEAR_RPRO_BOARD
+        super().setUp()
+
+        self.created= threading.Event()
+        self.created_fn= FnVoid_VoidP_VoidP_VoidPP_UInt_Int(self.graph_created)
+        self.graph= self.libmetawear.mbl_mw_dataprocessor_graph_create(self.board)
+        # processors are retrieved from the graph, a null callback is enough
+        self.no_callback= FnVoid_VoidP_VoidP()
+
+    def graph_created(self, context, board, processors, size, status):
+        self.processors= [processors[i] for i in range(size)]
+        self.status= status
+        self.created.set()
+
+    def node(self, index):
+        return self.libmetawear.mbl_mw_dataprocessor_graph_get_node(self.graph, index)
+
+    def test_freefall(self):
+        accel_signal= self.libmetawear.mbl_mw_acc_get_acceleration_data_signal(self.board)
+
+        self.libmetawear.mbl_mw_dataprocessor_graph_record(self.graph)
+        self.libmetawear.mbl_mw_dataprocessor_rss_create(accel_signal, None, self.no_callback)
+        self.libmetawear.mbl_mw_dataprocessor_average_create(self.node(0), 4, None, self.no_callback)
+        self.libmetawear.mbl_mw_dataprocessor_threshold_create(self.node(1), ThresholdMode.BINARY, 0.5, 0.0, None, self.no_callback)
+        self.libmetawear.mbl_mw_dataprocessor_comparator_create(self.node(2), ComparatorOperation.EQ, -1.0, None, self.no_callback)
+        self.libmetawear.mbl_mw_dataprocessor_comparator_create(self.node(2), ComparatorOperation.EQ, 1.0, None, self.no_callback)
+        self.libmetawear.mbl_mw_dataprocessor_graph_end_record(self.graph)
+
+        self.assertEqual(self.command_history, [])
+        self.assertEqual(self.libmetawear.mbl_mw_dataprocessor_graph_get_n_nodes(self.graph), 5)
+
+        self.libmetawear.mbl_mw_dataprocessor_graph_submit(self.graph, None, self.created_fn)
+        self.created.wait()
+
+        expected= [
+            [0x09, 0x02, 0x03, 0x04, 0xff, 0xa0, 0x07, 0xa5, 0x01],
+            [0x09, 0x02, 0x09, 0x03, 0x00, 0x20, 0x03, 0x05, 0x04],
+            [0x09, 0x02, 0x09, 0x03, 0x01, 0x20, 0x0d, 0x09, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00],
+            [0x09, 0x02, 0x09, 0x03, 0x02, 0x00, 0x06, 0x01, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff],
+            [0x09, 0x02, 0x09, 0x03, 0x02, 0x00, 0x06, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00]
+        ]
+        print("TestProcessorGraph \n")
+        self.assertEqual(self.command_history, expected)
+        self.assertEqual(self.status, Const.STATUS_OK)
+        self.assertEqual([self.libmetawear.mbl_mw_dataprocessor_get_id(p) for p in self.processors], [0, 1, 2, 3, 4])
+        self.assertEqual(self.libmetawear.mbl_mw_dataprocessor_lookup_id(self.board, 4), self.processors[4])
+
+        self.command_history= []
+        self.libmetawear.mbl_mw_dataprocessor_remove(self.processors[0])
+        self.assertEqual(self.command_history, [[0x09, 0x06, 0x03], [0x09, 0x06, 0x04], [0x09, 0x06, 0x02], [0x09, 0x06, 0x01], [0x09, 0x06, 0x00]])
+
+    def test_independent_branches(self):
+        accel_signal= self.libmetawear.mbl_mw_acc_get_acceleration_data_signal(self.board)
+        switch_signal= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.board)
+
+        self.libmetawear.mbl_mw_dataprocessor_graph_record(self.graph)
+        self.libmetawear.mbl_mw_dataprocessor_rss_create(accel_signal, None, self.no_callback)
+        self.libmetawear.mbl_mw_dataprocessor_counter_create(switch_signal, None, self.no_callback)
+        self.libmetawear.mbl_mw_dataprocessor_average_create(self.node(0), 4, None, self.no_callback)
+
+        # hold back the responses so only the first wave has been sent
+        with self.response_lock:
+            self.libmetawear.mbl_mw_dataprocessor_graph_submit(self.graph, None, self.created_fn)
+            in_flight= len(self.command_history)
+        self.created.wait()
+
+        print("TestProcessorGraph \n")
+        self.assertEqual(in_flight, 2)
+        self.assertEqual(self.command_history[2], [0x09, 0x02, 0x09, 0x03, 0x00, 0x20, 0x03, 0x05, 0x04])
+        self.assertEqual([self.libmetawear.mbl_mw_dataprocessor_get_id(p) for p in self.processors], [0, 1, 2])
+
+    def test_capacity(self):
+        switch_signal= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.board)
+
+        self.libmetawear.mbl_mw_dataprocessor_graph_record(self.graph)
+        for i in range(29):
+            self.libmetawear.mbl_mw_dataprocessor_counter_create(switch_signal, None, self.no_callback)
+
+        status= self.libmetawear.mbl_mw_dataprocessor_graph_submit(self.graph, None, self.created_fn)
+        self.libmetawear.mbl_mw_dataprocessor_graph_free(self.graph)
+
+        print("TestProcessorGraph \n")
+        self.assertEqual(status, Const.STATUS_ERROR_CAPACITY_EXCEEDED)
+        self.assertEqual(self.command_history, [])
+
+    def test_timeout(self):
+        self.schedule_response= lambda response: None
+        accel_signal= self.libmetawear.mbl_mw_acc_get_acceleration_data_signal(self.board)
+
+        self.libmetawear.mbl_mw_dataprocessor_graph_record(self.graph)
+        self.libmetawear.mbl_mw_dataprocessor_rss_create(accel_signal, None, self.no_callback)
+        self.libmetawear.mbl_mw_dataprocessor_average_create(self.node(0), 4, None, self.no_callback)
+
+        self.libmetawear.mbl_mw_dataprocessor_graph_submit(self.graph, None, self.created_fn)
+        self.created.wait()
+
+        print("TestProcessorGraph \n")
+        self.assertEqual(self.status, Const.STATUS_ERROR_TIMEOUT)
+        self.assertEqual(self.processors, [])
+        self.assertEqual(self.command_history, [[0x09, 0x02, 0x03, 0x04, 0xff, 0xa0, 0x07, 0xa5, 0x01]])
+
+class TestProcessorSharing(TestMetaWearBase):
+    serialize_responses= True
+
+    def setUp(self):
+        self.boardType= TestMetaWearBase.METAWEAR_RPRO_BOARD
+        super().setUp()
+
+        self.libmetawear.mbl_mw_dataprocessor_set_sharing(self.board, 1)
+        self.accel_signal= self.libmetawear.mbl_mw_acc_get_acceleration_data_signal(self.board)
+        self.created= []
+        self.created_event= threading.Event()
+        self.created_fn= FnVoid_VoidP_VoidP(self.shared_created)
+
+    def shared_created(self, context, processor):
+        self.created.append(processor)
+        self.created_event.set()
+
+    def create_chain(self):
+        self.created_event.clear()
+        self.libmetawear.mbl_mw_dataprocessor_rss_create(self.accel_signal, None, self.created_fn)
+        self.created_event.wait()
+
+        self.created_event.clear()
+        self.libmetawear.mbl_mw_dataprocessor_lowpass_create(self.created[-1], 4, None, self.created_fn)
+        self.created_event.wait()
+        return self.created[-2:]
+
+    def test_identical_chains(self):
+        first= self.create_chain()
+        second= self.create_chain()
+
+        self.assertEqual(first, second)
+        self.assertEqual(self.command_history, [
+            [0x09, 0x02, 0x03, 0x04, 0xff, 0xa0, 0x07, 0xa5, 0x01],
+            [0x09, 0x02, 0x09, 0x03, 0x00, 0x20, 0x03, 0x05, 0x04]
+        ])
+        self.assertEqual([self.libmetawear.mbl_mw_dataprocessor_get_n_references(p) for p in first], [2, 2])
+
+    def test_different_config(self):
+        (rss, lowpass)= self.create_chain()
+
+        self.created_event.clear()
+        self.libmetawear.mbl_mw_dataprocessor_lowpass_create(rss, 8, None, self.created_fn)
+        self.created_event.wait()
+
+        self.assertNotEqual(self.created[-1], lowpass)
+        self.assertEqual(len(self.command_history), 3)
+        self.assertEqual(self.libmetawear.mbl_mw_dataprocessor_get_n_references(rss), 1)
+
+    def test_in_flight(self):
+        with self.response_lock:
+            self.libmetawear.mbl_mw_dataprocessor_rss_create(self.accel_signal, None, self.created_fn)
+            self.libmetawear.mbl_mw_dataprocessor_rss_create(self.accel_signal, None, self.created_fn)
+        while len(self.created) < 2:
+            self.created_event.wait()
+            self.created_event.clear()
+
+        self.assertEqual(self.created[0], self.created[1])
+        self.assertEqual(len(self.command_history), 1)
+        self.assertEqual(self.libmetawear.mbl_mw_dataprocessor_get_n_references(self.created[0]), 2)
+
+    def test_remove(self):
+        (rss, _)= self.create_chain()
+        self.create_chain()
+        self.command_history= []
+
+        self.libmetawear.mbl_mw_dataprocessor_remove(rss)
+        self.assertEqual(self.command_history, [])
+
+        self.libmetawear.mbl_mw_dataprocessor_remove(rss)
+        self.assertEqual(self.command_history, [[0x09, 0x06, 0x01], [0x09, 0x06, 0x00]])
+
+    def test_remove_own_consumers(self):
+        for context, width in [(1, 4), (2, 8)]:
+            self.created_event.clear()
+            self.libmetawear.mbl_mw_dataprocessor_rss_create(self.accel_signal, context, self.created_fn)
+            self.created_event.wait()
+
+            self.created_event.clear()
+            self.libmetawear.mbl_mw_dataprocessor_lowpass_create(self.created[-1], width, context, self.created_fn)
+            self.created_event.wait()
+
+        rss= self.created[0]
+        self.command_history= []
+        self.libmetawear.mbl_mw_dataprocessor_remove_shared(rss, 1)
+        self.assertEqual(self.command_history, [[0x09, 0x06, 0x01]])
+        self.assertEqual(self.libmetawear.mbl_mw_dataprocessor_get_n_references(rss), 1)
+
+        self.command_history= []
+        self.libmetawear.mbl_mw_dataprocessor_remove(rss)
+        self.assertEqual(self.command_history, [[0x09, 0x06, 0x02], [0x09, 0x06, 0x00]])
+
+    def test_remove_diverged(self):
+        lowpasses= []
+        for width in [4, 8]:
+            self.created_event.clear()
+            self.libmetawear.mbl_mw_dataprocessor_rss_create(self.accel_signal, None, self.created_fn)
+            self.created_event.wait()
+
+            self.created_event.clear()
+            self.libmetawear.mbl_mw_dataprocessor_lowpass_create(self.created[-1], width, None, self.created_fn)
+            self.created_event.wait()
+            lowpasses.append(self.created[-1])
+
+        rss= self.created[0]
+        self.command_history= []
+        self.libmetawear.mbl_mw_dataprocessor_remove(rss)
+        self.assertEqual(self.command_history, [])
+        self.assertEqual(self.libmetawear.mbl_mw_dataprocessor_get_n_references(rss), 1)
+        self.assertEqual([self.libmetawear.mbl_mw_dataprocessor_get_n_references(p) for p in lowpasses], [1, 1])
+
+        self.libmetawear.mbl_mw_dataprocessor_remove_shared(rss, None)
+        self.assertEqual(self.command_history, [[0x09, 0x06, 0x01], [0x09, 0x06, 0x02], [0x09, 0x06, 0x00]])
+
+    def test_disabled(self):
+        self.libmetawear.mbl_mw_dataprocessor_set_sharing(self.board, 0)
+        first= self.create_chain()
+        second= self.create_chain()
+
+        self.assertNotEqual(first, second)
+        self.assertEqual(len(self.command_history), 4)
+
+    def test_fan_out(self):
+        (_, lowpass)= self.create_chain()
+        received= {1: [], 2: []}
+        handler= FnVoid_VoidP_DataP(lambda context, data: received[context].append(cast(data.contents.value, POINTER(c_float)).contents.value))
+
+        self.command_history= []
+        self.libmetawear.mbl_mw_dataprocessor_subscribe_shared(lowpass, 1, handler)
+        self.libmetawear.mbl_mw_dataprocessor_subscribe_shared(lowpass, 2, handler)
+        self.assertEqual(self.command_history, [[0x09, 0x07, 0x01, 0x01], [0x09, 0x03, 0x01]])
+
+        self.notify_mw_char(to_string_buffer([0x09, 0x03, 0x01, 0x00, 0x08]))
+        self.libmetawear.mbl_mw_dataprocessor_unsubscribe_shared(lowpass, 1)
+        self.notify_mw_char(to_string_buffer([0x09, 0x03, 0x01, 0x00, 0x10]))
+        self.assertEqual(received, {1: [0.125], 2: [0.125, 0.25]})
+
+        self.command_history= []
+        self.libmetawear.mbl_mw_dataprocessor_unsubscribe_shared(lowpass, 2)
+        self.assertEqual(self.command_history, [[0x09, 0x07, 0x01, 0x00]])
+
+class TestPackedSubscription(TestMetaWearBase):
+    serialize_responses= True
+
+    def setUp(self):
+        self.boardType= TestMetaWearBase.METAWEAR_RPRO_BOARD
+        super().setUp()
+
+        self.samples= []
+        self.data_fn= FnVoid_VoidP_DataP(self.packed_data_received)
+        self.subscribed= threading.Event()
+        self.subscribed_fn= FnVoid_VoidP_VoidP_VoidPP_UInt_Int(self.chain_subscribed)
+
+    def packed_data_received(self, context, data):
+        self.sensorDataHandler(context, data)
+        self.samples.append((data.contents.epoch, self.data))
+
+    def chain_subscribed(self, context, board, processors, size, status):
+        self.processors= [processors[i] for i in range(size)]
+        self.status= status
+        self.subscribed.set()
+
+    def subscribe(self, signal, rate, timestamp):
+        self.command_history= []
+        self.assertEqual(self.libmetawear.mbl_mw_datasignal_subscribe_packed(signal, rate, timestamp, None, self.data_fn, self.subscribed_fn), Const.STATUS_OK)
+        self.subscribed.wait()
+        self.assertEqual(self.status, Const.STATUS_OK)
+
+    def test_within_budget(self):
+        signal= self.libmetawear.mbl_mw_acc_get_acceleration_data_signal(self.board)
+        self.subscribe(signal, 50.0, 0)
+
+        self.assertEqual(self.processors, [])
+        self.assertEqual(self.command_history, [[0x03, 0x04, 0x01]])
+
+    def test_raised_budget(self):
+        signal= self.libmetawear.mbl_mw_acc_get_acceleration_data_signal(self.board)
+        self.libmetawear.mbl_mw_dataprocessor_set_notification_budget(self.board, 500.0)
+        self.subscribe(signal, 400.0, 0)
+
+        self.assertEqual(self.processors, [])
+
+    def test_pack(self):
+        signal= self.libmetawear.mbl_mw_acc_get_acceleration_data_signal(self.board)
+        self.subscribe(signal, 400.0, 0)
+
+        self.assertEqual(len(self.processors), 1)
+        self.assertEqual(self.command_history, [
+            [0x09, 0x02, 0x03, 0x04, 0xff, 0xa0, 0x10, 0x05, 0x01],
+            [0x09, 0x07, 0x00, 0x01],
+            [0x09, 0x03, 0x01]
+        ])
+
+        self.notify_mw_char(to_string_buffer([0x09, 0x03, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08]))
+        values= [value for (_, value) in self.samples]
+        self.assertEqual(values, [CartesianFloat(x= 0.125, y= 0.0, z= 0.0), CartesianFloat(x= 0.0, y= 0.0, z= 0.125)])
+        # 400Hz samples are 2.5ms apart, the last sample gets the packet's epoch
+        self.assertEqual(self.samples[1][0] - self.samples[0][0], 2)
+
+    def test_timestamped(self):
+        signal= self.libmetawear.mbl_mw_multi_chnl_temp_get_temperature_data_signal(self.board, MetaWearRProChannel.ON_BOARD_THERMISTOR)
+        self.subscribe(signal, 200.0, 1)
+
+        self.assertEqual(len(self.processors), 2)
+        self.assertEqual(self.command_history[0:2], [
+            [0x09, 0x02, 0x04, 0xc1, 0x01, 0x20, 0x11, 0x31, 0x03],
+            [0x09, 0x02, 0x09, 0x03, 0x00, 0xa0, 0x10, 0x05, 0x01]
+        ])
+
+        responses = [
+            [0x0b, 0x84, 0xf5, 0x62, 0x02, 0x00, 0x00],
+            [0x09, 0x03, 0x01, 0x7b, 0x64, 0x02, 0x00, 0xec, 0x00, 0x92, 0x64, 0x02, 0x00, 0xeb, 0x00],
+            [0x09, 0x03, 0x01, 0xa8, 0x64, 0x02, 0x00, 0xef, 0x00, 0xbf, 0x64, 0x02, 0x00, 0xed, 0x00]
+        ]
+        for r in responses:
+            self.notify_mw_char(to_string_buffer(r))
+
+        self.assertEqual([value.value for (_, value) in self.samples], [29.5, 29.375, 29.875, 29.625])
+        epochs= [epoch for (epoch, _) in self.samples]
+        self.assertEqual([epochs[i + 1] - epochs[i] for i in range(3)], [34, 32, 34])
+
+    def test_timestamp_too_large(self):
+        # acc samples with timestamps do not fit 2 to a packet, the samples are packed without them
+        signal= self.libmetawear.mbl_mw_acc_get_acceleration_data_signal(self.board)
+        self.subscribe(signal, 400.0, 1)
+
+        self.assertEqual(len(self.processors), 1)
+        self.assertEqual(self.command_history[0], [0x09, 0x02, 0x03, 0x04, 0xff, 0xa0, 0x10, 0x05, 0x01])
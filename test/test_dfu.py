@@ -0,0 +1,336 @@
+from common import TestMetaWearBase, to_string_buffer
+from cbindings import *
+from threading import Event, Lock, Thread
+import os
+import queue
+import struct
+import tempfile
+import zipfile
+
+DFU_CONTROL_POINT_UUID= 0x000015311212EFDE
+DFU_PACKET_UUID= 0x000015321212EFDE
+
+class Bootloader:
+    """Legacy Nordic bootloader, responses are queued and delivered by the test's worker thread"""
+    def __init__(self, responses, receipt_offset= 0):
+        self.responses= responses
+        self.receipt_offset= receipt_offset
+        self.commands= []
+        self.image_packets= []
+        self.receipt_intervals= []
+        self.file_size= None
+        self.init_packet= None
+        self.receiving= False
+        self.receipt_target= 0
+        self.receipt_count= 0
+        self.reset= Event()
+
+    def write(self, board, uuid, value):
+        if uuid == DFU_CONTROL_POINT_UUID:
+            self.commands.append(list(value))
+            if value[0] == 0x08:
+                self.receipt_target= value[1] | (value[2] << 8)
+                self.receipt_count= 0
+                self.receipt_intervals.append(self.receipt_target)
+            elif value[0] == 0x02 and value[1] == 0x00:
+                self.init_packet= b''
+            elif value[0] == 0x02 and value[1] == 0x01:
+                self.responses.put((board, [0x10, 0x02, 0x01]))
+            elif value[0] == 0x03:
+                self.receiving= True
+            elif value[0] == 0x04:
+                self.responses.put((board, [0x10, 0x04, 0x01]))
+            elif value[0] == 0x06:
+                self.reset.set()
+        elif self.file_size is None:
+            # the zip flow sends the softdevice, bootloader, and application sizes
+            self.file_size= struct.unpack('<I', value[-4:])[0]
+            self.responses.put((board, [0x10, 0x01, 0x01]))
+        elif self.init_packet is not None and not self.receiving:
+            self.init_packet+= value
+        elif self.receiving:
+            self.image_packets.append(value)
+            received= sum(len(p) for p in self.image_packets)
+            self.receipt_count+= 1
+            if received == self.file_size:
+                self.responses.put((board, [0x10, 0x03, 0x01]))
+            elif self.receipt_count == self.receipt_target:
+                self.receipt_count= 0
+                self.responses.put((board, [0x11] + list(struct.pack('<I', received + self.receipt_offset))))
+
+class TestDfuBase(TestMetaWearBase):
+    def setUp(self):
+        super().setUp()
+
+        self.image= bytes([i & 0xff for i in range(7331)])
+        (fd, self.filename)= tempfile.mkstemp(suffix= '.bin')
+        with os.fdopen(fd, 'wb') as f:
+            f.write(self.image)
+
+        self.bootloaders= {}
+        self.bootloader_lock= Lock()
+        self.responses= queue.Queue()
+        self.worker= Thread(target= self.bootloader_worker)
+        self.worker.start()
+
+    def tearDown(self):
+        self.responses.put(None)
+        self.worker.join()
+        os.remove(self.filename)
+        super().tearDown()
+
+    def bootloader_worker(self):
+        # notifications are delivered from another thread, as the BLE stack would
+        while True:
+            response= self.responses.get()
+            if response is None:
+                return
+            buffer= to_string_buffer(response[1])
+            self.notify_handler(response[0], cast(buffer, POINTER(c_ubyte)), len(buffer.raw))
+
+    def commandLogger(self, context, board, writeType, characteristic, command, length):
+        uuid= characteristic.contents.uuid_high
+        if uuid == DFU_CONTROL_POINT_UUID or uuid == DFU_PACKET_UUID:
+            with self.bootloader_lock:
+                self.bootloaders[board].write(board, uuid, bytes(command[i] for i in range(length)))
+        else:
+            super().commandLogger(context, board, writeType, characteristic, command, length)
+
+class TestDfu(TestDfuBase):
+    def setUp(self):
+        super().setUp()
+
+        self.bootloader= Bootloader(self.responses)
+        self.bootloaders[self.board]= self.bootloader
+
+        self.errors= []
+        self.rates= []
+        self.finished= Event()
+        self.delegate= DfuDelegate(context= None, on_dfu_started= FnVoid_VoidP(lambda ctx: None), on_dfu_cancelled= FnVoid_VoidP(lambda ctx: None),
+                on_transfer_percentage= FnVoid_VoidP_Int(lambda ctx, p: None), on_successful_file_transferred= FnVoid_VoidP(self.dfu_finished),
+                on_error= FnVoid_VoidP_charP(self.dfu_error))
+        self.transfer_rate_fn= FnVoid_VoidP_Float(self.transfer_rate)
+        self.libmetawear.mbl_mw_metawearboard_set_dfu_transfer_rate_handler(self.board, self.transfer_rate_fn)
+
+    def dfu_finished(self, context):
+        self.finished.set()
+
+    def dfu_error(self, context, message):
+        self.errors.append(message)
+        self.finished.set()
+
+    def transfer_rate(self, context, rate):
+        self.rates.append(rate)
+
+    def perform_dfu(self):
+        self.libmetawear.mbl_mw_metawearboard_perform_dfu(self.board, byref(self.delegate), self.filename.encode('ascii'))
+        self.assertTrue(self.finished.wait(10))
+
+    def test_default_mtu(self):
+        self.perform_dfu()
+
+        self.assertEqual(self.errors, [])
+        self.assertEqual(b''.join(self.bootloader.image_packets), self.image)
+        self.assertEqual(max(len(p) for p in self.bootloader.image_packets), 20)
+        self.assertEqual(self.bootloader.commands[-1], [0x05])
+
+    def test_negotiated_mtu(self):
+        self.libmetawear.mbl_mw_metawearboard_set_mtu(self.board, 247)
+        self.perform_dfu()
+
+        packets= self.bootloader.image_packets
+        self.assertEqual(self.errors, [])
+        self.assertEqual(b''.join(packets), self.image)
+        self.assertEqual([len(p) for p in packets[:-1]], [244] * (len(packets) - 1))
+        self.assertEqual(len(packets[-1]), len(self.image) % 244)
+
+    def test_oversized_mtu(self):
+        self.libmetawear.mbl_mw_metawearboard_set_mtu(self.board, 517)
+        self.perform_dfu()
+
+        self.assertEqual(b''.join(self.bootloader.image_packets), self.image)
+        self.assertEqual(max(len(p) for p in self.bootloader.image_packets), 244)
+
+    def test_receipt_interval(self):
+        self.perform_dfu()
+
+        intervals= self.bootloader.receipt_intervals
+        self.assertEqual(self.errors, [])
+        self.assertEqual(intervals[0], 10)
+        self.assertTrue(all(1 <= n <= 100 for n in intervals))
+        self.assertGreater(len(intervals), 1)
+        self.assertGreater(len(self.rates), 0)
+        self.assertTrue(all(rate > 0 for rate in self.rates))
+
+    def test_receipt_mismatch(self):
+        self.bootloader.receipt_offset= -1
+        self.perform_dfu()
+
+        # the error is reported before the board is reset
+        self.assertTrue(self.bootloader.reset.wait(5))
+        self.assertEqual(len(self.errors), 1)
+        self.assertEqual(self.bootloader.commands[-1], [0x06])
+        self.assertLess(len(self.bootloader.image_packets), len(self.image) // 20 + 1)
+
+    def test_zip(self):
+        # large enough that the application is inflated over many reads
+        image= bytes([(i * 7919 >> 5) & 0xff for i in range(200000)])
+        init_packet= bytes(range(40))
+        (fd, filename)= tempfile.mkstemp(suffix= '.zip')
+        os.close(fd)
+        try:
+            with zipfile.ZipFile(filename, 'w', zipfile.ZIP_DEFLATED) as package:
+                package.writestr('manifest.json', '{"manifest": {"application": {"bin_file": "app.bin", "dat_file": "app.dat"}}}')
+                package.writestr('app.bin', image)
+                package.writestr('app.dat', init_packet)
+
+            self.libmetawear.mbl_mw_metawearboard_set_mtu(self.board, 247)
+            self.libmetawear.mbl_mw_metawearboard_perform_dfu(self.board, byref(self.delegate), filename.encode('ascii'))
+            self.assertTrue(self.finished.wait(10))
+        finally:
+            os.remove(filename)
+
+        self.assertEqual(self.errors, [])
+        self.assertEqual(self.bootloader.commands[0], [0x01, 0x04])
+        self.assertEqual(self.bootloader.file_size, len(image))
+        self.assertEqual(self.bootloader.init_packet, init_packet)
+        self.assertEqual(b''.join(self.bootloader.image_packets), image)
+
+    def test_zip_crc_mismatch(self):
+        image= bytes([(i * 7919 >> 5) & 0xff for i in range(5000)])
+        (fd, filename)= tempfile.mkstemp(suffix= '.zip')
+        os.close(fd)
+        try:
+            with zipfile.ZipFile(filename, 'w', zipfile.ZIP_STORED) as package:
+                package.writestr('manifest.json', '{"manifest": {"application": {"bin_file": "app.bin", "dat_file": "app.dat"}}}')
+                package.writestr('app.bin', image)
+                package.writestr('app.dat', bytes(range(40)))
+
+            # stored entries keep the image as is, flip a byte without touching the recorded crc
+            with open(filename, 'r+b') as f:
+                contents= f.read()
+                offset= contents.index(image) + 1000
+                f.seek(offset)
+                f.write(bytes([contents[offset] ^ 0xff]))
+
+            self.libmetawear.mbl_mw_metawearboard_perform_dfu(self.board, byref(self.delegate), filename.encode('ascii'))
+            self.assertTrue(self.finished.wait(10))
+        finally:
+            os.remove(filename)
+
+        self.assertTrue(self.bootloader.reset.wait(5))
+        self.assertEqual(self.errors, [b'firmware image failed the zip crc check'])
+        self.assertEqual(self.bootloader.commands[-1], [0x06])
+        self.assertLess(sum(len(p) for p in self.bootloader.image_packets), len(image))
+
+    def test_invalid_zip(self):
+        (fd, filename)= tempfile.mkstemp(suffix= '.zip')
+        with os.fdopen(fd, 'wb') as f:
+            f.write(b'not a zip file')
+        try:
+            self.libmetawear.mbl_mw_metawearboard_perform_dfu(self.board, byref(self.delegate), filename.encode('ascii'))
+        finally:
+            os.remove(filename)
+
+        self.assertEqual(len(self.errors), 1)
+        self.assertEqual(self.bootloader.commands, [])
+
+    def test_missing_file(self):
+        self.libmetawear.mbl_mw_metawearboard_perform_dfu(self.board, byref(self.delegate), b'/nonexistent/firmware.bin')
+
+        self.assertEqual(self.errors, [b'failed to open file'])
+        self.assertEqual(self.bootloader.commands, [])
+
+class TestDfuOrchestrator(TestDfuBase):
+    def setUp(self):
+        super().setUp()
+
+        self.boards= []
+        self.board_results= []
+        self.progress= []
+        self.summary= None
+        self.finished= Event()
+        self.orchestrator= None
+        self.delegate= DfuOrchestratorDelegate(context= None, on_board_finished= FnVoid_VoidP_VoidP_charP(self.board_finished),
+                on_progress= FnVoid_VoidP_Int(self.progressed), on_finished= FnVoid_VoidP_Int_Int(self.all_finished))
+
+        # active uploads are tracked from the start request until the board activates or resets
+        self.active= 0
+        self.max_active= 0
+
+    def tearDown(self):
+        if self.orchestrator is not None:
+            self.libmetawear.mbl_mw_dfu_orchestrator_free(self.orchestrator)
+        for board in self.boards:
+            self.libmetawear.mbl_mw_metawearboard_free(board)
+        super().tearDown()
+
+    def commandLogger(self, context, board, writeType, characteristic, command, length):
+        if characteristic.contents.uuid_high == DFU_CONTROL_POINT_UUID:
+            with self.bootloader_lock:
+                if command[0] == 0x01:
+                    self.active+= 1
+                    self.max_active= max(self.max_active, self.active)
+                elif command[0] == 0x05 or command[0] == 0x06:
+                    self.active-= 1
+        super().commandLogger(context, board, writeType, characteristic, command, length)
+
+    def board_finished(self, context, board, error):
+        self.board_results.append((board, error))
+
+    def progressed(self, context, percentage):
+        self.progress.append(percentage)
+
+    def all_finished(self, context, n_succeeded, n_failed):
+        self.summary= (n_succeeded, n_failed)
+        self.finished.set()
+
+    def add_boards(self, n, failing= []):
+        for i in range(n):
+            board= self.libmetawear.mbl_mw_metawearboard_create(byref(self.btle_connection))
+            self.bootloaders[board]= Bootloader(self.responses, -1 if i in failing else 0)
+            self.boards.append(board)
+            self.libmetawear.mbl_mw_dfu_orchestrator_add_board(self.orchestrator, board)
+
+    def test_all_boards_updated(self):
+        self.orchestrator= self.libmetawear.mbl_mw_dfu_orchestrator_create(self.filename.encode('ascii'), 3, byref(self.delegate))
+        self.add_boards(8)
+        self.libmetawear.mbl_mw_dfu_orchestrator_start(self.orchestrator)
+        self.assertTrue(self.finished.wait(20))
+
+        self.assertEqual(self.summary, (8, 0))
+        self.assertEqual(sorted(board for (board, error) in self.board_results), sorted(self.boards))
+        self.assertTrue(all(error is None for (board, error) in self.board_results))
+        for board in self.boards:
+            self.assertEqual(b''.join(self.bootloaders[board].image_packets), self.image)
+        self.assertLessEqual(self.max_active, 3)
+        self.assertGreater(self.max_active, 1)
+        self.assertEqual(self.progress[-1], 100)
+
+    def test_failures(self):
+        self.orchestrator= self.libmetawear.mbl_mw_dfu_orchestrator_create(self.filename.encode('ascii'), 2, byref(self.delegate))
+        self.add_boards(5, failing= [1, 3])
+        self.libmetawear.mbl_mw_dfu_orchestrator_start(self.orchestrator)
+        self.assertTrue(self.finished.wait(20))
+
+        self.assertEqual(self.summary, (3, 2))
+        failed= sorted(board for (board, error) in self.board_results if error is not None)
+        self.assertEqual(failed, sorted([self.boards[1], self.boards[3]]))
+
+    def test_unlimited(self):
+        self.orchestrator= self.libmetawear.mbl_mw_dfu_orchestrator_create(self.filename.encode('ascii'), 0, byref(self.delegate))
+        self.add_boards(4)
+        self.libmetawear.mbl_mw_dfu_orchestrator_start(self.orchestrator)
+        self.assertTrue(self.finished.wait(20))
+
+        self.assertEqual(self.summary, (4, 0))
+        self.assertEqual(self.max_active, 4)
+
+    def test_no_boards(self):
+        self.orchestrator= self.libmetawear.mbl_mw_dfu_orchestrator_create(self.filename.encode('ascii'), 2, byref(self.delegate))
+        self.libmetawear.mbl_mw_dfu_orchestrator_start(self.orchestrator)
+
+        self.assertEqual(self.summary, (0, 0))
+
+    def test_missing_file(self):
+        self.assertIsNone(self.libmetawear.mbl_mw_dfu_orchestrator_create(b'/nonexistent/firmware.zip', 2, byref(self.delegate)))
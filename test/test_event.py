@@ -77,6 +77,113 @@ class TestEvent(TestMetaWearBase):
         print("TestEvent \n")
         self.assertEqual(self.command_history, expected_cmds)
 
+class TestEventProgram(TestMetaWearBase):
+    serialize_responses= True
+
+    def setUp(self):
+        super().setUp()
+
+        self.programmed= threading.Event()
+        self.completed= []
+        self.programmed_fn= FnVoid_VoidP_VoidP_EventBindingResultP_UInt_Int(self.bindings_programmed)
+        self.temp_signal= self.libmetawear.mbl_mw_multi_chnl_temp_get_temperature_data_signal(self.board, 1)
+        self.read_temp_fn= FnVoid_VoidP_VoidP(lambda context, event: self.libmetawear.mbl_mw_datasignal_read(self.temp_signal))
+        self.read_temp_twice_fn= FnVoid_VoidP_VoidP(lambda context, event: [self.libmetawear.mbl_mw_datasignal_read(self.temp_signal) for i in range(2)])
+
+    def bindings_programmed(self, context, board, results, n_results, status):
+        self.completed.append(context)
+        self.program_status= status
+        self.program_results= [(results[i].event, [results[i].entry_ids[j] for j in range(results[i].n_entry_ids)]) for i in range(n_results)]
+        self.programmed.set()
+
+    def test_program(self):
+        switch= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.board)
+        temp= self.libmetawear.mbl_mw_multi_chnl_temp_get_temperature_data_signal(self.board, 0)
+        bindings= (EventBinding * 2)(
+            EventBinding(event= switch, context= None, record= self.read_temp_twice_fn),
+            EventBinding(event= temp, context= None, record= self.read_temp_fn)
+        )
+
+        self.libmetawear.mbl_mw_event_program(self.board, bindings, len(bindings), None, self.programmed_fn)
+        self.programmed.wait()
+
+        expected_cmds= [
+            [0x0a, 0x02, 0x01, 0x01, 0xff, 0x04, 0xc1, 0x01], [0x0a, 0x03, 0x01],
+            [0x0a, 0x02, 0x01, 0x01, 0xff, 0x04, 0xc1, 0x01], [0x0a, 0x03, 0x01],
+            [0x0a, 0x02, 0x04, 0xc1, 0x00, 0x04, 0xc1, 0x01], [0x0a, 0x03, 0x01]
+        ]
+        print("TestEventProgram \n")
+        self.assertEqual(self.command_history, expected_cmds)
+        self.assertEqual(self.program_status, Const.STATUS_OK)
+        self.assertEqual(self.program_results, [(switch, [0, 1]), (temp, [2])])
+
+    def test_flow_control(self):
+        switch= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.board)
+        bindings= (EventBinding * 3)(*[EventBinding(event= switch, context= None, record= self.read_temp_twice_fn) for i in range(3)])
+
+        # hold back the responses so only the first window has been sent
+        with self.response_lock:
+            self.libmetawear.mbl_mw_event_program(self.board, bindings, len(bindings), None, self.programmed_fn)
+            in_flight= len(self.command_history)
+        self.programmed.wait()
+
+        print("TestEventProgram \n")
+        self.assertEqual(in_flight, 8)
+        self.assertEqual(len(self.command_history), 12)
+        self.assertEqual([ids for (_, ids) in self.program_results], [[0, 1], [2, 3], [4, 5]])
+
+    def test_queued(self):
+        switch= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.board)
+        first= (EventBinding * 1)(EventBinding(event= switch, context= None, record= self.read_temp_twice_fn))
+        second= (EventBinding * 1)(EventBinding(event= switch, context= None, record= self.read_temp_fn))
+
+        self.libmetawear.mbl_mw_event_program(self.board, first, len(first), 1, self.programmed_fn)
+        self.libmetawear.mbl_mw_event_program(self.board, second, len(second), 2, self.programmed_fn)
+        while len(self.completed) < 2 and self.programmed.wait(5):
+            self.programmed.clear()
+
+        print("TestEventProgram \n")
+        self.assertEqual(self.completed, [1, 2])
+        self.assertEqual(self.program_results, [(switch, [2])])
+        self.assertEqual(len(self.command_history), 6)
+
+    def test_empty(self):
+        bindings= (EventBinding * 0)()
+
+        self.libmetawear.mbl_mw_event_program(self.board, bindings, 0, None, self.programmed_fn)
+
+        print("TestEventProgram \n")
+        self.assertTrue(self.programmed.is_set())
+        self.assertEqual((self.program_status, self.program_results), (Const.STATUS_OK, []))
+
+class TestEventProgramTimeout(TestEventProgram):
+    def commandLogger(self, context, board, writeType, characteristic, command, length):
+        if (command[0] == 0xa and command[1] == 0x3 and len(self.command_history) >= 4):
+            self.command_history.append([command[i] for i in range(length)])
+        else:
+            super().commandLogger(context, board, writeType, characteristic, command, length)
+
+    def test_program(self):
+        switch= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.board)
+        temp= self.libmetawear.mbl_mw_multi_chnl_temp_get_temperature_data_signal(self.board, 0)
+        bindings= (EventBinding * 2)(
+            EventBinding(event= switch, context= None, record= self.read_temp_fn),
+            EventBinding(event= temp, context= None, record= self.read_temp_twice_fn)
+        )
+
+        self.libmetawear.mbl_mw_event_program(self.board, bindings, len(bindings), None, self.programmed_fn)
+        self.programmed.wait()
+
+        print("TestEventProgramTimeout \n")
+        self.assertEqual(self.program_status, Const.STATUS_ERROR_TIMEOUT)
+        self.assertEqual(self.program_results, [(switch, [0]), (temp, [1])])
+
+    def test_flow_control(self):
+        pass
+
+    def test_queued(self):
+        pass
+
 class TestEventTimeout(TestMetaWearBase):
     def commandLogger(self, context, board, writeType, characteristic, command, length):
         if (command[0] == 0xa and command[1] == 0x3):
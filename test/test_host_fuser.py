@@ -0,0 +1,123 @@
+from common import TestMetaWearBase
+from cbindings import *
+from ctypes import create_string_buffer
+import threading
+
+class TestHostFuser(TestMetaWearBase):
+    def setUp(self):
+        super().setUp()
+
+        self.frames= []
+        self.frame_fn= FnVoid_VoidP_DataP_UInt(self.frame_received)
+        self.fuser= None
+
+    def tearDown(self):
+        if self.fuser is not None:
+            self.libmetawear.mbl_mw_host_fuser_free(self.fuser)
+        super().tearDown()
+
+    def frame_received(self, context, samples, n_samples):
+        self.frames.append([(samples[i].epoch, samples[i].type_id, cast(samples[i].value, POINTER(c_uint)).contents.value) for i in range(n_samples)])
+
+    def create(self, n_streams, tolerance, capacity):
+        self.fuser= self.libmetawear.mbl_mw_host_fuser_create(n_streams, tolerance, capacity, None, self.frame_fn)
+
+    def feed(self, index, epoch, value):
+        data= Data(epoch= epoch, value= cast(pointer(c_uint(value)), c_void_p), type_id= DataTypeId.UINT32, length= 4)
+        self.libmetawear.mbl_mw_host_fuser_process(self.libmetawear.mbl_mw_host_fuser_get_stream(self.fuser, index), byref(data))
+
+    def test_align(self):
+        self.create(3, 5, 16)
+
+        # acc and gyro at 100Hz, mag at 50Hz
+        for (epoch, value) in [(1000, 1), (1010, 2), (1020, 3)]:
+            self.feed(0, epoch, value)
+        for (epoch, value) in [(1001, 4), (1011, 5), (1022, 6)]:
+            self.feed(1, epoch, value)
+        self.assertEqual(self.frames, [])
+
+        self.feed(2, 1003, 7)
+        self.feed(2, 1021, 8)
+
+        self.assertEqual(self.frames, [
+            [(1000, DataTypeId.UINT32, 1), (1001, DataTypeId.UINT32, 4), (1003, DataTypeId.UINT32, 7)],
+            [(1020, DataTypeId.UINT32, 3), (1022, DataTypeId.UINT32, 6), (1021, DataTypeId.UINT32, 8)]
+        ])
+        self.assertEqual(self.libmetawear.mbl_mw_host_fuser_get_n_dropped(self.fuser), 2)
+
+    def test_tolerance(self):
+        self.create(2, 0, 16)
+
+        self.feed(0, 1000, 1)
+        self.feed(1, 1001, 2)
+        self.feed(0, 1010, 3)
+        self.feed(1, 1010, 4)
+
+        self.assertEqual(self.frames, [[(1010, DataTypeId.UINT32, 3), (1010, DataTypeId.UINT32, 4)]])
+        self.assertEqual(self.libmetawear.mbl_mw_host_fuser_get_n_dropped(self.fuser), 2)
+
+    def test_full_ring(self):
+        # capacity of 3 is rounded up to 4 samples
+        self.create(2, 5, 3)
+
+        for i in range(6):
+            self.feed(0, 1000 + 10 * i, i)
+        self.feed(1, 1000, 10)
+
+        self.assertEqual(self.frames, [[(1000, DataTypeId.UINT32, 0), (1000, DataTypeId.UINT32, 10)]])
+        self.assertEqual(self.libmetawear.mbl_mw_host_fuser_get_n_dropped(self.fuser), 2)
+
+    def test_oversized_dropped(self):
+        self.create(1, 5, 4)
+
+        value= (c_ubyte * 64)()
+        data= Data(epoch= 1000, value= cast(value, c_void_p), type_id= DataTypeId.BYTE_ARRAY, length= 64)
+        self.libmetawear.mbl_mw_host_fuser_process(self.libmetawear.mbl_mw_host_fuser_get_stream(self.fuser, 0), byref(data))
+        self.feed(0, 1010, 5)
+
+        self.assertEqual(self.frames, [[(1010, DataTypeId.UINT32, 5)]])
+        self.assertEqual(self.libmetawear.mbl_mw_host_fuser_get_n_dropped(self.fuser), 1)
+
+    def test_invalid_stream(self):
+        self.create(2, 5, 4)
+        self.assertIsNone(self.libmetawear.mbl_mw_host_fuser_get_stream(self.fuser, 2))
+        self.assertIsNone(self.libmetawear.mbl_mw_host_fuser_create(0, 5, 4, None, self.frame_fn))
+
+    def test_signal(self):
+        self.create(1, 5, 4)
+        signal= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.board)
+        self.libmetawear.mbl_mw_datasignal_fuse(signal, self.fuser, 0)
+
+        self.notify_mw_char(create_string_buffer(b'\x01\x01\x01', 3))
+        self.notify_mw_char(create_string_buffer(b'\x01\x01\x00', 3))
+        self.libmetawear.mbl_mw_datasignal_unsubscribe(signal)
+
+        self.assertEqual([[(type_id, value) for (_, type_id, value) in frame] for frame in self.frames], [[(DataTypeId.UINT32, 1)], [(DataTypeId.UINT32, 0)]])
+
+    def test_concurrent_streams(self):
+        n_samples= 2000
+        self.create(2, 0, 64)
+
+        def producer(index):
+            stream= self.libmetawear.mbl_mw_host_fuser_get_stream(self.fuser, index)
+            value= c_uint(index)
+            data= Data(value= cast(byref(value), c_void_p), type_id= DataTypeId.UINT32, length= 4)
+            for i in range(n_samples):
+                data.epoch= i
+                self.libmetawear.mbl_mw_host_fuser_process(stream, byref(data))
+
+        threads= [threading.Thread(target= producer, args= (i,)) for i in range(2)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+
+        # every frame pairs samples with equal epochs, full rings drop samples but never mismatch them
+        self.assertTrue(all(frame[0][0] == frame[1][0] and frame[0][2] == 0 and frame[1][2] == 1 for frame in self.frames))
+        epochs= [frame[0][0] for frame in self.frames]
+        self.assertEqual(epochs, sorted(set(epochs)))
+        # samples still queued at the end were neither delivered nor dropped
+        handled= len(self.frames) * 2 + self.libmetawear.mbl_mw_host_fuser_get_n_dropped(self.fuser)
+        self.assertGreater(len(self.frames), 0)
+        self.assertLessEqual(handled, n_samples * 2)
+        self.assertGreaterEqual(handled, n_samples * 2 - 2 * 64)
@@ -0,0 +1,289 @@
+from common import TestMetaWearBase
+from cbindings import *
+from ctypes import create_string_buffer
+
+class TestHostProcessor(TestMetaWearBase):
+    def setUp(self):
+        super().setUp()
+
+        self.outputs= {}
+        self.handlers= []
+        self.roots= []
+
+    def tearDown(self):
+        for root in self.roots:
+            self.libmetawear.mbl_mw_host_processor_free(root)
+        super().tearDown()
+
+    def root(self, processor):
+        self.roots.append(processor)
+        return processor
+
+    def collect(self, processor, name):
+        self.outputs[name]= []
+        def handler(context, data):
+            contents= data.contents
+            if contents.type_id == DataTypeId.CARTESIAN_FLOAT:
+                value= cast(contents.value, POINTER(CartesianFloat)).contents
+                value= (round(value.x, 4), round(value.y, 4), round(value.z, 4))
+            elif contents.type_id == DataTypeId.FLOAT:
+                value= round(cast(contents.value, POINTER(c_float)).contents.value, 4)
+            elif contents.type_id == DataTypeId.INT32:
+                value= cast(contents.value, POINTER(c_int)).contents.value
+            else:
+                value= cast(contents.value, POINTER(c_uint)).contents.value
+            self.outputs[name].append((contents.epoch, contents.type_id, value))
+
+        fn= FnVoid_VoidP_DataP(handler)
+        self.handlers.append(fn)
+        self.libmetawear.mbl_mw_host_processor_subscribe(processor, None, fn)
+
+    def values(self, name):
+        return [value for (_, _, value) in self.outputs[name]]
+
+    def feed(self, processor, samples, type_id= DataTypeId.FLOAT):
+        ctype= { DataTypeId.FLOAT: c_float, DataTypeId.INT32: c_int, DataTypeId.UINT32: c_uint }
+        self.values_alive= []
+        batch= (Data * len(samples))()
+        for (i, sample) in enumerate(samples):
+            if type_id == DataTypeId.CARTESIAN_FLOAT:
+                value= CartesianFloat(x= sample[0], y= sample[1], z= sample[2])
+            else:
+                value= ctype[type_id](sample)
+            self.values_alive.append(value)
+            batch[i]= Data(epoch= 1000 + 10 * i, value= cast(byref(value), c_void_p), type_id= type_id, length= sizeof(value))
+        self.libmetawear.mbl_mw_host_processor_process_batch(processor, batch, len(samples))
+
+    def test_lowpass_highpass(self):
+        lowpass= self.root(self.libmetawear.mbl_mw_host_processor_lowpass_create(None, 4))
+        highpass= self.libmetawear.mbl_mw_host_processor_highpass_create(lowpass, 2)
+        self.collect(lowpass, 'lowpass')
+        self.collect(highpass, 'highpass')
+
+        self.feed(lowpass, [4.0, 8.0, 12.0, 16.0, 20.0, 4.0])
+        self.assertEqual(self.values('lowpass'), [4.0, 6.0, 8.0, 10.0, 14.0, 13.0])
+        self.assertEqual(self.values('highpass'), [0.0, 1.0, 1.0, 1.0, 2.0, -0.5])
+
+    def test_integer_average(self):
+        lowpass= self.root(self.libmetawear.mbl_mw_host_processor_lowpass_create(None, 2))
+        self.collect(lowpass, 'lowpass')
+
+        self.feed(lowpass, [1, 2, 4], DataTypeId.UINT32)
+        self.assertEqual(self.outputs['lowpass'], [(1000, DataTypeId.UINT32, 1), (1010, DataTypeId.UINT32, 1), (1020, DataTypeId.UINT32, 3)])
+
+    def test_rms_rss(self):
+        source= self.root(self.libmetawear.mbl_mw_host_processor_passthrough_create(None, PassthroughMode.ALL, 0))
+        rms= self.libmetawear.mbl_mw_host_processor_rms_create(source)
+        rss= self.libmetawear.mbl_mw_host_processor_rss_create(source)
+        self.collect(rms, 'rms')
+        self.collect(rss, 'rss')
+
+        self.feed(source, [(1.0, 2.0, 2.0), (0.0, -3.0, 4.0)], DataTypeId.CARTESIAN_FLOAT)
+        self.assertEqual(self.values('rss'), [3.0, 5.0])
+        self.assertEqual(self.values('rms'), [round(3.0 / 3 ** 0.5, 4), round(5.0 / 3 ** 0.5, 4)])
+        self.assertEqual(self.outputs['rms'][0][1], DataTypeId.FLOAT)
+
+    def test_threshold(self):
+        absolute= self.root(self.libmetawear.mbl_mw_host_processor_threshold_create(None, ThresholdMode.ABSOLUTE, 1.0, 0.25))
+        binary= self.root(self.libmetawear.mbl_mw_host_processor_threshold_create(None, ThresholdMode.BINARY, 1.0, 0.25))
+        self.collect(absolute, 'absolute')
+        self.collect(binary, 'binary')
+
+        samples= [0.5, 1.1, 1.5, 1.2, 0.9, 0.5, 2.0]
+        self.feed(absolute, samples)
+        self.feed(binary, samples)
+        self.assertEqual(self.values('absolute'), [1.5, 0.5, 2.0])
+        self.assertEqual(self.outputs['binary'], [(1020, DataTypeId.INT32, 1), (1050, DataTypeId.INT32, -1), (1060, DataTypeId.INT32, 1)])
+
+    def test_delta(self):
+        expected= {
+            DeltaMode.ABSOLUTE: [2.0, 4.5, 2.0],
+            DeltaMode.DIFFERENTIAL: [2.0, 2.5, -2.5],
+            DeltaMode.BINARY: [1, 1, -1]
+        }
+        for (mode, values) in expected.items():
+            delta= self.root(self.libmetawear.mbl_mw_host_processor_delta_create(None, mode, 2.0))
+            self.collect(delta, mode)
+            self.feed(delta, [1.0, 2.0, 3.0, 4.5, 3.0, 2.0])
+            self.assertEqual(self.values(mode), values)
+
+    def test_comparator(self):
+        comparator= self.root(self.libmetawear.mbl_mw_host_processor_comparator_create(None, ComparatorOperation.GTE, 2.5))
+        self.collect(comparator, 'comparator')
+
+        self.feed(comparator, [1, 2, 3, 4], DataTypeId.INT32)
+        # integer signals compare against an integer reference, as on the board
+        self.assertEqual(self.outputs['comparator'], [(1010, DataTypeId.INT32, 2), (1020, DataTypeId.INT32, 3), (1030, DataTypeId.INT32, 4)])
+
+    def test_math(self):
+        expected= {
+            MathOperation.ADD: [3.0, 1.5, -1.0],
+            MathOperation.MULTIPLY: [2.0, -1.0, -6.0],
+            MathOperation.DIVIDE: [0.5, -0.25, -1.5],
+            MathOperation.SUBTRACT: [-1.0, -2.5, -5.0],
+            MathOperation.ABS_VALUE: [1.0, 0.5, 3.0],
+            MathOperation.CONSTANT: [2.0, 2.0, 2.0],
+            MathOperation.LSHIFT: [4.0, -2.0, -12.0],
+        }
+        for (op, values) in expected.items():
+            math= self.root(self.libmetawear.mbl_mw_host_processor_math_create(None, op, 2.0))
+            self.collect(math, op)
+            self.feed(math, [1.0, -0.5, -3.0])
+            self.assertEqual(self.values(op), values, "op %d" % op)
+
+    def test_integer_math(self):
+        rshift= self.root(self.libmetawear.mbl_mw_host_processor_math_create(None, MathOperation.RSHIFT, 1))
+        subtract= self.root(self.libmetawear.mbl_mw_host_processor_math_create(None, MathOperation.SUBTRACT, 4))
+        self.collect(rshift, 'rshift')
+        self.collect(subtract, 'subtract')
+
+        self.feed(rshift, [-5, 7], DataTypeId.INT32)
+        self.feed(subtract, [1, 7], DataTypeId.UINT32)
+        self.assertEqual(self.values('rshift'), [-3, 3])
+        self.assertEqual(self.outputs['subtract'], [(1000, DataTypeId.INT32, -3), (1010, DataTypeId.INT32, 3)])
+
+    def test_integer_divide_by_zero(self):
+        divide= self.root(self.libmetawear.mbl_mw_host_processor_math_create(None, MathOperation.DIVIDE, 0))
+        modulus= self.root(self.libmetawear.mbl_mw_host_processor_math_create(None, MathOperation.MODULUS, 0))
+        # the result is a defined integer further down the chain too, not only once converted for the handler
+        comparator= self.libmetawear.mbl_mw_host_processor_comparator_create(modulus, ComparatorOperation.EQ, 0)
+        self.collect(divide, 'divide')
+        self.collect(modulus, 'modulus')
+        self.collect(comparator, 'comparator')
+
+        self.feed(divide, [-5, 0, 7], DataTypeId.INT32)
+        self.feed(modulus, [-5, 0, 7], DataTypeId.INT32)
+        self.assertEqual(self.values('divide'), [0, 0, 0])
+        self.assertEqual(self.values('modulus'), [0, 0, 0])
+        self.assertEqual(self.values('comparator'), [0, 0, 0])
+
+    def test_cartesian_math(self):
+        math= self.root(self.libmetawear.mbl_mw_host_processor_math_create(None, MathOperation.MULTIPLY, 2.0))
+        self.collect(math, 'math')
+
+        self.feed(math, [(1.0, -2.0, 0.5)], DataTypeId.CARTESIAN_FLOAT)
+        self.assertEqual(self.outputs['math'], [(1000, DataTypeId.CARTESIAN_FLOAT, (2.0, -4.0, 1.0))])
+
+    def test_pulse(self):
+        samples= [0.0, 2.0, 3.0, 5.0, 0.0, 2.0, 0.0, 4.0, 4.0, 1.0]
+        expected= {
+            PulseOutput.WIDTH: [(1040, DataTypeId.UINT32, 3), (1090, DataTypeId.UINT32, 2)],
+            PulseOutput.AREA: [(1040, DataTypeId.FLOAT, 10.0), (1090, DataTypeId.FLOAT, 8.0)],
+            PulseOutput.PEAK: [(1040, DataTypeId.FLOAT, 5.0), (1090, DataTypeId.FLOAT, 4.0)],
+            PulseOutput.ON_DETECTION: [(1020, DataTypeId.UINT32, 1), (1080, DataTypeId.UINT32, 1)]
+        }
+        for (output, values) in expected.items():
+            pulse= self.root(self.libmetawear.mbl_mw_host_processor_pulse_create(None, output, 1.0, 2))
+            self.collect(pulse, output)
+            self.feed(pulse, samples)
+            self.assertEqual(self.outputs[output], values, "output %d" % output)
+
+    def test_time(self):
+        absolute= self.root(self.libmetawear.mbl_mw_host_processor_time_create(None, TimeMode.ABSOLUTE, 25))
+        differential= self.root(self.libmetawear.mbl_mw_host_processor_time_create(None, TimeMode.DIFFERENTIAL, 25))
+        self.collect(absolute, 'absolute')
+        self.collect(differential, 'differential')
+
+        samples= [10, 11, 12, 13, 14, 15, 16]
+        self.feed(absolute, samples, DataTypeId.UINT32)
+        self.feed(differential, samples, DataTypeId.UINT32)
+        self.assertEqual(self.outputs['absolute'], [(1000, DataTypeId.UINT32, 10), (1030, DataTypeId.UINT32, 13), (1060, DataTypeId.UINT32, 16)])
+        self.assertEqual(self.outputs['differential'], [(1000, DataTypeId.INT32, 10), (1030, DataTypeId.INT32, 3), (1060, DataTypeId.INT32, 3)])
+
+    def test_sample(self):
+        sample= self.root(self.libmetawear.mbl_mw_host_processor_sample_create(None, 3))
+        self.collect(sample, 'sample')
+
+        self.feed(sample, [1.0, 2.0])
+        self.assertEqual(self.values('sample'), [])
+        self.feed(sample, [3.0, 4.0])
+        self.assertEqual(self.outputs['sample'], [(1000, DataTypeId.FLOAT, 1.0), (1010, DataTypeId.FLOAT, 2.0), (1000, DataTypeId.FLOAT, 3.0)])
+
+    def test_passthrough(self):
+        count= self.root(self.libmetawear.mbl_mw_host_processor_passthrough_create(None, PassthroughMode.COUNT, 3))
+        conditional= self.root(self.libmetawear.mbl_mw_host_processor_passthrough_create(None, PassthroughMode.CONDITIONAL, 0))
+        self.collect(count, 'count')
+        self.collect(conditional, 'conditional')
+
+        self.feed(count, [1.0, 2.0])
+        self.feed(count, [3.0, 4.0])
+        self.feed(conditional, [1.0, 2.0])
+        self.assertEqual(self.values('count'), [1.0, 2.0, 3.0])
+        self.assertEqual(self.values('conditional'), [])
+
+        self.libmetawear.mbl_mw_host_processor_reset(count)
+        self.feed(count, [5.0])
+        self.assertEqual(self.values('count'), [1.0, 2.0, 3.0, 5.0])
+
+    def test_counter_accumulator(self):
+        counter= self.root(self.libmetawear.mbl_mw_host_processor_counter_create(None))
+        accumulator= self.libmetawear.mbl_mw_host_processor_accumulator_create(counter)
+        self.collect(counter, 'counter')
+        self.collect(accumulator, 'accumulator')
+
+        self.feed(counter, [0.5, 0.5, 0.5])
+        self.assertEqual(self.outputs['counter'], [(1000, DataTypeId.UINT32, 1), (1010, DataTypeId.UINT32, 2), (1020, DataTypeId.UINT32, 3)])
+        self.assertEqual(self.outputs['accumulator'], [(1000, DataTypeId.UINT32, 1), (1010, DataTypeId.UINT32, 3), (1020, DataTypeId.UINT32, 6)])
+
+    def test_batch_matches_single(self):
+        samples= [0.0, 1.5, 3.0, 2.5, 0.5, 4.0, 4.5, 1.0, 0.0, 2.0, 3.5, 0.5]
+        results= []
+        for batched in [True, False]:
+            lowpass= self.root(self.libmetawear.mbl_mw_host_processor_lowpass_create(None, 2))
+            delta= self.libmetawear.mbl_mw_host_processor_delta_create(lowpass, DeltaMode.DIFFERENTIAL, 0.5)
+            pulse= self.libmetawear.mbl_mw_host_processor_pulse_create(delta, PulseOutput.AREA, 0.0, 1)
+            self.collect(pulse, batched)
+
+            if batched:
+                self.feed(lowpass, samples)
+            else:
+                for (i, sample) in enumerate(samples):
+                    value= c_float(sample)
+                    data= Data(epoch= 1000 + 10 * i, value= cast(byref(value), c_void_p), type_id= DataTypeId.FLOAT, length= 4)
+                    self.libmetawear.mbl_mw_host_processor_process(lowpass, byref(data))
+            results.append(self.outputs[batched])
+
+        self.assertNotEqual(results[0], [])
+        self.assertEqual(results[0], results[1])
+
+    def test_signal_source(self):
+        counter= self.root(self.libmetawear.mbl_mw_host_processor_counter_create(None))
+        comparator= self.libmetawear.mbl_mw_host_processor_comparator_create(None, ComparatorOperation.EQ, 1)
+        self.roots.append(comparator)
+        self.collect(counter, 'counter')
+        self.collect(comparator, 'comparator')
+
+        signal= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.board)
+        self.libmetawear.mbl_mw_datasignal_subscribe(signal, counter, cast(self.libmetawear.mbl_mw_host_processor_process, FnVoid_VoidP_DataP))
+        self.notify_mw_char(create_string_buffer(b'\x01\x01\x01', 3))
+        self.notify_mw_char(create_string_buffer(b'\x01\x01\x00', 3))
+        self.libmetawear.mbl_mw_datasignal_subscribe(signal, comparator, cast(self.libmetawear.mbl_mw_host_processor_process, FnVoid_VoidP_DataP))
+        self.notify_mw_char(create_string_buffer(b'\x01\x01\x01', 3))
+        self.libmetawear.mbl_mw_datasignal_unsubscribe(signal)
+
+        self.assertEqual(self.values('counter'), [1, 2])
+        self.assertEqual(self.values('comparator'), [1])
+
+    def test_unsupported_type(self):
+        counter= self.root(self.libmetawear.mbl_mw_host_processor_counter_create(None))
+        accumulator= self.root(self.libmetawear.mbl_mw_host_processor_accumulator_create(None))
+        self.collect(counter, 'counter')
+        self.collect(accumulator, 'accumulator')
+
+        value= (c_ubyte * 2)(1, 2)
+        data= Data(epoch= 1000, value= cast(value, c_void_p), type_id= DataTypeId.BYTE_ARRAY, length= 2)
+        self.libmetawear.mbl_mw_host_processor_process(counter, byref(data))
+        self.libmetawear.mbl_mw_host_processor_process(accumulator, byref(data))
+        self.assertEqual(self.values('counter'), [1])
+        self.assertEqual(self.values('accumulator'), [])
+
+    def test_free_branch(self):
+        source= self.root(self.libmetawear.mbl_mw_host_processor_passthrough_create(None, PassthroughMode.ALL, 0))
+        kept= self.libmetawear.mbl_mw_host_processor_counter_create(source)
+        removed= self.libmetawear.mbl_mw_host_processor_accumulator_create(source)
+        self.libmetawear.mbl_mw_host_processor_math_create(removed, MathOperation.ADD, 1.0)
+        self.collect(kept, 'kept')
+
+        self.libmetawear.mbl_mw_host_processor_free(removed)
+        self.feed(source, [1.0])
+        self.assertEqual(self.values('kept'), [1])
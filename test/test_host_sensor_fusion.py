@@ -0,0 +1,182 @@
+from common import TestMetaWearBase
+from cbindings import *
+import math
+import time
+
+class TestHostSensorFusion(TestMetaWearBase):
+    def setUp(self):
+        super().setUp()
+
+        self.outputs= {}
+        self.output_fn= FnVoid_VoidP_DataP(self.output_received)
+        self.fusions= []
+        self.pool= None
+
+    def tearDown(self):
+        if self.pool is not None:
+            self.libmetawear.mbl_mw_host_sensor_fusion_pool_free(self.pool)
+        for fusion in self.fusions:
+            self.libmetawear.mbl_mw_host_sensor_fusion_free(fusion)
+        super().tearDown()
+
+    def output_received(self, context, data):
+        if data.contents.type_id == DataTypeId.QUATERNION:
+            value= cast(data.contents.value, POINTER(Quaternion)).contents
+            sample= (value.w, value.x, value.y, value.z)
+        elif data.contents.type_id == DataTypeId.EULER_ANGLE:
+            value= cast(data.contents.value, POINTER(EulerAngles)).contents
+            sample= (value.heading, value.pitch, value.roll, value.yaw)
+        else:
+            value= cast(data.contents.value, POINTER(CartesianFloat)).contents
+            sample= (value.x, value.y, value.z)
+        self.outputs.setdefault(context, []).append((data.contents.epoch, sample))
+
+    def create(self, algorithm, sample_rate, gain, outputs= [SensorFusionData.QUATERNION]):
+        fusion= self.libmetawear.mbl_mw_host_sensor_fusion_create(algorithm, sample_rate, gain)
+        for output in outputs:
+            self.libmetawear.mbl_mw_host_sensor_fusion_subscribe(fusion, output, output + len(self.fusions) * 16, self.output_fn)
+        self.fusions.append(fusion)
+        return fusion
+
+    @staticmethod
+    def to_arrays(acc, gyro, mag):
+        n= len(gyro)
+        return ((CartesianFloat * n)(*[CartesianFloat(*v) for v in acc]), (CartesianFloat * n)(*[CartesianFloat(*v) for v in gyro]),
+                None if mag is None else (CartesianFloat * n)(*[CartesianFloat(*v) for v in mag]), (c_longlong * n)(*range(n)))
+
+    def process_batch(self, fusion, acc, gyro, mag= None):
+        (acc_array, gyro_array, mag_array, epochs)= TestHostSensorFusion.to_arrays(acc, gyro, mag)
+        self.libmetawear.mbl_mw_host_sensor_fusion_process_batch(fusion, acc_array, gyro_array, mag_array, epochs, len(gyro))
+
+    def assertSampleAlmostEqual(self, actual, expected, places= 3):
+        for (a, e) in zip(actual, expected):
+            self.assertAlmostEqual(a, e, places= places)
+
+    def test_invalid_sample_rate(self):
+        self.assertIsNone(self.libmetawear.mbl_mw_host_sensor_fusion_create(HostSensorFusionAlgorithm.MADGWICK, 0.0, 0.1))
+
+    def test_static(self):
+        for algorithm in [HostSensorFusionAlgorithm.MADGWICK, HostSensorFusionAlgorithm.MAHONY]:
+            with self.subTest(algorithm= algorithm):
+                self.outputs= {}
+                fusion= self.create(algorithm, 100.0, 0.1, [SensorFusionData.QUATERNION, SensorFusionData.EULER_ANGLE])
+                self.process_batch(fusion, [(0.0, 0.0, 1.0)] * 50, [(0.0, 0.0, 0.0)] * 50)
+
+                context= len(self.fusions) * 16 - 16
+                self.assertEqual(len(self.outputs[context + SensorFusionData.QUATERNION]), 50)
+                self.assertEqual(self.outputs[context + SensorFusionData.QUATERNION][-1][0], 49)
+                self.assertSampleAlmostEqual(self.outputs[context + SensorFusionData.QUATERNION][-1][1], (1.0, 0.0, 0.0, 0.0))
+                self.assertSampleAlmostEqual(self.outputs[context + SensorFusionData.EULER_ANGLE][-1][1], (0.0, 0.0, 0.0, 0.0))
+
+    def test_yaw_rotation(self):
+        # yaw is unobservable by the accelerometer so both filters integrate the gyro as is, 90 deg/s for 1s
+        expected= (math.sqrt(0.5), 0.0, 0.0, math.sqrt(0.5))
+        for algorithm in [HostSensorFusionAlgorithm.MADGWICK, HostSensorFusionAlgorithm.MAHONY]:
+            with self.subTest(algorithm= algorithm):
+                self.outputs= {}
+                fusion= self.create(algorithm, 100.0, 0.1, [SensorFusionData.QUATERNION, SensorFusionData.EULER_ANGLE])
+                self.process_batch(fusion, [(0.0, 0.0, 1.0)] * 100, [(0.0, 0.0, 90.0)] * 100)
+
+                context= len(self.fusions) * 16 - 16
+                self.assertSampleAlmostEqual(self.outputs[context + SensorFusionData.QUATERNION][-1][1], expected)
+                self.assertSampleAlmostEqual(self.outputs[context + SensorFusionData.EULER_ANGLE][-1][1], (90.0, 0.0, 0.0, 90.0), places= 1)
+
+    def test_tilt_convergence(self):
+        for (algorithm, gain) in [(HostSensorFusionAlgorithm.MADGWICK, 0.1), (HostSensorFusionAlgorithm.MAHONY, 2.0)]:
+            with self.subTest(algorithm= algorithm):
+                self.outputs= {}
+                fusion= self.create(algorithm, 100.0, gain, [SensorFusionData.EULER_ANGLE, SensorFusionData.GRAVITY_VECTOR, SensorFusionData.LINEAR_ACC])
+                self.process_batch(fusion, [(0.0, 1.0, 0.0)] * 2000, [(0.0, 0.0, 0.0)] * 2000)
+
+                context= len(self.fusions) * 16 - 16
+                self.assertAlmostEqual(self.outputs[context + SensorFusionData.EULER_ANGLE][-1][1][2], 90.0, places= 0)
+                self.assertSampleAlmostEqual(self.outputs[context + SensorFusionData.GRAVITY_VECTOR][-1][1], (0.0, 1.0, 0.0), places= 1)
+                self.assertSampleAlmostEqual(self.outputs[context + SensorFusionData.LINEAR_ACC][-1][1], (0.0, 0.0, 0.0), places= 1)
+
+    def test_mag_heading(self):
+        # magnetic north along the y axis turns the board -90 degrees so y points along the reference x axis
+        for (algorithm, gain) in [(HostSensorFusionAlgorithm.MADGWICK, 0.2), (HostSensorFusionAlgorithm.MAHONY, 2.0)]:
+            with self.subTest(algorithm= algorithm):
+                self.outputs= {}
+                fusion= self.create(algorithm, 100.0, gain, [SensorFusionData.EULER_ANGLE])
+                self.process_batch(fusion, [(0.0, 0.0, 1.0)] * 2000, [(0.0, 0.0, 0.0)] * 2000, [(0.0, 30.0, -40.0)] * 2000)
+
+                context= len(self.fusions) * 16 - 16
+                self.assertSampleAlmostEqual(self.outputs[context + SensorFusionData.EULER_ANGLE][-1][1], (270.0, 0.0, 0.0, -90.0), places= 0)
+
+    def test_stream_matches_batch(self):
+        n= 200
+        acc= [(0.1 * math.sin(i / 10.0), 0.2, 0.97) for i in range(n)]
+        gyro= [(5.0 * math.cos(i / 7.0), -3.0, 20.0) for i in range(n)]
+        mag= [(20.0, 5.0 * math.sin(i / 13.0), -30.0) for i in range(n)]
+
+        batched= self.create(HostSensorFusionAlgorithm.MADGWICK, 100.0, 0.1)
+        self.process_batch(batched, acc, gyro, mag)
+
+        streamed= self.create(HostSensorFusionAlgorithm.MADGWICK, 100.0, 0.1)
+        for i in range(n):
+            for (fn, value) in [(self.libmetawear.mbl_mw_host_sensor_fusion_process_acc, acc[i]),
+                    (self.libmetawear.mbl_mw_host_sensor_fusion_process_mag, mag[i]), (self.libmetawear.mbl_mw_host_sensor_fusion_process_gyro, gyro[i])]:
+                sample= CartesianFloat(*value)
+                data= Data(epoch= i, value= cast(byref(sample), c_void_p), type_id= DataTypeId.CARTESIAN_FLOAT, length= 12)
+                fn(streamed, byref(data))
+
+        self.assertEqual(self.outputs[SensorFusionData.QUATERNION], self.outputs[16 + SensorFusionData.QUATERNION])
+
+    def test_reset(self):
+        fusion= self.create(HostSensorFusionAlgorithm.MAHONY, 100.0, 0.1)
+        self.process_batch(fusion, [(0.0, 0.0, 1.0)] * 10, [(0.0, 0.0, 90.0)] * 10)
+        self.libmetawear.mbl_mw_host_sensor_fusion_reset(fusion)
+        self.process_batch(fusion, [(0.0, 0.0, 1.0)], [(0.0, 0.0, 0.0)])
+
+        self.assertSampleAlmostEqual(self.outputs[SensorFusionData.QUATERNION][-1][1], (1.0, 0.0, 0.0, 0.0))
+
+    def test_pool_matches_serial(self):
+        n_boards= 8
+        n_batches= 5
+        batch_size= 40
+        inputs= []
+        for b in range(n_boards):
+            inputs.append([TestHostSensorFusion.to_arrays(
+                    [(0.05 * b, 0.1 * math.sin((k * batch_size + i) / 9.0), 1.0) for i in range(batch_size)],
+                    [(10.0 + b, -4.0, 2.0 * math.cos((k * batch_size + i) / 5.0)) for i in range(batch_size)],
+                    [(25.0, -5.0 * b, -35.0) for i in range(batch_size)]) for k in range(n_batches)])
+
+        serial= [self.create(HostSensorFusionAlgorithm.MADGWICK, 100.0, 0.1) for b in range(n_boards)]
+        for b in range(n_boards):
+            for batch in inputs[b]:
+                self.libmetawear.mbl_mw_host_sensor_fusion_process_batch(serial[b], batch[0], batch[1], batch[2], batch[3], batch_size)
+
+        self.pool= self.libmetawear.mbl_mw_host_sensor_fusion_pool_create(4)
+        pooled= [self.create(HostSensorFusionAlgorithm.MADGWICK, 100.0, 0.1) for b in range(n_boards)]
+        for k in range(n_batches):
+            for b in range(n_boards):
+                batch= inputs[b][k]
+                self.libmetawear.mbl_mw_host_sensor_fusion_pool_submit(self.pool, pooled[b], batch[0], batch[1], batch[2], batch[3], batch_size)
+        self.libmetawear.mbl_mw_host_sensor_fusion_pool_wait(self.pool)
+
+        for b in range(n_boards):
+            expected= self.outputs[b * 16 + SensorFusionData.QUATERNION]
+            self.assertEqual(len(expected), n_batches * batch_size)
+            self.assertEqual(self.outputs[(n_boards + b) * 16 + SensorFusionData.QUATERNION], expected)
+
+    def test_throughput(self):
+        # no subscribers, only the filter itself is timed; reports board-samples per second, i.e. boards x Hz
+        n_boards= 64
+        n_batches= 10
+        batch_size= 100
+        (acc, gyro, mag, epochs)= TestHostSensorFusion.to_arrays([(0.0, 0.1, 0.99)] * batch_size, [(1.0, -2.0, 3.0)] * batch_size, [(20.0, 0.0, -40.0)] * batch_size)
+
+        self.pool= self.libmetawear.mbl_mw_host_sensor_fusion_pool_create(0)
+        fusions= [self.create(HostSensorFusionAlgorithm.MADGWICK, 100.0, 0.1, []) for b in range(n_boards)]
+
+        start= time.perf_counter()
+        for k in range(n_batches):
+            for fusion in fusions:
+                self.libmetawear.mbl_mw_host_sensor_fusion_pool_submit(self.pool, fusion, acc, gyro, mag, epochs, batch_size)
+        self.libmetawear.mbl_mw_host_sensor_fusion_pool_wait(self.pool)
+        elapsed= time.perf_counter() - start
+
+        print("\nhost sensor fusion: %d boards x %d samples in %.3fs, %.0f boards x Hz" % (n_boards, n_batches * batch_size, elapsed,
+                n_boards * n_batches * batch_size / elapsed))
+        self.assertGreater(elapsed, 0)
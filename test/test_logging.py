@@ -181,6 +181,34 @@ class TestAccelerometerLogging(TestAccelerometerLoggingBase):
         print("TestAccelerometerLogging \n")
         self.assertEqual(self.data_time_offsets, Bmi160Accelerometer.expected_offsets)
 
+class TestLogReadoutThroughput(TestAccelerometerLoggingBase):
+    N_PACKETS= 10000
+
+    def __init__(self, *args, **kwargs):
+        super().__init__(*args, **kwargs)
+
+        self.responses= []
+        for i in range(0, TestLogReadoutThroughput.N_PACKETS):
+            tick= list((0x42e6 + i * 16).to_bytes(4, byteorder='little'))
+            self.responses.append(to_string_buffer([0x0b, 0x07, 0xa0] + tick + [0xf5, 0x00, 0x3d, 0x01, 0xa1] + tick + [0xdd, 0x0f, 0x00, 0x00]))
+
+    def logger_ready(self, context, logger):
+        start= time.perf_counter()
+        super().logger_ready(context, logger)
+        elapsed= time.perf_counter() - start
+
+        print("TestLogReadoutThroughput: %d entries/sec \n" % (2 * TestLogReadoutThroughput.N_PACKETS / elapsed))
+
+    def test_readout(self):
+        acc_signal= self.libmetawear.mbl_mw_acc_get_acceleration_data_signal(self.board)
+        self.libmetawear.mbl_mw_acc_bosch_set_range(self.board, AccBoschRange._8G)
+        self.libmetawear.mbl_mw_datasignal_log(acc_signal, None, self.logger_created)
+        self.events["log"].wait()
+
+        self.assertEqual(len(self.logged_data), TestLogReadoutThroughput.N_PACKETS)
+        # 16 ticks = 23.4375ms, alternating between 23 and 24ms after rounding
+        self.assertEqual(set(self.data_time_offsets), {23, 24})
+
 class TestGyroYAxisLoggingBase(TestMetaWearBase):
     def __init__(self, *args, **kwargs):
         super().__init__(*args, **kwargs)
@@ -336,3 +364,16 @@ class TestLogTimestamp(TestMetaWearBase):
         # epoch should be within 32701ms
         print("TestLogTimestamp \n")
         self.assertTrue(abs(epoch[0] - self.now) <= 32701)
+
+class TestLogReferenceTime(TestMetaWearBase):
+    def test_out_of_range_uid(self):
+        before= self.libmetawear.mbl_mw_logging_get_reference_time(self.board, 1)
+        self.libmetawear.mbl_mw_logging_set_reference_time(self.board, 9, 1234)
+
+        self.assertEqual(self.libmetawear.mbl_mw_logging_get_reference_time(self.board, 1), before)
+        self.assertEqual(self.libmetawear.mbl_mw_logging_get_reference_time(self.board, 9), -1)
+
+    def test_set(self):
+        self.libmetawear.mbl_mw_logging_set_reference_time(self.board, 3, 1234)
+
+        self.assertEqual(self.libmetawear.mbl_mw_logging_get_reference_time(self.board, 3), 1234)
@@ -2,6 +2,7 @@ from common import TestMetaWearBase
 from ctypes import byref
 from cbindings import *
 #from mbientlab.metawear.cbindings import *
+import copy
 import threading
 
 class TestMacro(TestMetaWearBase):
@@ -156,3 +157,135 @@ class TestMacro(TestMetaWearBase):
         ]
         print("TestMacro \n")
         self.assertEqual(self.command_history, expected)
+
+class TestMacroBuilder(TestMetaWearBase):
+    def setUp(self):
+        self.boardType= TestMetaWearBase.METAWEAR_RPRO_BOARD
+
+        super().setUp()
+
+        self.uploaded= threading.Event()
+        self.uploaded_fn= FnVoid_VoidP_VoidP_MacroUploadResultP_Int(self.macro_uploaded)
+        self.builder= self.libmetawear.mbl_mw_macro_builder_create(self.board, 1)
+
+    def tearDown(self):
+        self.libmetawear.mbl_mw_macro_builder_free(self.builder)
+        super().tearDown()
+
+    def macro_uploaded(self, context, board, result, status):
+        self.upload_result= copy.deepcopy(result.contents)
+        self.upload_status= status
+        self.uploaded.set()
+
+    def upload(self):
+        self.command_history= []
+        self.libmetawear.mbl_mw_macro_builder_upload(self.builder, None, self.uploaded_fn)
+        self.uploaded.wait()
+
+    def test_dedup_config(self):
+        self.libmetawear.mbl_mw_macro_builder_record(self.builder)
+        self.libmetawear.mbl_mw_acc_set_odr(self.board, c_float(25.0))
+        self.libmetawear.mbl_mw_acc_write_acceleration_config(self.board)
+        self.libmetawear.mbl_mw_acc_set_odr(self.board, c_float(100.0))
+        self.libmetawear.mbl_mw_acc_write_acceleration_config(self.board)
+        self.libmetawear.mbl_mw_acc_enable_acceleration_sampling(self.board)
+        self.libmetawear.mbl_mw_acc_start(self.board)
+        self.libmetawear.mbl_mw_acc_write_acceleration_config(self.board)
+        self.libmetawear.mbl_mw_led_play(self.board)
+        self.libmetawear.mbl_mw_macro_builder_end_record(self.builder)
+
+        self.assertEqual(self.libmetawear.mbl_mw_macro_builder_get_n_commands(self.builder), 4)
+        self.assertEqual(self.libmetawear.mbl_mw_macro_builder_get_size(self.builder), 14)
+
+        self.upload()
+
+        expected = [
+            [0x0f, 0x02, 0x01],
+            [0x0f, 0x03, 0x03, 0x03, 0x28, 0x03],
+            [0x0f, 0x03, 0x03, 0x02, 0x01, 0x00],
+            [0x0f, 0x03, 0x03, 0x01, 0x01],
+            [0x0f, 0x03, 0x02, 0x01, 0x01],
+            [0x0f, 0x04]
+        ]
+        print("TestMacroBuilder \n")
+        self.assertEqual(self.command_history, expected)
+        self.assertEqual(self.upload_status, Const.STATUS_OK)
+        self.assertEqual((self.upload_result.id, self.upload_result.n_commands, self.upload_result.n_dropped, self.upload_result.size), (0, 4, 2, 14))
+
+    def test_keep_config_used_by_module(self):
+        self.libmetawear.mbl_mw_macro_builder_record(self.builder)
+        self.libmetawear.mbl_mw_acc_set_odr(self.board, c_float(25.0))
+        self.libmetawear.mbl_mw_acc_write_acceleration_config(self.board)
+        self.libmetawear.mbl_mw_acc_start(self.board)
+        self.libmetawear.mbl_mw_acc_set_odr(self.board, c_float(100.0))
+        self.libmetawear.mbl_mw_acc_write_acceleration_config(self.board)
+        self.libmetawear.mbl_mw_macro_builder_end_record(self.builder)
+
+        self.upload()
+
+        expected = [
+            [0x0f, 0x02, 0x01],
+            [0x0f, 0x03, 0x03, 0x03, 0x26, 0x03],
+            [0x0f, 0x03, 0x03, 0x01, 0x01],
+            [0x0f, 0x03, 0x03, 0x03, 0x28, 0x03],
+            [0x0f, 0x04]
+        ]
+        print("TestMacroBuilder \n")
+        self.assertEqual(self.command_history, expected)
+        self.assertEqual(self.upload_result.n_dropped, 0)
+
+    def test_raw_commands(self):
+        long_cmd= [0x09, 0x02] + list(range(16))
+        for cmd in [[0x02, 0x01, 0x01], [0x02, 0x01, 0x01], long_cmd]:
+            self.libmetawear.mbl_mw_macro_builder_add_command(self.builder, (c_ubyte * len(cmd))(*cmd), len(cmd))
+
+        self.assertEqual(self.libmetawear.mbl_mw_macro_builder_get_size(self.builder), 3 + 3 + 2 + 14)
+        self.upload()
+
+        expected = [
+            [0x0f, 0x02, 0x01],
+            [0x0f, 0x03, 0x02, 0x01, 0x01],
+            [0x0f, 0x03, 0x02, 0x01, 0x01],
+            [0x0f, 0x09, 0x09, 0x02],
+            [0x0f, 0x03] + list(range(14)),
+            [0x0f, 0x04]
+        ]
+        print("TestMacroBuilder \n")
+        self.assertEqual(self.command_history, expected)
+
+    def test_upload_timeout(self):
+        self.schedule_response= lambda response: None
+        self.libmetawear.mbl_mw_macro_builder_add_command(self.builder, (c_ubyte * 3)(0x02, 0x01, 0x01), 3)
+
+        self.upload()
+
+        print("TestMacroBuilder \n")
+        self.assertEqual(self.command_history, [[0x0f, 0x02, 0x01]])
+        self.assertEqual(self.upload_status, Const.STATUS_ERROR_TIMEOUT)
+
+    def test_free_while_uploading(self):
+        self.schedule_response= lambda response: None
+        self.libmetawear.mbl_mw_metawearboard_set_time_for_response(self.board, 100)
+        self.libmetawear.mbl_mw_macro_builder_add_command(self.builder, (c_ubyte * 3)(0x02, 0x01, 0x01), 3)
+        self.libmetawear.mbl_mw_macro_builder_upload(self.builder, None, self.uploaded_fn)
+
+        self.libmetawear.mbl_mw_macro_builder_free(self.builder)
+        self.builder= self.libmetawear.mbl_mw_macro_builder_create(self.board, 1)
+        print("TestMacroBuilder \n")
+        self.assertFalse(self.uploaded.wait(0.3))
+
+        # the next upload is answered as usual
+        del self.schedule_response
+        self.upload()
+        self.assertEqual(self.upload_status, Const.STATUS_OK)
+
+    def test_end_not_acknowledged(self):
+        notify_mw_char= self.notify_mw_char
+        self.notify_mw_char= lambda response: None if response.raw[0:2] == b'\x0f\x80' else notify_mw_char(response)
+        self.libmetawear.mbl_mw_macro_builder_add_command(self.builder, (c_ubyte * 3)(0x02, 0x01, 0x01), 3)
+
+        self.upload()
+
+        print("TestMacroBuilder \n")
+        self.assertEqual(self.command_history, [[0x0f, 0x02, 0x01], [0x0f, 0x03, 0x02, 0x01, 0x01], [0x0f, 0x04]])
+        self.assertEqual(self.upload_status, Const.STATUS_ERROR_TIMEOUT)
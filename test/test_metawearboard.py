@@ -218,6 +218,14 @@ class TestTearDown(TestGpioFeedbackSetup):
         print("TestTearDown \n")
         self.assertEqual(tear_down_cmds, expected_cmds)
 
+    def test_summary(self):
+        summary= TearDownSummary()
+        self.libmetawear.mbl_mw_metawearboard_tear_down_with_summary(self.board, byref(summary))
+
+        print("TestTearDown \n")
+        self.assertEqual(self.command_history[22:], [[0x09, 0x08], [0x0a, 0x05], [0x0b, 0x0a]])
+        self.assertEqual(summary, TearDownSummary(n_commands= 3, n_per_object_commands= 15, n_freed= 11))
+
 class TestTimerTearDown(TestMetaWearBase):
     def timer_created(self, context, timer_signal):
         self.timerSignals.append(timer_signal)
@@ -248,6 +256,20 @@ class TestTimerTearDown(TestMetaWearBase):
         print("TestTimerTearDown \n")
         self.assertEqual(self.command_history[4:], expected_cmds)
 
+    def test_summary(self):
+        last_timer_handler = FnVoid_VoidP_VoidP(self.timer_created_last)
+        self.libmetawear.mbl_mw_timer_create(self.board, 667408, -1, 0, None, self.timer_signal_ready)
+        self.libmetawear.mbl_mw_timer_create(self.board, 1000, -1, 0, None, self.timer_signal_ready)
+        self.libmetawear.mbl_mw_timer_create(self.board, 1000, 10, 0, None, self.timer_signal_ready)
+        self.libmetawear.mbl_mw_timer_create_indefinite(self.board, 1000, 0, None, last_timer_handler)
+        self.events["timer"].wait()
+
+        summary= TearDownSummary()
+        self.libmetawear.mbl_mw_metawearboard_tear_down_with_summary(self.board, byref(summary))
+        print("TestTimerTearDown \n")
+        self.assertEqual(len(self.command_history[4:]), 7)
+        self.assertEqual(summary, TearDownSummary(n_commands= 7, n_per_object_commands= 4, n_freed= 4))
+
 class TestMetaWearBoardSerialize(TestMetaWearBase):
     motion_r_state = [
         2, 
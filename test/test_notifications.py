@@ -0,0 +1,89 @@
+from common import TestMetaWearBase
+from cbindings import *
+
+class TestBulkNotifications(TestMetaWearBase):
+    def setUp(self):
+        super().setUp()
+
+        self.received= []
+        self.data_handler_fn= FnVoid_VoidP_DataP(self.data_received)
+
+    def data_received(self, context, data):
+        value= cast(data.contents.value, POINTER(c_uint)).contents.value
+        self.received.append((context, data.contents.epoch, value))
+
+    @staticmethod
+    def to_notifications(packets, epochs= None):
+        buffers= [(c_ubyte * len(packet))(*packet) for (board, packet) in packets]
+        epochs= epochs if epochs is not None else [0] * len(packets)
+        notifications= (Notification * len(packets))(*[Notification(board= board, value= cast(buffer, POINTER(c_ubyte)), length= len(buffer), epoch= epoch) 
+                for ((board, packet), buffer, epoch) in zip(packets, buffers, epochs)])
+        return (notifications, buffers)
+
+    def test_one_board(self):
+        signal= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.board)
+        self.libmetawear.mbl_mw_datasignal_subscribe(signal, None, self.data_handler_fn)
+
+        (notifications, buffers)= TestBulkNotifications.to_notifications([(self.board, [0x01, 0x01, 0x01]), (self.board, [0x01, 0x01, 0x00]), 
+                (self.board, [0x01, 0x01, 0x01])])
+        n_unhandled= self.libmetawear.mbl_mw_metawearboard_handle_notifications(notifications, len(notifications))
+
+        self.assertEqual(n_unhandled, 0)
+        self.assertEqual([value for (context, epoch, value) in self.received], [1, 0, 1])
+        self.assertEqual(len(set([epoch for (context, epoch, value) in self.received])), 1)
+
+    def test_notification_epochs(self):
+        signal= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.board)
+        self.libmetawear.mbl_mw_datasignal_subscribe(signal, None, self.data_handler_fn)
+
+        (notifications, buffers)= TestBulkNotifications.to_notifications([(self.board, [0x01, 0x01, 0x01]), (self.board, [0x01, 0x01, 0x00]), 
+                (self.board, [0x01, 0x01, 0x01])], [1500000000000, 1500000000010, 0])
+        self.libmetawear.mbl_mw_metawearboard_handle_notifications(notifications, len(notifications))
+
+        epochs= [epoch for (context, epoch, value) in self.received]
+        self.assertEqual(epochs[0:2], [1500000000000, 1500000000010])
+        self.assertGreater(epochs[2], 1500000000010)
+
+    def test_many_boards(self):
+        # the mock answers whichever board self.board points to
+        first= self.board
+        other= self.libmetawear.mbl_mw_metawearboard_create(byref(self.btle_connection))
+        self.board= other
+        self.libmetawear.mbl_mw_metawearboard_initialize(other, None, self.initialized_fn)
+        self.board= first
+
+        boards= [self.board, other]
+        for (i, board) in enumerate(boards):
+            signal= self.libmetawear.mbl_mw_switch_get_state_data_signal(board)
+            self.libmetawear.mbl_mw_datasignal_subscribe(signal, i, self.data_handler_fn)
+
+        (notifications, buffers)= TestBulkNotifications.to_notifications([(other, [0x01, 0x01, 0x01]), (self.board, [0x01, 0x01, 0x00]), 
+                (self.board, [0x01, 0x01, 0x01]), (other, [0x01, 0x01, 0x00])])
+        n_unhandled= self.libmetawear.mbl_mw_metawearboard_handle_notifications(notifications, len(notifications))
+        self.libmetawear.mbl_mw_metawearboard_free(other)
+
+        self.assertEqual(n_unhandled, 0)
+        self.assertEqual([(context, value) for (context, epoch, value) in self.received], [(1, 1), (None, 0), (None, 1), (1, 0)])
+
+    def test_unhandled(self):
+        (notifications, buffers)= TestBulkNotifications.to_notifications([(self.board, [0x01, 0x01, 0x01]), (self.board, [0x01]), 
+                (self.board, [0x7f, 0x01, 0x00])])
+        n_unhandled= self.libmetawear.mbl_mw_metawearboard_handle_notifications(notifications, len(notifications))
+
+        self.assertEqual(n_unhandled, 3)
+        self.assertEqual(self.received, [])
+
+    def test_matches_single_notifications(self):
+        signal= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.board)
+        self.libmetawear.mbl_mw_datasignal_subscribe(signal, None, self.data_handler_fn)
+
+        packets= [[0x01, 0x01, i % 2] for i in range(0, 16)]
+        for packet in packets:
+            self.notify_mw_char(create_string_buffer(bytes(packet), len(packet)))
+        single= [value for (context, epoch, value) in self.received]
+
+        self.received= []
+        (notifications, buffers)= TestBulkNotifications.to_notifications([(self.board, packet) for packet in packets])
+        self.libmetawear.mbl_mw_metawearboard_handle_notifications(notifications, len(notifications))
+
+        self.assertEqual([value for (context, epoch, value) in self.received], single)
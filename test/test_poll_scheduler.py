@@ -0,0 +1,114 @@
+from common import TestMetaWearBase
+from cbindings import *
+from threading import Event
+import os
+import threading
+import time
+
+def n_threads():
+    return len(os.listdir('/proc/self/task'))
+
+class TestPollScheduler(TestMetaWearBase):
+    def setUp(self):
+        self.now= 1000
+        self.clock_fn= FnLong_VoidP(lambda context: self.now)
+        self.scheduler= self.libmetawear.mbl_mw_poll_scheduler_create(None, self.clock_fn)
+
+        self.board= self.libmetawear.mbl_mw_metawearboard_create(byref(self.btle_connection))
+        self.libmetawear.mbl_mw_poll_scheduler_add_board(self.scheduler, self.board)
+        self.libmetawear.mbl_mw_metawearboard_initialize(self.board, None, self.initialized_fn)
+        self.libmetawear.mbl_mw_metawearboard_set_time_for_response(self.board, 200)
+
+        self.created= []
+        self.created_threads= []
+        self.created_event= Event()
+        self.timer_fn= FnVoid_VoidP_VoidP(self.timer_created)
+
+    def tearDown(self):
+        if self.scheduler is not None:
+            self.libmetawear.mbl_mw_poll_scheduler_free(self.scheduler)
+
+    def commandLogger(self, context, board, writeType, characteristic, command, length):
+        # timer create responses are sent by the test
+        if length >= 2 and command[0] == 0x0c and command[1] == 0x02:
+            return
+        super().commandLogger(context, board, writeType, characteristic, command, length)
+
+    def timer_created(self, context, timer):
+        self.created.append(timer)
+        self.created_threads.append(threading.get_ident())
+        self.created_event.set()
+
+    def create_timer(self):
+        self.libmetawear.mbl_mw_timer_create(self.board, 1000, 0, 0, None, self.timer_fn)
+
+    def test_initialized(self):
+        self.assertEqual(self.libmetawear.mbl_mw_poll_scheduler_next_deadline(self.scheduler), -1)
+
+    def test_now(self):
+        self.now= 1234
+        self.assertEqual(self.libmetawear.mbl_mw_poll_scheduler_now(self.scheduler), 1234)
+
+    def test_timeout_waits_for_process(self):
+        self.create_timer()
+        self.assertEqual(self.libmetawear.mbl_mw_poll_scheduler_next_deadline(self.scheduler), 1200)
+
+        self.now= 5000
+        self.assertEqual(self.libmetawear.mbl_mw_poll_scheduler_process_timeouts(self.scheduler, 1199), 0)
+        self.assertEqual(self.created, [])
+
+        self.assertEqual(self.libmetawear.mbl_mw_poll_scheduler_process_timeouts(self.scheduler, 1200), 1)
+        self.assertEqual(self.created, [None])
+        self.assertEqual(self.created_threads, [threading.get_ident()])
+        self.assertEqual(self.libmetawear.mbl_mw_poll_scheduler_next_deadline(self.scheduler), -1)
+
+    def test_response_cancels(self):
+        self.create_timer()
+        self.notify_mw_char(create_string_buffer(b'\x0c\x02\x00', 3))
+
+        self.assertEqual(self.libmetawear.mbl_mw_poll_scheduler_next_deadline(self.scheduler), -1)
+        self.assertEqual(self.libmetawear.mbl_mw_poll_scheduler_process_timeouts(self.scheduler, 10000), 0)
+        self.assertEqual(len(self.created), 1)
+        self.assertIsNotNone(self.created[0])
+
+    def test_queued_creates(self):
+        # the second timer is only created once the first one times out
+        self.create_timer()
+        self.create_timer()
+        self.assertEqual(self.libmetawear.mbl_mw_poll_scheduler_next_deadline(self.scheduler), 1200)
+
+        self.now= 1200
+        self.assertEqual(self.libmetawear.mbl_mw_poll_scheduler_process_timeouts(self.scheduler, self.now), 1)
+        self.assertEqual(self.libmetawear.mbl_mw_poll_scheduler_next_deadline(self.scheduler), 1400)
+
+        self.now= 1400
+        self.assertEqual(self.libmetawear.mbl_mw_poll_scheduler_process_timeouts(self.scheduler, self.now), 1)
+        self.assertEqual(self.created, [None, None])
+
+    def test_no_threads(self):
+        before= n_threads()
+        self.create_timer()
+        self.assertEqual(n_threads(), before)
+        self.libmetawear.mbl_mw_poll_scheduler_process_timeouts(self.scheduler, 1200)
+
+        # removed boards go back to a thread per timeout
+        self.libmetawear.mbl_mw_poll_scheduler_remove_board(self.scheduler, self.board)
+        self.created_event.clear()
+        self.create_timer()
+        self.assertEqual(n_threads(), before + 1)
+        self.assertTrue(self.created_event.wait(5))
+
+    def test_free_moves_timeouts(self):
+        self.create_timer()
+        self.libmetawear.mbl_mw_poll_scheduler_free(self.scheduler)
+        self.scheduler= None
+
+        self.assertTrue(self.created_event.wait(5))
+        self.assertEqual(self.created, [None])
+
+    def test_default_clock(self):
+        scheduler= self.libmetawear.mbl_mw_poll_scheduler_create(None, cast(None, FnLong_VoidP))
+        now= self.libmetawear.mbl_mw_poll_scheduler_now(scheduler)
+        self.libmetawear.mbl_mw_poll_scheduler_free(scheduler)
+
+        self.assertLess(abs(now - time.monotonic() * 1000), 1000)
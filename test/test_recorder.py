@@ -0,0 +1,145 @@
+from common import TestMetaWearBase
+from cbindings import *
+from ctypes import create_string_buffer
+import os
+import struct
+import tempfile
+import zlib
+
+HEADER_FORMAT= '<8sIIiBBH40x'
+INDEX_FORMAT= '<QIIqq'
+TRAILER_FORMAT= '<QII8s'
+
+class RecordingFile:
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.raw= f.read()
+
+        (self.magic, self.version, self.chunk_rows, self.type_id, self.n_columns, self.column_width, self.flags)= struct.unpack_from(HEADER_FORMAT, self.raw, 0)
+        (index_offset, n_chunks, _, self.index_magic)= struct.unpack_from(TRAILER_FORMAT, self.raw, len(self.raw) - struct.calcsize(TRAILER_FORMAT))
+        self.index= [struct.unpack_from(INDEX_FORMAT, self.raw, index_offset + i * struct.calcsize(INDEX_FORMAT)) for i in range(n_chunks)]
+
+    def column_stride(self):
+        return (self.column_width * self.chunk_rows + 7) & ~7
+
+    def chunk(self, chunk):
+        (offset, _, size, _, _)= self.index[chunk]
+        contents= self.raw[offset:offset + size]
+        return zlib.decompress(contents) if self.flags & RecorderFlag.COMPRESS else contents
+
+    def epochs(self, chunk):
+        return list(struct.unpack_from('<%dq' % self.index[chunk][1], self.chunk(chunk), 0))
+
+    def column(self, chunk, i, fmt):
+        return list(struct.unpack_from('<%d%s' % (self.index[chunk][1], fmt), self.chunk(chunk), 8 * self.chunk_rows + i * self.column_stride()))
+
+class TestRecorder(TestMetaWearBase):
+    def setUp(self):
+        self.boardType= TestMetaWearBase.METAWEAR_RG_BOARD
+
+        super().setUp()
+
+        fd, self.path= tempfile.mkstemp(suffix= '.mwrec')
+        os.close(fd)
+
+    def tearDown(self):
+        super().tearDown()
+        os.remove(self.path)
+
+    def test_empty_recording(self):
+        recorder= self.libmetawear.mbl_mw_recorder_create(self.path.encode(), 16)
+        self.assertEqual(self.libmetawear.mbl_mw_recorder_close(recorder), Const.STATUS_OK)
+
+        recording= RecordingFile(self.path)
+        self.assertEqual(recording.magic, b'MBLMWREC')
+        self.assertEqual(recording.index_magic, b'MBLMWIDX')
+        self.assertEqual(recording.type_id, -1)
+        self.assertEqual(recording.index, [])
+
+    def test_invalid_chunk_rows(self):
+        self.assertIsNone(self.libmetawear.mbl_mw_recorder_create(self.path.encode(), 0))
+
+    def test_switch_columns(self):
+        recorder= self.libmetawear.mbl_mw_recorder_create(self.path.encode(), 4)
+        signal= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.board)
+        self.libmetawear.mbl_mw_datasignal_record(signal, recorder)
+
+        for i in range(10):
+            self.notify_mw_char(create_string_buffer(b'\x01\x01' + bytes([i & 0x1]), 3))
+        self.assertEqual(self.libmetawear.mbl_mw_recorder_close(recorder), Const.STATUS_OK)
+
+        recording= RecordingFile(self.path)
+        self.assertEqual((recording.type_id, recording.n_columns, recording.column_width, recording.chunk_rows), (DataTypeId.UINT32, 1, 4, 4))
+        self.assertEqual([entry[1] for entry in recording.index], [4, 4, 2])
+
+        values= []
+        for chunk in range(len(recording.index)):
+            self.assertEqual(recording.epochs(chunk)[0], recording.index[chunk][3])
+            self.assertEqual(recording.epochs(chunk)[-1], recording.index[chunk][4])
+            values+= recording.column(chunk, 0, 'I')
+        self.assertEqual(values, [i & 0x1 for i in range(10)])
+
+    def test_acceleration_columns(self):
+        recorder= self.libmetawear.mbl_mw_recorder_create(self.path.encode(), 64)
+        signal= self.libmetawear.mbl_mw_acc_bosch_get_acceleration_data_signal(self.board)
+        self.libmetawear.mbl_mw_acc_bosch_set_range(self.board, AccBoschRange._4G)
+        self.libmetawear.mbl_mw_datasignal_record(signal, recorder)
+
+        self.notify_mw_char(create_string_buffer(b'\x03\x04\x16\xc4\x94\xa2\x2a\xd0'))
+        self.notify_mw_char(create_string_buffer(b'\x03\x04\x00\x00\x00\x00\x00\x20'))
+        self.assertEqual(self.libmetawear.mbl_mw_recorder_flush(recorder), Const.STATUS_OK)
+        self.libmetawear.mbl_mw_datasignal_unsubscribe(signal)
+        self.assertEqual(self.libmetawear.mbl_mw_recorder_close(recorder), Const.STATUS_OK)
+
+        recording= RecordingFile(self.path)
+        self.assertEqual((recording.type_id, recording.n_columns, recording.column_width), (DataTypeId.CARTESIAN_FLOAT, 3, 4))
+        self.assertEqual(len(recording.index), 1)
+
+        expected= [[-1.872, 0.0], [-2.919, 0.0], [-1.495, 1.0]]
+        for i in range(3):
+            actual= recording.column(0, i, 'f')
+            self.assertTrue(all(is_close(a, e) for a, e in zip(actual, expected[i])), "column %d: %s" % (i, actual))
+
+    def test_mismatched_type_dropped(self):
+        recorder= self.libmetawear.mbl_mw_recorder_create(self.path.encode(), 8)
+        data= [Data(epoch= 1000, value= cast(pointer(c_uint(5)), c_void_p), type_id= DataTypeId.UINT32, length= 4),
+            Data(epoch= 1010, value= cast(pointer(c_float(1.5)), c_void_p), type_id= DataTypeId.FLOAT, length= 4),
+            Data(epoch= 1020, value= cast(pointer(c_uint(7)), c_void_p), type_id= DataTypeId.UINT32, length= 4)]
+        for it in data:
+            self.libmetawear.mbl_mw_recorder_write(recorder, byref(it))
+
+        self.assertEqual(self.libmetawear.mbl_mw_recorder_get_dropped(recorder), 1)
+        self.assertEqual(self.libmetawear.mbl_mw_recorder_close(recorder), Const.STATUS_OK)
+
+        recording= RecordingFile(self.path)
+        self.assertEqual(recording.epochs(0), [1000, 1020])
+        self.assertEqual(recording.column(0, 0, 'I'), [5, 7])
+        self.assertEqual(recording.index[0][3:], (1000, 1020))
+
+    def test_compressed_delta_columns(self):
+        recorder= self.libmetawear.mbl_mw_recorder_create_with_flags(self.path.encode(), 256, RecorderFlag.COMPRESS | RecorderFlag.DELTA_ENCODE)
+        for i in range(300):
+            data= Data(epoch= 1000 + 20 * i, value= cast(pointer(c_uint(100 + 3 * i)), c_void_p), type_id= DataTypeId.UINT32, length= 4)
+            self.libmetawear.mbl_mw_recorder_write(recorder, byref(data))
+        self.assertEqual(self.libmetawear.mbl_mw_recorder_close(recorder), Const.STATUS_OK)
+
+        recording= RecordingFile(self.path)
+        self.assertEqual(recording.flags, RecorderFlag.COMPRESS | RecorderFlag.DELTA_ENCODE)
+        self.assertEqual([entry[1] for entry in recording.index], [256, 44])
+        self.assertLess(recording.index[0][2], 256 * 12 // 4)
+
+        self.assertEqual(recording.epochs(0)[:3], [1000, 20, 20])
+        self.assertEqual(recording.column(0, 0, 'I')[:3], [100, 3, 3])
+        self.assertEqual(recording.epochs(1)[0], 1000 + 20 * 256)
+        self.assertEqual(recording.index[1][3:], (1000 + 20 * 256, 1000 + 20 * 299))
+
+    def test_compressed_float_columns(self):
+        recorder= self.libmetawear.mbl_mw_recorder_create_with_flags(self.path.encode(), 8, RecorderFlag.COMPRESS | RecorderFlag.DELTA_ENCODE)
+        for i in range(3):
+            data= Data(epoch= 1000 + i, value= cast(pointer(c_float(0.5 * i)), c_void_p), type_id= DataTypeId.FLOAT, length= 4)
+            self.libmetawear.mbl_mw_recorder_write(recorder, byref(data))
+        self.assertEqual(self.libmetawear.mbl_mw_recorder_close(recorder), Const.STATUS_OK)
+
+        recording= RecordingFile(self.path)
+        self.assertEqual(recording.epochs(0), [1000, 1, 1])
+        self.assertEqual(recording.column(0, 0, 'f'), [0.0, 0.5, 1.0])
@@ -93,3 +93,76 @@ class TestSensorFusionConfig(TestMetaWearBase):
                 ]
                 print("TestSensorFusionConfig \n")
                 self.assertEqual(self.command_history, expected)
+
+class TestSensorFusionChangedConfig(TestMetaWearBase):
+    def setUp(self):
+        self.boardType = TestMetaWearBase.METAWEAR_MOTION_R_BOARD
+
+        super().setUp()
+
+        self.libmetawear.mbl_mw_metawearboard_set_config_write_mode(self.board, ConfigWriteMode.CHANGED)
+
+    def configure_algorithm(self, mode, acc, gyro):
+        self.command_history = []
+        self.libmetawear.mbl_mw_sensor_fusion_set_mode(self.board, mode)
+        self.libmetawear.mbl_mw_sensor_fusion_set_acc_range(self.board, acc)
+        self.libmetawear.mbl_mw_sensor_fusion_set_gyro_range(self.board, gyro)
+        self.libmetawear.mbl_mw_sensor_fusion_write_config(self.board)
+        return self.command_history
+
+    def test_rewrite_unchanged(self):
+        first = self.configure_algorithm(SensorFusionMode.NDOF, SensorFusionAccRange._8G, SensorFusionGyroRange._500DPS)
+        second = self.configure_algorithm(SensorFusionMode.NDOF, SensorFusionAccRange._8G, SensorFusionGyroRange._500DPS)
+
+        print("TestSensorFusionChangedConfig \n")
+        self.assertEqual((len(first), len(second)), (5, 0))
+
+    def test_acc_range_changed(self):
+        self.configure_algorithm(SensorFusionMode.NDOF, SensorFusionAccRange._8G, SensorFusionGyroRange._500DPS)
+        expected = [
+            [0x19, 0x02, SensorFusionMode.NDOF, 0x33],
+            [0x03, 0x03, 0x28, 0x0c]
+        ]
+
+        print("TestSensorFusionChangedConfig \n")
+        self.assertEqual(self.configure_algorithm(SensorFusionMode.NDOF, SensorFusionAccRange._16G, SensorFusionGyroRange._500DPS), expected)
+
+    def test_mode_changed(self):
+        self.configure_algorithm(SensorFusionMode.NDOF, SensorFusionAccRange._8G, SensorFusionGyroRange._500DPS)
+        expected = [
+            [0x19, 0x02, SensorFusionMode.IMU_PLUS, 0x32]
+        ]
+
+        print("TestSensorFusionChangedConfig \n")
+        self.assertEqual(self.configure_algorithm(SensorFusionMode.IMU_PLUS, SensorFusionAccRange._8G, SensorFusionGyroRange._500DPS), expected)
+
+    def test_force_full_write(self):
+        self.configure_algorithm(SensorFusionMode.NDOF, SensorFusionAccRange._8G, SensorFusionGyroRange._500DPS)
+        self.libmetawear.mbl_mw_metawearboard_set_config_write_mode(self.board, ConfigWriteMode.ALL)
+
+        print("TestSensorFusionChangedConfig \n")
+        self.assertEqual(len(self.configure_algorithm(SensorFusionMode.NDOF, SensorFusionAccRange._8G, SensorFusionGyroRange._500DPS)), 5)
+
+    def test_initialize_resends(self):
+        self.configure_algorithm(SensorFusionMode.NDOF, SensorFusionAccRange._8G, SensorFusionGyroRange._500DPS)
+        self.libmetawear.mbl_mw_debug_reset(self.board)
+
+        print("TestSensorFusionChangedConfig \n")
+        self.assertEqual(len(self.configure_algorithm(SensorFusionMode.NDOF, SensorFusionAccRange._8G, SensorFusionGyroRange._500DPS)), 5)
+
+class TestSensorFusionDefaultWriteMode(TestMetaWearBase):
+    def setUp(self):
+        self.boardType = TestMetaWearBase.METAWEAR_MOTION_R_BOARD
+
+        super().setUp()
+
+    def test_rewrite_unchanged(self):
+        counts = []
+        for i in range(2):
+            self.command_history = []
+            self.libmetawear.mbl_mw_sensor_fusion_set_mode(self.board, SensorFusionMode.NDOF)
+            self.libmetawear.mbl_mw_sensor_fusion_write_config(self.board)
+            counts.append(len(self.command_history))
+
+        print("TestSensorFusionDefaultWriteMode \n")
+        self.assertEqual(counts, [5, 5])
@@ -0,0 +1,96 @@
+from common import TestMetaWearBase
+from cbindings import *
+from threading import Event, Thread
+import threading
+import time
+
+class TestSerializationBase(TestMetaWearBase):
+    def setUp(self):
+        self.board= self.libmetawear.mbl_mw_metawearboard_create(byref(self.btle_connection))
+        if self.serialized:
+            self.libmetawear.mbl_mw_metawearboard_enable_serialization(self.board)
+        self.libmetawear.mbl_mw_metawearboard_initialize(self.board, None, self.initialized_fn)
+
+        self.received= []
+        self.data_handler_fn= FnVoid_VoidP_DataP(lambda context, data: self.received.append(time.perf_counter()))
+
+    def notify_during_execute(self):
+        # another thread holds the board in execute while a notification arrives
+        signal= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.board)
+        self.libmetawear.mbl_mw_datasignal_subscribe(signal, None, self.data_handler_fn)
+
+        entered= Event()
+        exited= []
+        def hold(context, board):
+            entered.set()
+            time.sleep(0.2)
+            exited.append(time.perf_counter())
+        fn= FnVoid_VoidP_VoidP(hold)
+
+        holder= Thread(target= lambda: self.libmetawear.mbl_mw_metawearboard_execute(self.board, None, fn))
+        holder.start()
+        self.assertTrue(entered.wait(5))
+        self.notify_mw_char(create_string_buffer(b'\x01\x01\x01', 3))
+        holder.join()
+
+        self.assertEqual(len(self.received), 1)
+        return self.received[0] - exited[0]
+
+class TestSerialization(TestSerializationBase):
+    serialized= True
+
+    def commandLogger(self, context, board, writeType, characteristic, command, length):
+        # timer create responses are sent by the test
+        if length >= 2 and command[0] == 0x0c and command[1] == 0x02:
+            return
+        super().commandLogger(context, board, writeType, characteristic, command, length)
+
+    def test_execute(self):
+        calls= []
+        fn= FnVoid_VoidP_VoidP(lambda context, board: calls.append((context, board, threading.get_ident())))
+        self.libmetawear.mbl_mw_metawearboard_execute(self.board, 42, fn)
+
+        self.assertEqual(calls, [(42, self.board, threading.get_ident())])
+
+    def test_notification_waits(self):
+        self.assertGreaterEqual(self.notify_during_execute(), 0)
+
+    def test_callback_reenters(self):
+        # callbacks hold the board's lock, calling back into the api from them does not deadlock
+        done= Event()
+        def received(context, data):
+            self.libmetawear.mbl_mw_led_stop(self.board)
+            done.set()
+        handler= FnVoid_VoidP_DataP(received)
+        signal= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.board)
+        self.libmetawear.mbl_mw_datasignal_subscribe(signal, None, handler)
+
+        notifier= Thread(target= lambda: self.notify_mw_char(create_string_buffer(b'\x01\x01\x01', 3)))
+        notifier.start()
+        notifier.join(5)
+
+        self.assertTrue(done.is_set())
+        self.assertEqual(self.command, [0x02, 0x02, 0x00])
+
+    def test_cancelled_timeout(self):
+        created= []
+        timer_fn= FnVoid_VoidP_VoidP(lambda context, timer: created.append(timer))
+        def create(context, board):
+            self.libmetawear.mbl_mw_timer_create(board, 1000, 0, 0, None, timer_fn)
+            # the timeout fires while the board is held, the response arrives before it can run
+            time.sleep(0.1)
+            self.notify_mw_char(create_string_buffer(b'\x0c\x02\x00', 3))
+        fn= FnVoid_VoidP_VoidP(create)
+
+        self.libmetawear.mbl_mw_metawearboard_set_time_for_response(self.board, 10)
+        self.libmetawear.mbl_mw_metawearboard_execute(self.board, None, fn)
+        time.sleep(0.1)
+
+        self.assertEqual(len(created), 1)
+        self.assertIsNotNone(created[0])
+
+class TestNoSerialization(TestSerializationBase):
+    serialized= False
+
+    def test_notification_does_not_wait(self):
+        self.assertLess(self.notify_during_execute(), 0)
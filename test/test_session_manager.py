@@ -0,0 +1,186 @@
+from common import TestMetaWearBase
+from cbindings import *
+from threading import Event, Lock
+import threading
+import time
+
+class TestSessionManager(TestMetaWearBase):
+    def setUp(self):
+        super().setUp()
+
+        self.manager= None
+        self.boards= []
+        self.lock= Lock()
+        self.done= Event()
+        self.remaining= 0
+
+    def tearDown(self):
+        for board in self.boards:
+            self.libmetawear.mbl_mw_session_manager_remove_board(self.manager, board)
+            self.libmetawear.mbl_mw_metawearboard_free(board)
+        if self.manager is not None:
+            self.libmetawear.mbl_mw_session_manager_free(self.manager)
+        super().tearDown()
+
+    def create(self, n_workers, n_boards):
+        self.manager= self.libmetawear.mbl_mw_session_manager_create(n_workers)
+        for i in range(n_boards):
+            board= self.libmetawear.mbl_mw_metawearboard_create(byref(self.btle_connection))
+            self.libmetawear.mbl_mw_session_manager_add_board(self.manager, board)
+            self.boards.append(board)
+
+    def expect(self, n):
+        self.remaining= n
+        self.done.clear()
+
+    def finished(self):
+        with self.lock:
+            self.remaining-= 1
+            if self.remaining == 0:
+                self.done.set()
+
+    def test_n_workers(self):
+        self.manager= self.libmetawear.mbl_mw_session_manager_create(3)
+        self.assertEqual(self.libmetawear.mbl_mw_session_manager_get_n_workers(self.manager), 3)
+
+    def test_strand_order(self):
+        n_tasks= 200
+        self.create(4, 16)
+
+        runs= {i: [] for i in range(len(self.boards))}
+        threads= set()
+        def run(context):
+            (board, seq)= divmod(context or 0, n_tasks)
+            runs[board].append(seq)
+            threads.add(threading.get_ident())
+            self.finished()
+        fn= FnVoid_VoidP(run)
+
+        self.expect(n_tasks * len(self.boards))
+        for seq in range(n_tasks):
+            for (i, board) in enumerate(self.boards):
+                self.libmetawear.mbl_mw_session_manager_post(self.manager, board, i * n_tasks + seq, fn)
+        self.assertTrue(self.done.wait(30))
+
+        for i in range(len(self.boards)):
+            self.assertEqual(runs[i], list(range(n_tasks)))
+        self.assertLessEqual(len(threads), 4)
+        self.assertNotIn(threading.get_ident(), threads)
+
+    def test_work_stealing(self):
+        # boards are assigned round robin, the first and third board share a worker
+        self.create(2, 4)
+
+        threads= []
+        def run(context):
+            threads.append(threading.get_ident())
+            time.sleep(0.2)
+            self.finished()
+        fn= FnVoid_VoidP(run)
+
+        self.expect(2)
+        start= time.perf_counter()
+        self.libmetawear.mbl_mw_session_manager_post(self.manager, self.boards[0], None, fn)
+        self.libmetawear.mbl_mw_session_manager_post(self.manager, self.boards[2], None, fn)
+        self.assertTrue(self.done.wait(5))
+        elapsed= time.perf_counter() - start
+
+        self.assertEqual(len(set(threads)), 2)
+        self.assertLess(elapsed, 0.35)
+
+    def test_submit(self):
+        self.create(4, 0)
+
+        threads= set()
+        def run(context):
+            threads.add(threading.get_ident())
+            time.sleep(0.1)
+            self.finished()
+        fn= FnVoid_VoidP(run)
+
+        self.expect(8)
+        start= time.perf_counter()
+        for i in range(8):
+            self.libmetawear.mbl_mw_session_manager_submit(self.manager, None, fn)
+        self.assertTrue(self.done.wait(5))
+        elapsed= time.perf_counter() - start
+
+        self.assertLessEqual(len(threads), 4)
+        self.assertLess(elapsed, 0.35)
+
+    def test_notifications(self):
+        self.manager= self.libmetawear.mbl_mw_session_manager_create(2)
+        self.libmetawear.mbl_mw_session_manager_add_board(self.manager, self.board)
+
+        values= []
+        threads= set()
+        def received(context, data):
+            values.append(cast(data.contents.value, POINTER(c_uint)).contents.value)
+            threads.add(threading.get_ident())
+            self.finished()
+        handler= FnVoid_VoidP_DataP(received)
+        signal= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.board)
+        self.libmetawear.mbl_mw_datasignal_subscribe(signal, None, handler)
+
+        n= 64
+        self.expect(n)
+        buffer= (c_ubyte * 3)(0x01, 0x01, 0x00)
+        notification= (Notification * 1)(Notification(board= self.board, value= cast(buffer, POINTER(c_ubyte)), length= 3))
+        for i in range(n):
+            # the manager copies the value, the buffer can be reused right away
+            buffer[2]= i & 0x1
+            self.libmetawear.mbl_mw_session_manager_handle_notifications(self.manager, notification, 1)
+        self.assertTrue(self.done.wait(5))
+
+        self.libmetawear.mbl_mw_session_manager_remove_board(self.manager, self.board)
+        self.assertEqual(values, [i & 0x1 for i in range(n)])
+        self.assertNotIn(threading.get_ident(), threads)
+
+class TestSessionManagerTimeout(TestMetaWearBase):
+    def setUp(self):
+        # the silent board never answers reads, initialization can only finish by timing out
+        self.silent_read_fn= FnVoid_VoidP_VoidP_GattCharP_FnIntVoidPtrArray(lambda context, board, characteristic, handler: None)
+        self.silent_connection= BtleConnection(context= None, write_gatt_char= self.send_command_fn, read_gatt_char= self.silent_read_fn,
+                enable_notifications= self.enable_gatt_notify_fn, on_disconnect= self.on_disconnect_fn)
+
+        self.init_threads= []
+        self.init_status= []
+        self.init_done= Event()
+        self.silent_initialized_fn= FnVoid_VoidP_VoidP_Int(self.silent_initialized)
+
+        self.manager= self.libmetawear.mbl_mw_session_manager_create(1)
+        self.silent= self.libmetawear.mbl_mw_metawearboard_create(byref(self.silent_connection))
+        self.libmetawear.mbl_mw_metawearboard_set_time_for_response(self.silent, 10)
+
+    def tearDown(self):
+        if self.manager is not None:
+            self.libmetawear.mbl_mw_session_manager_remove_board(self.manager, self.silent)
+            self.libmetawear.mbl_mw_session_manager_free(self.manager)
+        self.libmetawear.mbl_mw_metawearboard_free(self.silent)
+
+    def silent_initialized(self, context, board, status):
+        self.init_threads.append(threading.get_ident())
+        self.init_status.append(status)
+        self.init_done.set()
+
+    def test_timeout_on_worker(self):
+        worker= []
+        fn= FnVoid_VoidP(lambda context: worker.append(threading.get_ident()))
+        self.libmetawear.mbl_mw_session_manager_submit(self.manager, None, fn)
+
+        self.libmetawear.mbl_mw_session_manager_add_board(self.manager, self.silent)
+        self.libmetawear.mbl_mw_metawearboard_initialize(self.silent, None, self.silent_initialized_fn)
+        self.assertTrue(self.init_done.wait(5))
+
+        self.assertEqual(self.init_status, [Const.STATUS_ERROR_TIMEOUT])
+        self.assertEqual(self.init_threads, worker)
+
+    def test_free_keeps_timeouts(self):
+        self.libmetawear.mbl_mw_session_manager_add_board(self.manager, self.silent)
+        self.libmetawear.mbl_mw_metawearboard_set_time_for_response(self.silent, 50)
+        self.libmetawear.mbl_mw_metawearboard_initialize(self.silent, None, self.silent_initialized_fn)
+        self.libmetawear.mbl_mw_session_manager_free(self.manager)
+        self.manager= None
+
+        self.assertTrue(self.init_done.wait(5))
+        self.assertEqual(self.init_status, [Const.STATUS_ERROR_TIMEOUT])
@@ -0,0 +1,68 @@
+from common import TestMetaWearBase
+from cbindings import *
+from ctypes import create_string_buffer
+import os
+
+class TestShmPublisher(TestMetaWearBase):
+    def setUp(self):
+        super().setUp()
+
+        self.name= ("/metawear-test-%d" % os.getpid()).encode()
+        self.publisher= self.libmetawear.mbl_mw_shm_publisher_create(self.name, 6)
+        self.reader= self.libmetawear.mbl_mw_shm_reader_open(self.name)
+
+    def tearDown(self):
+        self.libmetawear.mbl_mw_shm_reader_close(self.reader)
+        self.libmetawear.mbl_mw_shm_publisher_close(self.publisher)
+        super().tearDown()
+
+    def read_all(self, reader):
+        values= []
+        data= Data()
+        while self.libmetawear.mbl_mw_shm_reader_next(reader, byref(data)) == 1:
+            values.append((data.epoch, data.type_id, cast(data.value, POINTER(c_uint)).contents.value))
+        return values
+
+    def publish_uint32(self, epoch, value):
+        data= Data(epoch= epoch, value= cast(pointer(c_uint(value)), c_void_p), type_id= DataTypeId.UINT32, length= 4)
+        self.libmetawear.mbl_mw_shm_publisher_write(self.publisher, byref(data))
+
+    def test_open_missing(self):
+        self.assertIsNone(self.libmetawear.mbl_mw_shm_reader_open(b'/metawear-test-missing'))
+
+    def test_signal_fan_out(self):
+        second= self.libmetawear.mbl_mw_shm_reader_open(self.name)
+        signal= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.board)
+        self.libmetawear.mbl_mw_datasignal_publish(signal, self.publisher)
+
+        self.notify_mw_char(create_string_buffer(b'\x01\x01\x01', 3))
+        self.notify_mw_char(create_string_buffer(b'\x01\x01\x00', 3))
+
+        for reader in [self.reader, second]:
+            self.assertEqual([(type_id, value) for (_, type_id, value) in self.read_all(reader)], [(DataTypeId.UINT32, 1), (DataTypeId.UINT32, 0)])
+        self.libmetawear.mbl_mw_shm_reader_close(second)
+
+    def test_late_reader(self):
+        self.publish_uint32(1000, 1)
+        late= self.libmetawear.mbl_mw_shm_reader_open(self.name)
+        self.publish_uint32(1010, 2)
+
+        self.assertEqual(self.read_all(late), [(1010, DataTypeId.UINT32, 2)])
+        self.assertEqual(self.read_all(self.reader), [(1000, DataTypeId.UINT32, 1), (1010, DataTypeId.UINT32, 2)])
+        self.libmetawear.mbl_mw_shm_reader_close(late)
+
+    def test_overrun(self):
+        # capacity of 6 is rounded up to 8 samples
+        for i in range(20):
+            self.publish_uint32(1000 + i, i)
+
+        self.assertEqual([value for (_, _, value) in self.read_all(self.reader)], list(range(12, 20)))
+        self.assertEqual(self.libmetawear.mbl_mw_shm_reader_get_dropped(self.reader), 12)
+
+    def test_oversized_dropped(self):
+        value= (c_ubyte * 64)()
+        data= Data(epoch= 1000, value= cast(value, c_void_p), type_id= DataTypeId.BYTE_ARRAY, length= 64)
+        self.libmetawear.mbl_mw_shm_publisher_write(self.publisher, byref(data))
+        self.publish_uint32(1010, 5)
+
+        self.assertEqual(self.read_all(self.reader), [(1010, DataTypeId.UINT32, 5)])
@@ -0,0 +1,177 @@
+from common import TestMetaWearBase
+from cbindings import *
+from threading import Event
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+PEER_SCRIPT= os.path.join(os.path.dirname(os.path.abspath(__file__)), 'socket_peer.py')
+
+class TestSocketConnection(TestMetaWearBase):
+    def setUp(self):
+        # in process board, answered by the mock, to compare against
+        super().setUp()
+
+        self.tmpdir= tempfile.TemporaryDirectory()
+        self.path= os.path.join(self.tmpdir.name, 'peer.sock')
+        self.peer= None
+        self.connection= None
+        self.socket_board= None
+
+        self.socket_initialized= Event()
+        self.socket_initialized_fn= FnVoid_VoidP_VoidP_Int(self.socket_board_initialized)
+        self.received= 0
+        self.all_received= Event()
+        self.data_handler_fn= FnVoid_VoidP_DataP(self.data_received)
+
+    def tearDown(self):
+        if self.connection is not None:
+            self.libmetawear.mbl_mw_socket_connection_close(self.connection)
+        if self.socket_board is not None:
+            self.libmetawear.mbl_mw_metawearboard_free(self.socket_board)
+        if self.peer is not None:
+            self.peer.wait(10)
+        self.tmpdir.cleanup()
+        super().tearDown()
+
+    def commandLogger(self, context, board, writeType, characteristic, command, length):
+        # answer temperature reads right away, like the peer does
+        if length == 3 and command[0] == 0x04 and command[1] == 0x81:
+            self.notify_mw_char(create_string_buffer(bytes([0x04, 0x81, command[2], 0x00, 0x01]), 5))
+        else:
+            super().commandLogger(context, board, writeType, characteristic, command, length)
+
+    def socket_board_initialized(self, context, board, status):
+        self.socket_init_status= status
+        self.socket_initialized.set()
+
+    def data_received(self, context, data):
+        self.received+= 1
+        if self.received == self.expected:
+            self.all_received.set()
+
+    def start_peer(self, *args):
+        self.peer= subprocess.Popen([sys.executable, PEER_SCRIPT, self.path] + list(args), stdout= subprocess.PIPE, universal_newlines= True)
+        self.assertEqual(self.peer.stdout.readline().strip(), 'ready')
+
+        self.connection= self.libmetawear.mbl_mw_socket_connection_open(self.path.encode('ascii'), b'F1:4A:45:90:AC:9D')
+        self.assertIsNotNone(self.connection)
+        self.socket_board= self.libmetawear.mbl_mw_metawearboard_create(self.libmetawear.mbl_mw_socket_connection_get_btle_connection(self.connection))
+        self.libmetawear.mbl_mw_metawearboard_set_write_gatt_chars(self.socket_board, self.libmetawear.mbl_mw_socket_connection_get_write_gatt_chars(self.connection))
+        self.libmetawear.mbl_mw_metawearboard_initialize(self.socket_board, None, self.socket_initialized_fn)
+        self.assertTrue(self.socket_initialized.wait(10))
+        self.assertEqual(self.socket_init_status, Const.STATUS_OK)
+
+    def close_peer(self):
+        self.libmetawear.mbl_mw_socket_connection_close(self.connection)
+        self.connection= None
+        self.peer.wait(10)
+
+    def read_temperature(self, board, n):
+        # reads one at a time, each read waits on the previous response
+        done= Event()
+        handler= FnVoid_VoidP_DataP(lambda context, data: done.set())
+
+        signal= self.libmetawear.mbl_mw_multi_chnl_temp_get_temperature_data_signal(board, 0)
+        self.libmetawear.mbl_mw_datasignal_subscribe(signal, None, handler)
+        start= time.perf_counter()
+        for i in range(n):
+            done.clear()
+            self.libmetawear.mbl_mw_datasignal_read(signal)
+            self.assertTrue(done.wait(10))
+        elapsed= time.perf_counter() - start
+        self.libmetawear.mbl_mw_datasignal_unsubscribe(signal)
+        return elapsed
+
+    def test_open_missing_socket(self):
+        self.assertIsNone(self.libmetawear.mbl_mw_socket_connection_open(self.path.encode('ascii'), b'F1:4A:45:90:AC:9D'))
+
+    def test_initialize(self):
+        self.start_peer()
+
+        self.assertEqual(self.libmetawear.mbl_mw_metawearboard_get_model(self.socket_board), Model.METAWEAR_R)
+        self.assertEqual(self.libmetawear.mbl_mw_metawearboard_lookup_module(self.socket_board, Module.TEMPERATURE), 1)
+
+    def test_batched_writes(self):
+        log= os.path.join(self.tmpdir.name, 'frames.json')
+        self.start_peer('--log', log)
+        self.libmetawear.mbl_mw_metawearboard_tear_down(self.socket_board)
+        self.close_peer()
+
+        with open(log) as f:
+            frames= json.load(f)
+        # the commands are sent in one frame, other frames can still be in flight from initialization
+        self.assertIn([[0x09, 0x08], [0x0a, 0x05], [0x0b, 0x0a]], [frame['entries'] for frame in frames])
+
+    def test_send_failure(self):
+        self.start_peer('--stop-reading')
+        self.expected= 1
+        signal= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.socket_board)
+        self.libmetawear.mbl_mw_datasignal_subscribe(signal, None, self.data_handler_fn)
+        self.libmetawear.mbl_mw_led_play(self.socket_board)
+        self.assertTrue(self.all_received.wait(10))
+
+        self.socket_initialized.clear()
+        self.libmetawear.mbl_mw_metawearboard_initialize(self.socket_board, None, self.socket_initialized_fn)
+        self.assertTrue(self.socket_initialized.wait(10))
+        self.assertEqual(self.socket_init_status, Const.STATUS_ERROR_ENABLE_NOTIFY)
+
+    def test_disconnect_reported_once(self):
+        self.start_peer('--disconnect')
+        statuses= []
+        disconnected= Event()
+        def handler(caller, status):
+            statuses.append(status)
+            disconnected.set()
+        self.dc_handler_fn= FnVoid_VoidP_Int(handler)
+
+        # stands in for the board's handler so the reports can be counted
+        btle_conn= self.libmetawear.mbl_mw_socket_connection_get_btle_connection(self.connection).contents
+        btle_conn.on_disconnect(btle_conn.context, None, self.dc_handler_fn)
+        self.libmetawear.mbl_mw_led_play(self.socket_board)
+        self.assertTrue(disconnected.wait(10))
+        self.peer.wait(10)
+        # the socket closing after the disconnected frame must not be reported again
+        time.sleep(0.5)
+
+        self.assertEqual(statuses, [0])
+
+    def test_round_trip(self):
+        n= 200
+        self.start_peer()
+
+        socket_elapsed= self.read_temperature(self.socket_board, n)
+        local_elapsed= self.read_temperature(self.board, n)
+
+        print("\nsocket connection: %.1fus per round trip, in process: %.1fus" % (socket_elapsed / n * 1e6, local_elapsed / n * 1e6))
+        self.assertGreater(socket_elapsed, 0)
+
+    def test_notification_throughput(self):
+        self.expected= 20000
+        batch= 32
+        self.start_peer('--stream', str(self.expected), '--batch', str(batch))
+
+        signal= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.socket_board)
+        start= time.perf_counter()
+        self.libmetawear.mbl_mw_datasignal_subscribe(signal, None, self.data_handler_fn)
+        self.assertTrue(self.all_received.wait(60))
+        socket_elapsed= time.perf_counter() - start
+
+        # same notifications handed to the in process board in the same batches
+        self.received= 0
+        self.all_received.clear()
+        signal= self.libmetawear.mbl_mw_switch_get_state_data_signal(self.board)
+        self.libmetawear.mbl_mw_datasignal_subscribe(signal, None, self.data_handler_fn)
+        buffers= [(c_ubyte * 3)(0x01, 0x01, i & 0x1) for i in range(batch)]
+        notifications= (Notification * batch)(*[Notification(board= self.board, value= cast(buffer, POINTER(c_ubyte)), length= 3) for buffer in buffers])
+        start= time.perf_counter()
+        for i in range(self.expected // batch):
+            self.libmetawear.mbl_mw_metawearboard_handle_notifications(notifications, batch)
+        self.libmetawear.mbl_mw_metawearboard_handle_notifications(notifications, self.expected % batch)
+        local_elapsed= time.perf_counter() - start
+
+        print("\nsocket connection: %.0f notifications/s, in process: %.0f notifications/s" % (self.expected / socket_elapsed, self.expected / local_elapsed))
+        self.assertEqual(self.received, self.expected)
@@ -0,0 +1,107 @@
+from common import TestMetaWearBase
+from cbindings import *
+import threading
+
+class TestWriteBatchBase(TestMetaWearBase):
+    def __init__(self, *args, **kwargs):
+        super().__init__(*args, **kwargs)
+
+        self.batches= []
+        self.write_gatt_chars_fn= FnVoid_VoidP_VoidP_GattCharWriteP_UInt(self.write_gatt_chars)
+
+    def setUp(self):
+        super().setUp()
+
+        self.libmetawear.mbl_mw_metawearboard_set_write_gatt_chars(self.board, self.write_gatt_chars_fn)
+
+    def write_gatt_chars(self, context, board, writes, n_writes):
+        batch= []
+        for i in range(0, n_writes):
+            batch.append([writes[i].value[j] for j in range(0, writes[i].length)])
+            self.commandLogger(context, board, writes[i].write_type, writes[i].characteristic, writes[i].value, writes[i].length)
+        self.batches.append(batch)
+
+class TestWriteBatch(TestWriteBatchBase):
+    def setUp(self):
+        self.boardType = TestMetaWearBase.METAWEAR_MOTION_R_BOARD
+
+        super().setUp()
+
+        self.batches= []
+        self.command_history= []
+
+    def test_sensor_fusion_start(self):
+        self.libmetawear.mbl_mw_sensor_fusion_set_mode(self.board, SensorFusionMode.NDOF)
+        self.libmetawear.mbl_mw_sensor_fusion_enable_data(self.board, SensorFusionData.QUATERNION)
+        self.libmetawear.mbl_mw_sensor_fusion_start(self.board)
+
+        expected= [
+            [0x03, 0x02, 0x01, 0x00],
+            [0x13, 0x02, 0x01, 0x00],
+            [0x15, 0x02, 0x01, 0x00],
+            [0x03, 0x01, 0x01],
+            [0x13, 0x01, 0x01],
+            [0x15, 0x01, 0x01],
+            [0x19, 0x03, 0x08, 0x00],
+            [0x19, 0x01, 0x01]
+        ]
+        self.assertEqual(self.batches, [expected])
+        self.assertEqual(self.command_history, expected)
+
+    def test_sensor_fusion_stop(self):
+        self.libmetawear.mbl_mw_sensor_fusion_stop(self.board)
+
+        self.assertEqual(len(self.batches), 1)
+        self.assertEqual(self.batches[0], self.command_history)
+
+    def test_tear_down(self):
+        self.libmetawear.mbl_mw_metawearboard_tear_down(self.board)
+
+        expected= [
+            [0x09, 0x08],
+            [0x0a, 0x05],
+            [0x0b, 0x0a]
+        ]
+        self.assertEqual(self.batches, [expected])
+        self.assertEqual(self.command_history, expected)
+
+    def test_single_write(self):
+        self.libmetawear.mbl_mw_led_play(self.board)
+
+        self.assertEqual(self.batches, [])
+        self.assertEqual(self.command_history, [[0x02, 0x01, 0x01]])
+
+class TestWriteBatchMacro(TestWriteBatchBase):
+    def setUp(self):
+        self.boardType= TestMetaWearBase.METAWEAR_RPRO_BOARD
+
+        super().setUp()
+
+        self.uploaded= threading.Event()
+        self.uploaded_fn= FnVoid_VoidP_VoidP_MacroUploadResultP_Int(lambda ctx, board, result, status: self.uploaded.set())
+        self.builder= self.libmetawear.mbl_mw_macro_builder_create(self.board, 1)
+
+    def tearDown(self):
+        self.libmetawear.mbl_mw_macro_builder_free(self.builder)
+        super().tearDown()
+
+    def test_upload(self):
+        self.libmetawear.mbl_mw_macro_builder_record(self.builder)
+        self.libmetawear.mbl_mw_led_play(self.board)
+        self.libmetawear.mbl_mw_led_stop(self.board)
+        self.libmetawear.mbl_mw_macro_builder_end_record(self.builder)
+
+        self.batches= []
+        self.command_history= []
+        self.libmetawear.mbl_mw_macro_builder_upload(self.builder, None, self.uploaded_fn)
+        self.uploaded.wait()
+
+        expected = [
+            [0x0f, 0x02, 0x01],
+            [0x0f, 0x03, 0x02, 0x01, 0x01],
+            [0x0f, 0x03, 0x02, 0x02, 0x00],
+            [0x0f, 0x04]
+        ]
+        # the info read acknowledges the end command and goes out in the same batch
+        self.assertEqual(self.batches, [expected[1:] + [[0x0f, 0x80]]])
+        self.assertEqual(self.command_history, expected)